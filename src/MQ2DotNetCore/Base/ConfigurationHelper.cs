@@ -1,8 +1,10 @@
 ﻿using Microsoft.Extensions.Configuration;
+using Microsoft.Extensions.FileProviders;
 using Microsoft.Extensions.Logging;
 using MQ2DotNetCore.Logging;
 using System;
 using System.IO;
+using System.Runtime.CompilerServices;
 using System.Threading;
 using System.Threading.Tasks;
 
@@ -11,6 +13,7 @@ namespace MQ2DotNetCore.Base
 	public static class ConfigurationHelper
 	{
 		private static IConfiguration? _configuration;
+		private static PhysicalFileProvider? _fileProvider;
 		private static readonly object _lock = new object();
 		private static readonly string _logFilePath = Path.Combine(MQ2DotNetCoreAssemblyInformation.AssemblyDirectory, "debug_entry_point.log");
 
@@ -30,6 +33,7 @@ namespace MQ2DotNetCore.Base
 				mq2DotNetCoreOptions.IsConsoleLoggingEnabled
 				|| mq2DotNetCoreOptions.IsDebugLoggingEnabled
 				|| mq2DotNetCoreOptions.IsFileLoggingEnabled
+				|| mq2DotNetCoreOptions.IsLoaderLoggingEnabled
 				|| mq2DotNetCoreOptions.IsMQ2LoggingEnabled;
 
 			ILoggerFactory? loggerFactory = null;
@@ -61,6 +65,11 @@ namespace MQ2DotNetCore.Base
 						});
 					}
 
+					if (mq2DotNetCoreOptions.IsLoaderLoggingEnabled)
+					{
+						loggingBuilder.AddLoader();
+					}
+
 					if (mq2DotNetCoreOptions.IsMQ2LoggingEnabled)
 					{
 						loggingBuilder.AddMQ2();
@@ -87,8 +96,10 @@ namespace MQ2DotNetCore.Base
 						return _configuration;
 					}
 
+					// Owned here rather than by the builder so its file watcher can be stopped again, see ReleaseConfiguration
+					_fileProvider = new PhysicalFileProvider(MQ2DotNetCoreAssemblyInformation.AssemblyDirectory);
 					_configuration = new ConfigurationBuilder()
-						.SetBasePath(MQ2DotNetCoreAssemblyInformation.AssemblyDirectory)
+						.SetFileProvider(_fileProvider)
 						.AddJsonFile("MQ2DotNetCore.appsettings.json", optional: false, reloadOnChange: true)
 						.Build();
 				}
@@ -102,6 +113,26 @@ namespace MQ2DotNetCore.Base
 			}
 		}
 
+		// Fallback logging for code that runs without a logger factory, e.g. HotReloadHost
+		internal static void TryAppendException(Exception exception, [CallerFilePath] string? callerFilePath = null, [CallerMemberName] string? callerMemberName = null)
+			=> TryAppendToFile($"{PrefixLogEntry(LogLevel.Critical, callerFilePath, callerMemberName)}  An exception occurred:\n\n{exception}\n");
+
+		/// <summary>
+		/// Stops watching the settings file for changes. Only needed before unloading a hot reloaded copy, whose reload callbacks
+		/// would otherwise stay registered with the file watcher.
+		/// </summary>
+		internal static void ReleaseConfiguration()
+		{
+			lock (_lock)
+			{
+				(_configuration as IDisposable)?.Dispose();
+				_fileProvider?.Dispose();
+
+				_configuration = null;
+				_fileProvider = null;
+			}
+		}
+
 		private static string PrefixLogEntry(LogLevel logLevel, string? callerFilePath, string? callerMemberName)
 		{
 			var callSite = StringHelper.GetCallSiteString(callerFilePath, callerMemberName);
@@ -0,0 +1,48 @@
+﻿using System;
+using System.IO;
+using System.Reflection;
+using System.Runtime.Loader;
+
+namespace MQ2DotNetCore.Base
+{
+	/// <summary>
+	/// Collectible context that <see cref="HotReloadHost"/> loads a copy of MQ2DotNetCore into. The copy is read from memory so
+	/// loading it doesn't lock MQ2DotNetCore.dll, the loader runs the host itself from a copy for the same reason. Its dependencies
+	/// come from the context the host was loaded into, so every copy shares one instance of them, they stay locked, and only
+	/// MQ2DotNetCore is loaded again.
+	/// </summary>
+	internal sealed class CoreAssemblyLoadContext : AssemblyLoadContext
+	{
+		private readonly AssemblyLoadContext _hostLoadContext;
+
+		public CoreAssemblyLoadContext(string name, AssemblyLoadContext hostLoadContext)
+			: base(name, true)
+		{
+			_hostLoadContext = hostLoadContext;
+		}
+
+		internal Assembly LoadCore(string assemblyPath)
+		{
+			using var assemblyStream = new MemoryStream(File.ReadAllBytes(assemblyPath));
+
+			var symbolsPath = Path.ChangeExtension(assemblyPath, ".pdb");
+			if (!File.Exists(symbolsPath))
+			{
+				return LoadFromStream(assemblyStream);
+			}
+
+			using var symbolsStream = new MemoryStream(File.ReadAllBytes(symbolsPath));
+			return LoadFromStream(assemblyStream, symbolsStream);
+		}
+
+		protected override Assembly? Load(AssemblyName assemblyName)
+		{
+			if (assemblyName == null)
+			{
+				throw new ArgumentNullException(nameof(assemblyName));
+			}
+
+			return _hostLoadContext.LoadFromAssemblyName(assemblyName);
+		}
+	}
+}
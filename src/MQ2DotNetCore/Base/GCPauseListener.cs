@@ -0,0 +1,127 @@
+﻿using System;
+using System.Diagnostics.Tracing;
+
+namespace MQ2DotNetCore.Base
+{
+	/// <summary>
+	/// Listens to the runtime's GC events and times each pause from the start of the suspension to the end of the restart, which
+	/// is the time the EQ thread couldn't run managed code. The runtime raises the events on its own dispatch thread, usually a
+	/// little after the pause, so a pulse sees the pauses that were reported since the previous one rather than the ones that
+	/// happened during it. Must be disposed, the runtime keeps every listener in a static list.
+	/// </summary>
+	internal sealed class GCPauseListener : EventListener
+	{
+		private const string RuntimeEventSourceName = "Microsoft-Windows-DotNETRuntime";
+		private const EventKeywords GCKeyword = (EventKeywords)0x1;
+
+		private const int GCStartEventId = 1;
+		private const int GCRestartEEEndEventId = 3;
+		private const int GCSuspendEEBeginEventId = 9;
+
+		// GCStart's Type, the other two block the threads for the whole collection
+		private const uint BackgroundGCType = 1;
+
+		private readonly object _lock = new object();
+		private readonly LatencyHistogram _pauseTimings = new LatencyHistogram();
+
+		// Only touched on the dispatch thread
+		private DateTime _suspendTimestamp;
+		private int _pauseGeneration = -1;
+
+		private ulong _pendingPauseCount;
+		private ulong _pendingPauseNanoseconds;
+		private ulong _pendingLongestPauseNanoseconds;
+		private uint _pendingBlockingGen2Count;
+
+		internal void TakePending(out ulong pauseCount, out ulong pauseNanoseconds, out ulong longestPauseNanoseconds, out uint blockingGen2Count)
+		{
+			lock (_lock)
+			{
+				pauseCount = _pendingPauseCount;
+				pauseNanoseconds = _pendingPauseNanoseconds;
+				longestPauseNanoseconds = _pendingLongestPauseNanoseconds;
+				blockingGen2Count = _pendingBlockingGen2Count;
+
+				_pendingPauseCount = 0;
+				_pendingPauseNanoseconds = 0;
+				_pendingLongestPauseNanoseconds = 0;
+				_pendingBlockingGen2Count = 0;
+			}
+		}
+
+		internal Interop.CallbackTimingSummary GetPauseSummary()
+		{
+			lock (_lock)
+			{
+				return _pauseTimings.GetSummary();
+			}
+		}
+
+		internal void ResetPauseTimings()
+		{
+			lock (_lock)
+			{
+				_pauseTimings.Reset();
+			}
+		}
+
+		protected override void OnEventSourceCreated(EventSource eventSource)
+		{
+			if (eventSource.Name == RuntimeEventSourceName)
+			{
+				EnableEvents(eventSource, EventLevel.Informational, GCKeyword);
+			}
+		}
+
+		protected override void OnEventWritten(EventWrittenEventArgs eventData)
+		{
+			switch (eventData.EventId)
+			{
+				case GCSuspendEEBeginEventId:
+					_suspendTimestamp = eventData.TimeStamp;
+					_pauseGeneration = -1;
+					break;
+
+				case GCStartEventId:
+					_pauseGeneration = Convert.ToInt32(GetPayload(eventData, "Depth") ?? -1);
+					if (_pauseGeneration == 2 && Convert.ToUInt32(GetPayload(eventData, "Type") ?? 0u) != BackgroundGCType)
+					{
+						lock (_lock)
+						{
+							++_pendingBlockingGen2Count;
+						}
+					}
+
+					break;
+
+				case GCRestartEEEndEventId:
+					if (_suspendTimestamp == default)
+					{
+						break;
+					}
+
+					var pauseNanoseconds = (ulong)Math.Max(0, (eventData.TimeStamp - _suspendTimestamp).Ticks) * 100;
+					_suspendTimestamp = default;
+
+					lock (_lock)
+					{
+						_pauseTimings.RecordNanoseconds(pauseNanoseconds);
+						++_pendingPauseCount;
+						_pendingPauseNanoseconds += pauseNanoseconds;
+						if (pauseNanoseconds > _pendingLongestPauseNanoseconds)
+						{
+							_pendingLongestPauseNanoseconds = pauseNanoseconds;
+						}
+					}
+
+					break;
+			}
+		}
+
+		private static object? GetPayload(EventWrittenEventArgs eventData, string name)
+		{
+			var index = eventData.PayloadNames?.IndexOf(name) ?? -1;
+			return index >= 0 && eventData.Payload != null && index < eventData.Payload.Count ? eventData.Payload[index] : null;
+		}
+	}
+}
@@ -0,0 +1,55 @@
+﻿using System;
+using System.Runtime.Loader;
+
+namespace MQ2DotNetCore.Base
+{
+	/// <summary>
+	/// What one copy of the core hands to the next when the loader reloads it, see <see cref="HotReloadHost"/>. Each copy has its
+	/// own statics, so the state is kept in the AppDomain's data slots, which every load context shares.
+	/// </summary>
+	internal static class HotReloadState
+	{
+		private const string AssemblyPathKey = "MQ2DotNetCore.HotReload.AssemblyPath";
+		private const string GenerationKey = "MQ2DotNetCore.HotReload.Generation";
+		private const string RunningProgramsKey = "MQ2DotNetCore.HotReload.RunningPrograms";
+
+		/// <summary>
+		/// True when this copy was loaded by <see cref="HotReloadHost"/> and can be unloaded again
+		/// </summary>
+		internal static bool IsHosted => AssemblyLoadContext.GetLoadContext(typeof(HotReloadState).Assembly)?.IsCollectible == true;
+
+		/// <summary>
+		/// Where the host read this copy from, since an assembly loaded from a stream has no location of its own
+		/// </summary>
+		internal static string? AssemblyPath
+		{
+			get => AppDomain.CurrentDomain.GetData(AssemblyPathKey) as string;
+			set => AppDomain.CurrentDomain.SetData(AssemblyPathKey, value);
+		}
+
+		/// <summary>
+		/// 1 for the copy loaded with the plugin, one more for every reload after it
+		/// </summary>
+		internal static int Generation
+		{
+			get => AppDomain.CurrentDomain.GetData(GenerationKey) is int generation ? generation : 0;
+			set => AppDomain.CurrentDomain.SetData(GenerationKey, value);
+		}
+
+		/// <summary>
+		/// Saves the /netcorerun arguments of the programs that were running when the old copy shut down
+		/// </summary>
+		internal static void SaveRunningPrograms(string[][] programArguments)
+			=> AppDomain.CurrentDomain.SetData(RunningProgramsKey, programArguments);
+
+		/// <summary>
+		/// Returns the programs the previous copy saved, at most once
+		/// </summary>
+		internal static string[][] TakeRunningPrograms()
+		{
+			var programArguments = AppDomain.CurrentDomain.GetData(RunningProgramsKey) as string[][];
+			AppDomain.CurrentDomain.SetData(RunningProgramsKey, null);
+			return programArguments ?? Array.Empty<string[]>();
+		}
+	}
+}
@@ -0,0 +1,167 @@
+﻿using MQ2DotNetCore.Interop;
+using MQ2DotNetCore.MQ2Api;
+using System;
+using System.Diagnostics;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using System.Threading;
+
+namespace MQ2DotNetCore.Base
+{
+	/// <summary>
+	/// JITs what the first pulses after a load would otherwise compile on the EQ thread: the callback handlers, what they
+	/// dispatch to, and every <see cref="MQ2TypeFactory"/> wrapper type with its members. Methods are only compiled, never run, so
+	/// this is safe off the EQ thread. With PreWarm=1 in MQ2DotNetCoreLoader.ini it all runs on the loader's boot thread when
+	/// AsyncBoot=1 is set. Otherwise <see cref="LoaderEntryPoint.InitializePlugin(IntPtr, int)"/> compiles the hot paths itself,
+	/// since a background thread would be compiling the same methods the first pulses are waiting on, and leaves the wrappers to a
+	/// background thread. With tiered compilation this puts the tier 0 code in place, hot methods are still recompiled later.
+	/// </summary>
+	internal static class JitWarmup
+	{
+		private const BindingFlags DeclaredMembers = BindingFlags.DeclaredOnly | BindingFlags.Instance | BindingFlags.Static | BindingFlags.Public | BindingFlags.NonPublic;
+
+		// In the order the first pulses need them
+		private static readonly Type[] _hotPathTypes =
+		{
+			typeof(LoaderEntryPoint),
+			typeof(LoaderCallbackSubscriptions),
+			typeof(SubmoduleRegistry),
+			typeof(MQ2SubmoduleEventRegistry),
+			typeof(MQ2SynchronizationContext),
+			typeof(MQ2CommandRegistry),
+			typeof(PulseSnapshotDispatcher),
+			typeof(MQ2GCTelemetry),
+			typeof(MQ2DotNetCoreLoader.NativeMethods),
+			typeof(SpawnHandleTable),
+			typeof(InternTable),
+			typeof(MQ2TypeFactory),
+			typeof(MQ2DataType),
+			typeof(MQ2Spawns),
+			typeof(ChatUtilities)
+		};
+
+		private static Thread? _thread;
+		private static volatile bool _isStopping;
+		private static volatile bool _hasRun;
+
+		internal static bool HasRun => _hasRun;
+		internal static int PreparedMethodCount { get; private set; }
+		internal static TimeSpan Elapsed { get; private set; }
+
+		internal static void Run()
+		{
+			PrepareHotPaths();
+			PrepareWrappers();
+		}
+
+		internal static void PrepareHotPaths()
+		{
+			var stopwatch = Stopwatch.StartNew();
+			foreach (var type in _hotPathTypes)
+			{
+				PreparedMethodCount += PrepareType(type);
+			}
+
+			Elapsed += stopwatch.Elapsed;
+		}
+
+		/// <summary>
+		/// Starts <see cref="PrepareWrappers"/> on a background thread
+		/// </summary>
+		internal static void StartWrappers()
+		{
+			_isStopping = false;
+			_thread = new Thread(PrepareWrappers)
+			{
+				IsBackground = true,
+				Name = "MQ2DotNetCore JIT warm-up",
+				Priority = ThreadPriority.BelowNormal
+			};
+
+			_thread.Start();
+		}
+
+		/// <summary>
+		/// Stops a warm-up that is still running and waits for its thread, which would otherwise keep a hot reloaded copy loaded
+		/// </summary>
+		internal static void Stop()
+		{
+			_isStopping = true;
+			_thread?.Join();
+			_thread = null;
+		}
+
+		private static void PrepareWrappers()
+		{
+			var stopwatch = Stopwatch.StartNew();
+			var preparedMethodCount = 0;
+			foreach (var type in typeof(MQ2DataType).Assembly.GetTypes())
+			{
+				if (!type.IsAbstract && type.IsSubclassOf(typeof(MQ2DataType)) && type.GetCustomAttribute<MQ2TypeAttribute>() != null)
+				{
+					preparedMethodCount += PrepareType(type);
+				}
+			}
+
+			PreparedMethodCount += preparedMethodCount;
+			Elapsed += stopwatch.Elapsed;
+			_hasRun = !_isStopping;
+		}
+
+		internal static string GetSummary()
+			=> $"{PreparedMethodCount} methods in {Elapsed.TotalMilliseconds:0.0} ms" + (_hasRun ? string.Empty : ", still running");
+
+		// Lambdas and iterators compile into nested types, they're prepared along with the type that declares them
+		private static int PrepareType(Type type)
+		{
+			var preparedMethodCount = 0;
+			if (_isStopping || type.ContainsGenericParameters)
+			{
+				return preparedMethodCount;
+			}
+
+			foreach (var constructor in type.GetConstructors(DeclaredMembers))
+			{
+				// Compiling a static constructor doesn't run it, but there's nothing to gain from it either
+				if (!constructor.IsStatic && TryPrepare(constructor))
+				{
+					++preparedMethodCount;
+				}
+			}
+
+			foreach (var method in type.GetMethods(DeclaredMembers))
+			{
+				if (!method.IsAbstract && !method.ContainsGenericParameters && TryPrepare(method))
+				{
+					++preparedMethodCount;
+				}
+			}
+
+			foreach (var nestedType in type.GetNestedTypes(BindingFlags.Public | BindingFlags.NonPublic))
+			{
+				preparedMethodCount += PrepareType(nestedType);
+			}
+
+			return preparedMethodCount;
+		}
+
+		private static bool TryPrepare(MethodBase method)
+		{
+			if (_isStopping)
+			{
+				return false;
+			}
+
+			try
+			{
+				RuntimeHelpers.PrepareMethod(method.MethodHandle);
+				return true;
+			}
+			catch (Exception)
+			{
+				// E.g. a P/Invoke whose signature can't be marshaled until it's called, it's left to the first call
+				return false;
+			}
+		}
+	}
+}
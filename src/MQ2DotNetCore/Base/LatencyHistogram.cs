@@ -0,0 +1,120 @@
+﻿using MQ2DotNetCore.Interop;
+using System;
+using System.Diagnostics;
+
+namespace MQ2DotNetCore.Base
+{
+	/// <summary>
+	/// Managed copy of the loader's log linear LatencyHistogram (CallbackTimings.h), used for the per submodule breakdown of the
+	/// callback timings and the GC pauses. Not thread safe, the pause listener locks around it.
+	/// </summary>
+	internal sealed class LatencyHistogram
+	{
+		private const int SubBucketBits = 3;
+		private const int SubBucketCount = 1 << SubBucketBits;
+		private const int LinearLimit = 2 * SubBucketCount;
+		private const int MaxExponent = 36;
+		private const int BucketCount = LinearLimit + (MaxExponent - (SubBucketBits + 1)) * SubBucketCount;
+
+		private static readonly double _nanosecondsPerTick = 1_000_000_000.0 / Stopwatch.Frequency;
+
+		private readonly ulong[] _buckets = new ulong[BucketCount];
+		private ulong _count;
+		private ulong _maxNanoseconds;
+		private ulong _totalNanoseconds;
+
+		internal void RecordTicks(long elapsedTicks)
+		{
+			RecordNanoseconds(elapsedTicks <= 0 ? 0UL : (ulong)(elapsedTicks * _nanosecondsPerTick));
+		}
+
+		internal void RecordNanoseconds(ulong nanoseconds)
+		{
+			++_buckets[ToBucket(nanoseconds)];
+			++_count;
+			_totalNanoseconds += nanoseconds;
+			if (nanoseconds > _maxNanoseconds)
+			{
+				_maxNanoseconds = nanoseconds;
+			}
+		}
+
+		internal void Reset()
+		{
+			Array.Clear(_buckets, 0, _buckets.Length);
+			_count = 0;
+			_maxNanoseconds = 0;
+			_totalNanoseconds = 0;
+		}
+
+		internal CallbackTimingSummary GetSummary()
+		{
+			return new CallbackTimingSummary
+			{
+				Count = _count,
+				TotalNanoseconds = _totalNanoseconds,
+				P50Nanoseconds = GetPercentile(50),
+				P90Nanoseconds = GetPercentile(90),
+				P99Nanoseconds = GetPercentile(99),
+				MaxNanoseconds = _maxNanoseconds
+			};
+		}
+
+		private ulong GetPercentile(ulong percentile)
+		{
+			if (_count == 0)
+			{
+				return 0;
+			}
+
+			var threshold = (_count * percentile + 99) / 100;
+			ulong cumulative = 0;
+			for (var bucket = 0; bucket < BucketCount; ++bucket)
+			{
+				cumulative += _buckets[bucket];
+				if (cumulative >= threshold)
+				{
+					var upperBound = BucketUpperBound(bucket);
+					return upperBound < _maxNanoseconds ? upperBound : _maxNanoseconds;
+				}
+			}
+
+			return _maxNanoseconds;
+		}
+
+		private static int ToBucket(ulong nanoseconds)
+		{
+			if (nanoseconds < LinearLimit)
+			{
+				return (int)nanoseconds;
+			}
+
+			var exponent = 63;
+			while ((nanoseconds >> exponent) == 0)
+			{
+				--exponent;
+			}
+
+			if (exponent >= MaxExponent)
+			{
+				return BucketCount - 1;
+			}
+
+			var subBucket = (int)(nanoseconds >> (exponent - SubBucketBits)) & (SubBucketCount - 1);
+			return LinearLimit + (exponent - (SubBucketBits + 1)) * SubBucketCount + subBucket;
+		}
+
+		private static ulong BucketUpperBound(int bucket)
+		{
+			if (bucket < LinearLimit)
+			{
+				return (ulong)bucket;
+			}
+
+			var exponent = (bucket - LinearLimit) / SubBucketCount + SubBucketBits + 1;
+			var subBucket = (ulong)((bucket - LinearLimit) % SubBucketCount);
+			var width = 1UL << (exponent - SubBucketBits);
+			return (SubBucketCount + subBucket) * width + width - 1;
+		}
+	}
+}
@@ -0,0 +1,124 @@
+﻿using MQ2DotNetCore.Interop;
+using System.Threading;
+
+namespace MQ2DotNetCore.Base
+{
+	/// <summary>
+	/// Counts the handlers subscribed to each loader callback across every submodule's <see cref="MQ2Api.MQ2SubmoduleEventRegistry"/>
+	/// and publishes which callbacks have any to the loader, which skips the transition into managed code for the rest.
+	/// </summary>
+	/// <remarks>
+	/// OnPulse is also published while a pulse is requested. Running programs, async commands and continuations posted to the
+	/// <see cref="MQ2SynchronizationContext"/> all need pulses without subscribing to an event, so they call <see cref="RequestPulse"/>
+	/// and <see cref="LoaderEntryPoint"/> releases it from a pulse that finds none of them left.
+	/// </remarks>
+	internal static class LoaderCallbackSubscriptions
+	{
+		private static bool _isEnabled;
+
+		// 1 while a pulse is requested, an int so it can be swapped with a full fence
+		private static int _isPulseRequested = 1;
+
+		private static readonly object _lock = new object();
+		private static uint _publishedMask;
+		private static readonly int[] _subscriberCounts = new int[(int)LoaderCallback.Count];
+
+		internal static bool IsEnabled => _isEnabled;
+
+		internal static void ChangeSubscriberCount(LoaderCallback callback, int subscriberCountChange)
+		{
+			lock (_lock)
+			{
+				_subscriberCounts[(int)callback] += subscriberCountChange;
+				PublishLocked();
+			}
+		}
+
+		/// <summary>
+		/// Starts publishing the subscriptions, until then the loader forwards every callback
+		/// </summary>
+		internal static void Enable()
+		{
+			lock (_lock)
+			{
+				_isEnabled = true;
+				_isPulseRequested = 1;
+				_publishedMask = 0;
+				PublishLocked(true);
+			}
+		}
+
+		/// <summary>
+		/// Has the loader forward every callback again
+		/// </summary>
+		internal static void Disable()
+		{
+			lock (_lock)
+			{
+				if (_isEnabled)
+				{
+					_isEnabled = false;
+					MQ2DotNetCoreLoader.NativeMethods.CallbackSubscriptions__SetMask(uint.MaxValue);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Keeps OnPulse forwarded until the next <see cref="ReleasePulse"/>. Safe to call from any thread, and cheap when a pulse
+		/// is already requested.
+		/// </summary>
+		internal static void RequestPulse()
+		{
+			if (Volatile.Read(ref _isPulseRequested) == 1)
+			{
+				return;
+			}
+
+			lock (_lock)
+			{
+				_isPulseRequested = 1;
+				PublishLocked();
+			}
+		}
+
+		/// <summary>
+		/// Stops forwarding OnPulse unless something subscribed to it. Callers must check for work that was queued concurrently
+		/// afterwards and call <see cref="RequestPulse"/> for it.
+		/// </summary>
+		internal static void ReleasePulse()
+		{
+			if (Interlocked.Exchange(ref _isPulseRequested, 0) == 0)
+			{
+				return;
+			}
+
+			lock (_lock)
+			{
+				PublishLocked();
+			}
+		}
+
+		private static void PublishLocked(bool isForced = false)
+		{
+			if (!_isEnabled)
+			{
+				return;
+			}
+
+			var mask = _isPulseRequested == 1 ? 1u << (int)LoaderCallback.Pulse : 0u;
+			for (var callback = 0; callback < _subscriberCounts.Length; ++callback)
+			{
+				if (_subscriberCounts[callback] > 0)
+				{
+					mask |= 1u << callback;
+				}
+			}
+
+			if (mask != _publishedMask || isForced)
+			{
+				_publishedMask = mask;
+				MQ2DotNetCoreLoader.NativeMethods.CallbackSubscriptions__SetMask(mask);
+			}
+		}
+	}
+}
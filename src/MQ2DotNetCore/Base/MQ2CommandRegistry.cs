@@ -181,6 +181,9 @@ namespace MQ2DotNetCore.Base
 		{
 			try
 			{
+				// Finished tasks are only cleaned up during OnPulse
+				LoaderCallbackSubscriptions.RequestPulse();
+
 				if (_asyncCommandTasks.TryGetValue(submoduleName, out var wrapperListForSubmodule)
 					&& wrapperListForSubmodule != null)
 				{
@@ -600,6 +603,19 @@ namespace MQ2DotNetCore.Base
 			}
 		}
 
+		internal bool HasAsyncCommandTasks()
+		{
+			foreach (var submoduleWrapperList in _asyncCommandTasks.Values)
+			{
+				if (submoduleWrapperList?.Count > 0)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
 		internal int ProcessAsyncCommandTasks()
 		{
 #if DEBUG
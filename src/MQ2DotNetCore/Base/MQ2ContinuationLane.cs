@@ -0,0 +1,19 @@
+﻿namespace MQ2DotNetCore.Base
+{
+	/// <summary>
+	/// Queues continuations posted to <see cref="MQ2SynchronizationContext"/> are kept in. Each pulse runs the lanes in order, so when the
+	/// pulse budget runs out it's the later lanes that wait for the next pulse.
+	/// </summary>
+	public enum MQ2ContinuationLane
+	{
+		/// <summary>
+		/// Commands and the handlers of plugin callbacks
+		/// </summary>
+		Command = 0,
+
+		/// <summary>
+		/// Programs started with /netcorerun
+		/// </summary>
+		Background = 1
+	}
+}
@@ -17,7 +17,11 @@ namespace MQ2DotNetCore.Base
 		static MQ2DotNetCoreAssemblyInformation()
 		{
 			MQ2DotNetCoreAssembly = typeof(MQ2DotNetCoreAssemblyInformation).Assembly;
-			AssemblyLocation = MQ2DotNetCoreAssembly.Location;
+
+			// A copy loaded by HotReloadHost was read from memory and has no location of its own
+			AssemblyLocation = string.IsNullOrEmpty(MQ2DotNetCoreAssembly.Location)
+				? HotReloadState.AssemblyPath ?? string.Empty
+				: MQ2DotNetCoreAssembly.Location;
 			AssemblyDirectory = Directory.GetParent(AssemblyLocation).FullName;
 
 			FileVersionInfo = FileVersionInfo.GetVersionInfo(AssemblyLocation);
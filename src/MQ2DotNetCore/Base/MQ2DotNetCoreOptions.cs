@@ -10,9 +10,84 @@ namespace MQ2DotNetCore.Base
 		}
 
 		public Version? FileVersion { get; set; }
+
+		/// <summary>
+		/// When true the loader only calls into the managed side for callbacks that some submodule has a handler for, and for
+		/// OnPulse while programs, async commands or continuations need it. With no programs running no callback crosses into
+		/// managed code. Only read during initialization.
+		/// </summary>
+		public bool IsCallbackSubscriptionEnabled { get; set; }
+
 		public bool IsConsoleLoggingEnabled { get; set; }
 		public bool IsDebugLoggingEnabled { get; set; }
 		public bool IsFileLoggingEnabled { get; set; }
+
+		/// <summary>
+		/// When true allocations, collections and GC pauses are measured every pulse for <see cref="MQ2Api.MQ2.GCTelemetry"/> and
+		/// /netcorestats. Pauses come from an in process listener on the runtime's GC events, which costs a little for every
+		/// collection. Only read during initialization.
+		/// </summary>
+		public bool IsGCTelemetryEnabled { get; set; }
+
+		/// <summary>
+		/// When true the loader queues spawn, ground item, and zone events in its event ring and they are dispatched in a
+		/// single batch at the start of each OnPulse, instead of making one native to managed transition per event.
+		/// Spawn and ground item removals aren't batched: EQ frees them as soon as the callback returns, so the batch so far is
+		/// dispatched first and then OnRemoveSpawn / OnRemoveGroundItem is called while the spawn or item is still valid. Spawns in
+		/// batched OnAddSpawn events are stale (their members return null) if the client zoned before the batch was dispatched, or
+		/// if the loader's spawn handle table had no room for them.
+		/// Only read during initialization.
+		/// </summary>
+		public bool IsLoaderEventBatchingEnabled { get; set; }
+
+		/// <summary>
+		/// When true log records are handed to the loader, whose writer thread appends them to debug_plugin.log together with its own
+		/// lines. Logging never waits on the file, records that arrive while the loader's ring is full are dropped and counted. The
+		/// "Loader" provider alias filters them. Only read during initialization.
+		/// </summary>
+		public bool IsLoaderLoggingEnabled { get; set; }
+
+		/// <summary>
+		/// When true the loader memoizes TLO and member reads until the start of the next pulse, so e.g. every submodule reading
+		/// Me.PctHPs in the same pulse only costs one GetMember call. The cache is dropped after <see cref="MQ2Api.MQ2.DoCommand"/>
+		/// and spawn / ground item removals. Only read during initialization.
+		/// </summary>
+		public bool IsMemberCacheEnabled { get; set; }
 		public bool IsMQ2LoggingEnabled { get; set; }
+
+		/// <summary>
+		/// When true, and at least one pattern is registered through <see cref="MQ2Api.ChatUtilities.AddPattern"/>, chat lines that don't
+		/// match any pattern are dropped by the loader and never reach the OnChat* events. When false every line is forwarded as before and
+		/// matching lines just carry their pattern ids. Only read during initialization.
+		/// </summary>
+		public bool IsNativeChatFilterEnabled { get; set; }
+
+		/// <summary>
+		/// Members and TLOs whose value can change between two reads in the same pulse, e.g. Rand, which the member cache always
+		/// reads through. Matched case insensitively. Only read during initialization.
+		/// </summary>
+		public string[]? MemberCacheBypass { get; set; }
+
+		/// <summary>
+		/// Spawn fields the loader diffs once per pulse for <see cref="MQ2Api.MQ2SubmoduleEventRegistry.OnSpawnsChanged"/>, e.g.
+		/// "Position, HPPercent", see <see cref="MQ2Api.SpawnChangeFields"/>. None (the default) turns the change feed off. Only read
+		/// during initialization.
+		/// </summary>
+		/// <remarks>
+		/// A string rather than the enum since binding converts enums through TypeDescriptor, whose cache would keep a hot reloaded
+		/// copy of the core from ever being collected.
+		/// </remarks>
+		public string? SpawnChangeFeedFields { get; set; }
+
+		/// <summary>
+		/// Name of the shared memory region for <see cref="MQ2Api.MQ2StateBus"/>. Every client that uses the same name shares a bus,
+		/// null or empty (the default) leaves it closed. Only read during initialization.
+		/// </summary>
+		public string? StateBusName { get; set; }
+
+		internal MQ2Api.SpawnChangeFields GetSpawnChangeFeedFields()
+			=> Enum.TryParse<MQ2Api.SpawnChangeFields>(SpawnChangeFeedFields, true, out var spawnChangeFields)
+				? spawnChangeFields & MQ2Api.SpawnChangeFields.All
+				: MQ2Api.SpawnChangeFields.None;
 	}
 }
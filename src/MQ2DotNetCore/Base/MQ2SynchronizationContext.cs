@@ -1,6 +1,5 @@
 ﻿using System;
-using System.Collections.Concurrent;
-using System.Collections.Generic;
+using System.Diagnostics;
 using System.Threading;
 
 namespace MQ2DotNetCore.Base
@@ -9,15 +8,80 @@ namespace MQ2DotNetCore.Base
 	/// Per Alynel, the vast majority of EQ/MQ2 calls are not thread safe so we'll start most tasks using the task factory combined with this
 	/// synchronization context to ensure the task continuations run on the 'EQ' thread by default.
 	/// </summary>
+	/// <remarks>
+	/// Continuations are queued per <see cref="MQ2ContinuationLane"/>. The instance created with the constructor is the
+	/// <see cref="MQ2ContinuationLane.Command"/> lane, <see cref="ForLane"/> returns the instance for another lane that shares its queues.
+	/// Since an await resumes on the context it captured, continuations stay in the lane their task started in.
+	/// </remarks>
 	public class MQ2SynchronizationContext : SynchronizationContext
 	{
-		private readonly ConcurrentQueue<KeyValuePair<SendOrPostCallback, object?>> _continuationsQueue =
-			new ConcurrentQueue<KeyValuePair<SendOrPostCallback, object?>>();
+		private const int LaneCount = 2;
+
+		private readonly ContinuationQueues _queues;
+
+		public MQ2SynchronizationContext()
+		{
+			_queues = new ContinuationQueues();
+			_queues.Contexts[(int)MQ2ContinuationLane.Command] = this;
+			_queues.Contexts[(int)MQ2ContinuationLane.Background] = new MQ2SynchronizationContext(_queues, MQ2ContinuationLane.Background);
+			Lane = MQ2ContinuationLane.Command;
+		}
+
+		private MQ2SynchronizationContext(ContinuationQueues queues, MQ2ContinuationLane lane)
+		{
+			_queues = queues;
+			Lane = lane;
+		}
+
+		/// <summary>
+		/// The lane continuations posted to this instance are queued in
+		/// </summary>
+		public MQ2ContinuationLane Lane { get; }
+
+		/// <summary>
+		/// True if continuations are waiting for the next <see cref="DoEvents(bool)"/>
+		/// </summary>
+		public bool HasPendingContinuations => Volatile.Read(ref _queues.PendingCount) > 0;
+
+		/// <summary>
+		/// Continuations run by <see cref="DoEvents(bool, long, uint)"/> since the last <see cref="ResetStatistics"/>
+		/// </summary>
+		public long ExecutedContinuationCount => _queues.ExecutedCount;
+
+		/// <summary>
+		/// Continuations left queued for the next pulse because the pulse budget ran out, counted once per pulse they were left over in
+		/// </summary>
+		public long DeferredContinuationCount => _queues.DeferredCount;
+
+		/// <summary>
+		/// Pulses whose continuations were still running when the budget ran out
+		/// </summary>
+		public long BudgetOverrunCount => _queues.BudgetOverrunCount;
+
+		/// <summary>
+		/// The furthest past the budget a pulse's continuations ran
+		/// </summary>
+		public TimeSpan LongestBudgetOverrun => TimeSpan.FromTicks((long)(_queues.LongestOverrunTimestampTicks * ((double)TimeSpan.TicksPerSecond / Stopwatch.Frequency)));
+
+		/// <summary>
+		/// Returns the instance for the given lane, they all share the same queues
+		/// </summary>
+		public MQ2SynchronizationContext ForLane(MQ2ContinuationLane lane) => _queues.Contexts[(int)lane];
+
+		/// <inheritdoc />
+		public override SynchronizationContext CreateCopy() => this;
 
 		/// <inheritdoc />
 		public override void Post(SendOrPostCallback d, object? state)
 		{
-			_continuationsQueue.Enqueue(new KeyValuePair<SendOrPostCallback, object?>(d, state));
+			lock (_queues.Lock)
+			{
+				_queues.Lanes[(int)Lane].Enqueue(new Continuation(d, state));
+				++_queues.PendingCount;
+			}
+
+			// Continuations run during OnPulse, which the loader may have stopped forwarding
+			LoaderCallbackSubscriptions.RequestPulse();
 		}
 
 		/// <inheritdoc />
@@ -34,30 +98,97 @@ namespace MQ2DotNetCore.Base
 		/// </param>
 		public void DoEvents(bool setSyncContext)
 		{
-			void Action()
-			{
-				// Any continuations currently in the queue get removed and inserted into a list
-				var continuations = new List<KeyValuePair<SendOrPostCallback, object?>>();
-				while (_continuationsQueue.TryDequeue(out var continuation))
-				{
-					continuations.Add(continuation);
-				}
+			DoEvents(setSyncContext, 0, 0);
+		}
+
+		/// <summary>
+		/// Invoke the queued continuations, lane by lane, until the budget runs out. Whatever is left stays queued for the next call.
+		/// Continuations posted while this runs also wait for the next call.
+		/// </summary>
+		/// <param name="setSyncContext">
+		/// If true, continuations will be invoked on the synchronization context of their lane. If false, they will be invoked on SynchronizationContext.Current
+		/// </param>
+		/// <param name="frameStartTimestamp">When the pulse started, from <see cref="Stopwatch.GetTimestamp"/></param>
+		/// <param name="budgetMicroseconds">
+		/// How long after <paramref name="frameStartTimestamp"/> continuations may still be started, 0 for no limit. At least one continuation
+		/// always runs, so queued work makes progress even when the pulse is already over budget.
+		/// </param>
+		public void DoEvents(bool setSyncContext, long frameStartTimestamp, uint budgetMicroseconds)
+		{
+			var deadlineTimestamp = budgetMicroseconds > 0
+				? frameStartTimestamp + budgetMicroseconds * Stopwatch.Frequency / 1_000_000
+				: long.MaxValue;
 
-				// Now all the continuations in the list get executed
-				// Any further continuations posted as a result of one of the existing ones will go in the queue to get executed next iteration of the loop
-				foreach (var continuation in continuations)
+			Span<int> remainingCounts = stackalloc int[LaneCount];
+			lock (_queues.Lock)
+			{
+				for (var lane = 0; lane < LaneCount; ++lane)
 				{
-					continuation.Key(continuation.Value);
+					remainingCounts[lane] = _queues.Lanes[lane].Count;
 				}
 			}
 
-			if (setSyncContext)
+			var oldContext = Current;
+			var executedCount = 0;
+			try
 			{
-				SetExecuteAndRestore(Action);
+				for (var lane = 0; lane < LaneCount; ++lane)
+				{
+					if (setSyncContext)
+					{
+						SetSynchronizationContext(_queues.Contexts[lane]);
+					}
+
+					while (remainingCounts[lane] > 0)
+					{
+						if (executedCount > 0 && Stopwatch.GetTimestamp() >= deadlineTimestamp)
+						{
+							var deferredCount = 0;
+							foreach (var remainingCount in remainingCounts)
+							{
+								deferredCount += remainingCount;
+							}
+
+							_queues.DeferredCount += deferredCount;
+							return;
+						}
+
+						Continuation continuation;
+						lock (_queues.Lock)
+						{
+							// RemoveAllContinuations(..) may have emptied the lane
+							if (!_queues.Lanes[lane].TryDequeue(out continuation))
+							{
+								break;
+							}
+
+							--_queues.PendingCount;
+						}
+
+						--remainingCounts[lane];
+						++executedCount;
+						continuation.Callback(continuation.State);
+					}
+				}
 			}
-			else
+			finally
 			{
-				Action();
+				if (setSyncContext)
+				{
+					SetSynchronizationContext(oldContext);
+				}
+
+				_queues.ExecutedCount += executedCount;
+
+				if (budgetMicroseconds > 0 && executedCount > 0)
+				{
+					var overrunTicks = Stopwatch.GetTimestamp() - deadlineTimestamp;
+					if (overrunTicks > 0)
+					{
+						++_queues.BudgetOverrunCount;
+						_queues.LongestOverrunTimestampTicks = Math.Max(_queues.LongestOverrunTimestampTicks, overrunTicks);
+					}
+				}
 			}
 		}
 
@@ -107,15 +238,112 @@ namespace MQ2DotNetCore.Base
 		}
 
 		/// <summary>
-		/// Remove all queued continuations
+		/// Remove all queued continuations, from every lane
 		/// </summary>
 		/// <returns></returns>
 		public int RemoveAllContinuations()
 		{
-			var count = _continuationsQueue.Count;
-			_continuationsQueue.Clear();
+			lock (_queues.Lock)
+			{
+				var count = _queues.PendingCount;
+				foreach (var lane in _queues.Lanes)
+				{
+					lane.Clear();
+				}
+
+				_queues.PendingCount = 0;
+				return count;
+			}
+		}
+
+		/// <summary>
+		/// Zero the executed, deferred and overrun counters
+		/// </summary>
+		public void ResetStatistics()
+		{
+			_queues.ExecutedCount = 0;
+			_queues.DeferredCount = 0;
+			_queues.BudgetOverrunCount = 0;
+			_queues.LongestOverrunTimestampTicks = 0;
+		}
+
+		private readonly struct Continuation
+		{
+			public Continuation(SendOrPostCallback callback, object? state)
+			{
+				Callback = callback;
+				State = state;
+			}
+
+			public SendOrPostCallback Callback { get; }
+			public object? State { get; }
+		}
+
+		/// <summary>
+		/// Growable circular buffer, so steady state posting and running continuations doesn't allocate. Not thread safe.
+		/// </summary>
+		private sealed class ContinuationRing
+		{
+			private Continuation[] _items = new Continuation[64];
+			private int _head;
+
+			public int Count { get; private set; }
+
+			public void Enqueue(in Continuation continuation)
+			{
+				if (Count == _items.Length)
+				{
+					var items = new Continuation[_items.Length * 2];
+					for (var index = 0; index < Count; ++index)
+					{
+						items[index] = _items[(_head + index) & (_items.Length - 1)];
+					}
+
+					_items = items;
+					_head = 0;
+				}
+
+				_items[(_head + Count) & (_items.Length - 1)] = continuation;
+				++Count;
+			}
+
+			public bool TryDequeue(out Continuation continuation)
+			{
+				if (Count == 0)
+				{
+					continuation = default;
+					return false;
+				}
+
+				continuation = _items[_head];
+
+				// Don't keep the callback and its state alive
+				_items[_head] = default;
+				_head = (_head + 1) & (_items.Length - 1);
+				--Count;
+				return true;
+			}
+
+			public void Clear()
+			{
+				Array.Clear(_items, 0, _items.Length);
+				_head = 0;
+				Count = 0;
+			}
+		}
+
+		// Shared by the instances of every lane. The counters are only touched from the EQ thread.
+		private sealed class ContinuationQueues
+		{
+			public readonly MQ2SynchronizationContext[] Contexts = new MQ2SynchronizationContext[LaneCount];
+			public readonly ContinuationRing[] Lanes = { new ContinuationRing(), new ContinuationRing() };
+			public readonly object Lock = new object();
+			public int PendingCount;
 
-			return count;
+			public long BudgetOverrunCount;
+			public long DeferredCount;
+			public long ExecutedCount;
+			public long LongestOverrunTimestampTicks;
 		}
 	}
 }
@@ -0,0 +1,141 @@
+﻿using Microsoft.Extensions.Logging;
+using MQ2DotNetCore.Logging;
+using MQ2DotNetCore.MQ2Api;
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading;
+
+namespace MQ2DotNetCore.Base
+{
+	/// <summary>
+	/// Captures a <see cref="PulseSnapshot"/> at the start of each pulse and runs the OnPulseSnapshot handlers on the thread pool,
+	/// one work item per submodule. There's a single snapshot shared by every worker, so a pulse is only captured once every handler
+	/// has returned from the previous one, pulses in between are skipped. Dispatch is only called from the EQ thread.
+	/// </summary>
+	internal sealed class PulseSnapshotDispatcher
+	{
+		private readonly LatencyHistogram _captureTimings = new LatencyHistogram();
+		private readonly List<MQ2SubmoduleEventRegistry> _eventRegistries = new List<MQ2SubmoduleEventRegistry>();
+		private readonly ManualResetEventSlim _idleEvent = new ManualResetEventSlim(true);
+		private readonly ILogger? _logger;
+		private readonly SendOrPostCallback _logHandlerException;
+		private readonly PulseSnapshot _pulseSnapshot;
+		private readonly SynchronizationContext _resultSynchronizationContext;
+		private readonly Action<MQ2SubmoduleEventRegistry> _runHandlers;
+
+		private long _batchStartTimestamp;
+		private long _dispatchedCount;
+		private long _faultedCount;
+		private long _longestBatchTicks;
+		private int _runningCount;
+		private long _skippedCount;
+
+		internal PulseSnapshotDispatcher(ILogger? logger, SynchronizationContext resultSynchronizationContext)
+		{
+			_logger = logger;
+			_logHandlerException = LogHandlerException;
+			_pulseSnapshot = new PulseSnapshot(resultSynchronizationContext);
+			_resultSynchronizationContext = resultSynchronizationContext;
+			_runHandlers = RunHandlers;
+		}
+
+		internal bool HasDispatched => Interlocked.Read(ref _dispatchedCount) > 0 || Interlocked.Read(ref _skippedCount) > 0;
+
+		/// <summary>
+		/// True while handlers from the last captured pulse are still running
+		/// </summary>
+		internal bool IsBusy => Volatile.Read(ref _runningCount) != 0;
+
+		internal void Dispatch(SubmoduleRegistry submoduleRegistry)
+		{
+			if (!MQ2SubmoduleEventRegistry.HasAnyPulseSnapshotHandlers)
+			{
+				return;
+			}
+
+			if (IsBusy)
+			{
+				Interlocked.Increment(ref _skippedCount);
+				return;
+			}
+
+			submoduleRegistry.CollectPulseSnapshotSubscribers(_eventRegistries);
+			if (_eventRegistries.Count == 0)
+			{
+				return;
+			}
+
+			var startTimestamp = Stopwatch.GetTimestamp();
+			_pulseSnapshot.Capture();
+			_captureTimings.RecordTicks(Stopwatch.GetTimestamp() - startTimestamp);
+
+			_batchStartTimestamp = startTimestamp;
+			_idleEvent.Reset();
+			Volatile.Write(ref _runningCount, _eventRegistries.Count);
+			foreach (var eventRegistry in _eventRegistries)
+			{
+				ThreadPool.UnsafeQueueUserWorkItem(_runHandlers, eventRegistry, preferLocal: false);
+			}
+
+			_eventRegistries.Clear();
+			Interlocked.Increment(ref _dispatchedCount);
+		}
+
+		/// <summary>
+		/// Blocks until the running handlers have returned, e.g. before the submodules are unloaded
+		/// </summary>
+		/// <returns>false if they were still running when the timeout expired</returns>
+		internal bool WaitForHandlers(TimeSpan timeout)
+			=> _idleEvent.Wait(timeout);
+
+		internal string GetSummary()
+		{
+			var longestBatch = TimeSpan.FromSeconds((double)Interlocked.Read(ref _longestBatchTicks) / Stopwatch.Frequency);
+			return $"{Interlocked.Read(ref _dispatchedCount)} dispatched, {Interlocked.Read(ref _skippedCount)} skipped while handlers were busy, "
+				+ $"{Interlocked.Read(ref _faultedCount)} handler exceptions, longest batch {longestBatch.TotalMilliseconds:0.###} ms, "
+				+ $"capture {_captureTimings.GetSummary()}";
+		}
+
+		internal void ResetStatistics()
+		{
+			_captureTimings.Reset();
+			Interlocked.Exchange(ref _dispatchedCount, 0);
+			Interlocked.Exchange(ref _faultedCount, 0);
+			Interlocked.Exchange(ref _longestBatchTicks, 0);
+			Interlocked.Exchange(ref _skippedCount, 0);
+		}
+
+		private void RunHandlers(MQ2SubmoduleEventRegistry eventRegistry)
+		{
+			try
+			{
+				eventRegistry.NotifyPulseSnapshot(_pulseSnapshot);
+			}
+			catch (Exception exc)
+			{
+				Interlocked.Increment(ref _faultedCount);
+
+				// The loggers write to MQ2's chat, which is only safe on the EQ thread
+				_resultSynchronizationContext.Post(_logHandlerException, exc);
+			}
+			finally
+			{
+				// The last handler to return hands the snapshot back to the EQ thread
+				if (Interlocked.Decrement(ref _runningCount) == 0)
+				{
+					var elapsedTicks = Stopwatch.GetTimestamp() - _batchStartTimestamp;
+					if (elapsedTicks > Interlocked.Read(ref _longestBatchTicks))
+					{
+						Interlocked.Exchange(ref _longestBatchTicks, elapsedTicks);
+					}
+
+					_idleEvent.Set();
+				}
+			}
+		}
+
+		private void LogHandlerException(object? state)
+			=> _logger?.LogErrorPrefixed("An OnPulseSnapshot handler threw:\n", (Exception)state!);
+	}
+}
@@ -2,6 +2,7 @@
 using MQ2DotNetCore.Logging;
 using MQ2DotNetCore.MQ2Api;
 using System;
+using System.Collections.Generic;
 using System.Runtime.Loader;
 using System.Threading;
 using System.Threading.Tasks;
@@ -14,6 +15,7 @@ namespace MQ2DotNetCore.Base
 		private ILogger<SubmoduleProgramWrapper>? _logger;
 
 		public SubmoduleProgramWrapper(
+			string[] arguments,
 			AssemblyLoadContext assemblyLoadContext,
 			CancellationTokenSource cancellationTokenSource,
 			ILogger<SubmoduleProgramWrapper>? logger,
@@ -26,6 +28,7 @@ namespace MQ2DotNetCore.Base
 		{
 			_logger = logger;
 
+			Arguments = arguments;
 			AssemblyLoadContext = assemblyLoadContext;
 			CancellationTokenSource = cancellationTokenSource;
 			MQ2Dependencies = mq2Dependencies;
@@ -35,7 +38,16 @@ namespace MQ2DotNetCore.Base
 			Task = task;
 		}
 
+		/// <summary>
+		/// The /netcorerun arguments the program was started with, starting with its name
+		/// </summary>
+		public string[] Arguments { get; }
 		public AssemblyLoadContext AssemblyLoadContext { get; private set; }
+
+		/// <summary>
+		/// How long the submodule's handlers took, keyed by the loader callback that invoked them. Only touched from the EQ thread.
+		/// </summary>
+		public Dictionary<string, LatencyHistogram> CallbackTimings { get; } = new Dictionary<string, LatencyHistogram>();
 		public CancellationTokenSource CancellationTokenSource { get; private set; }
 		public bool HasCancelled { get; private set; }
 		public MQ2Dependencies MQ2Dependencies { get; private set; }
@@ -3,9 +3,12 @@ using MQ2DotNetCore.Logging;
 using MQ2DotNetCore.MQ2Api;
 using System;
 using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Diagnostics;
 using System.IO;
 using System.Linq;
 using System.Reflection;
+using System.Runtime.CompilerServices;
 using System.Runtime.ConstrainedExecution;
 using System.Threading;
 using System.Threading.Tasks;
@@ -58,7 +61,7 @@ namespace MQ2DotNetCore.Base
 			_isDisposed = true;
 		}
 
-		internal void ExecuteForEachSubmodule(Action<SubmoduleProgramWrapper> actionToInvoke)
+		internal void ExecuteForEachSubmodule(Action<SubmoduleProgramWrapper> actionToInvoke, string callbackName)
 		{
 			if (_isDisposed)
 			{
@@ -70,6 +73,12 @@ namespace MQ2DotNetCore.Base
 				throw new ArgumentNullException(nameof(actionToInvoke));
 			}
 
+			// Keys takes every lock in the dictionary, skip it for the common case of no programs running
+			if (_programsDictionary.IsEmpty)
+			{
+				return;
+			}
+
 			var submoduleNames = _programsDictionary.Keys.ToArray();
 			foreach (var submoduleName in submoduleNames)
 			{
@@ -82,7 +91,15 @@ namespace MQ2DotNetCore.Base
 						continue;
 					}
 
-					actionToInvoke.Invoke(submoduleWrapper);
+					var startTimestamp = Stopwatch.GetTimestamp();
+					try
+					{
+						actionToInvoke.Invoke(submoduleWrapper);
+					}
+					finally
+					{
+						RecordCallbackTiming(submoduleWrapper, callbackName, Stopwatch.GetTimestamp() - startTimestamp);
+					}
 				}
 				catch (Exception exc)
 				{
@@ -91,6 +108,92 @@ namespace MQ2DotNetCore.Base
 			}
 		}
 
+		internal void PrintCallbackTimings()
+		{
+			if (_isDisposed)
+			{
+				throw new ObjectDisposedException(nameof(SubmoduleRegistry));
+			}
+
+			foreach (var submoduleWrapper in _programsDictionary.Values)
+			{
+				foreach (var callbackTiming in submoduleWrapper.CallbackTimings.OrderBy(callbackTiming => callbackTiming.Key))
+				{
+					_mq2Instance.WriteChatSafe($"  {submoduleWrapper.Name} {callbackTiming.Key}: {callbackTiming.Value.GetSummary()}");
+				}
+			}
+		}
+
+		internal void ResetCallbackTimings()
+		{
+			if (_isDisposed)
+			{
+				throw new ObjectDisposedException(nameof(SubmoduleRegistry));
+			}
+
+			foreach (var submoduleWrapper in _programsDictionary.Values)
+			{
+				foreach (var latencyHistogram in submoduleWrapper.CallbackTimings.Values)
+				{
+					latencyHistogram.Reset();
+				}
+			}
+		}
+
+		// callbackName is the loader callback the handlers were invoked for, e.g. AddSpawn, so the v1 / v2 / batched paths of a
+		// callback are timed together
+		private static void RecordCallbackTiming(SubmoduleProgramWrapper submoduleWrapper, string callbackName, long elapsedTicks)
+		{
+			if (!submoduleWrapper.CallbackTimings.TryGetValue(callbackName, out var latencyHistogram))
+			{
+				latencyHistogram = new LatencyHistogram();
+				submoduleWrapper.CallbackTimings.Add(callbackName, latencyHistogram);
+			}
+
+			latencyHistogram.RecordTicks(elapsedTicks);
+		}
+
+		internal bool HasPrograms => !_programsDictionary.IsEmpty;
+
+		// Adds the event registry of every running submodule that has OnPulseSnapshot handlers, see PulseSnapshotDispatcher
+		internal void CollectPulseSnapshotSubscribers(List<MQ2SubmoduleEventRegistry> eventRegistries)
+		{
+			if (_isDisposed)
+			{
+				throw new ObjectDisposedException(nameof(SubmoduleRegistry));
+			}
+
+			foreach (var submoduleEntry in _programsDictionary)
+			{
+				try
+				{
+					var eventRegistry = submoduleEntry.Value.MQ2Dependencies?.GetEventRegistry();
+					if (eventRegistry?.HasPulseSnapshotHandlers == true)
+					{
+						eventRegistries.Add(eventRegistry);
+					}
+				}
+				catch (ObjectDisposedException)
+				{
+					// The submodule is being stopped, it gets no more events
+				}
+			}
+		}
+
+		// The arguments of every program that hasn't stopped, so they can be started again after a hot reload
+		internal string[][] GetRunningProgramArguments()
+		{
+			if (_isDisposed)
+			{
+				throw new ObjectDisposedException(nameof(SubmoduleRegistry));
+			}
+
+			return _programsDictionary.Values
+				.Where(submoduleProgramWrapper => !CleanupHelper.IsTaskStopped(submoduleProgramWrapper.Task))
+				.Select(submoduleProgramWrapper => submoduleProgramWrapper.Arguments)
+				.ToArray();
+		}
+
 		internal void PrintRunningPrograms()
 		{
 			if (_isDisposed)
@@ -312,6 +415,7 @@ namespace MQ2DotNetCore.Base
 					);
 
 					var wrapper = new SubmoduleProgramWrapper(
+						commandArguments,
 						assemblyLoadContext,
 						cancellationTokenSource,
 						_submoduleProgramWrapperLogger,
@@ -328,6 +432,9 @@ namespace MQ2DotNetCore.Base
 					}
 #pragma warning restore CA2000 // Dispose objects before losing scope
 
+					// Programs are checked for completion, and their continuations run, during OnPulse
+					LoaderCallbackSubscriptions.RequestPulse();
+
 					return true;
 				}
 			}
@@ -0,0 +1,127 @@
+﻿using MQ2DotNetCore.Base;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using System.Runtime.Loader;
+
+namespace MQ2DotNetCore
+{
+	/// <summary>
+	/// The loader's entry point when HotReload is enabled in MQ2DotNetCoreLoader.ini. This copy of MQ2DotNetCore stays loaded for
+	/// the life of the process and only hosts. The loader runs it from a copy of MQ2DotNetCore.dll made for this process, so the
+	/// deployed file isn't locked. It loads another copy from the deployed file into a <see cref="CoreAssemblyLoadContext"/> and runs
+	/// that copy's <see cref="LoaderEntryPoint.InitializePlugin(IntPtr, int)"/>, which binds the loader's callbacks as usual. On a
+	/// reload the loader shuts that copy down, calls <see cref="Unload(IntPtr, int)"/>, then <see cref="InitializePlugin(IntPtr, int)"/>
+	/// again.
+	/// </summary>
+	/// <remarks>
+	/// Nothing here may touch <see cref="LoaderEntryPoint"/> or the MQ2 API, their statics would belong to this copy and keep
+	/// running next to the hosted one. State handed from one copy to the next goes through <see cref="HotReloadState"/>.
+	/// </remarks>
+	public static class HotReloadHost
+	{
+		// Full collections to wait through for an unloaded context to be collected before counting it as leaked
+		private const int MaxCollectAttempts = 10;
+
+		private static CoreAssemblyLoadContext? _coreLoadContext;
+		private static readonly List<WeakReference> _unloadedContexts = new List<WeakReference>();
+
+		public static int InitializePlugin(IntPtr arg, int argLength)
+		{
+			try
+			{
+				if (_coreLoadContext != null)
+				{
+					UnloadCore();
+				}
+
+				HotReloadState.AssemblyPath = GetDeployedAssemblyPath();
+				HotReloadState.Generation += 1;
+
+				var returnCode = InitializeCore(HotReloadState.AssemblyPath, arg, argLength);
+				if (returnCode != 0)
+				{
+					UnloadCore();
+				}
+
+				return returnCode;
+			}
+			catch (Exception exc)
+			{
+				ConfigurationHelper.TryAppendException(exc);
+				UnloadCore();
+			}
+
+			return 1;
+		}
+
+		// This assembly was loaded from the loader's MQ2DotNetCore.HotReloadHost.<pid>.dll, the core is read from the
+		// MQ2DotNetCore.dll next to it
+		private static string GetDeployedAssemblyPath()
+		{
+			var hostAssembly = typeof(HotReloadHost).Assembly;
+			return Path.Combine(Path.GetDirectoryName(hostAssembly.Location)!, $"{hostAssembly.GetName().Name}.dll");
+		}
+
+		/// <summary>
+		/// Unloads the hosted copy and returns how many of the contexts unloaded so far are still alive after a few full collections,
+		/// or -1 if that couldn't be determined. Anything above 0 means something outside the context still references it.
+		/// </summary>
+		public static int Unload(IntPtr arg, int argLength)
+		{
+			try
+			{
+				UnloadCore();
+
+				for (var attempt = 0; attempt < MaxCollectAttempts && _unloadedContexts.Exists(context => context.IsAlive); ++attempt)
+				{
+					GC.Collect();
+					GC.WaitForPendingFinalizers();
+				}
+
+				_unloadedContexts.RemoveAll(context => !context.IsAlive);
+				return _unloadedContexts.Count;
+			}
+			catch (Exception exc)
+			{
+				ConfigurationHelper.TryAppendException(exc);
+			}
+
+			return -1;
+		}
+
+		// Not inlined so no reference to the hosted assembly or its types outlives the call on this thread's stack
+		[MethodImpl(MethodImplOptions.NoInlining)]
+		private static int InitializeCore(string assemblyPath, IntPtr arg, int argLength)
+		{
+			var hostLoadContext = AssemblyLoadContext.GetLoadContext(typeof(HotReloadHost).Assembly) ?? AssemblyLoadContext.Default;
+			_coreLoadContext = new CoreAssemblyLoadContext($"MQ2DotNetCore ({HotReloadState.Generation})", hostLoadContext);
+
+			var coreAssembly = _coreLoadContext.LoadCore(assemblyPath);
+			var initializePlugin = coreAssembly
+				.GetType(typeof(LoaderEntryPoint).FullName!, true)!
+				.GetMethod(nameof(LoaderEntryPoint.InitializePlugin), BindingFlags.Public | BindingFlags.Static);
+
+			if (initializePlugin == null)
+			{
+				throw new MissingMethodException(typeof(LoaderEntryPoint).FullName, nameof(LoaderEntryPoint.InitializePlugin));
+			}
+
+			return (int)initializePlugin.Invoke(null, new object[] { arg, argLength })!;
+		}
+
+		private static void UnloadCore()
+		{
+			if (_coreLoadContext == null)
+			{
+				return;
+			}
+
+			_unloadedContexts.Add(new WeakReference(_coreLoadContext));
+			_coreLoadContext.Unload();
+			_coreLoadContext = null;
+		}
+	}
+}
@@ -0,0 +1,21 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Counters for the loader's callback capture (Capture=1). Mirrors the CallbackCaptureStatistics struct in CallbackCapture.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct CallbackCaptureStatistics
+	{
+		public ulong RecordCount;
+		public ulong ByteCount;
+		public ulong DroppedCount;
+		public uint IsCapturing;
+		public uint Reserved;
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[RecordCount: {RecordCount}, ByteCount: {ByteCount}, DroppedCount: {DroppedCount}, IsCapturing: {IsCapturing != 0}]";
+	}
+}
@@ -0,0 +1,23 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Latency summary for one of the loader's PLUGIN_API forwarders, times are in nanoseconds. Mirrors the CallbackTimingSummary
+	/// struct in CallbackTimings.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct CallbackTimingSummary
+	{
+		public ulong Count;
+		public ulong TotalNanoseconds;
+		public ulong P50Nanoseconds;
+		public ulong P90Nanoseconds;
+		public ulong P99Nanoseconds;
+		public ulong MaxNanoseconds;
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[Count: {Count}, P50: {P50Nanoseconds / 1000.0:0.0} us, P90: {P90Nanoseconds / 1000.0:0.0} us, P99: {P99Nanoseconds / 1000.0:0.0} us, Max: {MaxNanoseconds / 1000.0:0.0} us, Total: {TotalNanoseconds / 1_000_000.0:0.0} ms]";
+	}
+}
@@ -0,0 +1,20 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Counters for the loader's chat pre-filter. Mirrors the ChatFilterStatistics struct in ChatFilter.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct ChatFilterStatistics
+	{
+		public ulong LinesScanned;
+		public ulong LinesMatched;
+		public uint PatternCount;
+		public uint NodeCount;
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[PatternCount: {PatternCount}, NodeCount: {NodeCount}, LinesScanned: {LinesScanned}, LinesMatched: {LinesMatched}]";
+	}
+}
@@ -0,0 +1,20 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Counters for the loader's expression plan cache. Mirrors the ExpressionPlanStatistics struct in ExpressionPlan.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct ExpressionPlanStatistics
+	{
+		public ulong EvaluationCount;
+		public ulong FallbackCount;
+		public uint PlanCount;
+		public uint CompileCount;
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[PlanCount: {PlanCount}, CompileCount: {CompileCount}, EvaluationCount: {EvaluationCount}, FallbackCount: {FallbackCount}]";
+	}
+}
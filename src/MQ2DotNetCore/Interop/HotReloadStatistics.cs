@@ -0,0 +1,23 @@
+﻿using MQ2DotNetCore.Base;
+using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Counters for reloading the core without restarting the client. Mirrors the HotReloadStatistics struct in HotReload.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct HotReloadStatistics
+	{
+		public uint IsEnabled;
+		public uint ReloadCount;
+		public uint FailedReloadCount;
+		public uint LeakedContextCount;
+		public ulong LastReloadNanoseconds;
+		public ulong LongestReloadNanoseconds;
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[Generation: {HotReloadState.Generation}, ReloadCount: {ReloadCount}, FailedReloadCount: {FailedReloadCount}, LeakedContextCount: {LeakedContextCount}, LastReload: {LastReloadNanoseconds / 1e6:0.0} ms, LongestReload: {LongestReloadNanoseconds / 1e6:0.0} ms]";
+	}
+}
@@ -0,0 +1,62 @@
+﻿using System;
+using System.Collections.Concurrent;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Ids for MQ2 type and member names from the loader's intern table. A name is passed to the loader the first time it's seen,
+	/// after that its id comes from a dictionary, and a type's MQ2Type* is read straight out of the loader's array. The loader
+	/// resolves the types again when plugins may have added or removed some, so the pointer is read from the array every time
+	/// rather than kept. Ids are the same for the life of the process, including across hot reloads. An id of 0 means the
+	/// loader's table was full, callers then fall back to passing the name.
+	/// </summary>
+	internal static unsafe class InternTable
+	{
+		private static readonly object _lock = new object();
+		private static readonly ConcurrentDictionary<string, uint> _memberIds = new ConcurrentDictionary<string, uint>(StringComparer.Ordinal);
+		private static readonly ConcurrentDictionary<string, uint> _typeIds = new ConcurrentDictionary<string, uint>(StringComparer.Ordinal);
+		private static readonly IntPtr* _types = (IntPtr*)MQ2DotNetCoreLoader.NativeMethods.InternTable__GetTypes(out _);
+
+		/// <summary>
+		/// The MQ2Type* for the type name, <see cref="IntPtr.Zero"/> if MQ2 has no such type
+		/// </summary>
+		internal static IntPtr FindType(string typeName)
+		{
+			if (_typeIds.TryGetValue(typeName, out var typeId))
+			{
+				if (typeId == 0)
+				{
+					return MQ2Main.NativeMethods.FindMQ2DataType(typeName);
+				}
+
+				var pType = _types[typeId];
+				if (pType != IntPtr.Zero)
+				{
+					return pType;
+				}
+			}
+
+			// New, or it didn't resolve last time, interning it again resolves it again
+			lock (_lock)
+			{
+				typeId = MQ2DotNetCoreLoader.NativeMethods.InternTable__InternType(typeName);
+				_typeIds[typeName] = typeId;
+			}
+
+			return typeId == 0 ? MQ2Main.NativeMethods.FindMQ2DataType(typeName) : _types[typeId];
+		}
+
+		internal static uint GetMemberId(string memberName)
+		{
+			if (_memberIds.TryGetValue(memberName, out var memberId))
+			{
+				return memberId;
+			}
+
+			lock (_lock)
+			{
+				return _memberIds.GetOrAdd(memberName, name => MQ2DotNetCoreLoader.NativeMethods.InternTable__InternMember(name));
+			}
+		}
+	}
+}
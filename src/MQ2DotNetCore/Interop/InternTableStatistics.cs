@@ -0,0 +1,20 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Counters for the loader's type and member name ids. Mirrors the InternTableStatistics struct in InternTable.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct InternTableStatistics
+	{
+		public uint TypeCount;
+		public uint UnresolvedTypeCount;
+		public uint MemberCount;
+		public uint OverflowCount;
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[TypeCount: {TypeCount}, UnresolvedTypeCount: {UnresolvedTypeCount}, MemberCount: {MemberCount}, OverflowCount: {OverflowCount}]";
+	}
+}
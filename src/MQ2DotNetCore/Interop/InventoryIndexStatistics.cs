@@ -0,0 +1,21 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Counters for the loader's inventory index. Mirrors the InventoryIndexStatistics struct in InventoryIndex.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct InventoryIndexStatistics
+	{
+		public uint SlotCount;
+		public uint ItemCount;
+		public ulong CheckCount;
+		public ulong RebuildCount;
+		public ulong QueryCount;
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[SlotCount: {SlotCount}, ItemCount: {ItemCount}, CheckCount: {CheckCount}, RebuildCount: {RebuildCount}, QueryCount: {QueryCount}]";
+	}
+}
@@ -10,9 +10,6 @@ namespace MQ2DotNetCore.Interop
 
 		internal static class NativeMethods
 		{
-			[DllImport(Kernel32.DLL, ExactSpelling = true, SetLastError = true)]
-			internal static extern bool FreeLibrary(IntPtr moduleHandle);
-
 			/// <summary>
 			/// Native method for reading values from .INI files. Why not use a managed method or stop using INI files all together?
 			/// </summary>
@@ -20,13 +17,6 @@ namespace MQ2DotNetCore.Interop
 			public static extern uint GetPrivateProfileString(string section, string key, string defaultValue, StringBuilder returnValue, int size, string filePath);
 
 
-			[DllImport(Kernel32.DLL)]
-			public static extern IntPtr GetProcAddress(SafeLibraryHandle libraryHandle, string processName);
-
-
-			[DllImport(Kernel32.DLL)]
-			public static extern SafeLibraryHandle LoadLibrary(string libraryName);
-
 			/// <summary>
 			/// Native method for writing values to .INI files. Why not use a managed method or stop using INI files all together?
 			/// </summary>
@@ -0,0 +1,24 @@
+﻿namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// The PLUGIN_API forwarders timed by the loader. Mirrors the LoaderCallback enum in CallbackTimings.h
+	/// </summary>
+	internal enum LoaderCallback : uint
+	{
+		Pulse = 0,
+		DrawHUD,
+		WriteChatColor,
+		IncomingChat,
+		AddSpawn,
+		RemoveSpawn,
+		AddGroundItem,
+		RemoveGroundItem,
+		BeginZone,
+		EndZone,
+		Zoned,
+		ReloadUI,
+		CleanUI,
+		SetGameState,
+		Count
+	}
+}
@@ -0,0 +1,27 @@
+﻿using System;
+using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// A single batched spawn, ground item, or zone event drained from the loader's event ring. Mirrors the LoaderEvent struct in LoaderEventRing.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct LoaderEvent
+	{
+		public uint Sequence;
+		public LoaderEventType EventType;
+		public IntPtr Pointer;
+
+		/// <summary>
+		/// The SpawnID / DropID captured when the event was queued
+		/// </summary>
+		public uint Id;
+
+		/// <summary>
+		/// The spawn's handle for spawn events, 0 otherwise and for spawns the handle table had no room for. It no longer resolves
+		/// if the client zoned before the batch was drained.
+		/// </summary>
+		public ulong Handle;
+	}
+}
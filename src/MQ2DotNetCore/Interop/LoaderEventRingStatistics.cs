@@ -0,0 +1,21 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Counters for the loader's event ring. Mirrors the LoaderEventRingStatistics struct in LoaderEventRing.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct LoaderEventRingStatistics
+	{
+		public ulong TotalEnqueued;
+		public uint Capacity;
+		public uint Count;
+		public uint HighWaterMark;
+		public uint OverflowCount;
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[Capacity: {Capacity}, Count: {Count}, HighWaterMark: {HighWaterMark}, OverflowCount: {OverflowCount}, TotalEnqueued: {TotalEnqueued}]";
+	}
+}
@@ -0,0 +1,17 @@
+﻿namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Event types that the loader can batch in its event ring. Mirrors the LoaderEventType enum in LoaderEventRing.h
+	/// </summary>
+	internal enum LoaderEventType : uint
+	{
+		None = 0,
+		AddSpawn = 1,
+		RemoveSpawn = 2,
+		AddGroundItem = 3,
+		RemoveGroundItem = 4,
+		BeginZone = 5,
+		EndZone = 6,
+		Zoned = 7
+	}
+}
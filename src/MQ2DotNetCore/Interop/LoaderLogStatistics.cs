@@ -0,0 +1,21 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Counters for the loader's log ring. Mirrors the LoaderLogStatistics struct in LoaderLog.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct LoaderLogStatistics
+	{
+		public ulong WrittenCount;
+		public ulong DroppedCount;
+		public ulong TruncatedCount;
+		public uint Capacity;
+		public uint HighWaterMark;
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[Capacity: {Capacity} slots, HighWaterMark: {HighWaterMark} slots, WrittenCount: {WrittenCount}, DroppedCount: {DroppedCount}, TruncatedCount: {TruncatedCount}]";
+	}
+}
@@ -1,4 +1,5 @@
 ﻿using MQ2DotNetCore.Base;
+using MQ2DotNetCore.MQ2Api;
 using System;
 using System.IO;
 using System.Runtime.InteropServices;
@@ -8,9 +9,15 @@ namespace MQ2DotNetCore.Interop
 {
 	internal static class MQ2DotNetCoreLoader
 	{
-		public static readonly string AbsoluteDllPath = Path.GetFullPath(Path.Combine(MQ2DotNetCoreAssemblyInformation.AssemblyDirectory, @"..\MQ2DotNetCoreLoader.dll"));
+		public static readonly string AbsoluteDllPath = Path.GetFullPath(Path.Combine(MQ2DotNetCoreAssemblyInformation.AssemblyDirectory, "..", DllName));
 		public const string DllName = "MQ2DotNetCoreLoader.dll";
-		public const string RelativeDllpath = @"..\MQ2DotNetCoreLoader.dll";
+		public static readonly string RelativeDllpath = Path.Combine("..", DllName);
+
+		// Bit in the flags written by the *Utf8 string functions, mirrors TextResultTruncated in TextEncoding.h
+		public const uint TextResultTruncated = 0x1;
+
+		// Newest callback ABI the managed side binds, the loader may select an older one (see LoaderAbiVersion in MQ2DotNetCoreLoader.cpp)
+		public const uint CallbackAbiVersion = 2;
 
 		internal static class NativeMethods
 		{
@@ -32,6 +39,285 @@ namespace MQ2DotNetCore.Interop
 
 			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
 			public static extern bool MQ2Type__ToString(IntPtr pThis, MQ2VarPtr varPtr, [MarshalAs(UnmanagedType.LPStr)] StringBuilder destination);
+
+			// Blittable versions (ABI v2), strings are UTF-8 pointer + length and the results 0 / 1 so nothing needs marshaling
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern int MQ2Type__FromStringUtf8(IntPtr pThis, out MQ2VarPtr varPtr, ref byte source, uint sourceLength);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern int MQ2Type__GetMemberById(IntPtr pThis, MQ2VarPtr varPtr, uint memberId, ref byte index, uint indexLength, out MQ2TypeVar dest);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern int MQ2Type__GetMemberUtf8(IntPtr pThis, MQ2VarPtr varPtr, ref byte member, uint memberLength, ref byte index, uint indexLength, out MQ2TypeVar dest);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern int MQ2Type__ToStringUtf8(IntPtr pThis, MQ2VarPtr varPtr, ref byte destination, uint capacity, out uint flags);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern IntPtr MQ2Type__ToStringArena(IntPtr pThis, MQ2VarPtr varPtr, out uint length);
+
+
+			// Async boot, the warm-up covers the first pulses after the managed side was loaded or hot reloaded
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void AsyncBoot__GetWarmupSummary(out WarmupSummary summary);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			[return: MarshalAs(UnmanagedType.I1)]
+			public static extern bool AsyncBoot__IsPreWarmEnabled();
+
+
+			// Callback capture, only capturing with Capture=1 in MQ2DotNetCoreLoader.ini
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void CallbackCapture__GetStatistics(out CallbackCaptureStatistics statistics);
+
+			// Callback subscriptions, the loader only forwards the callbacks whose bit is set in the mask
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint CallbackSubscriptions__GetMask(out uint version);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern ulong CallbackSubscriptions__GetSkippedCount(LoaderCallback callback);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint CallbackSubscriptions__SetMask(uint mask);
+
+			// Callback timings, latency histograms for every PLUGIN_API forwarder
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			[return: MarshalAs(UnmanagedType.I1)]
+			public static extern bool CallbackTimings__GetSummary(LoaderCallback callback, out CallbackTimingSummary summary);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void CallbackTimings__Reset();
+
+			// Chat pre-filter, lines that don't match a registered pattern can be dropped before they cross into the managed side
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern int ChatFilter__AddPattern([MarshalAs(UnmanagedType.LPStr)] string pattern, uint sourceMask, uint color, uint filterMask);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void ChatFilter__GetStatistics(out ChatFilterStatistics statistics);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			[return: MarshalAs(UnmanagedType.I1)]
+			public static extern bool ChatFilter__RemovePattern(int id);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void ChatFilter__SetPassthrough([MarshalAs(UnmanagedType.I1)] bool isPassthrough);
+
+
+			// Expression plans, macro expressions compiled once by the loader and evaluated by handle
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			[return: MarshalAs(UnmanagedType.I1)]
+			public static extern bool ExpressionPlan__Calculate(int handle, out double result);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern int ExpressionPlan__Compile([MarshalAs(UnmanagedType.LPUTF8Str)] string expression);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			[return: MarshalAs(UnmanagedType.I1)]
+			public static extern bool ExpressionPlan__Evaluate(int handle, [Out] byte[] destination, uint capacity, out uint length);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void ExpressionPlan__GetStatistics(out ExpressionPlanStatistics statistics);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void ExpressionPlan__Invalidate();
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			[return: MarshalAs(UnmanagedType.I1)]
+			public static extern bool ExpressionPlan__Release(int handle);
+
+
+			// Inventory index, the first lookup of a pulse checks it against the character's items and rebuilds it if they changed
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint InventoryIndex__FindById(uint itemId, InventoryQueryFilter containerMask, [Out] InventorySlot[]? slots, uint capacity, out ulong totalCount);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint InventoryIndex__FindByName(ref byte name, uint nameLength, [MarshalAs(UnmanagedType.I1)] bool isExact, InventoryQueryFilter containerMask, [Out] InventorySlot[]? slots, uint capacity, out ulong totalCount);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void InventoryIndex__GetStatistics(out InventoryIndexStatistics statistics);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void InventoryIndex__Invalidate();
+
+
+			// Intern table, type and member names get ids once so reads pass ids instead of strings
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void InternTable__GetStatistics(out InternTableStatistics statistics);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern IntPtr InternTable__GetTypes(out uint count);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint InternTable__InternMember([MarshalAs(UnmanagedType.LPStr)] string name);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint InternTable__InternType([MarshalAs(UnmanagedType.LPStr)] string name);
+
+
+			// Loader callback ABI, the managed side binds the callbacks of every version it knows and then selects the newest one
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint LoaderAbi__GetVersion();
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint LoaderAbi__SelectVersion(uint version);
+
+			// Loader event ring, used when spawn/ground item/zone events are batched and drained once per pulse
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint LoaderEventRing__Drain([Out] LoaderEvent[] destination, uint destinationCapacity);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void LoaderEventRing__GetStatistics(out LoaderEventRingStatistics statistics);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void LoaderEventRing__SetEnabled([MarshalAs(UnmanagedType.I1)] bool isEnabled);
+
+
+			// Loader hot reload, only does anything with HotReload=1 in MQ2DotNetCoreLoader.ini
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void LoaderHotReload__GetStatistics(out HotReloadStatistics statistics);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			[return: MarshalAs(UnmanagedType.I1)]
+			public static extern bool LoaderHotReload__IsReloading();
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			[return: MarshalAs(UnmanagedType.I1)]
+			public static extern bool LoaderHotReload__Request();
+
+
+			// Loader log, records are queued in a ring and written to debug_plugin.log by the loader's writer thread
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void LoaderLog__GetStatistics(out LoaderLogStatistics statistics);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			[return: MarshalAs(UnmanagedType.I1)]
+			public static extern bool LoaderLog__Write(uint level, byte[] category, uint categoryLength, byte[] message, uint messageLength);
+
+
+			// Member batch, walks many GetMember chains in one call
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint MemberBatch__Evaluate(
+				[In] MemberBatchPath[] paths,
+				uint pathCount,
+				[In] MemberBatchStep[] steps,
+				uint stepCount,
+				[In] byte[] strings,
+				uint stringsSize,
+				[Out] MemberBatchResult[] results,
+				[Out] byte[] text,
+				uint textCapacity,
+				out uint textSize
+			);
+
+			// Member cache, memoizes TLO and member reads for the rest of the pulse
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void MemberCache__AddBypass([MarshalAs(UnmanagedType.LPStr)] string member);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void MemberCache__ClearBypass();
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void MemberCache__GetStatistics(out MemberCacheStatistics statistics);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void MemberCache__Invalidate();
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void MemberCache__ResetStatistics();
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void MemberCache__SetEnabled([MarshalAs(UnmanagedType.I1)] bool isEnabled);
+
+			// TLO lookup through the member cache, and macro parsing into UTF-8 (either a caller provided buffer or the pulse arena)
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			[return: MarshalAs(UnmanagedType.I1)]
+			public static extern bool MQ2Main__GetTopLevelObject([MarshalAs(UnmanagedType.LPStr)] string name, [MarshalAs(UnmanagedType.LPStr)] string index, out MQ2TypeVar dest);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern int MQ2Main__GetTopLevelObjectUtf8(ref byte name, uint nameLength, ref byte index, uint indexLength, out MQ2TypeVar dest);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern int MQ2Main__ParseMacroDataUtf8(ref byte expression, ref byte destination, uint capacity, out uint flags);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern IntPtr MQ2Main__ParseMacroDataArena(ref byte expression, out uint length);
+
+			// Pulse arena, the loader's per pulse scratch memory for strings handed out by the *Arena functions
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint PulseArena__GetHighWaterMark();
+
+			// Shared state bus, state and messages shared with the other clients on this machine through a shared memory region
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void SharedStateBus__Close();
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			[return: MarshalAs(UnmanagedType.I1)]
+			public static extern bool SharedStateBus__GetInstance(uint instanceIndex, out StateBusInstance info);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void SharedStateBus__GetStatistics(out SharedStateBusStatistics statistics);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			[return: MarshalAs(UnmanagedType.I1)]
+			public static extern bool SharedStateBus__Open(string name, string instanceName);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			[return: MarshalAs(UnmanagedType.I1)]
+			public static extern bool SharedStateBus__Publish(IntPtr pState, uint size);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern int SharedStateBus__ReadState(uint instanceIndex, IntPtr pDestination, uint capacity);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint SharedStateBus__Receive([Out] StateBusMessage[] messages, uint capacity);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			[return: MarshalAs(UnmanagedType.I1)]
+			public static extern bool SharedStateBus__Send(int targetIndex, uint messageType, IntPtr pPayload, uint size);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void SharedStateBus__SetInstanceName(string instanceName);
+
+
+			// Spawn change feed, the loader diffs the tracked fields of every spawn once per pulse
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint SpawnChangeFeed__Drain([Out] SpawnChange[] destination, uint destinationCapacity);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void SpawnChangeFeed__SetFields(SpawnChangeFields trackedFields);
+
+
+			// Spawn handle table, the loader's generation checked handles for the spawns in the zone
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern ulong SpawnHandleTable__Find(IntPtr spawn);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern IntPtr SpawnHandleTable__GetSlots(out uint capacity);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void SpawnHandleTable__GetStatistics(out SpawnHandleTableStatistics statistics);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint SpawnHandleTable__GetUsedSlotCount();
+
+
+			// Spawn snapshot, copies the whole spawn list into a structure of arrays buffer in one call
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint SpawnSnapshot__CapturePulse([In, Out] byte[] buffer, uint bufferSize, uint capacity, out uint totalCount, out PulseSnapshotFocus focus);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern void SpawnSnapshot__GetLayout(uint capacity, out SpawnSnapshotLayout layout);
+
+
+			// Spawn spatial index, maintained by the loader from OnAddSpawn / OnRemoveSpawn with positions refreshed once per pulse
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint SpawnSpatialIndex__QueryBox(float minX, float minY, float maxX, float maxY, SpawnQueryFilter typeMask, [Out] SpawnQueryResult[] results, uint capacity);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint SpawnSpatialIndex__QueryNearest(float x, float y, uint k, float maxRadius, SpawnQueryFilter typeMask, [Out] SpawnQueryResult[] results);
+
+			[DllImport(MQ2DotNetCoreLoader.DllName, CallingConvention = CallingConvention.Cdecl)]
+			public static extern uint SpawnSpatialIndex__QueryRadius(float x, float y, float radius, SpawnQueryFilter typeMask, [Out] SpawnQueryResult[] results, uint capacity);
 		}
 	}
 }
@@ -1,4 +1,5 @@
 ﻿using System;
+using System.Buffers;
 using System.Runtime.InteropServices;
 using System.Text;
 
@@ -22,28 +23,154 @@ namespace MQ2DotNetCore.Interop
 				throw new InvalidOperationException();
 			}
 
-			var wasGetMemberSuccessful = MQ2DotNetCoreLoader.NativeMethods.MQ2Type__GetMember(
+			var maxEncodedLength = Encoding.UTF8.GetMaxByteCount(memberName.Length + index.Length);
+			var rentedBuffer = maxEncodedLength > MaxStackEncodedLength ? ArrayPool<byte>.Shared.Rent(maxEncodedLength) : null;
+			Span<byte> buffer = rentedBuffer != null ? rentedBuffer : stackalloc byte[MaxStackEncodedLength];
+			try
+			{
+				var memberLength = Encoding.UTF8.GetBytes(memberName, buffer);
+				var indexLength = Encoding.UTF8.GetBytes(index, buffer.Slice(memberLength));
+
+				var wasGetMemberSuccessful = MQ2DotNetCoreLoader.NativeMethods.MQ2Type__GetMemberUtf8(
+					pType,
+					VarPtr,
+					ref buffer[0],
+					(uint)memberLength,
+					ref buffer[memberLength],
+					(uint)indexLength,
+					out result
+				);
+
+				return wasGetMemberSuccessful != 0 && result.pType != IntPtr.Zero;
+			}
+			finally
+			{
+				if (rentedBuffer != null)
+				{
+					ArrayPool<byte>.Shared.Return(rentedBuffer);
+				}
+			}
+		}
+
+		internal bool TryGetMember(uint memberId, string index, out MQ2TypeVar result)
+		{
+			if (pType == IntPtr.Zero)
+			{
+				throw new InvalidOperationException();
+			}
+
+			var maxEncodedLength = Encoding.UTF8.GetMaxByteCount(index.Length);
+			var rentedBuffer = maxEncodedLength > MaxStackEncodedLength ? ArrayPool<byte>.Shared.Rent(maxEncodedLength) : null;
+			Span<byte> buffer = rentedBuffer != null ? rentedBuffer : stackalloc byte[MaxStackEncodedLength];
+			try
+			{
+				var indexLength = Encoding.UTF8.GetBytes(index, buffer);
+
+				var wasGetMemberSuccessful = MQ2DotNetCoreLoader.NativeMethods.MQ2Type__GetMemberById(
+					pType,
+					VarPtr,
+					memberId,
+					ref buffer[0],
+					(uint)indexLength,
+					out result
+				);
+
+				return wasGetMemberSuccessful != 0 && result.pType != IntPtr.Zero;
+			}
+			finally
+			{
+				if (rentedBuffer != null)
+				{
+					ArrayPool<byte>.Shared.Return(rentedBuffer);
+				}
+			}
+		}
+
+		internal static bool TryGetTopLevelObject(string name, string index, out MQ2TypeVar result)
+		{
+			var maxEncodedLength = Encoding.UTF8.GetMaxByteCount(name.Length + index.Length);
+			var rentedBuffer = maxEncodedLength > MaxStackEncodedLength ? ArrayPool<byte>.Shared.Rent(maxEncodedLength) : null;
+			Span<byte> buffer = rentedBuffer != null ? rentedBuffer : stackalloc byte[MaxStackEncodedLength];
+			try
+			{
+				var nameLength = Encoding.UTF8.GetBytes(name, buffer);
+				var indexLength = Encoding.UTF8.GetBytes(index, buffer.Slice(nameLength));
+
+				var wasFound = MQ2DotNetCoreLoader.NativeMethods.MQ2Main__GetTopLevelObjectUtf8(
+					ref buffer[0],
+					(uint)nameLength,
+					ref buffer[nameLength],
+					(uint)indexLength,
+					out result
+				);
+
+				return wasFound != 0;
+			}
+			finally
+			{
+				if (rentedBuffer != null)
+				{
+					ArrayPool<byte>.Shared.Return(rentedBuffer);
+				}
+			}
+		}
+
+		// Names and indexes are encoded on the stack when they fit, GetMaxByteCount always leaves room past the name so the index's
+		// ref is in bounds even when it's empty
+		private const int MaxStackEncodedLength = 512;
+
+		/// <summary>
+		/// Writes the variable's text, as UTF-8, into <paramref name="destination"/>
+		/// </summary>
+		/// <param name="destination">Buffer to write to, the text is null terminated if it fits</param>
+		/// <param name="isTruncated">Set if the text didn't fit, the buffer then holds as many whole characters as fit</param>
+		/// <returns>The full length of the text in bytes, excluding the terminator</returns>
+		internal int ToUtf8(Span<byte> destination, out bool isTruncated)
+		{
+			var length = MQ2DotNetCoreLoader.NativeMethods.MQ2Type__ToStringUtf8(
 				pType,
 				VarPtr,
-				memberName,
-				index,
-				out result
+				ref MemoryMarshal.GetReference(destination),
+				(uint)destination.Length,
+				out var flags
 			);
 
+			if (length < 0)
+			{
+				throw new ApplicationException("MQ2Type::ToString failed");
+			}
+
+			isTruncated = (flags & MQ2DotNetCoreLoader.TextResultTruncated) != 0;
+			return length;
+		}
 
-			return wasGetMemberSuccessful && result.pType != IntPtr.Zero;
+		/// <summary>
+		/// Gets the variable's text, as UTF-8, without allocating. The span points into the loader's pulse arena and is only valid
+		/// until the start of the next pulse.
+		/// </summary>
+		/// <returns>The text, excluding the terminator, or an empty span if ToString failed or the arena is full</returns>
+		internal unsafe ReadOnlySpan<byte> ToUtf8Span()
+		{
+			var pText = MQ2DotNetCoreLoader.NativeMethods.MQ2Type__ToStringArena(pType, VarPtr, out var length);
+			return pText == IntPtr.Zero
+				? ReadOnlySpan<byte>.Empty
+				: new ReadOnlySpan<byte>(pText.ToPointer(), (int)length);
 		}
 
 		/// <inheritdoc />
 		public override string ToString()
 		{
-			var resultStringBuilder = new StringBuilder(2048);
-			if (!MQ2DotNetCoreLoader.NativeMethods.MQ2Type__ToString(pType, VarPtr, resultStringBuilder))
+			var pText = MQ2DotNetCoreLoader.NativeMethods.MQ2Type__ToStringArena(pType, VarPtr, out var length);
+			if (pText != IntPtr.Zero)
 			{
-				throw new ApplicationException("MQ2Type::ToString failed");
+				return length == 0 ? string.Empty : Marshal.PtrToStringUTF8(pText, (int)length);
 			}
 
-			return resultStringBuilder.ToString();
+			// The arena is full (or ToString failed), fall back to a stack buffer. MQ2 strings are at most MAX_STRING (2048)
+			// characters, which can be up to 3 bytes each in UTF-8.
+			Span<byte> buffer = stackalloc byte[2048 * 3];
+			var textLength = ToUtf8(buffer, out _);
+			return Encoding.UTF8.GetString(buffer.Slice(0, Math.Min(textLength, buffer.Length)));
 		}
 	}
 }
@@ -0,0 +1,22 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// One member chain of a <see cref="MQ2Api.MemberBatch"/>. Mirrors the MemberBatchPath struct in MemberBatch.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct MemberBatchPath
+	{
+		public const uint NoString = uint.MaxValue;
+
+		/// <summary>
+		/// Starting variable, only used when <see cref="RootNameOffset"/> is <see cref="NoString"/>
+		/// </summary>
+		public MQ2TypeVar Root;
+		public uint RootNameOffset;
+		public uint RootIndexOffset;
+		public uint FirstStep;
+		public uint StepCount;
+	}
+}
@@ -0,0 +1,19 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// The final value of a <see cref="MemberBatchPath"/>. Mirrors the MemberBatchResult struct in MemberBatch.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct MemberBatchResult
+	{
+		public MQ2TypeVar Value;
+		public uint IsSuccess;
+
+		/// <summary>
+		/// Offset of the copied string in the batch's text buffer, or <see cref="MemberBatchPath.NoString"/>
+		/// </summary>
+		public uint TextOffset;
+	}
+}
@@ -0,0 +1,15 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// A single GetMember call of a <see cref="MemberBatchPath"/>, as offsets into the batch's string table. Mirrors the
+	/// MemberBatchStep struct in MemberBatch.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct MemberBatchStep
+	{
+		public uint MemberOffset;
+		public uint IndexOffset;
+	}
+}
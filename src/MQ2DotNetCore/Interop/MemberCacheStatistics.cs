@@ -0,0 +1,25 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Counters for the loader's per pulse member cache. Mirrors the MemberCacheStatistics struct in MemberCache.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct MemberCacheStatistics
+	{
+		public ulong Hits;
+		public ulong Misses;
+		public ulong Bypassed;
+		public uint EntryCount;
+		public uint BypassedMemberCount;
+
+		/// <inheritdoc />
+		public override string ToString()
+		{
+			var lookupCount = Hits + Misses;
+			var hitRate = lookupCount == 0 ? 0.0 : 100.0 * Hits / lookupCount;
+			return $"[Hits: {Hits}, Misses: {Misses}, HitRate: {hitRate:0.0}%, Bypassed: {Bypassed}, EntryCount: {EntryCount}, BypassedMemberCount: {BypassedMemberCount}]";
+		}
+	}
+}
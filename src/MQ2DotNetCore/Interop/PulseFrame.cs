@@ -0,0 +1,23 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// The loader's exported g_pulseFrame, rewritten at the start of every OnPulse. Mirrors the PulseFrame struct in MQ2DotNetCoreLoader.cpp
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct PulseFrame
+	{
+		/// <summary>
+		/// When the pulse started, comparable with <see cref="System.Diagnostics.Stopwatch.GetTimestamp"/>
+		/// </summary>
+		public long StartTimestamp;
+
+		/// <summary>
+		/// How long continuations may run for during the pulse, 0 for no limit
+		/// </summary>
+		public uint BudgetMicroseconds;
+
+		public uint Reserved;
+	}
+}
@@ -0,0 +1,16 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Where the character and their target are in a pulse snapshot. Mirrors the PulseSnapshotFocus struct in SpawnSnapshot.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct PulseSnapshotFocus
+	{
+		public uint CharacterSpawnId;
+		public uint TargetSpawnId;
+		public int CharacterIndex;
+		public int TargetIndex;
+	}
+}
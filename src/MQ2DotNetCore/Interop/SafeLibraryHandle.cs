@@ -1,14 +1,36 @@
 ﻿using Microsoft.Win32.SafeHandles;
+using System;
+using System.Runtime.InteropServices;
 
 namespace MQ2DotNetCore.Interop
 {
+	/// <summary>
+	/// Handle to a native library loaded through <see cref="NativeLibrary"/>, so it works the same on Windows and on the
+	/// portable (Linux) build of the loader.
+	/// </summary>
 	internal sealed class SafeLibraryHandle : SafeHandleZeroOrMinusOneIsInvalid
 	{
 		internal SafeLibraryHandle() : base(true) { }
 
+		/// <summary>
+		/// Loads the library, or gets another reference to it if it's already loaded (e.g. MQ2Main.dll). Throws if it can't be loaded.
+		/// </summary>
+		internal static SafeLibraryHandle Load(string libraryPath)
+		{
+			var libraryHandle = new SafeLibraryHandle();
+			libraryHandle.SetHandle(NativeLibrary.Load(libraryPath));
+			return libraryHandle;
+		}
+
+		/// <summary>
+		/// Address of an exported function or variable. Throws if the library doesn't export it.
+		/// </summary>
+		internal IntPtr GetExport(string name) => NativeLibrary.GetExport(handle, name);
+
 		protected override bool ReleaseHandle()
 		{
-			return Kernel32.NativeMethods.FreeLibrary(handle);
+			NativeLibrary.Free(handle);
+			return true;
 		}
 	}
 }
@@ -0,0 +1,24 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// This instance's counters for the shared state bus. Mirrors the SharedStateBusStatistics struct in SharedStateBus.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct SharedStateBusStatistics
+	{
+		public ulong PublishedCount;
+		public ulong SentCount;
+		public ulong ReceivedCount;
+		public ulong MissedCount;
+		public ulong TornReadCount;
+		public ulong LostSlotCount;
+		public int InstanceIndex;
+		public uint InstanceCapacity;
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[InstanceIndex: {InstanceIndex}/{InstanceCapacity}, PublishedCount: {PublishedCount}, SentCount: {SentCount}, ReceivedCount: {ReceivedCount}, MissedCount: {MissedCount}, TornReadCount: {TornReadCount}, LostSlotCount: {LostSlotCount}]";
+	}
+}
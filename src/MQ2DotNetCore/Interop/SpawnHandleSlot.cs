@@ -0,0 +1,24 @@
+﻿using System;
+using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// One slot of the loader's spawn handle table. Mirrors the SpawnHandleSlot struct in SpawnHandleTable.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct SpawnHandleSlot
+	{
+		/// <summary>
+		/// The spawn, <see cref="IntPtr.Zero"/> while the slot is free
+		/// </summary>
+		public IntPtr Pointer;
+
+		/// <summary>
+		/// Bumped every time the slot is freed, a handle only resolves while its generation matches
+		/// </summary>
+		public uint Generation;
+
+		public uint NextFree;
+	}
+}
@@ -0,0 +1,53 @@
+﻿using MQ2DotNetCore.MQ2Api;
+using System;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Resolves <see cref="SpawnHandle"/>s by reading the loader's slot array directly, a bounds check and a generation compare
+	/// rather than a call into the loader. The slots are only written on the EQ thread, so they must only be read from it.
+	/// </summary>
+	internal static unsafe class SpawnHandleTable
+	{
+		private static uint _capacity;
+		private static SpawnHandleSlot* _slots;
+
+		internal static void Bind()
+		{
+			_slots = (SpawnHandleSlot*)MQ2DotNetCoreLoader.NativeMethods.SpawnHandleTable__GetSlots(out _capacity);
+		}
+
+		/// <summary>
+		/// Slots past this have never been handed out
+		/// </summary>
+		internal static uint UsedSlotCount => _slots == null ? 0 : MQ2DotNetCoreLoader.NativeMethods.SpawnHandleTable__GetUsedSlotCount();
+
+		internal static bool TryResolve(SpawnHandle handle, out IntPtr spawnPointer)
+		{
+			var index = handle.Index;
+			if (_slots == null || index >= _capacity || _slots[index].Generation != handle.Generation)
+			{
+				spawnPointer = IntPtr.Zero;
+				return false;
+			}
+
+			spawnPointer = _slots[index].Pointer;
+			return spawnPointer != IntPtr.Zero;
+		}
+
+		/// <summary>
+		/// The handle of the spawn in the slot, or <see cref="SpawnHandle.None"/> if it is free
+		/// </summary>
+		internal static SpawnHandle GetHandle(uint index, out IntPtr spawnPointer)
+		{
+			if (_slots == null || index >= _capacity || _slots[index].Pointer == IntPtr.Zero)
+			{
+				spawnPointer = IntPtr.Zero;
+				return SpawnHandle.None;
+			}
+
+			spawnPointer = _slots[index].Pointer;
+			return new SpawnHandle(((ulong)_slots[index].Generation << 32) | index);
+		}
+	}
+}
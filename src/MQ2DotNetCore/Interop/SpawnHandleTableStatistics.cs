@@ -0,0 +1,20 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Counters for the loader's spawn handle table. Mirrors the SpawnHandleTableStatistics struct in SpawnHandleTable.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct SpawnHandleTableStatistics
+	{
+		public uint Capacity;
+		public uint Count;
+		public uint UsedSlotCount;
+		public uint OverflowCount;
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[Capacity: {Capacity}, Count: {Count}, UsedSlotCount: {UsedSlotCount}, OverflowCount: {OverflowCount}]";
+	}
+}
@@ -0,0 +1,25 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Byte offsets of each array in a spawn snapshot buffer. Mirrors the SpawnSnapshotLayout struct in SpawnSnapshot.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct SpawnSnapshotLayout
+	{
+		public uint Capacity;
+		public uint IdsOffset;
+		public uint XOffset;
+		public uint YOffset;
+		public uint ZOffset;
+		public uint HeadingsOffset;
+		public uint NameOffsetsOffset;
+		public uint TypesOffset;
+		public uint LevelsOffset;
+		public uint HPPercentsOffset;
+		public uint NamesOffset;
+		public uint NamesCapacity;
+		public uint TotalSize;
+	}
+}
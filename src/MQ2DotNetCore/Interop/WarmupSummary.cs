@@ -0,0 +1,21 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.Interop
+{
+	/// <summary>
+	/// Time to the first pulse after the managed side was loaded or hot reloaded, and the latencies of the pulses after it.
+	/// Mirrors the WarmupSummary struct in AsyncBoot.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	internal struct WarmupSummary
+	{
+		public ulong TimeToFirstPulseNanoseconds;
+		public uint PulseCount;
+		public uint IsPreWarmEnabled;
+		public CallbackTimingSummary Pulses;
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[TimeToFirstPulse: {TimeToFirstPulseNanoseconds / 1_000_000.0:0.0} ms, PulseCount: {PulseCount}, Pulses: {Pulses}, IsPreWarmEnabled: {IsPreWarmEnabled != 0}]";
+	}
+}
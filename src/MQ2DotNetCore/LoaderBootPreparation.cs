@@ -0,0 +1,53 @@
+﻿using MQ2DotNetCore.Base;
+using MQ2DotNetCore.Interop;
+using System;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+
+namespace MQ2DotNetCore
+{
+	/// <summary>
+	/// Called by the loader on its boot thread when AsyncBoot is enabled, before <see cref="LoaderEntryPoint.InitializePlugin(IntPtr, int)"/>
+	/// runs on the EQ thread. Loads MQ2DotNetCore's dependencies and JITs the entry point's methods so that less of that work
+	/// happens during the pulse that initializes the plugin. With PreWarm=1 it also runs the <see cref="JitWarmup"/>.
+	/// </summary>
+	/// <remarks>
+	/// Nothing here may call into MQ2 or touch <see cref="LoaderEntryPoint"/>'s static state, its static constructor looks up
+	/// MQ2 data types and the logger writes to the MQ2 chat window, neither of which is safe off the EQ thread.
+	/// </remarks>
+	public static class LoaderBootPreparation
+	{
+		public static int Prepare(IntPtr arg, int argLength)
+		{
+			try
+			{
+				foreach (var dependency in SubmoduleAssemblyLoadContext.MQ2DotNetCoreDependencies)
+				{
+					// Reading the name is enough to make sure the assembly and its metadata are loaded
+					_ = dependency.GetName();
+				}
+
+				var entryPointMethods = typeof(LoaderEntryPoint).GetMethods(BindingFlags.DeclaredOnly | BindingFlags.NonPublic | BindingFlags.Public | BindingFlags.Static);
+				foreach (var method in entryPointMethods)
+				{
+					if (!method.IsAbstract && !method.ContainsGenericParameters)
+					{
+						RuntimeHelpers.PrepareMethod(method.MethodHandle);
+					}
+				}
+
+				if (MQ2DotNetCoreLoader.NativeMethods.AsyncBoot__IsPreWarmEnabled())
+				{
+					JitWarmup.Run();
+				}
+
+				return 0;
+			}
+			catch (Exception)
+			{
+				// Not worth failing the boot over, InitializePlugin will just have more to do
+				return 1;
+			}
+		}
+	}
+}
@@ -5,8 +5,10 @@ using MQ2DotNetCore.Logging;
 using MQ2DotNetCore.MQ2Api;
 using MQ2DotNetCore.MQ2Api.DataTypes;
 using System;
+using System.Collections.Generic;
 using System.IO;
 using System.Linq;
+using System.Runtime;
 using System.Runtime.InteropServices;
 using System.Threading;
 using System.Threading.Tasks;
@@ -15,6 +17,10 @@ namespace MQ2DotNetCore
 {
 	public static class LoaderEntryPoint
 	{
+		private static bool _isLoaderEventBatchingEnabled;
+		private static bool _isMemberCacheEnabled;
+		private static bool _isSpawnChangeFeedEnabled;
+		private static readonly LoaderEvent[] _loaderEventBuffer = new LoaderEvent[512];
 		private static SafeLibraryHandle? _loaderLibraryHandle;
 
 		private static readonly ILoggerFactory? _loggerFactory;
@@ -24,7 +30,11 @@ namespace MQ2DotNetCore
 		private static readonly MQ2 _mq2Instance;
 		private static readonly MQ2SynchronizationContext _mq2SynchronizationContext;
 		private static readonly MQ2DotNetCoreOptions _options;
+		private static readonly List<SpawnChange> _pendingSpawnChanges = new List<SpawnChange>();
+		private static IntPtr _pulseFramePointer;
+		private static readonly PulseSnapshotDispatcher _pulseSnapshotDispatcher;
 		private static readonly MQ2TypeFactory _rootTypeFactory;
+		private static readonly SpawnChange[] _spawnChangeBuffer = new SpawnChange[256];
 		private static readonly SubmoduleRegistry _submoduleRegistry;
 
 		static LoaderEntryPoint()
@@ -56,6 +66,10 @@ namespace MQ2DotNetCore
 			var submoduleAssemblyLoadContextLogger = _loggerFactory?.CreateLogger<SubmoduleAssemblyLoadContext>();
 			var submoduleProgramWrapperLogger = _loggerFactory?.CreateLogger<SubmoduleProgramWrapper>();
 			_submoduleRegistry = new SubmoduleRegistry(submoduleRegistryLogger, _mq2Instance, submoduleAssemblyLoadContextLogger, submoduleProgramWrapperLogger);
+
+			// Results posted by the worker handlers run with the program continuations
+			var pulseSnapshotDispatcherLogger = _loggerFactory?.CreateLogger<PulseSnapshotDispatcher>();
+			_pulseSnapshotDispatcher = new PulseSnapshotDispatcher(pulseSnapshotDispatcherLogger, _mq2SynchronizationContext.ForLane(MQ2ContinuationLane.Background));
 		}
 
 		public static int InitializePlugin(IntPtr arg, int argLength)
@@ -72,28 +86,102 @@ namespace MQ2DotNetCore
 
 				// TODO: Consider passing/parsing the loader dll path through parameters
 				_logger?.LogDebugPrefixed($"Loader DLL Path: {MQ2DotNetCoreLoader.AbsoluteDllPath}");
-				_loaderLibraryHandle = Kernel32.NativeMethods.LoadLibrary(MQ2DotNetCoreLoader.AbsoluteDllPath);
-				if (_loaderLibraryHandle == null)
-				{
-					_logger?.LogErrorPrefixed($"{nameof(_loaderLibraryHandle)} is null");
-					return 1;
-				}
-
-				Marshal.WriteIntPtr(Kernel32.NativeMethods.GetProcAddress(_loaderLibraryHandle, "g_pfShutdownPlugin"), Marshal.GetFunctionPointerForDelegate(_handleShutdownPlugin));
-				Marshal.WriteIntPtr(Kernel32.NativeMethods.GetProcAddress(_loaderLibraryHandle, "g_pfOnCleanUI"), Marshal.GetFunctionPointerForDelegate(_handleCleanUI));
-				Marshal.WriteIntPtr(Kernel32.NativeMethods.GetProcAddress(_loaderLibraryHandle, "g_pfOnReloadUI"), Marshal.GetFunctionPointerForDelegate(_handleReloadUI));
-				Marshal.WriteIntPtr(Kernel32.NativeMethods.GetProcAddress(_loaderLibraryHandle, "g_pfOnDrawHUD"), Marshal.GetFunctionPointerForDelegate(_handleDrawHUD));
-				Marshal.WriteIntPtr(Kernel32.NativeMethods.GetProcAddress(_loaderLibraryHandle, "g_pfSetGameState"), Marshal.GetFunctionPointerForDelegate(_handleSetGameState));
-				Marshal.WriteIntPtr(Kernel32.NativeMethods.GetProcAddress(_loaderLibraryHandle, "g_pfOnPulse"), Marshal.GetFunctionPointerForDelegate(_handlePulse));
-				Marshal.WriteIntPtr(Kernel32.NativeMethods.GetProcAddress(_loaderLibraryHandle, "g_pfOnIncomingChat"), Marshal.GetFunctionPointerForDelegate(_handleIncomingChat));
-				Marshal.WriteIntPtr(Kernel32.NativeMethods.GetProcAddress(_loaderLibraryHandle, "g_pfOnWriteChatColor"), Marshal.GetFunctionPointerForDelegate(_handleWriteChatColor));
-				Marshal.WriteIntPtr(Kernel32.NativeMethods.GetProcAddress(_loaderLibraryHandle, "g_pfOnAddSpawn"), Marshal.GetFunctionPointerForDelegate(_handleAddSpawn));
-				Marshal.WriteIntPtr(Kernel32.NativeMethods.GetProcAddress(_loaderLibraryHandle, "g_pfOnRemoveSpawn"), Marshal.GetFunctionPointerForDelegate(_handleRemoveSpawn));
-				Marshal.WriteIntPtr(Kernel32.NativeMethods.GetProcAddress(_loaderLibraryHandle, "g_pfOnAddGroundItem"), Marshal.GetFunctionPointerForDelegate(_handleAddGroundItem));
-				Marshal.WriteIntPtr(Kernel32.NativeMethods.GetProcAddress(_loaderLibraryHandle, "g_pfOnRemoveGroundItem"), Marshal.GetFunctionPointerForDelegate(_handleRemoveGroundItem));
-				Marshal.WriteIntPtr(Kernel32.NativeMethods.GetProcAddress(_loaderLibraryHandle, "g_pfBeginZone"), Marshal.GetFunctionPointerForDelegate(_handleBeginZone));
-				Marshal.WriteIntPtr(Kernel32.NativeMethods.GetProcAddress(_loaderLibraryHandle, "g_pfEndZone"), Marshal.GetFunctionPointerForDelegate(_handleEndZone));
-				Marshal.WriteIntPtr(Kernel32.NativeMethods.GetProcAddress(_loaderLibraryHandle, "g_pfOnZoned"), Marshal.GetFunctionPointerForDelegate(_handleZoned));
+				_loaderLibraryHandle = SafeLibraryHandle.Load(MQ2DotNetCoreLoader.AbsoluteDllPath);
+
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfShutdownPlugin"), Marshal.GetFunctionPointerForDelegate(_handleShutdownPlugin));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnCleanUI"), Marshal.GetFunctionPointerForDelegate(_handleCleanUI));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnReloadUI"), Marshal.GetFunctionPointerForDelegate(_handleReloadUI));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnDrawHUD"), Marshal.GetFunctionPointerForDelegate(_handleDrawHUD));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfSetGameState"), Marshal.GetFunctionPointerForDelegate(_handleSetGameState));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnPulse"), Marshal.GetFunctionPointerForDelegate(_handlePulse));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnIncomingChat"), Marshal.GetFunctionPointerForDelegate(_handleIncomingChat));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnWriteChatColor"), Marshal.GetFunctionPointerForDelegate(_handleWriteChatColor));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnIncomingChatMatched"), Marshal.GetFunctionPointerForDelegate(_handleIncomingChatMatched));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnWriteChatColorMatched"), Marshal.GetFunctionPointerForDelegate(_handleWriteChatColorMatched));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnAddSpawn"), Marshal.GetFunctionPointerForDelegate(_handleAddSpawn));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnRemoveSpawn"), Marshal.GetFunctionPointerForDelegate(_handleRemoveSpawn));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnAddGroundItem"), Marshal.GetFunctionPointerForDelegate(_handleAddGroundItem));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnRemoveGroundItem"), Marshal.GetFunctionPointerForDelegate(_handleRemoveGroundItem));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfBeginZone"), Marshal.GetFunctionPointerForDelegate(_handleBeginZone));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfEndZone"), Marshal.GetFunctionPointerForDelegate(_handleEndZone));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnZoned"), Marshal.GetFunctionPointerForDelegate(_handleZoned));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfDrainLoaderEvents"), Marshal.GetFunctionPointerForDelegate(_handleDrainLoaderEvents));
+
+				// ABI v2 callbacks only take blittable arguments, the v1 ones above stay bound in case the loader selects v1
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnIncomingChatV2"), Marshal.GetFunctionPointerForDelegate(_handleIncomingChatV2));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnWriteChatColorV2"), Marshal.GetFunctionPointerForDelegate(_handleWriteChatColorV2));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnAddSpawnV2"), Marshal.GetFunctionPointerForDelegate(_handleAddSpawnV2));
+				Marshal.WriteIntPtr(_loaderLibraryHandle.GetExport("g_pfOnRemoveSpawnV2"), Marshal.GetFunctionPointerForDelegate(_handleRemoveSpawnV2));
+				var callbackAbiVersion = MQ2DotNetCoreLoader.NativeMethods.LoaderAbi__SelectVersion(MQ2DotNetCoreLoader.CallbackAbiVersion);
+				_logger?.LogDebugPrefixed($"Selected callback ABI v{callbackAbiVersion}");
+
+				_pulseFramePointer = _loaderLibraryHandle.GetExport("g_pulseFrame");
+				SpawnHandleTable.Bind();
+
+				if (_options.IsLoaderEventBatchingEnabled)
+				{
+					_logger?.LogDebugPrefixed("Enabling batched spawn, ground item, and zone events in the loader event ring");
+					MQ2DotNetCoreLoader.NativeMethods.LoaderEventRing__SetEnabled(true);
+					_isLoaderEventBatchingEnabled = true;
+				}
+
+				if (_options.IsNativeChatFilterEnabled)
+				{
+					_logger?.LogDebugPrefixed("Enabling the native chat filter, lines that don't match a registered chat pattern will not be forwarded");
+					MQ2DotNetCoreLoader.NativeMethods.ChatFilter__SetPassthrough(false);
+				}
+
+				if (_options.IsMemberCacheEnabled)
+				{
+					_logger?.LogDebugPrefixed("Enabling the per pulse member cache");
+					foreach (var member in _options.MemberCacheBypass ?? Array.Empty<string>())
+					{
+						MQ2DotNetCoreLoader.NativeMethods.MemberCache__AddBypass(member);
+					}
+
+					MQ2DotNetCoreLoader.NativeMethods.MemberCache__SetEnabled(true);
+					_isMemberCacheEnabled = true;
+				}
+
+				var spawnChangeFeedFields = _options.GetSpawnChangeFeedFields();
+				if (spawnChangeFeedFields != SpawnChangeFields.None)
+				{
+					_logger?.LogDebugPrefixed($"Enabling the spawn change feed for: {spawnChangeFeedFields}");
+					MQ2DotNetCoreLoader.NativeMethods.SpawnChangeFeed__SetFields(spawnChangeFeedFields);
+					_isSpawnChangeFeedEnabled = true;
+				}
+
+				if (!string.IsNullOrEmpty(_options.StateBusName))
+				{
+					// The slot is named once the program knows the character, through MQ2StateBus.SetInstanceName
+					if (MQ2DotNetCoreLoader.NativeMethods.SharedStateBus__Open(_options.StateBusName, string.Empty))
+					{
+						_logger?.LogDebugPrefixed($"Opened the shared state bus {_options.StateBusName} in slot {_mq2Instance.StateBus.InstanceIndex}");
+					}
+					else
+					{
+						_logger?.LogWarningPrefixed($"Failed to open the shared state bus {_options.StateBusName}, it may be full or mapped by an incompatible loader");
+					}
+				}
+
+				// The loader's [Runtime] settings override the runtimeconfig, this is what the runtime ended up with
+				_logger?.LogDebugPrefixed($"GC: {(GCSettings.IsServerGC ? "server" : "workstation")}, "
+					+ $"concurrent: {AppContext.GetData("System.GC.Concurrent") ?? "default"}, "
+					+ $"latency mode: {GCSettings.LatencyMode}, "
+					+ $"available memory: {GC.GetGCMemoryInfo().TotalAvailableMemoryBytes / (1024 * 1024)} MB, "
+					+ $"tiered compilation: {AppContext.GetData("System.Runtime.TieredCompilation") ?? "default"}");
+
+				if (_options.IsGCTelemetryEnabled)
+				{
+					_logger?.LogDebugPrefixed("Enabling the per pulse GC telemetry");
+					_mq2Instance.GCTelemetry.Enable();
+				}
+
+				if (_options.IsCallbackSubscriptionEnabled)
+				{
+					_logger?.LogDebugPrefixed("Enabling callback subscriptions, callbacks no submodule handles will not be forwarded");
+					LoaderCallbackSubscriptions.Enable();
+				}
 
 				var missingDependencyPaths =
 					Directory.EnumerateFiles(
@@ -103,6 +191,8 @@ namespace MQ2DotNetCore
 					)
 					.Where(path =>!path.EndsWith("JetBrains.Annotations.dll", StringComparison.OrdinalIgnoreCase)
 						&& !path.EndsWith("MQ2DotNetCore.dll", StringComparison.OrdinalIgnoreCase)
+						// The loader's copies of MQ2DotNetCore.dll that run the hot reload host
+						&& !Path.GetFileName(path).StartsWith("MQ2DotNetCore.HotReloadHost.", StringComparison.OrdinalIgnoreCase)
 						&& !SubmoduleAssemblyLoadContext.MQ2DotNetCoreDependencies.Any(dependencyAssembly => path.Equals(dependencyAssembly.Location, StringComparison.OrdinalIgnoreCase))
 					)
 					.ToList();
@@ -128,6 +218,10 @@ namespace MQ2DotNetCore
 
 				_mq2CommandRegistry.AddCommand(nameof(LoaderEntryPoint), "/netcorelist", NetListCommand);
 
+				_mq2CommandRegistry.AddCommand(nameof(LoaderEntryPoint), "/netcorestats", NetStatsCommand);
+
+				_mq2CommandRegistry.AddCommand(nameof(LoaderEntryPoint), "/netcorereload", NetReloadCommand);
+
 				_mq2CommandRegistry.AddCommand(nameof(LoaderEntryPoint), "/netcorecanceltask", NetCancelCommandTask);
 
 
@@ -147,6 +241,26 @@ namespace MQ2DotNetCore
 
 				_logger?.LogDebugPrefixed("Done registering the primary commands.");
 
+				// Already done on the boot thread with AsyncBoot=1, unless that was a copy that has since been hot reloaded
+				if (MQ2DotNetCoreLoader.NativeMethods.AsyncBoot__IsPreWarmEnabled() && !JitWarmup.HasRun)
+				{
+					JitWarmup.PrepareHotPaths();
+					_logger?.LogDebugPrefixed($"Pre-warmed the hot paths ({JitWarmup.GetSummary()}), the wrapper types continue in the background");
+					JitWarmup.StartWrappers();
+				}
+
+				if (HotReloadState.IsHosted)
+				{
+					_logger?.LogInformationPrefixed($"Running as hot reloadable generation {HotReloadState.Generation}");
+
+					// Started the same way /netcorerun does, so a program that fails to start only reports it like it would there
+					foreach (var programArguments in HotReloadState.TakeRunningPrograms())
+					{
+						_logger?.LogInformationPrefixed($"Restarting the {programArguments[0]} program that was running before the reload");
+						NetRunCommand(programArguments);
+					}
+				}
+
 				return 0;
 			}
 			catch (Exception exc)
@@ -294,6 +408,99 @@ namespace MQ2DotNetCore
 				_mq2CommandRegistry.PrintRegisteredCommands();
 
 				_mq2CommandRegistry.PrintRunningCommands();
+
+				if (_isLoaderEventBatchingEnabled)
+				{
+					MQ2DotNetCoreLoader.NativeMethods.LoaderEventRing__GetStatistics(out var loaderEventRingStatistics);
+					_mq2Instance.WriteChatSafe($"Loader event ring: {loaderEventRingStatistics}");
+				}
+
+				MQ2DotNetCoreLoader.NativeMethods.CallbackCapture__GetStatistics(out var callbackCaptureStatistics);
+				if (callbackCaptureStatistics.RecordCount > 0)
+				{
+					_mq2Instance.WriteChatSafe($"Callback capture: {callbackCaptureStatistics}");
+				}
+
+				MQ2DotNetCoreLoader.NativeMethods.ChatFilter__GetStatistics(out var chatFilterStatistics);
+				if (chatFilterStatistics.PatternCount > 0)
+				{
+					_mq2Instance.WriteChatSafe($"Chat filter: {chatFilterStatistics}");
+				}
+
+				MQ2DotNetCoreLoader.NativeMethods.ExpressionPlan__GetStatistics(out var expressionPlanStatistics);
+				if (expressionPlanStatistics.PlanCount > 0)
+				{
+					_mq2Instance.WriteChatSafe($"Expression plans: {expressionPlanStatistics}");
+				}
+
+				MQ2DotNetCoreLoader.NativeMethods.InventoryIndex__GetStatistics(out var inventoryIndexStatistics);
+				if (inventoryIndexStatistics.QueryCount > 0)
+				{
+					_mq2Instance.WriteChatSafe($"Inventory index: {inventoryIndexStatistics}");
+				}
+
+				if (_isMemberCacheEnabled)
+				{
+					MQ2DotNetCoreLoader.NativeMethods.MemberCache__GetStatistics(out var memberCacheStatistics);
+					_mq2Instance.WriteChatSafe($"Member cache: {memberCacheStatistics}");
+				}
+
+				if (_options.IsLoaderLoggingEnabled)
+				{
+					MQ2DotNetCoreLoader.NativeMethods.LoaderLog__GetStatistics(out var loaderLogStatistics);
+					_mq2Instance.WriteChatSafe($"Loader log: {loaderLogStatistics}");
+				}
+
+				if (HotReloadState.IsHosted)
+				{
+					MQ2DotNetCoreLoader.NativeMethods.LoaderHotReload__GetStatistics(out var hotReloadStatistics);
+					_mq2Instance.WriteChatSafe($"Hot reload: {hotReloadStatistics}");
+				}
+
+				MQ2DotNetCoreLoader.NativeMethods.InternTable__GetStatistics(out var internTableStatistics);
+				if (internTableStatistics.UnresolvedTypeCount > 0 || internTableStatistics.OverflowCount > 0)
+				{
+					_mq2Instance.WriteChatSafe($"Intern table: {internTableStatistics}");
+				}
+
+				MQ2DotNetCoreLoader.NativeMethods.SpawnHandleTable__GetStatistics(out var spawnHandleTableStatistics);
+				if (spawnHandleTableStatistics.OverflowCount > 0)
+				{
+					_mq2Instance.WriteChatSafe($"Spawn handle table: {spawnHandleTableStatistics}");
+				}
+
+				var stateBusStatistics = MQ2StateBus.GetStatistics();
+				if (stateBusStatistics.InstanceIndex >= 0)
+				{
+					_mq2Instance.WriteChatSafe($"State bus: {stateBusStatistics}");
+				}
+
+				var pulseArenaHighWaterMark = MQ2DotNetCoreLoader.NativeMethods.PulseArena__GetHighWaterMark();
+				if (pulseArenaHighWaterMark > 0)
+				{
+					_mq2Instance.WriteChatSafe($"Pulse arena high water mark: {pulseArenaHighWaterMark} bytes");
+				}
+			}
+			catch (Exception exc)
+			{
+				_logger?.LogErrorPrefixed(exc);
+			}
+		}
+
+		private static void NetReloadCommand(string[] commandArguments)
+		{
+			try
+			{
+				// The loader reloads at the start of the next pulse, once this command has returned
+				if (MQ2DotNetCoreLoader.NativeMethods.LoaderHotReload__Request())
+				{
+					_logger?.LogInformationPrefixed("Hot reload requested");
+					_mq2Instance.WriteChatSafe("Reloading MQ2DotNetCore on the next pulse, running programs will be restarted...");
+				}
+				else
+				{
+					_mq2Instance.WriteChatSafe("Hot reload is disabled, set HotReload=1 in MQ2DotNetCoreLoader.ini and load the plugin again to enable it");
+				}
 			}
 			catch (Exception exc)
 			{
@@ -311,8 +518,10 @@ namespace MQ2DotNetCore
 					return;
 				}
 
+				// Programs start in the background lane, so their loops wait behind commands when the pulse budget runs out
 				var submoduleProgramName = commandArguments[0];
-				_mq2SynchronizationContext.SetExecuteAndRestore(() =>
+				var programSynchronizationContext = _mq2SynchronizationContext.ForLane(MQ2ContinuationLane.Background);
+				programSynchronizationContext.SetExecuteAndRestore(() =>
 				{
 					try
 					{
@@ -328,7 +537,7 @@ namespace MQ2DotNetCore
 							submoduleEventRegistry,
 							_mq2DependenciesLogger,
 							_mq2Instance,
-							_mq2SynchronizationContext,
+							programSynchronizationContext,
 							submoduleTypeFactory,
 							new MQ2Spawns(submoduleTypeFactory),
 							submoduleProgramName,
@@ -360,9 +569,106 @@ namespace MQ2DotNetCore
 			}
 		}
 
+		private static void NetStatsCommand(string[] commandArguments)
+		{
+			try
+			{
+				if (commandArguments.Length > 0 && string.Equals(commandArguments[0], "reset", StringComparison.OrdinalIgnoreCase))
+				{
+					MQ2DotNetCoreLoader.NativeMethods.CallbackTimings__Reset();
+					_submoduleRegistry.ResetCallbackTimings();
+					_mq2SynchronizationContext.ResetStatistics();
+					_pulseSnapshotDispatcher.ResetStatistics();
+					_mq2Instance.GCTelemetry.ResetStatistics();
+					_mq2Instance.WriteChatSafe("Callback timings have been reset");
+					return;
+				}
+
+				if (commandArguments.Length > 0)
+				{
+					_mq2Instance.WriteChatProgram("Usage: /netcorestats [reset]");
+					return;
+				}
+
+				_mq2Instance.WriteChatSafe("Callback timings (including the managed handlers):");
+				for (var callback = LoaderCallback.Pulse; callback < LoaderCallback.Count; ++callback)
+				{
+					if (MQ2DotNetCoreLoader.NativeMethods.CallbackTimings__GetSummary(callback, out var summary) && summary.Count > 0)
+					{
+						var skippedCount = MQ2DotNetCoreLoader.NativeMethods.CallbackSubscriptions__GetSkippedCount(callback);
+						_mq2Instance.WriteChatSafe(skippedCount > 0
+							? $"  {callback}: {summary}, not forwarded: {skippedCount}"
+							: $"  {callback}: {summary}");
+					}
+				}
+
+				var subscriptionMask = MQ2DotNetCoreLoader.NativeMethods.CallbackSubscriptions__GetMask(out var subscriptionVersion);
+				_mq2Instance.WriteChatSafe($"Forwarded callbacks (version {subscriptionVersion}): {FormatCallbackMask(subscriptionMask)}");
+
+				var budgetMicroseconds = ReadPulseFrame().BudgetMicroseconds;
+				_mq2Instance.WriteChatSafe($"Continuations: {_mq2SynchronizationContext.ExecutedContinuationCount} run, "
+					+ $"{_mq2SynchronizationContext.DeferredContinuationCount} deferred, "
+					+ $"{_mq2SynchronizationContext.BudgetOverrunCount} budget overruns (longest {_mq2SynchronizationContext.LongestBudgetOverrun.TotalMilliseconds:0.###} ms), "
+					+ (budgetMicroseconds > 0 ? $"budget {budgetMicroseconds} us per pulse" : "no budget"));
+
+				MQ2DotNetCoreLoader.NativeMethods.AsyncBoot__GetWarmupSummary(out var warmupSummary);
+				if (warmupSummary.PulseCount > 0)
+				{
+					_mq2Instance.WriteChatSafe($"Warm-up: first pulse after {warmupSummary.TimeToFirstPulseNanoseconds / 1_000_000.0:0.0} ms, "
+						+ $"first {warmupSummary.PulseCount} pulses {warmupSummary.Pulses}"
+						+ (warmupSummary.IsPreWarmEnabled != 0 ? $", pre-warmed {JitWarmup.GetSummary()}" : string.Empty));
+				}
+
+				if (_mq2Instance.GCTelemetry.IsEnabled)
+				{
+					_mq2Instance.WriteChatSafe($"GC: {_mq2Instance.GCTelemetry.GetSummary()}, last pulse {_mq2Instance.GCTelemetry.LastPulse}");
+				}
+
+				if (_pulseSnapshotDispatcher.HasDispatched)
+				{
+					_mq2Instance.WriteChatSafe($"Pulse snapshots: {_pulseSnapshotDispatcher.GetSummary()}");
+				}
+
+				_mq2Instance.WriteChatSafe("Submodule handlers:");
+				_submoduleRegistry.PrintCallbackTimings();
+			}
+			catch (Exception exc)
+			{
+				_logger?.LogErrorPrefixed(exc);
+			}
+		}
+
+		private static unsafe PulseFrame ReadPulseFrame()
+		{
+			return *(PulseFrame*)_pulseFramePointer;
+		}
+
+		private static string FormatCallbackMask(uint mask)
+		{
+			var callbackNames = new List<string>();
+			for (var callback = LoaderCallback.Pulse; callback < LoaderCallback.Count; ++callback)
+			{
+				if ((mask & (1u << (int)callback)) != 0)
+				{
+					callbackNames.Add(callback.ToString());
+				}
+			}
+
+			return callbackNames.Count > 0 ? string.Join(", ", callbackNames) : "none";
+		}
+
 
 
 		// MQ2DotNetCoreLoader.dll Delegate Types
+		[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+		private delegate uint fIncomingChatMatched([MarshalAs(UnmanagedType.LPStr)]string chatLine, uint color, IntPtr matchedIds, uint matchedIdCount);
+
+		[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+		private delegate uint fIncomingChatV2(IntPtr chatLine, uint chatLineLength, uint color, IntPtr matchedIds, uint matchedIdCount);
+
+		[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+		private delegate void fLoaderEventsDrain();
+
 		[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
 		private delegate void fMQBeginZone();
 
@@ -402,6 +708,15 @@ namespace MQ2DotNetCore
 		[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
 		private delegate void fMQZoned();
 
+		[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+		private delegate void fSpawnV2(IntPtr spawn, ulong handle);
+
+		[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+		private delegate uint fWriteChatColorMatched([MarshalAs(UnmanagedType.LPStr)]string line, uint color, uint filter, IntPtr matchedIds, uint matchedIdCount);
+
+		[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+		private delegate uint fWriteChatColorV2(IntPtr line, uint lineLength, uint color, uint filter, IntPtr matchedIds, uint matchedIdCount);
+
 
 
 
@@ -416,7 +731,7 @@ namespace MQ2DotNetCore
 				_logger?.LogTracePrefixed("Method was called");
 #endif
 				_submoduleRegistry.ExecuteForEachSubmodule(
-					(submoduleWrapper) => NotifyAddGroundItem(submoduleWrapper, newGroundItemPointer));
+					(submoduleWrapper) => NotifyAddGroundItem(submoduleWrapper, newGroundItemPointer), nameof(LoaderCallback.AddGroundItem));
 			}
 			catch (Exception exc)
 			{
@@ -435,6 +750,13 @@ namespace MQ2DotNetCore
 
 		private static readonly fMQSpawn _handleAddSpawn = HandleAddSpawn;
 		private static void HandleAddSpawn(IntPtr newSpawnPointer)
+			=> HandleAddSpawnV2(newSpawnPointer, MQ2DotNetCoreLoader.NativeMethods.SpawnHandleTable__Find(newSpawnPointer));
+
+		private static readonly fSpawnV2 _handleAddSpawnV2 = HandleAddSpawnV2;
+		private static void HandleAddSpawnV2(IntPtr newSpawnPointer, ulong handle)
+			=> DispatchAddSpawn(newSpawnPointer, new SpawnHandle(handle), isBatched: false);
+
+		private static void DispatchAddSpawn(IntPtr newSpawnPointer, SpawnHandle spawnHandle, bool isBatched)
 		{
 			try
 			{
@@ -442,7 +764,7 @@ namespace MQ2DotNetCore
 				_logger?.LogTracePrefixed("Method was called");
 #endif
 				_submoduleRegistry.ExecuteForEachSubmodule(
-					(submoduleWrapper) => NotifyAddSpawn(submoduleWrapper, newSpawnPointer));
+					(submoduleWrapper) => NotifyAddSpawn(submoduleWrapper, newSpawnPointer, spawnHandle, isBatched), nameof(LoaderCallback.AddSpawn));
 			}
 			catch (Exception exc)
 			{
@@ -450,9 +772,10 @@ namespace MQ2DotNetCore
 			}
 		}
 
-		private static void NotifyAddSpawn(SubmoduleProgramWrapper submodule, IntPtr newSpawnPointer)
+		private static void NotifyAddSpawn(SubmoduleProgramWrapper submodule, IntPtr newSpawnPointer, SpawnHandle handle, bool isBatched)
 		{
-			var newSpawn = new SpawnType(submodule.MQ2Dependencies.GetTypeFactory(), newSpawnPointer);
+			var spawns = submodule.MQ2Dependencies.GetSpawns();
+			var newSpawn = isBatched ? spawns.GetBatchedSpawn(handle, newSpawnPointer) : spawns.GetSpawn(handle, newSpawnPointer);
 
 			submodule.MQ2Dependencies.GetEventRegistry().NotifyAddSpawn(newSpawn);
 		}
@@ -467,7 +790,7 @@ namespace MQ2DotNetCore
 #if DEBUG
 				_logger?.LogTracePrefixed("Method was called");
 #endif
-				_submoduleRegistry.ExecuteForEachSubmodule(NotifyBeginZone);
+				_submoduleRegistry.ExecuteForEachSubmodule(NotifyBeginZone, nameof(LoaderCallback.BeginZone));
 			}
 			catch (Exception exc)
 			{
@@ -488,7 +811,7 @@ namespace MQ2DotNetCore
 #if DEBUG
 				_logger?.LogTracePrefixed("Method was called");
 #endif
-				_submoduleRegistry.ExecuteForEachSubmodule(NotifyCleanUI);
+				_submoduleRegistry.ExecuteForEachSubmodule(NotifyCleanUI, nameof(LoaderCallback.CleanUI));
 			}
 			catch (Exception exc)
 			{
@@ -522,7 +845,7 @@ namespace MQ2DotNetCore
 				}
 #endif
 
-				_submoduleRegistry.ExecuteForEachSubmodule(NotifyDrawHUD);
+				_submoduleRegistry.ExecuteForEachSubmodule(NotifyDrawHUD, nameof(LoaderCallback.DrawHUD));
 			}
 			catch (Exception exc)
 			{
@@ -535,6 +858,62 @@ namespace MQ2DotNetCore
 
 
 
+		private static readonly fLoaderEventsDrain _handleDrainLoaderEvents = HandleDrainLoaderEvents;
+		private static void HandleDrainLoaderEvents()
+		{
+			try
+			{
+				uint drainedCount;
+				do
+				{
+					drainedCount = MQ2DotNetCoreLoader.NativeMethods.LoaderEventRing__Drain(_loaderEventBuffer, (uint)_loaderEventBuffer.Length);
+					for (var index = 0; index < drainedCount; ++index)
+					{
+						DispatchLoaderEvent(ref _loaderEventBuffer[index]);
+					}
+				}
+				while (drainedCount == _loaderEventBuffer.Length);
+			}
+			catch (Exception exc)
+			{
+				_logger?.LogErrorPrefixed(exc);
+			}
+		}
+
+		private static void DispatchLoaderEvent(ref LoaderEvent loaderEvent)
+		{
+			// Same handlers as the unbatched callbacks. Removals are never queued, the loader drains the ring before delivering them,
+			// so a queued add is always dispatched before its spawn or ground item is freed.
+			switch (loaderEvent.EventType)
+			{
+				case LoaderEventType.AddSpawn:
+					DispatchAddSpawn(loaderEvent.Pointer, new SpawnHandle(loaderEvent.Handle), isBatched: true);
+					break;
+
+				case LoaderEventType.AddGroundItem:
+					HandleAddGroundItem(loaderEvent.Pointer);
+					break;
+
+				case LoaderEventType.BeginZone:
+					HandleBeginZone();
+					break;
+
+				case LoaderEventType.EndZone:
+					HandleEndZone();
+					break;
+
+				case LoaderEventType.Zoned:
+					HandleZoned();
+					break;
+
+				default:
+					_logger?.LogWarningPrefixed($"Unknown loader event type: {loaderEvent.EventType} (Sequence: {loaderEvent.Sequence})");
+					break;
+			}
+		}
+
+
+
 		private static readonly fMQEndZone _handleEndZone = HandleEndZone;
 		private static void HandleEndZone()
 		{
@@ -544,7 +923,7 @@ namespace MQ2DotNetCore
 				_logger?.LogTracePrefixed("Method was called");
 #endif
 
-				_submoduleRegistry.ExecuteForEachSubmodule(NotifyEndZone);
+				_submoduleRegistry.ExecuteForEachSubmodule(NotifyEndZone, nameof(LoaderCallback.EndZone));
 			}
 			catch (Exception exc)
 			{
@@ -568,17 +947,74 @@ namespace MQ2DotNetCore
 				var chatLineEventArgs = new ChatLineEventArgs(chatLine, color);
 
 				_submoduleRegistry.ExecuteForEachSubmodule(
-					(submoduleWrapper) => NotifyIncomingChat(submoduleWrapper, chatLineEventArgs));
+					(submoduleWrapper) => NotifyIncomingChat(submoduleWrapper, chatLineEventArgs), nameof(LoaderCallback.IncomingChat));
+			}
+			catch (Exception exc)
+			{
+				_logger?.LogErrorPrefixed(exc);
+
+			}
+
+			return 0;
+		}
+
+		private static readonly fIncomingChatMatched _handleIncomingChatMatched = HandleIncomingChatMatched;
+		private static uint HandleIncomingChatMatched(string chatLine, uint color, IntPtr matchedIds, uint matchedIdCount)
+		{
+			try
+			{
+#if DEBUG
+				_logger?.LogTracePrefixed("Method was called");
+#endif
+				var chatLineEventArgs = new ChatLineEventArgs(chatLine, color, null, CopyMatchedPatternIds(matchedIds, matchedIdCount));
+
+				_submoduleRegistry.ExecuteForEachSubmodule(
+					(submoduleWrapper) => NotifyIncomingChat(submoduleWrapper, chatLineEventArgs), nameof(LoaderCallback.IncomingChat));
 			}
 			catch (Exception exc)
 			{
 				_logger?.LogErrorPrefixed(exc);
+			}
 
+			return 0;
+		}
+
+		private static readonly fIncomingChatV2 _handleIncomingChatV2 = HandleIncomingChatV2;
+		private static uint HandleIncomingChatV2(IntPtr chatLine, uint chatLineLength, uint color, IntPtr matchedIds, uint matchedIdCount)
+		{
+			try
+			{
+#if DEBUG
+				_logger?.LogTracePrefixed("Method was called");
+#endif
+				var chatLineEventArgs = new ChatLineEventArgs(DecodeChatLine(chatLine, chatLineLength), color, null, CopyMatchedPatternIds(matchedIds, matchedIdCount));
+
+				_submoduleRegistry.ExecuteForEachSubmodule(
+					(submoduleWrapper) => NotifyIncomingChat(submoduleWrapper, chatLineEventArgs), nameof(LoaderCallback.IncomingChat));
+			}
+			catch (Exception exc)
+			{
+				_logger?.LogErrorPrefixed(exc);
 			}
 
 			return 0;
 		}
 
+		private static string DecodeChatLine(IntPtr chatLine, uint chatLineLength)
+			=> chatLineLength == 0 ? string.Empty : Marshal.PtrToStringUTF8(chatLine, (int)chatLineLength);
+
+		private static int[] CopyMatchedPatternIds(IntPtr matchedIds, uint matchedIdCount)
+		{
+			if (matchedIds == IntPtr.Zero || matchedIdCount == 0)
+			{
+				return Array.Empty<int>();
+			}
+
+			var patternIds = new int[matchedIdCount];
+			Marshal.Copy(matchedIds, patternIds, 0, patternIds.Length);
+			return patternIds;
+		}
+
 		private static void NotifyIncomingChat(SubmoduleProgramWrapper submodule, ChatLineEventArgs chatLineEventArgs)
 		{
 			try
@@ -608,7 +1044,23 @@ namespace MQ2DotNetCore
 		{
 			try
 			{
-				_mq2SynchronizationContext.DoEvents(true);
+				_mq2Instance.GCTelemetry.OnPulse();
+
+				if (_isLoaderEventBatchingEnabled)
+				{
+					HandleDrainLoaderEvents();
+				}
+
+				if (_isSpawnChangeFeedEnabled)
+				{
+					DispatchSpawnChanges();
+				}
+
+				_pulseSnapshotDispatcher.Dispatch(_submoduleRegistry);
+
+				// Continuations only run until the loader's pulse budget is used up, the rest wait for the next pulse
+				var pulseFrame = ReadPulseFrame();
+				_mq2SynchronizationContext.DoEvents(true, pulseFrame.StartTimestamp, pulseFrame.BudgetMicroseconds);
 
 				Interlocked.Increment(ref pulseCount);
 
@@ -641,6 +1093,20 @@ namespace MQ2DotNetCore
 
 					Interlocked.Exchange(ref pulseCount, 1);
 				}
+
+				if (LoaderCallbackSubscriptions.IsEnabled
+					&& !_submoduleRegistry.HasPrograms
+					&& !_mq2CommandRegistry.HasAsyncCommandTasks()
+					&& !_mq2SynchronizationContext.HasPendingContinuations)
+				{
+					LoaderCallbackSubscriptions.ReleasePulse();
+
+					// A continuation posted between the check and the release would otherwise wait for the next request
+					if (_mq2SynchronizationContext.HasPendingContinuations)
+					{
+						LoaderCallbackSubscriptions.RequestPulse();
+					}
+				}
 			}
 			catch (Exception exc)
 			{
@@ -650,6 +1116,36 @@ namespace MQ2DotNetCore
 
 
 
+		private static void DispatchSpawnChanges()
+		{
+			uint drainedCount;
+			do
+			{
+				drainedCount = MQ2DotNetCoreLoader.NativeMethods.SpawnChangeFeed__Drain(_spawnChangeBuffer, (uint)_spawnChangeBuffer.Length);
+				for (var index = 0; index < drainedCount; ++index)
+				{
+					_pendingSpawnChanges.Add(_spawnChangeBuffer[index]);
+				}
+			}
+			while (drainedCount == _spawnChangeBuffer.Length);
+
+			if (_pendingSpawnChanges.Count == 0)
+			{
+				return;
+			}
+
+			// Handlers may hold on to the changes, so every pulse with changes gets its own array
+			var spawnsChangedEventArgs = new SpawnsChangedEventArgs(_pendingSpawnChanges.ToArray());
+			_pendingSpawnChanges.Clear();
+
+			_submoduleRegistry.ExecuteForEachSubmodule(submodule => NotifySpawnsChanged(submodule, spawnsChangedEventArgs), "SpawnsChanged");
+		}
+
+		private static void NotifySpawnsChanged(SubmoduleProgramWrapper submodule, SpawnsChangedEventArgs spawnsChangedEventArgs)
+			=> submodule.MQ2Dependencies.GetEventRegistry().NotifySpawnsChanged(spawnsChangedEventArgs);
+
+
+
 		private static readonly fMQReloadUI _handleReloadUI = HandleReloadUI;
 		private static void HandleReloadUI()
 		{
@@ -658,7 +1154,7 @@ namespace MQ2DotNetCore
 #if DEBUG
 				_logger?.LogTracePrefixed("Method was called");
 #endif
-				_submoduleRegistry.ExecuteForEachSubmodule(NotifyReloadUI);
+				_submoduleRegistry.ExecuteForEachSubmodule(NotifyReloadUI, nameof(LoaderCallback.ReloadUI));
 			}
 			catch (Exception exc)
 			{
@@ -680,7 +1176,7 @@ namespace MQ2DotNetCore
 				_logger?.LogTracePrefixed("Method was called");
 #endif
 				_submoduleRegistry.ExecuteForEachSubmodule(
-					(submoduleWrapper) => NotifyRemoveGroundItem(submoduleWrapper, removedGroundItemPointer));
+					(submoduleWrapper) => NotifyRemoveGroundItem(submoduleWrapper, removedGroundItemPointer), nameof(LoaderCallback.RemoveGroundItem));
 			}
 			catch (Exception exc)
 			{
@@ -697,8 +1193,13 @@ namespace MQ2DotNetCore
 
 
 
+		// The loader releases the handle after these return, so handlers can still read the spawn. Removals are never batched.
 		private static readonly fMQSpawn _handleRemoveSpawn = HandleRemoveSpawn;
 		private static void HandleRemoveSpawn(IntPtr removedSpawnPointer)
+			=> HandleRemoveSpawnV2(removedSpawnPointer, MQ2DotNetCoreLoader.NativeMethods.SpawnHandleTable__Find(removedSpawnPointer));
+
+		private static readonly fSpawnV2 _handleRemoveSpawnV2 = HandleRemoveSpawnV2;
+		private static void HandleRemoveSpawnV2(IntPtr removedSpawnPointer, ulong handle)
 		{
 			try
 			{
@@ -706,8 +1207,9 @@ namespace MQ2DotNetCore
 				_logger?.LogTracePrefixed("Method was called");
 #endif
 
+				var spawnHandle = new SpawnHandle(handle);
 				_submoduleRegistry.ExecuteForEachSubmodule(
-					(submoduleWrapper) => NotifyRemoveSpawn(submoduleWrapper, removedSpawnPointer));
+					(submoduleWrapper) => NotifyRemoveSpawn(submoduleWrapper, removedSpawnPointer, spawnHandle), nameof(LoaderCallback.RemoveSpawn));
 			}
 			catch (Exception exc)
 			{
@@ -715,9 +1217,9 @@ namespace MQ2DotNetCore
 			}
 		}
 
-		private static void NotifyRemoveSpawn(SubmoduleProgramWrapper submodule, IntPtr removedSpawnPointer)
+		private static void NotifyRemoveSpawn(SubmoduleProgramWrapper submodule, IntPtr removedSpawnPointer, SpawnHandle handle)
 		{
-			var removedSpawn = new SpawnType(submodule.MQ2Dependencies.GetTypeFactory(), removedSpawnPointer);
+			var removedSpawn = submodule.MQ2Dependencies.GetSpawns().GetSpawn(handle, removedSpawnPointer);
 
 			submodule.MQ2Dependencies.GetEventRegistry().NotifyRemoveSpawn(removedSpawn);
 		}
@@ -738,7 +1240,7 @@ namespace MQ2DotNetCore
 					: GameState.Unknown;
 
 				_submoduleRegistry.ExecuteForEachSubmodule(
-					(submodule) => NotifySetGameState(submodule, gameState));
+					(submodule) => NotifySetGameState(submodule, gameState), nameof(LoaderCallback.SetGameState));
 			}
 			catch (Exception exc)
 			{
@@ -759,11 +1261,62 @@ namespace MQ2DotNetCore
 				// Keep Initialize and Shutdown at LogInformation(..) level
 				_logger?.LogInformationPrefixed("Method was called!");
 
+				if (_isLoaderEventBatchingEnabled)
+				{
+					MQ2DotNetCoreLoader.NativeMethods.LoaderEventRing__SetEnabled(false);
+					_isLoaderEventBatchingEnabled = false;
+				}
+
+				if (_isSpawnChangeFeedEnabled)
+				{
+					MQ2DotNetCoreLoader.NativeMethods.SpawnChangeFeed__SetFields(SpawnChangeFields.None);
+					_isSpawnChangeFeedEnabled = false;
+				}
+
+				MQ2DotNetCoreLoader.NativeMethods.SharedStateBus__Close();
+
+				// The runtime keeps its listeners in a static list, which would keep a hot reloaded copy from being collected
+				_mq2Instance.GCTelemetry.Disable();
+
+				if (_isMemberCacheEnabled)
+				{
+					MQ2DotNetCoreLoader.NativeMethods.MemberCache__SetEnabled(false);
+					MQ2DotNetCoreLoader.NativeMethods.MemberCache__ClearBypass();
+					_isMemberCacheEnabled = false;
+				}
+
+				LoaderCallbackSubscriptions.Disable();
+
+				JitWarmup.Stop();
+
+				// Worker handlers run submodule code, let them finish before the submodules are unloaded
+				if (!_pulseSnapshotDispatcher.WaitForHandlers(TimeSpan.FromSeconds(2)))
+				{
+					_logger?.LogWarningPrefixed("Pulse snapshot handlers were still running when the submodules were unloaded");
+				}
+
+				if (HotReloadState.IsHosted && MQ2DotNetCoreLoader.NativeMethods.LoaderHotReload__IsReloading())
+				{
+					var runningPrograms = _submoduleRegistry.GetRunningProgramArguments();
+					_logger?.LogInformationPrefixed($"Saving {runningPrograms.Length} running programs to restart after the reload");
+					HotReloadState.SaveRunningPrograms(runningPrograms);
+				}
+
 				_logger?.LogInformationPrefixed($"Disposing of the {nameof(SubmoduleRegistry)}...");
 				CleanupHelper.TryDispose(_submoduleRegistry, _logger);
 
 				_logger?.LogInformationPrefixed($"Disposing of the {nameof(MQ2CommandRegistry)}...");
 				CleanupHelper.TryDispose(_mq2CommandRegistry, _logger);
+
+				TaskScheduler.UnobservedTaskException -= HandleUnobservedTaskException;
+
+				// Anything still referencing this copy from outside of it would keep its load context from being collected
+				if (HotReloadState.IsHosted)
+				{
+					_logger?.LogInformationPrefixed("Releasing the configuration and logger factory so this copy can be unloaded");
+					ConfigurationHelper.ReleaseConfiguration();
+					CleanupHelper.TryDispose(_loggerFactory, null);
+				}
 			}
 			catch (Exception exc)
 			{
@@ -784,7 +1337,49 @@ namespace MQ2DotNetCore
 				var chatLineEventArgs = new ChatLineEventArgs(chatLine, color, filter);
 
 				_submoduleRegistry.ExecuteForEachSubmodule(
-					(submodule) => NotifyWriteChatColor(submodule, chatLineEventArgs));
+					(submodule) => NotifyWriteChatColor(submodule, chatLineEventArgs), nameof(LoaderCallback.WriteChatColor));
+			}
+			catch (Exception exc)
+			{
+				_logger?.LogErrorPrefixed(exc);
+			}
+
+			return 0;
+		}
+
+		private static readonly fWriteChatColorMatched _handleWriteChatColorMatched = HandleWriteChatColorMatched;
+		private static uint HandleWriteChatColorMatched(string chatLine, uint color, uint filter, IntPtr matchedIds, uint matchedIdCount)
+		{
+			try
+			{
+#if DEBUG
+				_logger?.LogTracePrefixed("Method was called");
+#endif
+				var chatLineEventArgs = new ChatLineEventArgs(chatLine, color, filter, CopyMatchedPatternIds(matchedIds, matchedIdCount));
+
+				_submoduleRegistry.ExecuteForEachSubmodule(
+					(submodule) => NotifyWriteChatColor(submodule, chatLineEventArgs), nameof(LoaderCallback.WriteChatColor));
+			}
+			catch (Exception exc)
+			{
+				_logger?.LogErrorPrefixed(exc);
+			}
+
+			return 0;
+		}
+
+		private static readonly fWriteChatColorV2 _handleWriteChatColorV2 = HandleWriteChatColorV2;
+		private static uint HandleWriteChatColorV2(IntPtr chatLine, uint chatLineLength, uint color, uint filter, IntPtr matchedIds, uint matchedIdCount)
+		{
+			try
+			{
+#if DEBUG
+				_logger?.LogTracePrefixed("Method was called");
+#endif
+				var chatLineEventArgs = new ChatLineEventArgs(DecodeChatLine(chatLine, chatLineLength), color, filter, CopyMatchedPatternIds(matchedIds, matchedIdCount));
+
+				_submoduleRegistry.ExecuteForEachSubmodule(
+					(submodule) => NotifyWriteChatColor(submodule, chatLineEventArgs), nameof(LoaderCallback.WriteChatColor));
 			}
 			catch (Exception exc)
 			{
@@ -825,7 +1420,7 @@ namespace MQ2DotNetCore
 #if DEBUG
 				_logger?.LogTracePrefixed("Method was called");
 #endif
-				_submoduleRegistry.ExecuteForEachSubmodule(NotifyZoned);
+				_submoduleRegistry.ExecuteForEachSubmodule(NotifyZoned, nameof(LoaderCallback.Zoned));
 			}
 			catch (Exception exc)
 			{
@@ -6,6 +6,18 @@ namespace MQ2DotNetCore.Logging
 {
 	public static class ILoggingBuilderExtensions
 	{
+		public static ILoggingBuilder AddLoader(this ILoggingBuilder loggingBuilder)
+		{
+			if (loggingBuilder == null)
+			{
+				throw new ArgumentNullException(nameof(loggingBuilder));
+			}
+
+			loggingBuilder.Services.AddSingleton<ILoggerProvider, LoaderLoggerProvider>();
+
+			return loggingBuilder;
+		}
+
 		public static ILoggingBuilder AddMQ2(this ILoggingBuilder loggingBuilder)
 		{
 			if (loggingBuilder == null)
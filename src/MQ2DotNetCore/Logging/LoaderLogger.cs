@@ -0,0 +1,93 @@
+﻿using Microsoft.Extensions.Logging;
+using MQ2DotNetCore.Interop;
+using System;
+using System.Buffers;
+using System.Text;
+
+namespace MQ2DotNetCore.Logging
+{
+	/// <summary>
+	/// Encodes each record as UTF-8 into a pooled buffer and pushes it into the loader's log ring. Never waits, if the ring is full the
+	/// record is dropped and the loader counts it.
+	/// </summary>
+	public class LoaderLogger : ILogger
+	{
+		[ThreadStatic]
+		private static StringBuilder? _builder;
+
+		private readonly byte[] _categoryUtf8;
+		private readonly LoaderLoggerProvider _provider;
+
+		public LoaderLogger(
+			string categoryName,
+			LoaderLoggerProvider provider
+		)
+		{
+			_categoryUtf8 = Encoding.UTF8.GetBytes(categoryName ?? string.Empty);
+			_provider = provider ?? throw new ArgumentNullException(nameof(provider));
+		}
+
+		public IDisposable? BeginScope<TState>(TState state)
+		{
+			return _provider.ScopeProvider?.Push(state);
+		}
+
+		public bool IsEnabled(LogLevel logLevel)
+		{
+			// The aggregate logger handles the filters
+			return logLevel != LogLevel.None;
+		}
+
+		public void Log<TState>(LogLevel logLevel, EventId eventId, TState state, Exception exception, Func<TState, Exception, string> formatter)
+		{
+			if (!IsEnabled(logLevel))
+			{
+				return;
+			}
+
+			byte[]? messageUtf8 = null;
+			try
+			{
+				var builder = _builder ??= new StringBuilder();
+				builder.Clear();
+
+				_provider.ScopeProvider?.ForEachScope((scope, stringBuilder) => stringBuilder.Append(scope).Append(" => "), builder);
+				if (builder.Length > 0)
+				{
+					builder.Length -= " => ".Length;
+					builder.AppendLine(":");
+				}
+
+				builder.Append(formatter?.Invoke(state, exception));
+
+				if (exception != null)
+				{
+					builder.AppendLine().Append(exception);
+				}
+
+				var message = builder.ToString();
+				messageUtf8 = ArrayPool<byte>.Shared.Rent(Encoding.UTF8.GetMaxByteCount(message.Length));
+				var messageLength = Encoding.UTF8.GetBytes(message, 0, message.Length, messageUtf8, 0);
+
+				MQ2DotNetCoreLoader.NativeMethods.LoaderLog__Write((uint)logLevel, _categoryUtf8, (uint)_categoryUtf8.Length, messageUtf8, (uint)messageLength);
+			}
+#pragma warning disable RCS1075 // Avoid empty catch clause that catches System.Exception.
+#pragma warning disable CS0168 // Variable is declared but never used
+			catch (Exception exc)
+#pragma warning restore CS0168 // Variable is declared but never used
+#pragma warning restore RCS1075 // Avoid empty catch clause that catches System.Exception.
+			{
+#if DEBUG
+				Console.Write(exc);
+#endif
+			}
+			finally
+			{
+				if (messageUtf8 != null)
+				{
+					ArrayPool<byte>.Shared.Return(messageUtf8);
+				}
+			}
+		}
+	}
+}
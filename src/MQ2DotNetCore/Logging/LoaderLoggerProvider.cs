@@ -0,0 +1,28 @@
+﻿using Microsoft.Extensions.Logging;
+
+namespace MQ2DotNetCore.Logging
+{
+	/// <summary>
+	/// An <see cref="ILoggerProvider" /> implementation that hands records to the loader's log ring, which its writer thread appends
+	/// to debug_plugin.log along with the loader's own lines
+	/// </summary>
+	[ProviderAlias("Loader")]
+	public class LoaderLoggerProvider : ILoggerProvider, ISupportExternalScope
+	{
+		public IExternalScopeProvider? ScopeProvider { get; private set; }
+
+		public ILogger CreateLogger(string categoryName)
+		{
+			return new LoaderLogger(categoryName, this);
+		}
+
+		public void Dispose()
+		{
+		}
+
+		public void SetScopeProvider(IExternalScopeProvider scopeProvider)
+		{
+			ScopeProvider = scopeProvider;
+		}
+	}
+}
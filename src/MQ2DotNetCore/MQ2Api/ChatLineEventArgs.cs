@@ -1,17 +1,43 @@
 ﻿using System;
+using System.Collections.Generic;
 
 namespace MQ2DotNetCore.MQ2Api
 {
 	public class ChatLineEventArgs : EventArgs
 	{
-		public ChatLineEventArgs(string chatLine, uint color, uint? filter = null)
+		public ChatLineEventArgs(string chatLine, uint color, uint? filter = null, IReadOnlyList<int>? matchedPatternIds = null)
 		{
 			ChatLine = chatLine;
 			Color = color;
+			Filter = filter;
+			MatchedPatternIds = matchedPatternIds ?? Array.Empty<int>();
 		}
 
 		public string ChatLine { get; }
 		public uint Color { get; }
 		public uint? Filter { get; }
+
+		/// <summary>
+		/// Ids of the chat patterns (see <see cref="ChatUtilities.AddPattern(string, ChatSource, uint, uint)"/>) that matched this line.
+		/// Empty if the line didn't match any registered pattern.
+		/// </summary>
+		public IReadOnlyList<int> MatchedPatternIds { get; }
+
+		/// <summary>
+		/// Returns true if the chat pattern with the given id matched this line
+		/// </summary>
+		/// <param name="patternId">The id returned by <see cref="ChatUtilities.AddPattern(string, ChatSource, uint, uint)"/></param>
+		public bool IsMatch(int patternId)
+		{
+			for (var index = 0; index < MatchedPatternIds.Count; ++index)
+			{
+				if (MatchedPatternIds[index] == patternId)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
 	}
 }
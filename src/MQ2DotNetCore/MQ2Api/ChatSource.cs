@@ -0,0 +1,26 @@
+﻿using System;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// Chat sources a registered chat pattern applies to. Values mirror the ChatSource enum in the loader's ChatFilter.h
+	/// </summary>
+	[Flags]
+	public enum ChatSource : uint
+	{
+		/// <summary>
+		/// Lines from EQ (OnIncomingChat)
+		/// </summary>
+		EQ = 0x1,
+
+		/// <summary>
+		/// Lines from MQ2 (OnWriteChatColor)
+		/// </summary>
+		MQ2 = 0x2,
+
+		/// <summary>
+		/// Lines from either EQ or MQ2
+		/// </summary>
+		Any = EQ | MQ2
+	}
+}
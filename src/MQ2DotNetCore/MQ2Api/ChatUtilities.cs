@@ -1,5 +1,8 @@
 ﻿using JetBrains.Annotations;
+using MQ2DotNetCore.Base;
+using MQ2DotNetCore.Interop;
 using System;
+using System.Collections.Generic;
 using System.Threading;
 using System.Threading.Tasks;
 
@@ -9,8 +12,11 @@ namespace MQ2DotNetCore.MQ2Api
 	/// Contains utility methods and properties relating to ingame chat (messages in a chat window, from EQ or MQ2)
 	/// </summary>
 	[PublicAPI]
-	public class ChatUtilities
+	public class ChatUtilities : IDisposable
 	{
+		private bool _isDisposed = false;
+		private readonly object _lock = new object();
+		private readonly List<int> _patternIds = new List<int>();
 		private readonly MQ2SubmoduleEventRegistry _submoduleEventRegistry;
 
 		internal ChatUtilities(MQ2SubmoduleEventRegistry submoduleEventRegistry)
@@ -18,6 +24,84 @@ namespace MQ2DotNetCore.MQ2Api
 			_submoduleEventRegistry = submoduleEventRegistry;
 		}
 
+		/// <summary>
+		/// Removes any chat patterns this instance registered with the loader
+		/// </summary>
+		public void Dispose()
+		{
+			if (_isDisposed)
+			{
+				return;
+			}
+
+			lock (_lock)
+			{
+				foreach (var patternId in _patternIds)
+				{
+					MQ2DotNetCoreLoader.NativeMethods.ChatFilter__RemovePattern(patternId);
+				}
+
+				_patternIds.Clear();
+			}
+
+			_isDisposed = true;
+		}
+
+		/// <summary>
+		/// Register a chat pattern with the loader's native pre-filter. Matching lines carry the returned id in
+		/// <see cref="ChatLineEventArgs.MatchedPatternIds"/>, and when the IsNativeChatFilterEnabled option is set only lines that match
+		/// at least one registered pattern are forwarded to the OnChat* events at all.
+		/// </summary>
+		/// <param name="pattern">
+		/// Case insensitive text to match. Without wildcards it matches anywhere in the line. With * (any run of characters) or ? (any single character)
+		/// it must match the whole line, e.g. "* tells you, '*'"
+		/// </param>
+		/// <param name="source">Which chat source(s) the pattern applies to</param>
+		/// <param name="color">Only match lines with this chat color, or 0 for any color</param>
+		/// <param name="filterMask">Only match MQ2 lines whose filter value N has bit N set, or 0 for any filter</param>
+		/// <returns>The pattern id</returns>
+		public int AddPattern(string pattern, ChatSource source = ChatSource.Any, uint color = 0, uint filterMask = 0)
+		{
+			CleanupHelper.DisposedCheck(_isDisposed, nameof(ChatUtilities));
+
+			if (string.IsNullOrEmpty(pattern))
+			{
+				throw new ArgumentNullException(nameof(pattern), "cannot be null or empty.");
+			}
+
+			lock (_lock)
+			{
+				var patternId = MQ2DotNetCoreLoader.NativeMethods.ChatFilter__AddPattern(pattern, (uint)source, color, filterMask);
+				if (patternId <= 0)
+				{
+					throw new InvalidOperationException($"The loader failed to register the chat pattern: {pattern}");
+				}
+
+				_patternIds.Add(patternId);
+				return patternId;
+			}
+		}
+
+		/// <summary>
+		/// Remove a chat pattern previously registered with <see cref="AddPattern(string, ChatSource, uint, uint)"/>
+		/// </summary>
+		/// <param name="patternId">The pattern id</param>
+		/// <returns>True if the pattern was removed</returns>
+		public bool RemovePattern(int patternId)
+		{
+			CleanupHelper.DisposedCheck(_isDisposed, nameof(ChatUtilities));
+
+			lock (_lock)
+			{
+				if (!_patternIds.Remove(patternId))
+				{
+					return false;
+				}
+
+				return MQ2DotNetCoreLoader.NativeMethods.ChatFilter__RemovePattern(patternId);
+			}
+		}
+
 		/// <summary>
 		/// Wait indefinitely for a line of chat from either EQ or MQ2 matching <paramref name="predicate"/>
 		/// </summary>
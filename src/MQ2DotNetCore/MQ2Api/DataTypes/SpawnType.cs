@@ -41,6 +41,35 @@ namespace MQ2DotNetCore.MQ2Api.DataTypes
 			CachedBuff = new IndexedMember<CachedBuffType>(this, "CachedBuff");
 		}
 
+		/// <summary>
+		/// Create a SpawnType for a spawn in the loader's handle table, see <see cref="MQ2Spawns.GetSpawn(SpawnHandle)"/>
+		/// </summary>
+		internal SpawnType(MQ2TypeFactory mq2TypeFactory, SpawnHandle handle, IntPtr pSpawn)
+			: this(mq2TypeFactory, pSpawn)
+		{
+			Handle = handle;
+		}
+
+		/// <summary>
+		/// Create a SpawnType that is always stale, for a spawn whose pointer can't be checked, see <see cref="MQ2Spawns.GetBatchedSpawn"/>
+		/// </summary>
+		internal SpawnType(MQ2TypeFactory mq2TypeFactory, IntPtr pSpawn, bool isUntracked)
+			: this(mq2TypeFactory, pSpawn)
+		{
+			_isUntracked = isUntracked;
+		}
+
+		private readonly bool _isUntracked;
+
+		/// <summary>
+		/// The spawn's handle, or <see cref="SpawnHandle.None"/> if this SpawnType wasn't created from one, e.g. when it was returned
+		/// by a member such as Target. Once the handle is released, because the spawn left the zone, the SpawnType is stale and
+		/// every member returns null instead of reading the freed spawn.
+		/// </summary>
+		public SpawnHandle Handle { get; }
+
+		private protected override bool IsStale => _isUntracked || (!Handle.IsNone && !SpawnHandleTable.TryResolve(Handle, out _));
+
 		/// <summary>
 		/// Dunno wtf this is or why I would care about it
 		/// </summary>
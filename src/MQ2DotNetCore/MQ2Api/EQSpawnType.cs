@@ -0,0 +1,12 @@
+﻿namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// The raw SPAWNINFO::Type value of a spawn
+	/// </summary>
+	public enum EQSpawnType : byte
+	{
+		Player = 0,
+		NPC = 1,
+		Corpse = 2
+	}
+}
@@ -0,0 +1,100 @@
+﻿using JetBrains.Annotations;
+using MQ2DotNetCore.Base;
+using MQ2DotNetCore.Interop;
+using System;
+using System.Text;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// A macro expression compiled once by the loader, see <see cref="MQ2.Compile(string)"/>. Evaluating it skips re-tokenizing the
+	/// expression and looking up its TLOs, and reuses the same buffer every time. Must be evaluated on the EQ thread and disposed
+	/// when it is no longer needed, plans live in the loader until they are released.
+	/// </summary>
+	[PublicAPI]
+	public sealed class ExpressionPlan : IDisposable
+	{
+		private byte[] _buffer = new byte[256];
+		private int _handle;
+
+		internal ExpressionPlan(string expression)
+		{
+			Expression = expression;
+			_handle = MQ2DotNetCoreLoader.NativeMethods.ExpressionPlan__Compile(expression);
+			if (_handle == 0)
+			{
+				throw new ArgumentException("Expression must not be empty", nameof(expression));
+			}
+		}
+
+		public string Expression { get; }
+
+		/// <inheritdoc />
+		public void Dispose()
+		{
+			if (_handle == 0)
+			{
+				return;
+			}
+
+			MQ2DotNetCoreLoader.NativeMethods.ExpressionPlan__Release(_handle);
+			_handle = 0;
+		}
+
+		/// <summary>
+		/// Same as <see cref="MQ2.Calculate(string, bool)"/> with parse = true
+		/// </summary>
+		/// <exception cref="FormatException">The parsed expression isn't a valid formula</exception>
+		public double Calculate()
+		{
+			CleanupHelper.DisposedCheck(_handle == 0, nameof(ExpressionPlan));
+
+			if (!MQ2DotNetCoreLoader.NativeMethods.ExpressionPlan__Calculate(_handle, out var result))
+			{
+				throw new FormatException("Could not calculate expression: " + Expression);
+			}
+
+			return result;
+		}
+
+		/// <summary>
+		/// Same as <see cref="MQ2.Parse(string)"/>
+		/// </summary>
+		/// <exception cref="FormatException">The expression couldn't be parsed</exception>
+		public string Evaluate()
+		{
+			CleanupHelper.DisposedCheck(_handle == 0, nameof(ExpressionPlan));
+
+			uint length;
+			while (true)
+			{
+				if (!MQ2DotNetCoreLoader.NativeMethods.ExpressionPlan__Evaluate(_handle, _buffer, (uint)_buffer.Length, out length))
+				{
+					throw new FormatException("Could not parse expression: " + Expression);
+				}
+
+				if (length < _buffer.Length)
+				{
+					break;
+				}
+
+				_buffer = new byte[Math.Max(_buffer.Length * 2, (int)length + 1)];
+			}
+
+			return Encoding.UTF8.GetString(_buffer, 0, (int)length);
+		}
+
+		/// <summary>
+		/// Same as <see cref="MQ2.If(string, bool)"/> with parse = true
+		/// </summary>
+		public bool If()
+		{
+			// ReSharper disable once CompareOfFloatsByEqualityOperator
+			return Calculate() != 0.0;
+		}
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> Expression;
+	}
+}
@@ -0,0 +1,56 @@
+﻿using JetBrains.Annotations;
+using System;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// What the GC did between two pulses, from <see cref="MQ2GCTelemetry.LastPulse"/>
+	/// </summary>
+	[PublicAPI]
+	public readonly struct GCPulseStatistics
+	{
+		internal GCPulseStatistics(long allocatedBytes, int gen0Collections, int gen1Collections, int gen2Collections, uint blockingGen2Collections,
+			uint pauseCount, TimeSpan pauseTime, TimeSpan longestPause)
+		{
+			AllocatedBytes = allocatedBytes;
+			Gen0Collections = gen0Collections;
+			Gen1Collections = gen1Collections;
+			Gen2Collections = gen2Collections;
+			BlockingGen2Collections = blockingGen2Collections;
+			PauseCount = pauseCount;
+			PauseTime = pauseTime;
+			LongestPause = longestPause;
+		}
+
+		/// <summary>
+		/// Bytes allocated by every thread in the process, not just the EQ thread
+		/// </summary>
+		public long AllocatedBytes { get; }
+
+		public int Gen0Collections { get; }
+		public int Gen1Collections { get; }
+
+		/// <summary>
+		/// Gen2 collections, including background ones that mostly run alongside the EQ thread
+		/// </summary>
+		public int Gen2Collections { get; }
+
+		/// <summary>
+		/// Gen2 collections that suspended the EQ thread for all of their work, e.g. what a "no Gen2 during combat" budget should check
+		/// </summary>
+		public uint BlockingGen2Collections { get; }
+
+		/// <summary>
+		/// Pauses the runtime reported since the previous pulse, see <see cref="MQ2GCTelemetry"/>
+		/// </summary>
+		public uint PauseCount { get; }
+
+		public TimeSpan PauseTime { get; }
+		public TimeSpan LongestPause { get; }
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[Allocated: {AllocatedBytes / 1024.0:0.0} KB, Collections: {Gen0Collections}/{Gen1Collections}/{Gen2Collections}, BlockingGen2: {BlockingGen2Collections}, "
+				+ $"Pauses: {PauseCount}, PauseTime: {PauseTime.TotalMilliseconds:0.###} ms, LongestPause: {LongestPause.TotalMilliseconds:0.###} ms]";
+	}
+}
@@ -0,0 +1,12 @@
+﻿namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// Which of the character's item containers an <see cref="InventorySlot"/> is in. Mirrors the InventoryContainer enum in InventoryIndex.h
+	/// </summary>
+	public enum InventoryContainer : byte
+	{
+		Inventory = 0,
+		Bank = 1,
+		SharedBank = 2
+	}
+}
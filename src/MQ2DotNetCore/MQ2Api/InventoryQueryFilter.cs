@@ -0,0 +1,16 @@
+﻿using System;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// Which containers an <see cref="MQ2Inventory"/> lookup should search, one bit per <see cref="InventoryContainer"/>
+	/// </summary>
+	[Flags]
+	public enum InventoryQueryFilter : uint
+	{
+		Any = 0,
+		Inventory = 1 << InventoryContainer.Inventory,
+		Bank = 1 << InventoryContainer.Bank,
+		SharedBank = 1 << InventoryContainer.SharedBank
+	}
+}
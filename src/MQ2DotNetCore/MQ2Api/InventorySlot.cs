@@ -0,0 +1,52 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// Where an item returned by one of the <see cref="MQ2Inventory"/> lookups is. Mirrors the InventorySlot struct in InventoryIndex.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	public readonly struct InventorySlot
+	{
+		private readonly uint _itemId;
+		private readonly uint _stackCount;
+		private readonly ushort _slot;
+		private readonly short _bagSlot;
+		private readonly InventoryContainer _container;
+
+		internal InventorySlot(int itemId, int stackCount, InventoryContainer container, int slot, int bagSlot)
+		{
+			_itemId = (uint)itemId;
+			_stackCount = (uint)stackCount;
+			_slot = (ushort)slot;
+			_bagSlot = (short)bagSlot;
+			_container = container;
+		}
+
+		public int ItemId => (int)_itemId;
+
+		/// <summary>
+		/// Number of items in the stack, 1 for items that don't stack
+		/// </summary>
+		public int StackCount => (int)_stackCount;
+
+		public InventoryContainer Container => _container;
+
+		/// <summary>
+		/// The slot in the container, numbered the same as MQ2's inventory, bank and shared bank slots. For an item in a bag, the
+		/// slot the bag is in.
+		/// </summary>
+		public int Slot => _slot;
+
+		/// <summary>
+		/// The slot in the bag, or -1 if the item isn't in a bag
+		/// </summary>
+		public int BagSlot => _bagSlot;
+
+		public bool IsInBag => _bagSlot >= 0;
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[ItemId: {ItemId}, StackCount: {StackCount}, Container: {Container}, Slot: {Slot}, BagSlot: {BagSlot}]";
+	}
+}
@@ -1,5 +1,6 @@
 ﻿using MQ2DotNetCore.Interop;
 using System;
+using System.Runtime.InteropServices;
 using System.Text;
 
 namespace MQ2DotNetCore.MQ2Api
@@ -16,6 +17,21 @@ namespace MQ2DotNetCore.MQ2Api
 			_mq2NativeHelper = mq2NativeHelper ?? throw new ArgumentNullException(nameof(mq2NativeHelper));
 		}
 
+		/// <summary>
+		/// Allocations, collections and GC pauses per pulse, see <see cref="MQ2GCTelemetry"/>
+		/// </summary>
+		public MQ2GCTelemetry GCTelemetry { get; } = new MQ2GCTelemetry();
+
+		/// <summary>
+		/// Item lookups by id or name over the character's inventory, bank and shared bank, see <see cref="MQ2Inventory"/>
+		/// </summary>
+		public MQ2Inventory Inventory { get; } = new MQ2Inventory();
+
+		/// <summary>
+		/// State and messages shared with the other clients on this machine, see <see cref="MQ2StateBus"/>
+		/// </summary>
+		public MQ2StateBus StateBus { get; } = new MQ2StateBus();
+
 		/// <summary>
 		/// Uses MQ2's parser to evaluate a formula
 		/// </summary>
@@ -37,6 +53,21 @@ namespace MQ2DotNetCore.MQ2Api
 			return result;
 		}
 
+		/// <summary>
+		/// Compiles an expression into a plan that can be evaluated repeatedly without MQ2 re-parsing it, e.g. for expressions that
+		/// are checked every pulse. Plans for the same expression text are shared by the loader. Dispose the plan when done with it.
+		/// </summary>
+		/// <param name="expression">Expression to compile, as it would be passed to <see cref="Parse(string)"/></param>
+		public ExpressionPlan Compile(string expression)
+		{
+			if (string.IsNullOrEmpty(expression))
+			{
+				throw new ArgumentNullException(nameof(expression));
+			}
+
+			return new ExpressionPlan(expression);
+		}
+
 		/// <summary>
 		/// Execute a command, exactly as if you typed it in the chat window
 		/// Note: whether this will parse MQ2 variables or not depends only on the command entered. Use /noparse to force no parsing
@@ -51,6 +82,18 @@ namespace MQ2DotNetCore.MQ2Api
 			}
 
 			MQ2Main.NativeMethods.MQ2HideDoCommand(characterSpawnIntPointer, command, false);
+
+			// The command may have changed game state, e.g. /target, so nothing read earlier in the pulse can be reused
+			MQ2DotNetCoreLoader.NativeMethods.MemberCache__Invalidate();
+		}
+
+		/// <summary>
+		/// Drops every TLO / member value the loader's member cache is holding for the rest of the pulse. Only needed after changing
+		/// game state through something other than <see cref="DoCommand"/>.
+		/// </summary>
+		public void InvalidateMemberCache()
+		{
+			MQ2DotNetCoreLoader.NativeMethods.MemberCache__Invalidate();
 		}
 
 		/// <summary>
@@ -72,13 +115,76 @@ namespace MQ2DotNetCore.MQ2Api
 		/// <returns>Parsed expression</returns>
 		public string Parse(string expression)
 		{
-			var stringBuilder = new StringBuilder(expression, 2047);
-			if (!MQ2Main.NativeMethods.MQ2ParseMacroData(stringBuilder, (uint)stringBuilder.Capacity + 1))
+			var result = ParseUtf8(expression);
+			return result.IsEmpty ? string.Empty : Encoding.UTF8.GetString(result);
+		}
+
+		/// <summary>
+		/// Parse any MQ2 variables in <paramref name="expression"/> and write the resulting text, as UTF-8, into
+		/// <paramref name="destination"/> without allocating
+		/// </summary>
+		/// <param name="expression">Expression to parse</param>
+		/// <param name="destination">Buffer to write to, the text is null terminated if it fits</param>
+		/// <param name="isTruncated">Set if the text didn't fit, the buffer then holds as many whole characters as fit</param>
+		/// <returns>The full length of the parsed text in bytes, excluding the terminator</returns>
+		public int Parse(ReadOnlySpan<char> expression, Span<byte> destination, out bool isTruncated)
+		{
+			Span<byte> encodedExpression = stackalloc byte[MaxEncodedExpressionSize];
+			EncodeExpression(expression, encodedExpression);
+
+			var length = MQ2DotNetCoreLoader.NativeMethods.MQ2Main__ParseMacroDataUtf8(
+				ref MemoryMarshal.GetReference(encodedExpression),
+				ref MemoryMarshal.GetReference(destination),
+				(uint)destination.Length,
+				out var flags
+			);
+
+			if (length < 0)
+			{
+				throw new FormatException("Could not parse expression: " + expression.ToString());
+			}
+
+			isTruncated = (flags & MQ2DotNetCoreLoader.TextResultTruncated) != 0;
+			return length;
+		}
+
+		/// <summary>
+		/// Parse any MQ2 variables in <paramref name="expression"/> and return the resulting text as UTF-8 without allocating. The
+		/// span points into the loader's pulse arena and is only valid until the start of the next pulse, copy it if it needs
+		/// to live longer.
+		/// </summary>
+		/// <param name="expression">Expression to parse</param>
+		/// <returns>The parsed text, excluding the terminator</returns>
+		public unsafe ReadOnlySpan<byte> ParseUtf8(ReadOnlySpan<char> expression)
+		{
+			Span<byte> encodedExpression = stackalloc byte[MaxEncodedExpressionSize];
+			EncodeExpression(expression, encodedExpression);
+
+			var pText = MQ2DotNetCoreLoader.NativeMethods.MQ2Main__ParseMacroDataArena(ref MemoryMarshal.GetReference(encodedExpression), out var length);
+			if (pText != IntPtr.Zero)
+			{
+				return new ReadOnlySpan<byte>(pText.ToPointer(), (int)length);
+			}
+
+			// The arena is full (e.g. something is parsing outside of pulses) or the expression was invalid, the span version
+			// reports which
+			var buffer = new byte[MaxEncodedExpressionSize];
+			var textLength = Parse(expression, buffer, out _);
+			return new ReadOnlySpan<byte>(buffer, 0, Math.Min(textLength, buffer.Length));
+		}
+
+		// MQ2 expressions and results are at most MAX_STRING (2048) characters, which can be up to 3 bytes each in UTF-8
+		private const int MaxEncodedExpressionSize = 2048 * 3;
+
+		private static void EncodeExpression(ReadOnlySpan<char> expression, Span<byte> destination)
+		{
+			if (expression.Length >= 2048)
 			{
-				throw new FormatException("Could not parse expression: " + expression);
+				throw new FormatException("Could not parse expression, it is longer than 2047 characters");
 			}
 
-			return stringBuilder.ToString();
+			var length = Encoding.UTF8.GetBytes(expression, destination);
+			destination[length] = 0;
 		}
 
 		/// <summary>
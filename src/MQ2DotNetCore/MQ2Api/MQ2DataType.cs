@@ -40,7 +40,7 @@ namespace MQ2DotNetCore.MQ2Api
 		/// <param name="typeFactory">MQ2TypeFactory to use with GetMember calls</param>
 		/// <param name="varPtr"></param>
 		protected MQ2DataType(string typeName, MQ2TypeFactory typeFactory, MQ2VarPtr varPtr)
-			: this(typeFactory, new MQ2TypeVar { pType = MQ2Main.NativeMethods.FindMQ2DataType(typeName), VarPtr = varPtr })
+			: this(typeFactory, new MQ2TypeVar { pType = InternTable.FindType(typeName), VarPtr = varPtr })
 		{
 			if (_typeVar.pType == IntPtr.Zero)
 				throw new KeyNotFoundException($"MQ2Type not found: {typeName}");
@@ -51,10 +51,53 @@ namespace MQ2DotNetCore.MQ2Api
 		/// </summary>
 		protected MQ2VarPtr VarPtr => _typeVar.VarPtr;
 
+		/// <summary>
+		/// The wrapped variable, used as the root of <see cref="MemberBatch"/> paths
+		/// </summary>
+		internal MQ2TypeVar TypeVar => _typeVar;
+
+		/// <summary>
+		/// True once the object the variable points at is known to be gone, e.g. a spawn that left the zone. Members of a stale
+		/// variable are never read, they come back null.
+		/// </summary>
+		private protected virtual bool IsStale => false;
+
 		/// <inheritdoc />
 		public override string ToString()
 		{
-			return _typeVar.ToString();
+			return IsStale ? string.Empty : _typeVar.ToString();
+		}
+
+		/// <summary>
+		/// Writes the variable's text, as UTF-8, into <paramref name="destination"/> without allocating
+		/// </summary>
+		/// <param name="destination">Buffer to write to, the text is null terminated if it fits</param>
+		/// <param name="isTruncated">Set if the text didn't fit, the buffer then holds as many whole characters as fit</param>
+		/// <returns>The full length of the text in bytes, excluding the terminator</returns>
+		public int ToUtf8(Span<byte> destination, out bool isTruncated)
+		{
+			if (IsStale)
+			{
+				isTruncated = false;
+				if (destination.Length > 0)
+				{
+					destination[0] = 0;
+				}
+
+				return 0;
+			}
+
+			return _typeVar.ToUtf8(destination, out isTruncated);
+		}
+
+		/// <summary>
+		/// Gets the variable's text as UTF-8 without allocating. The span points into the loader's pulse arena and is only valid
+		/// until the start of the next pulse, copy it if it needs to live longer.
+		/// </summary>
+		/// <returns>The text, excluding the terminator, or an empty span if it couldn't be read</returns>
+		public ReadOnlySpan<byte> ToUtf8Span()
+		{
+			return IsStale ? ReadOnlySpan<byte>.Empty : _typeVar.ToUtf8Span();
 		}
 
 		/// <summary>
@@ -65,9 +108,23 @@ namespace MQ2DotNetCore.MQ2Api
 		/// <param name="index"></param>
 		/// <returns>The member if the call succeeded and was able to be cast to the <typeparamref name="T"/>, otherwise null</returns>
 		/// <exception cref="InvalidCastException" />
+		/// <remarks>
+		/// The name is only passed to the loader the first time it's read, after that the read passes its id from the loader's
+		/// intern table
+		/// </remarks>
 		protected T? GetMember<T>(string name, string? index = "") where T : MQ2DataType
 		{
-			if (index == null || !_typeVar.TryGetMember(name, index, out var result))
+			if (index == null || IsStale)
+			{
+				return default;
+			}
+
+			var memberId = InternTable.GetMemberId(name);
+			var wasGetMemberSuccessful = memberId != 0
+				? _typeVar.TryGetMember(memberId, index, out var result)
+				: _typeVar.TryGetMember(name, index, out result);
+
+			if (!wasGetMemberSuccessful)
 			{
 				return default;
 			}
@@ -103,6 +103,7 @@ namespace MQ2DotNetCore.MQ2Api
 				return;
 			}
 
+			CleanupHelper.TryDispose(_chat, _logger);
 			CleanupHelper.TryDispose(_commandRegistry, _logger);
 			CleanupHelper.TryDispose(_eventRegistry, _logger);
 			CleanupHelper.TryDispose(_mq2TypeFactory, _logger);
@@ -0,0 +1,174 @@
+﻿using JetBrains.Annotations;
+using MQ2DotNetCore.Base;
+using System;
+using System.Runtime;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// Allocations, collections and GC pauses per pulse, when <see cref="MQ2DotNetCoreOptions.IsGCTelemetryEnabled"/> is set, so
+	/// programs can hold themselves to a budget, e.g. checking <see cref="GCPulseStatistics.BlockingGen2Collections"/> while in
+	/// combat. Pause times come from the runtime's GC events, which arrive on a thread of their own shortly after the pause, so
+	/// <see cref="LastPulse"/> has the pauses reported since the previous pulse. The GC mode itself is set by the loader's
+	/// [Runtime] settings. Must be called from the EQ thread.
+	/// </summary>
+	[PublicAPI]
+	public sealed class MQ2GCTelemetry
+	{
+		private GCPauseListener? _pauseListener;
+
+		private long _lastAllocatedBytes;
+		private int _lastGen0Count;
+		private int _lastGen1Count;
+		private int _lastGen2Count;
+
+		private long _pulseCount;
+		private long _totalAllocatedBytes;
+		private long _mostAllocatedBytes;
+		private long _totalBlockingGen2Count;
+
+		private GCLatencyMode _suppressedLatencyMode;
+		private int _suppressionDepth;
+		private int _suppressionGen2Count;
+
+		internal MQ2GCTelemetry()
+		{
+		}
+
+		/// <summary>
+		/// True while the loader is collecting the statistics, <see cref="LastPulse"/> stays empty otherwise
+		/// </summary>
+		public bool IsEnabled => _pauseListener != null;
+
+		/// <summary>
+		/// What the GC did between the last two pulses
+		/// </summary>
+		public GCPulseStatistics LastPulse { get; private set; }
+
+		/// <summary>
+		/// Gen2 collections, blocking or background, that started while a <see cref="SuppressBlockingGen2"/> scope was open
+		/// </summary>
+		public long Gen2CollectionsWhileSuppressed { get; private set; }
+
+		/// <summary>
+		/// Switches the GC to <see cref="GCLatencyMode.SustainedLowLatency"/> until the returned scope is disposed, e.g. for the
+		/// length of a fight. Gen2 collections then run in the background instead of blocking, unless the process is low on
+		/// memory. Has no effect when concurrent GC is turned off (GCConcurrent=0). Scopes can nest, the previous mode is restored
+		/// when the outermost one is disposed.
+		/// </summary>
+		public IDisposable SuppressBlockingGen2()
+		{
+			if (_suppressionDepth++ == 0)
+			{
+				_suppressedLatencyMode = GCSettings.LatencyMode;
+				_suppressionGen2Count = GC.CollectionCount(2);
+				GCSettings.LatencyMode = GCLatencyMode.SustainedLowLatency;
+			}
+
+			return new Suppression(this);
+		}
+
+		internal void Enable()
+		{
+			if (_pauseListener != null)
+			{
+				return;
+			}
+
+			_pauseListener = new GCPauseListener();
+			_lastAllocatedBytes = GC.GetTotalAllocatedBytes(false);
+			_lastGen0Count = GC.CollectionCount(0);
+			_lastGen1Count = GC.CollectionCount(1);
+			_lastGen2Count = GC.CollectionCount(2);
+		}
+
+		internal void Disable()
+		{
+			_pauseListener?.Dispose();
+			_pauseListener = null;
+			LastPulse = default;
+		}
+
+		internal void OnPulse()
+		{
+			if (_pauseListener == null)
+			{
+				return;
+			}
+
+			var allocatedBytes = GC.GetTotalAllocatedBytes(false);
+			var gen0Count = GC.CollectionCount(0);
+			var gen1Count = GC.CollectionCount(1);
+			var gen2Count = GC.CollectionCount(2);
+			_pauseListener.TakePending(out var pauseCount, out var pauseNanoseconds, out var longestPauseNanoseconds, out var blockingGen2Count);
+
+			// Collection counts include the younger generations collected along with an older one
+			var pulse = new GCPulseStatistics(
+				allocatedBytes - _lastAllocatedBytes,
+				gen0Count - _lastGen0Count,
+				gen1Count - _lastGen1Count,
+				gen2Count - _lastGen2Count,
+				blockingGen2Count,
+				(uint)pauseCount,
+				TimeSpan.FromTicks((long)(pauseNanoseconds / 100)),
+				TimeSpan.FromTicks((long)(longestPauseNanoseconds / 100)));
+
+			LastPulse = pulse;
+			_lastAllocatedBytes = allocatedBytes;
+			_lastGen0Count = gen0Count;
+			_lastGen1Count = gen1Count;
+			_lastGen2Count = gen2Count;
+
+			++_pulseCount;
+			_totalAllocatedBytes += pulse.AllocatedBytes;
+			_totalBlockingGen2Count += pulse.BlockingGen2Collections;
+			if (pulse.AllocatedBytes > _mostAllocatedBytes)
+			{
+				_mostAllocatedBytes = pulse.AllocatedBytes;
+			}
+		}
+
+		internal void ResetStatistics()
+		{
+			_pauseListener?.ResetPauseTimings();
+			_pulseCount = 0;
+			_totalAllocatedBytes = 0;
+			_mostAllocatedBytes = 0;
+			_totalBlockingGen2Count = 0;
+			Gen2CollectionsWhileSuppressed = 0;
+		}
+
+		internal string GetSummary()
+		{
+			var averageAllocatedBytes = _pulseCount > 0 ? _totalAllocatedBytes / _pulseCount : 0;
+			return $"pauses {_pauseListener?.GetPauseSummary().ToString() ?? "not collected"}, "
+				+ $"{averageAllocatedBytes / 1024.0:0.0} KB allocated per pulse (most {_mostAllocatedBytes / 1024.0:0.0} KB), "
+				+ $"{_totalBlockingGen2Count} blocking gen2, {Gen2CollectionsWhileSuppressed} gen2 while suppressed";
+		}
+
+		private void EndSuppression()
+		{
+			if (--_suppressionDepth == 0)
+			{
+				GCSettings.LatencyMode = _suppressedLatencyMode;
+				Gen2CollectionsWhileSuppressed += GC.CollectionCount(2) - _suppressionGen2Count;
+			}
+		}
+
+		private sealed class Suppression : IDisposable
+		{
+			private MQ2GCTelemetry? _telemetry;
+
+			internal Suppression(MQ2GCTelemetry telemetry)
+			{
+				_telemetry = telemetry;
+			}
+
+			public void Dispose()
+			{
+				_telemetry?.EndSuppression();
+				_telemetry = null;
+			}
+		}
+	}
+}
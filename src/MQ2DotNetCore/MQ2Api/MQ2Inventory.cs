@@ -0,0 +1,136 @@
+﻿using JetBrains.Annotations;
+using MQ2DotNetCore.Interop;
+using System;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// Item lookups over everything the character has on them, in the bank and in the shared bank, including what's in bags. Each
+	/// lookup is one call into the loader's inventory index and returns every matching slot and the total count, rather than a
+	/// FindItem read per item or a member read per slot. The index is only rebuilt when the items changed or the client zoned.
+	/// Pass <see cref="InventoryQueryFilter.Inventory"/> to only search what MQ2's FindItem does. Must be used from the EQ thread.
+	/// </summary>
+	[PublicAPI]
+	public class MQ2Inventory
+	{
+		// ITEM_NAME_LEN, a longer name can't match any item
+		private const int MaxNameLength = 64;
+
+		private readonly InventorySlot[] _firstSlot = new InventorySlot[1];
+
+		internal MQ2Inventory()
+		{
+		}
+
+		/// <summary>
+		/// The first slot holding the item, searching the inventory, then the bank, then the shared bank, or null if there is none
+		/// </summary>
+		public InventorySlot? FindItem(int itemId, InventoryQueryFilter filter = InventoryQueryFilter.Any)
+		{
+			return FindItems(itemId, _firstSlot, out _, filter) > 0 ? _firstSlot[0] : (InventorySlot?)null;
+		}
+
+		/// <summary>
+		/// The first slot holding an item whose name contains <paramref name="name"/>, or is <paramref name="name"/> when it starts
+		/// with =, like MQ2's FindItem. Names are compared ignoring case.
+		/// </summary>
+		public InventorySlot? FindItem(string name, InventoryQueryFilter filter = InventoryQueryFilter.Any)
+		{
+			return FindItems(name, _firstSlot, out _, filter) > 0 ? _firstSlot[0] : (InventorySlot?)null;
+		}
+
+		/// <summary>
+		/// Every slot holding the item, in the same order as <see cref="FindItem(int, InventoryQueryFilter)"/> searches them
+		/// </summary>
+		/// <param name="itemId">Item ID</param>
+		/// <param name="results">Receives up to results.Length matching slots</param>
+		/// <param name="totalCount">The number of items in every matching slot, counting the stacks</param>
+		/// <param name="filter">Containers to search</param>
+		/// <returns>The total number of matching slots, which can be larger than results.Length</returns>
+		public int FindItems(int itemId, InventorySlot[] results, out long totalCount, InventoryQueryFilter filter = InventoryQueryFilter.Any)
+		{
+			if (results == null)
+			{
+				throw new ArgumentNullException(nameof(results));
+			}
+
+			var matchCount = MQ2DotNetCoreLoader.NativeMethods.InventoryIndex__FindById((uint)itemId, filter, results, (uint)results.Length, out var count);
+			totalCount = (long)count;
+			return (int)matchCount;
+		}
+
+		/// <summary>
+		/// Every slot holding an item matching <paramref name="name"/>, see <see cref="FindItem(string, InventoryQueryFilter)"/>
+		/// </summary>
+		/// <returns>The total number of matching slots, which can be larger than results.Length</returns>
+		public int FindItems(string name, InventorySlot[] results, out long totalCount, InventoryQueryFilter filter = InventoryQueryFilter.Any)
+		{
+			if (results == null)
+			{
+				throw new ArgumentNullException(nameof(results));
+			}
+
+			return FindByName(name, results, out totalCount, filter);
+		}
+
+		/// <summary>
+		/// The number of the item the character has, counting stacks, like MQ2's FindItemCount
+		/// </summary>
+		public long CountItem(int itemId, InventoryQueryFilter filter = InventoryQueryFilter.Any)
+		{
+			MQ2DotNetCoreLoader.NativeMethods.InventoryIndex__FindById((uint)itemId, filter, null, 0, out var count);
+			return (long)count;
+		}
+
+		/// <summary>
+		/// The number of items matching <paramref name="name"/> the character has, counting stacks, like MQ2's FindItemCount
+		/// </summary>
+		public long CountItem(string name, InventoryQueryFilter filter = InventoryQueryFilter.Any)
+		{
+			FindByName(name, null, out var totalCount, filter);
+			return totalCount;
+		}
+
+		/// <summary>
+		/// Rebuilds the index on the next lookup, even if the items look the same as the last time it was built
+		/// </summary>
+		public void Invalidate()
+		{
+			MQ2DotNetCoreLoader.NativeMethods.InventoryIndex__Invalidate();
+		}
+
+		private static int FindByName(string name, InventorySlot[]? results, out long totalCount, InventoryQueryFilter filter)
+		{
+			if (name == null)
+			{
+				throw new ArgumentNullException(nameof(name));
+			}
+
+			var isExact = name.StartsWith('=');
+			var nameCharacters = isExact ? name.AsSpan(1) : name.AsSpan();
+			if (nameCharacters.Length > MaxNameLength)
+			{
+				totalCount = 0;
+				return 0;
+			}
+
+			Span<byte> encodedName = stackalloc byte[MaxNameLength * 3];
+			var nameLength = Encoding.UTF8.GetBytes(nameCharacters, encodedName);
+
+			var matchCount = MQ2DotNetCoreLoader.NativeMethods.InventoryIndex__FindByName(
+				ref MemoryMarshal.GetReference(encodedName),
+				(uint)nameLength,
+				isExact,
+				filter,
+				results,
+				(uint)(results?.Length ?? 0),
+				out var count
+			);
+
+			totalCount = (long)count;
+			return (int)matchCount;
+		}
+	}
+}
@@ -18,7 +18,7 @@ namespace MQ2DotNetCore.MQ2Api
 
 			try
 			{
-				_mq2MainLibraryHandle = Kernel32.NativeMethods.LoadLibrary(MQ2Main.DLL);
+				_mq2MainLibraryHandle = SafeLibraryHandle.Load(MQ2Main.DLL);
 			}
 			catch (Exception exc)
 			{
@@ -44,7 +44,7 @@ namespace MQ2DotNetCore.MQ2Api
 
 			try
 			{
-				var ppLocalPlayer = Kernel32.NativeMethods.GetProcAddress(_mq2MainLibraryHandle, "ppLocalPlayer");
+				var ppLocalPlayer = _mq2MainLibraryHandle.GetExport("ppLocalPlayer");
 				var ppPlayer = Marshal.ReadIntPtr(ppLocalPlayer);
 				return Marshal.ReadIntPtr(ppPlayer);
 			}
@@ -68,7 +68,7 @@ namespace MQ2DotNetCore.MQ2Api
 				return null;
 			}
 
-			var mq2InitPath = Marshal.PtrToStringAnsi(Kernel32.NativeMethods.GetProcAddress(_mq2MainLibraryHandle, "gszINIPath"));
+			var mq2InitPath = Marshal.PtrToStringAnsi(_mq2MainLibraryHandle.GetExport("gszINIPath"));
 			_mq2IniPath = mq2InitPath;
 			return _mq2IniPath;
 		}
@@ -80,7 +80,7 @@ namespace MQ2DotNetCore.MQ2Api
 				return IntPtr.Zero;
 			}
 
-			var ppSpawnManager = Marshal.ReadIntPtr(Kernel32.NativeMethods.GetProcAddress(_mq2MainLibraryHandle, "ppSpawnManager"));
+			var ppSpawnManager = Marshal.ReadIntPtr(_mq2MainLibraryHandle.GetExport("ppSpawnManager"));
 			return Marshal.ReadIntPtr(ppSpawnManager);
 		}
 	}
@@ -15,28 +15,142 @@ namespace MQ2DotNetCore.MQ2Api
 	{
 		private readonly MQ2TypeFactory _mq2TypeFactory;
 
+		// One SpawnType per handle table slot, handed out again for as long as the slot's handle stays the same
+		private SpawnType?[] _spawnsBySlot = Array.Empty<SpawnType?>();
+
 		internal MQ2Spawns(MQ2TypeFactory mq2TypeFactory)
 		{
 			_mq2TypeFactory = mq2TypeFactory;
 		}
 
 		/// <summary>
-		/// All spawns in the current zone
+		/// All spawns in the current zone, in no particular order. Each spawn's <see cref="SpawnType"/> is created once and returned
+		/// again by later calls, and by <see cref="GetSpawn(SpawnHandle)"/>, until it leaves the zone. Must be called from the EQ thread.
 		/// </summary>
 		public IEnumerable<SpawnType> GetAll()
 		{
-			var spawnManagerPointer = _mq2TypeFactory.MQ2NativeHelper.GetSpawnManagerIntPointer();
-			if (spawnManagerPointer == IntPtr.Zero)
+			var usedSlotCount = SpawnHandleTable.UsedSlotCount;
+			for (var index = 0u; index < usedSlotCount; ++index)
+			{
+				var handle = SpawnHandleTable.GetHandle(index, out var spawnPointer);
+				if (!handle.IsNone)
+				{
+					yield return GetSpawn(handle, spawnPointer);
+				}
+			}
+		}
+
+		/// <summary>
+		/// The spawn with the handle, or null if it has left the zone. The same <see cref="SpawnType"/> is returned for as long as the
+		/// spawn stays. Must be called from the EQ thread.
+		/// </summary>
+		public SpawnType? GetSpawn(SpawnHandle handle)
+		{
+			return SpawnHandleTable.TryResolve(handle, out var spawnPointer) ? GetSpawn(handle, spawnPointer) : null;
+		}
+
+		// Also used for spawn events, where the handle may already have been released (batched events after zoning) or be None (the
+		// handle table was full). Those get a SpawnType of their own that isn't kept.
+		internal SpawnType GetSpawn(SpawnHandle handle, IntPtr spawnPointer)
+		{
+			if (handle.IsNone || !SpawnHandleTable.TryResolve(handle, out _))
+			{
+				return new SpawnType(_mq2TypeFactory, handle, spawnPointer);
+			}
+
+			var index = (int)handle.Index;
+			if (index >= _spawnsBySlot.Length)
+			{
+				Array.Resize(ref _spawnsBySlot, Math.Max(index + 1, _spawnsBySlot.Length * 2));
+			}
+
+			var spawn = _spawnsBySlot[index];
+			if (spawn == null || spawn.Handle != handle)
+			{
+				spawn = new SpawnType(_mq2TypeFactory, handle, spawnPointer);
+				_spawnsBySlot[index] = spawn;
+			}
+
+			return spawn;
+		}
+
+		// Spawns from batched AddSpawn events. Without a handle (the handle table was full) there's no telling whether the spawn
+		// is still there by the time the batch is dispatched, so the SpawnType is stale from the start.
+		internal SpawnType GetBatchedSpawn(SpawnHandle handle, IntPtr spawnPointer)
+			=> handle.IsNone ? new SpawnType(_mq2TypeFactory, spawnPointer, isUntracked: true) : GetSpawn(handle, spawnPointer);
+
+		/// <summary>
+		/// Copies every spawn in the current zone into a <see cref="SpawnSnapshot"/> with a single call into the loader, instead of
+		/// walking the spawn list and creating a <see cref="SpawnType"/> per spawn. Pass the snapshot from the previous call to reuse
+		/// its buffer. Must be called from the EQ thread.
+		/// </summary>
+		/// <param name="snapshot">An existing snapshot to refill, or null to create a new one</param>
+		/// <returns>The refilled or new snapshot</returns>
+		public SpawnSnapshot CaptureSnapshot(SpawnSnapshot? snapshot = null)
+		{
+			if (snapshot?.IsShared == true)
+			{
+				throw new ArgumentException($"The spawns of a {nameof(PulseSnapshot)} are read by other threads and can't be refilled", nameof(snapshot));
+			}
+
+			snapshot ??= new SpawnSnapshot();
+			snapshot.Capture();
+			return snapshot;
+		}
+
+		/// <summary>
+		/// Spawns within radius of the point (x, y), using the loader's spatial index instead of scanning every spawn. Results are
+		/// written in no particular order. Must be called from the EQ thread.
+		/// </summary>
+		/// <param name="x">SPAWNINFO X coordinate</param>
+		/// <param name="y">SPAWNINFO Y coordinate</param>
+		/// <param name="radius">2D radius, the same as Spawn.Distance</param>
+		/// <param name="results">Receives up to results.Length matches</param>
+		/// <param name="filter">Spawn types to include</param>
+		/// <returns>The total number of matches, which can be larger than results.Length</returns>
+		public int QueryRadius(float x, float y, float radius, SpawnQueryResult[] results, SpawnQueryFilter filter = SpawnQueryFilter.Any)
+		{
+			if (results == null)
+			{
+				throw new ArgumentNullException(nameof(results));
+			}
+
+			return (int)MQ2DotNetCoreLoader.NativeMethods.SpawnSpatialIndex__QueryRadius(x, y, radius, filter, results, (uint)results.Length);
+		}
+
+		/// <summary>
+		/// Spawns inside the box from (minX, minY) to (maxX, maxY), using the loader's spatial index. Results are written in no
+		/// particular order and their distance is from the center of the box. Must be called from the EQ thread.
+		/// </summary>
+		/// <returns>The total number of matches, which can be larger than results.Length</returns>
+		public int QueryBox(float minX, float minY, float maxX, float maxY, SpawnQueryResult[] results, SpawnQueryFilter filter = SpawnQueryFilter.Any)
+		{
+			if (results == null)
 			{
-				yield break;
+				throw new ArgumentNullException(nameof(results));
 			}
 
-			var nextSpawnPointer = Marshal.ReadIntPtr(spawnManagerPointer + 8);
-			while (nextSpawnPointer != IntPtr.Zero)
+			return (int)MQ2DotNetCoreLoader.NativeMethods.SpawnSpatialIndex__QueryBox(minX, minY, maxX, maxY, filter, results, (uint)results.Length);
+		}
+
+		/// <summary>
+		/// The results.Length spawns nearest to the point (x, y), sorted by distance, using the loader's spatial index. Must be called
+		/// from the EQ thread.
+		/// </summary>
+		/// <param name="x">SPAWNINFO X coordinate</param>
+		/// <param name="y">SPAWNINFO Y coordinate</param>
+		/// <param name="results">Receives the nearest spawns, its length is the number of spawns to find</param>
+		/// <param name="maxRadius">Ignore spawns further away than this, or 0 for no limit</param>
+		/// <param name="filter">Spawn types to include</param>
+		/// <returns>The number of spawns written to results</returns>
+		public int QueryNearest(float x, float y, SpawnQueryResult[] results, float maxRadius = 0, SpawnQueryFilter filter = SpawnQueryFilter.Any)
+		{
+			if (results == null)
 			{
-				yield return new SpawnType(_mq2TypeFactory, nextSpawnPointer);
-				nextSpawnPointer = Marshal.ReadIntPtr(nextSpawnPointer + 8);
+				throw new ArgumentNullException(nameof(results));
 			}
+
+			return (int)MQ2DotNetCoreLoader.NativeMethods.SpawnSpatialIndex__QueryNearest(x, y, (uint)results.Length, maxRadius, filter, results);
 		}
 
 		/// <summary>
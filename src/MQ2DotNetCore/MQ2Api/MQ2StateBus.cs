@@ -0,0 +1,158 @@
+﻿using JetBrains.Annotations;
+using MQ2DotNetCore.Interop;
+using System;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// State and messages shared between the clients running on this machine, through a shared memory region the loaders map
+	/// when <see cref="Base.MQ2DotNetCoreOptions.StateBusName"/> is set. Each client owns one slot it publishes a fixed size
+	/// unmanaged struct to and can read every other slot's latest copy, so e.g. a group leader can check everyone's HP and
+	/// position each pulse without a text protocol or a round trip through a server. Reads are a single seqlock checked copy,
+	/// nothing is serialized or parsed. Messages go through a broadcast ring each client reads with its own cursor, a client
+	/// that falls more than a ring's worth of messages behind skips the ones it missed and counts them.
+	/// Must be called from the EQ thread.
+	/// </summary>
+	[PublicAPI]
+	public sealed class MQ2StateBus
+	{
+		/// <summary>
+		/// Largest state struct a client can publish
+		/// </summary>
+		public const int StateCapacity = 256;
+
+		internal MQ2StateBus()
+		{
+		}
+
+		/// <summary>
+		/// True once the loader has mapped the bus and claimed a slot for this client
+		/// </summary>
+		public bool IsOpen => InstanceIndex >= 0;
+
+		/// <summary>
+		/// This client's slot, -1 while the bus isn't open. Changes if the slot was taken over while the client was stalled, -1 if no
+		/// other slot was free.
+		/// </summary>
+		public int InstanceIndex => GetStatistics().InstanceIndex;
+
+		/// <summary>
+		/// Number of slots, i.e. the most clients that can share a bus
+		/// </summary>
+		public int InstanceCapacity => (int)GetStatistics().InstanceCapacity;
+
+		/// <summary>
+		/// Sets the name other clients see in <see cref="StateBusInstance.Name"/>, e.g. the character's name once in game
+		/// </summary>
+		public void SetInstanceName(string name)
+		{
+			MQ2DotNetCoreLoader.NativeMethods.SharedStateBus__SetInstanceName(name ?? throw new ArgumentNullException(nameof(name)));
+		}
+
+		/// <summary>
+		/// Replaces this client's state with <paramref name="state"/>
+		/// </summary>
+		/// <returns>false if the bus isn't open</returns>
+		public unsafe bool Publish<T>(T state) where T : unmanaged
+		{
+			if (sizeof(T) > StateCapacity)
+			{
+				throw new ArgumentException($"{typeof(T).Name} is {sizeof(T)} bytes, the most a client can publish is {StateCapacity}", nameof(state));
+			}
+
+			return MQ2DotNetCoreLoader.NativeMethods.SharedStateBus__Publish((IntPtr)(&state), (uint)sizeof(T));
+		}
+
+		/// <summary>
+		/// Reads the latest state published to a slot. Fails if the slot is empty, hasn't published yet, or published a state of a
+		/// different size than <typeparamref name="T"/>.
+		/// </summary>
+		public unsafe bool TryRead<T>(int instanceIndex, out T state) where T : unmanaged
+		{
+			state = default;
+			if (instanceIndex < 0)
+			{
+				return false;
+			}
+
+			fixed (T* pState = &state)
+			{
+				var size = MQ2DotNetCoreLoader.NativeMethods.SharedStateBus__ReadState((uint)instanceIndex, (IntPtr)pState, (uint)sizeof(T));
+				if (size == sizeof(T))
+				{
+					return true;
+				}
+			}
+
+			state = default;
+			return false;
+		}
+
+		/// <summary>
+		/// Describes the client in a slot, fails if the slot is empty. Check <see cref="StateBusInstance.Age"/>
+		/// to tell whether its client is still pulsing
+		/// </summary>
+		public bool TryGetInstance(int instanceIndex, out StateBusInstance instance)
+		{
+			if (instanceIndex < 0)
+			{
+				instance = default;
+				return false;
+			}
+
+			return MQ2DotNetCoreLoader.NativeMethods.SharedStateBus__GetInstance((uint)instanceIndex, out instance);
+		}
+
+		/// <summary>
+		/// Sends <paramref name="payload"/> to the client in <paramref name="targetIndex"/>
+		/// </summary>
+		/// <returns>false if the bus isn't open</returns>
+		public unsafe bool Send<T>(int targetIndex, uint messageType, T payload) where T : unmanaged
+		{
+			if (targetIndex < 0)
+			{
+				throw new ArgumentOutOfRangeException(nameof(targetIndex), "Use Broadcast to send to every client");
+			}
+
+			return SendCore(targetIndex, messageType, &payload, sizeof(T));
+		}
+
+		/// <summary>
+		/// Sends <paramref name="payload"/> to every other client on the bus
+		/// </summary>
+		/// <returns>false if the bus isn't open</returns>
+		public unsafe bool Broadcast<T>(uint messageType, T payload) where T : unmanaged
+			=> SendCore(-1, messageType, &payload, sizeof(T));
+
+		/// <summary>
+		/// Copies the messages sent to this client (or broadcast) since the last call into <paramref name="messages"/>, oldest first.
+		/// Messages this client sent itself are skipped.
+		/// </summary>
+		/// <returns>The number of messages written</returns>
+		public int Receive(StateBusMessage[] messages)
+		{
+			if (messages == null)
+			{
+				throw new ArgumentNullException(nameof(messages));
+			}
+
+			return (int)MQ2DotNetCoreLoader.NativeMethods.SharedStateBus__Receive(messages, (uint)messages.Length);
+		}
+
+		internal static SharedStateBusStatistics GetStatistics()
+		{
+			MQ2DotNetCoreLoader.NativeMethods.SharedStateBus__GetStatistics(out var statistics);
+			return statistics;
+		}
+
+		private static unsafe bool SendCore(int targetIndex, uint messageType, void* pPayload, int size)
+		{
+			if (size > StateBusMessage.PayloadCapacity)
+			{
+				throw new ArgumentException($"The payload is {size} bytes, the most a message can carry is {StateBusMessage.PayloadCapacity}");
+			}
+
+			return MQ2DotNetCoreLoader.NativeMethods.SharedStateBus__Send(targetIndex, messageType, (IntPtr)pPayload, (uint)size);
+		}
+	}
+}
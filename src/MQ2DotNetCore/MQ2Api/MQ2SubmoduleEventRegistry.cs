@@ -1,6 +1,8 @@
 ﻿using MQ2DotNetCore.Base;
+using MQ2DotNetCore.Interop;
 using MQ2DotNetCore.MQ2Api.DataTypes;
 using System;
+using System.Threading;
 
 namespace MQ2DotNetCore.MQ2Api
 {
@@ -11,6 +13,9 @@ namespace MQ2DotNetCore.MQ2Api
 		private bool _isDisposed = false;
 		private readonly string _submoduleName;
 
+		// Guards the handler fields so the subscriber counts published to the loader always match them
+		private readonly object _subscriptionLock = new object();
+
 		internal MQ2SubmoduleEventRegistry(string submoduleName)
 		{
 			_submoduleName = submoduleName;
@@ -19,7 +24,61 @@ namespace MQ2DotNetCore.MQ2Api
 		/// <inheritdoc />
 		public void Dispose()
 		{
-			_isDisposed = true;
+			lock (_subscriptionLock)
+			{
+				if (_isDisposed)
+				{
+					return;
+				}
+
+				_isDisposed = true;
+
+				// Handlers of a disposed registry are never invoked, so they stop counting as subscribers
+				_onAddGroundItem = ClearHandlers(_onAddGroundItem, LoaderCallback.AddGroundItem);
+				_onAddSpawn = ClearHandlers(_onAddSpawn, LoaderCallback.AddSpawn);
+				_onBeginZone = ClearHandlers(_onBeginZone, LoaderCallback.BeginZone);
+				_onChatAny = ClearHandlers(_onChatAny, LoaderCallback.WriteChatColor, LoaderCallback.IncomingChat);
+				_onChatEQ = ClearHandlers(_onChatEQ, LoaderCallback.IncomingChat);
+				_onChatMQ2 = ClearHandlers(_onChatMQ2, LoaderCallback.WriteChatColor);
+				_onCleanUI = ClearHandlers(_onCleanUI, LoaderCallback.CleanUI);
+				_onDrawHUD = ClearHandlers(_onDrawHUD, LoaderCallback.DrawHUD);
+				_onEndZone = ClearHandlers(_onEndZone, LoaderCallback.EndZone);
+				SetPulseSnapshotHandlers(ClearHandlers(_onPulseSnapshot, LoaderCallback.Pulse));
+				_onReloadUI = ClearHandlers(_onReloadUI, LoaderCallback.ReloadUI);
+				_onRemoveGroundItem = ClearHandlers(_onRemoveGroundItem, LoaderCallback.RemoveGroundItem);
+				_onRemoveSpawn = ClearHandlers(_onRemoveSpawn, LoaderCallback.RemoveSpawn);
+				_onSetGameState = ClearHandlers(_onSetGameState, LoaderCallback.SetGameState);
+				_onSpawnsChanged = ClearHandlers(_onSpawnsChanged, LoaderCallback.Pulse);
+				_onZoned = ClearHandlers(_onZoned, LoaderCallback.Zoned);
+			}
+		}
+
+		// Every handler counts as a subscriber to the loader callbacks that raise its event, see LoaderCallbackSubscriptions
+		private static TEventHandler? ClearHandlers<TEventHandler>(TEventHandler? handlers, params LoaderCallback[] callbacks)
+			where TEventHandler : Delegate
+			=> UpdateSubscriberCounts(handlers, null, callbacks);
+
+		private static TEventHandler? CombineHandlers<TEventHandler>(TEventHandler? handlers, TEventHandler? value, params LoaderCallback[] callbacks)
+			where TEventHandler : Delegate
+			=> UpdateSubscriberCounts(handlers, (TEventHandler?)Delegate.Combine(handlers, value), callbacks);
+
+		private static TEventHandler? RemoveHandlers<TEventHandler>(TEventHandler? handlers, TEventHandler? value, params LoaderCallback[] callbacks)
+			where TEventHandler : Delegate
+			=> UpdateSubscriberCounts(handlers, (TEventHandler?)Delegate.Remove(handlers, value), callbacks);
+
+		private static TEventHandler? UpdateSubscriberCounts<TEventHandler>(TEventHandler? handlers, TEventHandler? updatedHandlers, LoaderCallback[] callbacks)
+			where TEventHandler : Delegate
+		{
+			var subscriberCountChange = (updatedHandlers?.GetInvocationList().Length ?? 0) - (handlers?.GetInvocationList().Length ?? 0);
+			if (subscriberCountChange != 0)
+			{
+				foreach (var callback in callbacks)
+				{
+					LoaderCallbackSubscriptions.ChangeSubscriberCount(callback, subscriberCountChange);
+				}
+			}
+
+			return updatedHandlers;
 		}
 
 
@@ -33,12 +92,18 @@ namespace MQ2DotNetCore.MQ2Api
 			add
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onAddGroundItem += value;
+				lock (_subscriptionLock)
+				{
+					_onAddGroundItem = CombineHandlers(_onAddGroundItem, value, LoaderCallback.AddGroundItem);
+				}
 			}
 			remove
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onAddGroundItem -= value;
+				lock (_subscriptionLock)
+				{
+					_onAddGroundItem = RemoveHandlers(_onAddGroundItem, value, LoaderCallback.AddGroundItem);
+				}
 			}
 		}
 
@@ -54,12 +119,18 @@ namespace MQ2DotNetCore.MQ2Api
 			add
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onAddSpawn += value;
+				lock (_subscriptionLock)
+				{
+					_onAddSpawn = CombineHandlers(_onAddSpawn, value, LoaderCallback.AddSpawn);
+				}
 			}
 			remove
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onAddSpawn -= value;
+				lock (_subscriptionLock)
+				{
+					_onAddSpawn = RemoveHandlers(_onAddSpawn, value, LoaderCallback.AddSpawn);
+				}
 			}
 		}
 
@@ -75,12 +146,18 @@ namespace MQ2DotNetCore.MQ2Api
 			add
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onBeginZone += value;
+				lock (_subscriptionLock)
+				{
+					_onBeginZone = CombineHandlers(_onBeginZone, value, LoaderCallback.BeginZone);
+				}
 			}
 			remove
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onBeginZone -= value;
+				lock (_subscriptionLock)
+				{
+					_onBeginZone = RemoveHandlers(_onBeginZone, value, LoaderCallback.BeginZone);
+				}
 			}
 		}
 
@@ -96,12 +173,18 @@ namespace MQ2DotNetCore.MQ2Api
 			add
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onChatAny += value;
+				lock (_subscriptionLock)
+				{
+					_onChatAny = CombineHandlers(_onChatAny, value, LoaderCallback.WriteChatColor, LoaderCallback.IncomingChat);
+				}
 			}
 			remove
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onChatAny -= value;
+				lock (_subscriptionLock)
+				{
+					_onChatAny = RemoveHandlers(_onChatAny, value, LoaderCallback.WriteChatColor, LoaderCallback.IncomingChat);
+				}
 			}
 		}
 
@@ -117,13 +200,18 @@ namespace MQ2DotNetCore.MQ2Api
 			add
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onChatEQ += value;
+				lock (_subscriptionLock)
+				{
+					_onChatEQ = CombineHandlers(_onChatEQ, value, LoaderCallback.IncomingChat);
+				}
 			}
 			remove
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-
-				_onChatEQ -= value;
+				lock (_subscriptionLock)
+				{
+					_onChatEQ = RemoveHandlers(_onChatEQ, value, LoaderCallback.IncomingChat);
+				}
 			}
 		}
 
@@ -138,12 +226,18 @@ namespace MQ2DotNetCore.MQ2Api
 			add
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onChatMQ2 += value;
+				lock (_subscriptionLock)
+				{
+					_onChatMQ2 = CombineHandlers(_onChatMQ2, value, LoaderCallback.WriteChatColor);
+				}
 			}
 			remove
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onChatMQ2 -= value;
+				lock (_subscriptionLock)
+				{
+					_onChatMQ2 = RemoveHandlers(_onChatMQ2, value, LoaderCallback.WriteChatColor);
+				}
 			}
 		}
 
@@ -159,12 +253,18 @@ namespace MQ2DotNetCore.MQ2Api
 			add
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onCleanUI += value;
+				lock (_subscriptionLock)
+				{
+					_onCleanUI = CombineHandlers(_onCleanUI, value, LoaderCallback.CleanUI);
+				}
 			}
 			remove
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onCleanUI -= value;
+				lock (_subscriptionLock)
+				{
+					_onCleanUI = RemoveHandlers(_onCleanUI, value, LoaderCallback.CleanUI);
+				}
 			}
 		}
 
@@ -180,12 +280,18 @@ namespace MQ2DotNetCore.MQ2Api
 			add
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onDrawHUD += value;
+				lock (_subscriptionLock)
+				{
+					_onDrawHUD = CombineHandlers(_onDrawHUD, value, LoaderCallback.DrawHUD);
+				}
 			}
 			remove
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onDrawHUD -= value;
+				lock (_subscriptionLock)
+				{
+					_onDrawHUD = RemoveHandlers(_onDrawHUD, value, LoaderCallback.DrawHUD);
+				}
 			}
 		}
 
@@ -200,17 +306,69 @@ namespace MQ2DotNetCore.MQ2Api
 			add
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onEndZone += value;
+				lock (_subscriptionLock)
+				{
+					_onEndZone = CombineHandlers(_onEndZone, value, LoaderCallback.EndZone);
+				}
 			}
 			remove
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onEndZone -= value;
+				lock (_subscriptionLock)
+				{
+					_onEndZone = RemoveHandlers(_onEndZone, value, LoaderCallback.EndZone);
+				}
 			}
 		}
 
 
 
+		private event EventHandler<PulseSnapshot>? _onPulseSnapshot;
+
+		/// <summary>
+		/// Fired on a thread pool thread once per pulse with a <see cref="PulseSnapshot"/> of the spawns, character and target, for work
+		/// that's too slow for the EQ thread and doesn't need live game objects, e.g. threat estimation. The handlers of one submodule
+		/// run one after the other on the same worker while other submodules' handlers run in parallel, and every handler sees the
+		/// same snapshot. A pulse that arrives before every handler returned from the previous one is skipped rather than queued.
+		/// Handlers must not touch <see cref="DataTypes.SpawnType"/>, the TLOs or anything else that reads game memory, results are
+		/// handed back to the EQ thread with <see cref="PulseSnapshot.Post(Action)"/>.
+		/// </summary>
+		public event EventHandler<PulseSnapshot>? OnPulseSnapshot
+		{
+			add
+			{
+				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
+				lock (_subscriptionLock)
+				{
+					SetPulseSnapshotHandlers(CombineHandlers(_onPulseSnapshot, value, LoaderCallback.Pulse));
+				}
+			}
+			remove
+			{
+				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
+				lock (_subscriptionLock)
+				{
+					SetPulseSnapshotHandlers(RemoveHandlers(_onPulseSnapshot, value, LoaderCallback.Pulse));
+				}
+			}
+		}
+
+		// Across every submodule, so the pulse handler can skip looking for subscribers when there are none
+		private static int _pulseSnapshotHandlerCount;
+
+		internal static bool HasAnyPulseSnapshotHandlers => Volatile.Read(ref _pulseSnapshotHandlerCount) > 0;
+
+		internal bool HasPulseSnapshotHandlers => !_isDisposed && _onPulseSnapshot != null;
+
+		private void SetPulseSnapshotHandlers(EventHandler<PulseSnapshot>? handlers)
+		{
+			var handlerCountChange = (handlers?.GetInvocationList().Length ?? 0) - (_onPulseSnapshot?.GetInvocationList().Length ?? 0);
+			Interlocked.Add(ref _pulseSnapshotHandlerCount, handlerCountChange);
+			_onPulseSnapshot = handlers;
+		}
+
+
+
 		private event EventHandler? _onReloadUI;
 
 		/// <summary>
@@ -221,12 +379,18 @@ namespace MQ2DotNetCore.MQ2Api
 			add
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onReloadUI += value;
+				lock (_subscriptionLock)
+				{
+					_onReloadUI = CombineHandlers(_onReloadUI, value, LoaderCallback.ReloadUI);
+				}
 			}
 			remove
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onReloadUI -= value;
+				lock (_subscriptionLock)
+				{
+					_onReloadUI = RemoveHandlers(_onReloadUI, value, LoaderCallback.ReloadUI);
+				}
 			}
 		}
 
@@ -241,12 +405,18 @@ namespace MQ2DotNetCore.MQ2Api
 			add
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onRemoveGroundItem += value;
+				lock (_subscriptionLock)
+				{
+					_onRemoveGroundItem = CombineHandlers(_onRemoveGroundItem, value, LoaderCallback.RemoveGroundItem);
+				}
 			}
 			remove
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onRemoveGroundItem -= value;
+				lock (_subscriptionLock)
+				{
+					_onRemoveGroundItem = RemoveHandlers(_onRemoveGroundItem, value, LoaderCallback.RemoveGroundItem);
+				}
 			}
 		}
 
@@ -262,12 +432,18 @@ namespace MQ2DotNetCore.MQ2Api
 			add
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onRemoveSpawn += value;
+				lock (_subscriptionLock)
+				{
+					_onRemoveSpawn = CombineHandlers(_onRemoveSpawn, value, LoaderCallback.RemoveSpawn);
+				}
 			}
 			remove
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onRemoveSpawn -= value;
+				lock (_subscriptionLock)
+				{
+					_onRemoveSpawn = RemoveHandlers(_onRemoveSpawn, value, LoaderCallback.RemoveSpawn);
+				}
 			}
 		}
 
@@ -283,12 +459,47 @@ namespace MQ2DotNetCore.MQ2Api
 			add
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onSetGameState += value;
+				lock (_subscriptionLock)
+				{
+					_onSetGameState = CombineHandlers(_onSetGameState, value, LoaderCallback.SetGameState);
+				}
 			}
 			remove
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onSetGameState -= value;
+				lock (_subscriptionLock)
+				{
+					_onSetGameState = RemoveHandlers(_onSetGameState, value, LoaderCallback.SetGameState);
+				}
+			}
+		}
+
+
+
+		private event EventHandler<SpawnsChangedEventArgs>? _onSpawnsChanged;
+
+		/// <summary>
+		/// Fired once per pulse with every spawn that was added, removed, or had one of the tracked fields change since the previous
+		/// pulse. Only fired when the SpawnChangeFeedFields option selects at least one field. Spawns that leave during a zone change
+		/// are not reported, use <see cref="OnBeginZone"/> to reset any state built from this event.
+		/// </summary>
+		public event EventHandler<SpawnsChangedEventArgs>? OnSpawnsChanged
+		{
+			add
+			{
+				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
+				lock (_subscriptionLock)
+				{
+					_onSpawnsChanged = CombineHandlers(_onSpawnsChanged, value, LoaderCallback.Pulse);
+				}
+			}
+			remove
+			{
+				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
+				lock (_subscriptionLock)
+				{
+					_onSpawnsChanged = RemoveHandlers(_onSpawnsChanged, value, LoaderCallback.Pulse);
+				}
 			}
 		}
 
@@ -304,12 +515,18 @@ namespace MQ2DotNetCore.MQ2Api
 			add
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onZoned += value;
+				lock (_subscriptionLock)
+				{
+					_onZoned = CombineHandlers(_onZoned, value, LoaderCallback.Zoned);
+				}
 			}
 			remove
 			{
 				CleanupHelper.DisposedCheck(_isDisposed, nameof(MQ2SubmoduleEventRegistry));
-				_onZoned -= value;
+				lock (_subscriptionLock)
+				{
+					_onZoned = RemoveHandlers(_onZoned, value, LoaderCallback.Zoned);
+				}
 			}
 		}
 
@@ -388,6 +605,14 @@ namespace MQ2DotNetCore.MQ2Api
 			}
 		}
 
+		internal void NotifyPulseSnapshot(PulseSnapshot pulseSnapshot)
+		{
+			if (!_isDisposed)
+			{
+				_onPulseSnapshot?.Invoke(this, pulseSnapshot);
+			}
+		}
+
 		internal void NotifyReloadUI(EventArgs eventArgs)
 		{
 			if (!_isDisposed)
@@ -420,6 +645,14 @@ namespace MQ2DotNetCore.MQ2Api
 			}
 		}
 
+		internal void NotifySpawnsChanged(SpawnsChangedEventArgs spawnsChangedEventArgs)
+		{
+			if (!_isDisposed)
+			{
+				_onSpawnsChanged?.Invoke(this, spawnsChangedEventArgs);
+			}
+		}
+
 		internal void NotifyZoned(EventArgs eventArgs)
 		{
 			if (!_isDisposed)
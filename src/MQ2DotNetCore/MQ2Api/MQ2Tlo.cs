@@ -1,4 +1,5 @@
 ﻿using JetBrains.Annotations;
+using MQ2DotNetCore.Interop;
 using MQ2DotNetCore.Logging;
 using MQ2DotNetCore.MQ2Api.DataTypes;
 using System;
@@ -331,15 +332,9 @@ namespace MQ2DotNetCore.MQ2Api
 		/// <returns></returns>
 		public T? GetTLO<T>(string name, string? index = "") where T : MQ2DataType
 		{
-			// To get an MQ2TypeVar from a TLO, first we call FindMQ2Data to get a function pointer to the TLO's function
-			var tlo = _typeFactory.MQ2NativeHelper.FindMQ2Data(name);// ?? throw new KeyNotFoundException();
-
-#if DEBUG
-			_typeFactory.Logger?.LogTracePrefixed($"TLO date item for {name}: {tlo.pFunction}");
-#endif
-
-			// Then we call that function, providing the index as a parameter
-			if (tlo.pFunction == IntPtr.Zero || index == null || !tlo.Function(index, out var typeVar))
+			// The loader finds the TLO's data item and calls its function with the index, going through the member cache if
+			// it's enabled
+			if (index == null || !MQ2TypeVar.TryGetTopLevelObject(name, index, out var typeVar))
 			{
 				return default;
 			}
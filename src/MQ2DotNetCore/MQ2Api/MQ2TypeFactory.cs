@@ -211,7 +211,7 @@ namespace MQ2DotNetCore.MQ2Api
 		/// <param name="constructor"></param>
 		private void Register(string typeName, Func<MQ2TypeFactory, MQ2TypeVar, MQ2DataType> constructor)
 		{
-			var dataType = MQ2Main.NativeMethods.FindMQ2DataType(typeName);
+			var dataType = InternTable.FindType(typeName);
 
 			if (dataType == IntPtr.Zero)
 			{
@@ -0,0 +1,321 @@
+﻿using JetBrains.Annotations;
+using MQ2DotNetCore.Interop;
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// A reusable set of member paths, e.g. "Me.Buff[3].Duration.TotalSeconds", that the loader resolves in a single call. Each
+	/// path is parsed once when it is added, and every <see cref="Evaluate"/> walks all of them natively with MQ2Type::GetMember,
+	/// instead of making one P/Invoke and creating one intermediate <see cref="MQ2DataType"/> per member. Not thread safe, evaluate
+	/// it on the EQ thread like any other MQ2 call.
+	/// </summary>
+	[PublicAPI]
+	public class MemberBatch
+	{
+		private const int DefaultTextCapacity = 4096;
+
+		private readonly List<MemberBatchPath> _pathList = new List<MemberBatchPath>();
+		private readonly List<MemberBatchStep> _stepList = new List<MemberBatchStep>();
+		private readonly MQ2TypeFactory _typeFactory;
+
+		private MemberBatchPath[] _paths = Array.Empty<MemberBatchPath>();
+		private MemberBatchResult[] _results = Array.Empty<MemberBatchResult>();
+		private MemberBatchStep[] _steps = Array.Empty<MemberBatchStep>();
+		private byte[] _strings = new byte[256];
+		private int _stringsSize;
+		private byte[] _text = new byte[DefaultTextCapacity];
+
+		public MemberBatch(MQ2TypeFactory typeFactory)
+		{
+			_typeFactory = typeFactory ?? throw new ArgumentNullException(nameof(typeFactory));
+		}
+
+		/// <summary>
+		/// Number of paths in the batch
+		/// </summary>
+		public int Count => _pathList.Count;
+
+		/// <summary>
+		/// Number of paths that resolved during the last <see cref="Evaluate"/>
+		/// </summary>
+		public int SuccessCount { get; private set; }
+
+		/// <summary>
+		/// Adds a path that starts from a TLO, e.g. "Me.Buff[3].Duration.TotalSeconds" or "Spawn[npc radius 50].Name"
+		/// </summary>
+		/// <returns>The id of the path, used to read its result</returns>
+		/// <exception cref="ArgumentException">The path is empty or its brackets don't match</exception>
+		public int Add(string path)
+		{
+			var segments = ParsePath(path);
+			var (rootName, rootIndex) = segments[0];
+
+			return AddPath(new MemberBatchPath
+			{
+				RootNameOffset = AddString(rootName),
+				RootIndexOffset = AddString(rootIndex ?? string.Empty)
+			}, segments, 1);
+		}
+
+		/// <summary>
+		/// Adds a path of members relative to an existing variable, e.g. "Duration.TotalSeconds" relative to a <see cref="DataTypes.BuffType"/>.
+		/// The root is captured as is, if it can change between evaluations update it with <see cref="SetRoot(int, MQ2DataType)"/>
+		/// </summary>
+		/// <returns>The id of the path, used to read its result</returns>
+		/// <exception cref="ArgumentException">The path is empty or its brackets don't match</exception>
+		public int Add(MQ2DataType root, string path)
+		{
+			if (root == null)
+			{
+				throw new ArgumentNullException(nameof(root));
+			}
+
+			return AddPath(new MemberBatchPath
+			{
+				Root = root.TypeVar,
+				RootNameOffset = MemberBatchPath.NoString,
+				RootIndexOffset = MemberBatchPath.NoString
+			}, ParsePath(path), 0);
+		}
+
+		/// <summary>
+		/// Replaces the root variable of a path added with <see cref="Add(MQ2DataType, string)"/>
+		/// </summary>
+		public void SetRoot(int id, MQ2DataType root)
+		{
+			if (root == null)
+			{
+				throw new ArgumentNullException(nameof(root));
+			}
+
+			var path = _pathList[id];
+			if (path.RootNameOffset != MemberBatchPath.NoString)
+			{
+				throw new InvalidOperationException($"Path {id} starts from a TLO");
+			}
+
+			path.Root = root.TypeVar;
+			_pathList[id] = path;
+			if (_paths.Length == _pathList.Count)
+			{
+				_paths[id].Root = path.Root;
+			}
+		}
+
+		/// <summary>
+		/// Removes every path, ids start from 0 again
+		/// </summary>
+		public void Clear()
+		{
+			_pathList.Clear();
+			_stepList.Clear();
+			_stringsSize = 0;
+			_paths = Array.Empty<MemberBatchPath>();
+			_steps = Array.Empty<MemberBatchStep>();
+			Array.Clear(_results, 0, _results.Length);
+			SuccessCount = 0;
+		}
+
+		/// <summary>
+		/// Resolves every path with a single call into the loader
+		/// </summary>
+		/// <returns>The number of paths that resolved</returns>
+		public int Evaluate()
+		{
+			if (_pathList.Count == 0)
+			{
+				SuccessCount = 0;
+				return 0;
+			}
+
+			// The arrays handed to the loader are only rebuilt after the batch changes
+			if (_paths.Length != _pathList.Count)
+			{
+				_paths = _pathList.ToArray();
+				_steps = _stepList.ToArray();
+				if (_results.Length != _paths.Length)
+				{
+					_results = new MemberBatchResult[_paths.Length];
+				}
+			}
+
+			SuccessCount = EvaluatePaths(out var textSize);
+			if (textSize > _text.Length)
+			{
+				// Some string results didn't fit, MQ2's temporary buffers have been overwritten since so the whole batch has to run again
+				_text = new byte[Math.Max(_text.Length * 2, textSize)];
+				SuccessCount = EvaluatePaths(out _);
+			}
+
+			return SuccessCount;
+		}
+
+		/// <summary>
+		/// Returns true if the path resolved during the last <see cref="Evaluate"/>
+		/// </summary>
+		public bool IsSuccess(int id)
+			=> id >= 0 && id < _results.Length && _results[id].IsSuccess != 0;
+
+		/// <summary>
+		/// Wraps the result of a path, or returns null if it didn't resolve
+		/// </summary>
+		/// <exception cref="InvalidCastException" />
+		public T? Get<T>(int id) where T : MQ2DataType
+			=> IsSuccess(id) ? (T)_typeFactory.Create(_results[id].Value) : default;
+
+		/// <summary>
+		/// Raw data of the result of a path, e.g. <see cref="MQ2VarPtr.Int"/> for an int member. Doesn't allocate.
+		/// </summary>
+		public bool TryGetVarPtr(int id, out MQ2VarPtr varPtr)
+		{
+			if (!IsSuccess(id))
+			{
+				varPtr = default;
+				return false;
+			}
+
+			varPtr = _results[id].Value.VarPtr;
+			return true;
+		}
+
+		/// <summary>
+		/// The result of a path as a string, or null if it didn't resolve. String members are copied by the loader during <see cref="Evaluate"/>,
+		/// anything else is converted with MQ2Type::ToString.
+		/// </summary>
+		public string? GetString(int id)
+		{
+			if (!IsSuccess(id))
+			{
+				return null;
+			}
+
+			var textOffset = _results[id].TextOffset;
+			if (textOffset == MemberBatchPath.NoString)
+			{
+				return _results[id].Value.ToString();
+			}
+
+			var textLength = Array.IndexOf(_text, (byte)0, (int)textOffset) - (int)textOffset;
+			return Encoding.UTF8.GetString(_text, (int)textOffset, textLength);
+		}
+
+		private int EvaluatePaths(out int textSize)
+		{
+			var successCount = MQ2DotNetCoreLoader.NativeMethods.MemberBatch__Evaluate(
+				_paths,
+				(uint)_paths.Length,
+				_steps,
+				(uint)_steps.Length,
+				_strings,
+				(uint)_stringsSize,
+				_results,
+				_text,
+				(uint)_text.Length,
+				out var requiredTextSize
+			);
+
+			textSize = (int)requiredTextSize;
+			return (int)successCount;
+		}
+
+		private int AddPath(MemberBatchPath path, List<(string Member, string? Index)> segments, int firstSegment)
+		{
+			path.FirstStep = (uint)_stepList.Count;
+			path.StepCount = (uint)(segments.Count - firstSegment);
+
+			for (var segmentIndex = firstSegment; segmentIndex < segments.Count; ++segmentIndex)
+			{
+				var (member, index) = segments[segmentIndex];
+				_stepList.Add(new MemberBatchStep
+				{
+					MemberOffset = AddString(member),
+					IndexOffset = index == null ? MemberBatchPath.NoString : AddString(index)
+				});
+			}
+
+			_pathList.Add(path);
+			_paths = Array.Empty<MemberBatchPath>();
+			return _pathList.Count - 1;
+		}
+
+		private uint AddString(string value)
+		{
+			var byteCount = Encoding.UTF8.GetByteCount(value) + 1;
+			if (_stringsSize + byteCount > _strings.Length)
+			{
+				Array.Resize(ref _strings, Math.Max(_strings.Length * 2, _stringsSize + byteCount));
+			}
+
+			var offset = _stringsSize;
+			_stringsSize += Encoding.UTF8.GetBytes(value, 0, value.Length, _strings, offset);
+			_strings[_stringsSize++] = 0;
+			return (uint)offset;
+		}
+
+		// Splits "Me.Buff[3].Duration" into (Me, null), (Buff, 3), (Duration, null). Dots inside an index don't split, e.g. Spell[1.5]
+		private static List<(string Member, string? Index)> ParsePath(string path)
+		{
+			if (string.IsNullOrWhiteSpace(path))
+			{
+				throw new ArgumentException("Path must not be empty", nameof(path));
+			}
+
+			var segments = new List<(string Member, string? Index)>();
+			var segmentStart = 0;
+			var bracketDepth = 0;
+			for (var position = 0; position <= path.Length; ++position)
+			{
+				var character = position < path.Length ? path[position] : '.';
+				if (character == '[')
+				{
+					++bracketDepth;
+				}
+				else if (character == ']')
+				{
+					if (--bracketDepth < 0)
+					{
+						throw new ArgumentException($"Unmatched ] in path: {path}", nameof(path));
+					}
+				}
+				else if (character == '.' && bracketDepth == 0)
+				{
+					segments.Add(ParseSegment(path, segmentStart, position));
+					segmentStart = position + 1;
+				}
+			}
+
+			if (bracketDepth != 0)
+			{
+				throw new ArgumentException($"Unmatched [ in path: {path}", nameof(path));
+			}
+
+			return segments;
+		}
+
+		private static (string Member, string? Index) ParseSegment(string path, int start, int end)
+		{
+			var indexStart = path.IndexOf('[', start, end - start);
+			var memberEnd = indexStart < 0 ? end : indexStart;
+			if (memberEnd == start)
+			{
+				throw new ArgumentException($"Empty member name at position {start} in path: {path}", nameof(path));
+			}
+
+			var member = path.Substring(start, memberEnd - start);
+			if (indexStart < 0)
+			{
+				return (member, null);
+			}
+
+			if (path[end - 1] != ']')
+			{
+				throw new ArgumentException($"Unexpected characters after the index of {member} in path: {path}", nameof(path));
+			}
+
+			return (member, path.Substring(indexStart + 1, end - indexStart - 2));
+		}
+	}
+}
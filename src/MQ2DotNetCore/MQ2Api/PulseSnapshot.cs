@@ -0,0 +1,82 @@
+﻿using JetBrains.Annotations;
+using MQ2DotNetCore.Interop;
+using System;
+using System.Threading;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// The spawns, character and target as they were at the start of a pulse, copied out by the loader in one pass and handed to
+	/// the <see cref="MQ2SubmoduleEventRegistry.OnPulseSnapshot"/> handlers on worker threads. Every handler reads the same
+	/// instance and nothing in it changes until all of them have returned, after which the loader refills it for a later pulse,
+	/// so copy anything that has to outlive the handler. Nothing here touches game memory, unlike <see cref="DataTypes.SpawnType"/>
+	/// and the TLOs, which must not be used from a worker thread. Use <see cref="Post(Action)"/> to act on the results.
+	/// </summary>
+	[PublicAPI]
+	public sealed class PulseSnapshot : EventArgs
+	{
+		private readonly SynchronizationContext _synchronizationContext;
+
+		internal PulseSnapshot(SynchronizationContext synchronizationContext)
+		{
+			_synchronizationContext = synchronizationContext;
+			Spawns = new SpawnSnapshot { IsShared = true };
+		}
+
+		/// <summary>
+		/// Increases by one for every pulse that was captured. Pulses that arrive while handlers are still running aren't captured,
+		/// so the sequence doesn't count game pulses.
+		/// </summary>
+		public long Sequence { get; private set; }
+
+		/// <summary>
+		/// Every spawn in the zone, including the character
+		/// </summary>
+		public SpawnSnapshot Spawns { get; }
+
+		/// <summary>
+		/// The character's spawn id, 0 when not in game
+		/// </summary>
+		public uint CharacterSpawnId { get; private set; }
+
+		/// <summary>
+		/// The character's index in <see cref="Spawns"/>, -1 when not in game
+		/// </summary>
+		public int CharacterIndex { get; private set; } = -1;
+
+		/// <summary>
+		/// The target's spawn id, 0 when nothing is targeted
+		/// </summary>
+		public uint TargetSpawnId { get; private set; }
+
+		/// <summary>
+		/// The target's index in <see cref="Spawns"/>, -1 when nothing is targeted
+		/// </summary>
+		public int TargetIndex { get; private set; } = -1;
+
+		/// <summary>
+		/// Runs <paramref name="action"/> on the EQ thread during a later pulse, through the same synchronization context as program
+		/// continuations. This is where the results of an analysis can be acted on, e.g. with <see cref="MQ2.DoCommand(string)"/>.
+		/// </summary>
+		public void Post(Action action)
+		{
+			if (action == null)
+			{
+				throw new ArgumentNullException(nameof(action));
+			}
+
+			_synchronizationContext.Post(state => ((Action)state!).Invoke(), action);
+		}
+
+		// Only called from the EQ thread while no handler is running
+		internal void Capture()
+		{
+			Spawns.Capture(out PulseSnapshotFocus focus);
+			CharacterSpawnId = focus.CharacterSpawnId;
+			CharacterIndex = focus.CharacterIndex;
+			TargetSpawnId = focus.TargetSpawnId;
+			TargetIndex = focus.TargetIndex;
+			++Sequence;
+		}
+	}
+}
@@ -0,0 +1,34 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// The state most multiboxing programs share, ready to pass to <see cref="MQ2StateBus.Publish"/> and
+	/// <see cref="MQ2StateBus.TryRead"/>. Programs that need more can publish their own unmanaged struct of up to
+	/// <see cref="MQ2StateBus.StateCapacity"/> bytes instead, as long as every instance agrees on it.
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	public struct SharedCharacterState
+	{
+		public uint SpawnId;
+		public uint TargetId;
+		public uint ZoneId;
+		public byte HPPercent;
+		public byte ManaPercent;
+		public byte EndurancePercent;
+		public byte Level;
+		public float X;
+		public float Y;
+		public float Z;
+		public float Heading;
+
+		/// <summary>
+		/// Free for the program to use, e.g. a bit per state such as casting, sitting or in combat
+		/// </summary>
+		public uint Flags;
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[SpawnId: {SpawnId}, TargetId: {TargetId}, ZoneId: {ZoneId}, HP: {HPPercent}%, Mana: {ManaPercent}%, Endurance: {EndurancePercent}%, Level: {Level}, Position: ({X}, {Y}, {Z}), Heading: {Heading}, Flags: {Flags}]";
+	}
+}
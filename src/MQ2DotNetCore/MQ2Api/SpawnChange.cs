@@ -0,0 +1,42 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// A spawn whose tracked fields changed since the previous pulse, see <see cref="MQ2SubmoduleEventRegistry.OnSpawnsChanged"/>. Every
+	/// field holds the spawn's current value, <see cref="ChangedFields"/> says which ones changed. Mirrors the SpawnChange struct in
+	/// SpawnChangeFeed.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	public readonly struct SpawnChange
+	{
+		public uint SpawnId { get; }
+		public SpawnChangeFields ChangedFields { get; }
+		public float X { get; }
+		public float Y { get; }
+		public float Z { get; }
+
+		/// <summary>
+		/// Degrees
+		/// </summary>
+		public float Heading { get; }
+		public uint TargetOfTargetId { get; }
+		public byte HPPercent { get; }
+		public byte Level { get; }
+		public EQSpawnType Type { get; }
+		public byte StandState { get; }
+
+		public bool IsAdded => (ChangedFields & SpawnChangeFields.Added) != 0;
+		public bool IsRemoved => (ChangedFields & SpawnChangeFields.Removed) != 0;
+
+		/// <summary>
+		/// Returns true if any of the given fields changed
+		/// </summary>
+		public bool HasChanged(SpawnChangeFields fields)
+			=> (ChangedFields & fields) != 0;
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[SpawnId: {SpawnId}, ChangedFields: {ChangedFields}, X: {X}, Y: {Y}, Z: {Z}, Heading: {Heading}, HPPercent: {HPPercent}, Level: {Level}, Type: {Type}, StandState: {StandState}, TargetOfTargetId: {TargetOfTargetId}]";
+	}
+}
@@ -0,0 +1,40 @@
+﻿using System;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// Spawn fields the loader's change feed can track, and which of them changed in a <see cref="SpawnChange"/>. Mirrors the
+	/// SpawnChangeField enum in SpawnChangeFeed.h
+	/// </summary>
+	[Flags]
+	public enum SpawnChangeFields : uint
+	{
+		None = 0,
+
+		/// <summary>
+		/// X, Y or Z
+		/// </summary>
+		Position = 0x01,
+		Heading = 0x02,
+		HPPercent = 0x04,
+		Level = 0x08,
+
+		/// <summary>
+		/// e.g. an NPC turning into a corpse
+		/// </summary>
+		Type = 0x10,
+		StandState = 0x20,
+		TargetOfTarget = 0x40,
+		All = Position | Heading | HPPercent | Level | Type | StandState | TargetOfTarget,
+
+		/// <summary>
+		/// Only set on changes, the spawn was added to the zone since the previous pulse. Every other field holds its initial value
+		/// </summary>
+		Added = 0x40000000,
+
+		/// <summary>
+		/// Only set on changes, the spawn was removed from the zone since the previous pulse. Every other field holds its last known value
+		/// </summary>
+		Removed = 0x80000000
+	}
+}
@@ -0,0 +1,56 @@
+﻿using JetBrains.Annotations;
+using System;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// Identifies a spawn for as long as it is in the zone. The loader hands one out when the spawn is added and releases it when
+	/// the spawn is removed or the zone changes, after which the handle never resolves again, even once its slot is reused.
+	/// </summary>
+	[PublicAPI]
+	public readonly struct SpawnHandle : IEquatable<SpawnHandle>
+	{
+		/// <summary>
+		/// No spawn, e.g. for spawns the loader's handle table had no room for
+		/// </summary>
+		public static readonly SpawnHandle None = default;
+
+		internal SpawnHandle(ulong value)
+		{
+			Value = value;
+		}
+
+		/// <summary>
+		/// The slot's index in the low 32 bits and its generation in the high 32
+		/// </summary>
+		public ulong Value { get; }
+
+		internal uint Index => (uint)Value;
+		internal uint Generation => (uint)(Value >> 32);
+
+		/// <summary>
+		/// True for <see cref="None"/>
+		/// </summary>
+		public bool IsNone => Value == 0;
+
+		/// <summary>
+		/// True while the spawn is still in the zone. Must be checked from the EQ thread.
+		/// </summary>
+		public bool IsAlive => Interop.SpawnHandleTable.TryResolve(this, out _);
+
+		/// <inheritdoc />
+		public bool Equals(SpawnHandle other) => Value == other.Value;
+
+		/// <inheritdoc />
+		public override bool Equals(object? obj) => obj is SpawnHandle other && Equals(other);
+
+		/// <inheritdoc />
+		public override int GetHashCode() => Value.GetHashCode();
+
+		/// <inheritdoc />
+		public override string ToString() => IsNone ? "None" : $"{Index}:{Generation}";
+
+		public static bool operator ==(SpawnHandle left, SpawnHandle right) => left.Equals(right);
+		public static bool operator !=(SpawnHandle left, SpawnHandle right) => !left.Equals(right);
+	}
+}
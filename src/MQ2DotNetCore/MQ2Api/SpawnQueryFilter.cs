@@ -0,0 +1,16 @@
+﻿using System;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// Which spawn types a spatial query should return, one bit per <see cref="EQSpawnType"/>
+	/// </summary>
+	[Flags]
+	public enum SpawnQueryFilter : uint
+	{
+		Any = 0,
+		Player = 1 << EQSpawnType.Player,
+		NPC = 1 << EQSpawnType.NPC,
+		Corpse = 1 << EQSpawnType.Corpse
+	}
+}
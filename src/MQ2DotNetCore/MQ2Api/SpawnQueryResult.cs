@@ -0,0 +1,28 @@
+﻿using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// A spawn returned by one of the <see cref="MQ2Spawns"/> spatial queries. Mirrors the SpawnQueryResult struct in SpawnSpatialIndex.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	public readonly struct SpawnQueryResult
+	{
+		public SpawnQueryResult(uint spawnId, float distance)
+		{
+			SpawnId = spawnId;
+			Distance = distance;
+		}
+
+		public uint SpawnId { get; }
+
+		/// <summary>
+		/// 2D distance from the query point (or the center of the box for box queries)
+		/// </summary>
+		public float Distance { get; }
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[SpawnId: {SpawnId}, Distance: {Distance}]";
+	}
+}
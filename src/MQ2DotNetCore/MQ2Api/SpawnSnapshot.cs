@@ -0,0 +1,116 @@
+﻿using JetBrains.Annotations;
+using MQ2DotNetCore.Interop;
+using System;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// A structure of arrays copy of every spawn in the zone, captured by the loader in a single call. Index i of each span
+	/// refers to the same spawn. Reading it doesn't allocate (except <see cref="GetName(int)"/>) and doesn't call back into MQ2,
+	/// but it is only as current as the last <see cref="MQ2Spawns.CaptureSnapshot(SpawnSnapshot?)"/> call.
+	/// </summary>
+	[PublicAPI]
+	public class SpawnSnapshot
+	{
+		private const int DefaultCapacity = 512;
+
+		private byte[] _buffer = Array.Empty<byte>();
+		private SpawnSnapshotLayout _layout;
+
+		public SpawnSnapshot(int initialCapacity = DefaultCapacity)
+		{
+			if (initialCapacity <= 0)
+			{
+				throw new ArgumentOutOfRangeException(nameof(initialCapacity), "must be greater than zero.");
+			}
+
+			Resize((uint)initialCapacity);
+		}
+
+		/// <summary>
+		/// Number of spawns the snapshot can hold before it has to grow
+		/// </summary>
+		public int Capacity => (int)_layout.Capacity;
+
+		/// <summary>
+		/// Number of spawns in the snapshot
+		/// </summary>
+		public int Count { get; private set; }
+
+		public ReadOnlySpan<uint> Ids => GetSpan<uint>(_layout.IdsOffset);
+		public ReadOnlySpan<float> X => GetSpan<float>(_layout.XOffset);
+		public ReadOnlySpan<float> Y => GetSpan<float>(_layout.YOffset);
+		public ReadOnlySpan<float> Z => GetSpan<float>(_layout.ZOffset);
+
+		/// <summary>
+		/// Headings in degrees
+		/// </summary>
+		public ReadOnlySpan<float> Headings => GetSpan<float>(_layout.HeadingsOffset);
+
+		public ReadOnlySpan<EQSpawnType> Types => GetSpan<EQSpawnType>(_layout.TypesOffset);
+		public ReadOnlySpan<byte> Levels => GetSpan<byte>(_layout.LevelsOffset);
+		public ReadOnlySpan<byte> HPPercents => GetSpan<byte>(_layout.HPPercentsOffset);
+
+		/// <summary>
+		/// The name of the spawn at the given index (SPAWNINFO::Name, same as <see cref="DataTypes.SpawnType.Name"/>). Allocates a string,
+		/// use <see cref="GetNameBytes(int)"/> to compare names without allocating.
+		/// </summary>
+		public string GetName(int index)
+			=> Encoding.ASCII.GetString(GetNameBytes(index));
+
+		/// <summary>
+		/// The ASCII name of the spawn at the given index, without the null terminator
+		/// </summary>
+		public ReadOnlySpan<byte> GetNameBytes(int index)
+		{
+			if ((uint)index >= (uint)Count)
+			{
+				throw new ArgumentOutOfRangeException(nameof(index));
+			}
+
+			var nameOffset = (int)(_layout.NamesOffset + GetSpan<uint>(_layout.NameOffsetsOffset)[index]);
+			var name = _buffer.AsSpan(nameOffset, (int)_layout.TotalSize - nameOffset);
+			var nameLength = name.IndexOf((byte)0);
+			return nameLength < 0 ? name : name.Slice(0, nameLength);
+		}
+
+		/// <summary>
+		/// Index of the spawn with the given id, or -1 if it isn't in the snapshot
+		/// </summary>
+		public int IndexOf(uint spawnId)
+			=> Ids.IndexOf(spawnId);
+
+		/// <summary>
+		/// True for the snapshot a <see cref="PulseSnapshot"/> shares between worker threads, which only the loader entry point may refill
+		/// </summary>
+		internal bool IsShared { get; set; }
+
+		internal void Capture()
+			=> Capture(out _);
+
+		internal void Capture(out PulseSnapshotFocus focus)
+		{
+			var count = MQ2DotNetCoreLoader.NativeMethods.SpawnSnapshot__CapturePulse(_buffer, (uint)_buffer.Length, _layout.Capacity, out var totalCount, out focus);
+			if (totalCount > _layout.Capacity)
+			{
+				// Leave some head room so a few spawns popping doesn't force another resize on the next capture
+				Resize(totalCount + totalCount / 4);
+				count = MQ2DotNetCoreLoader.NativeMethods.SpawnSnapshot__CapturePulse(_buffer, (uint)_buffer.Length, _layout.Capacity, out _, out focus);
+			}
+
+			Count = (int)count;
+		}
+
+		private ReadOnlySpan<T> GetSpan<T>(uint offset) where T : struct
+			=> MemoryMarshal.Cast<byte, T>(_buffer.AsSpan((int)offset)).Slice(0, Count);
+
+		private void Resize(uint capacity)
+		{
+			MQ2DotNetCoreLoader.NativeMethods.SpawnSnapshot__GetLayout(capacity, out _layout);
+			_buffer = new byte[_layout.TotalSize];
+			Count = 0;
+		}
+	}
+}
@@ -0,0 +1,18 @@
+﻿using System;
+using System.Collections.Generic;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	public class SpawnsChangedEventArgs : EventArgs
+	{
+		public SpawnsChangedEventArgs(IReadOnlyList<SpawnChange> changes)
+		{
+			Changes = changes;
+		}
+
+		/// <summary>
+		/// One entry per spawn that was added, removed, or had a tracked field change since the previous pulse
+		/// </summary>
+		public IReadOnlyList<SpawnChange> Changes { get; }
+	}
+}
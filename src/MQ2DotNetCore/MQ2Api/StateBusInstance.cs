@@ -0,0 +1,58 @@
+﻿using System;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// A client with a slot on the state bus, from <see cref="MQ2StateBus.TryGetInstance"/>. Mirrors the SharedStateInstanceInfo struct
+	/// in SharedStateBus.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	public unsafe struct StateBusInstance
+	{
+		private readonly uint _processId;
+		private readonly uint _stateSize;
+		private readonly ulong _publishCount;
+		private readonly long _ageMicroseconds;
+		private fixed byte _name[64];
+
+		public uint ProcessId => _processId;
+
+		/// <summary>
+		/// Size of the last published state, 0 if the instance hasn't published yet
+		/// </summary>
+		public int StateSize => (int)_stateSize;
+
+		public ulong PublishCount => _publishCount;
+
+		/// <summary>
+		/// Time since the instance last published or pulsed
+		/// </summary>
+		public TimeSpan Age => TimeSpan.FromTicks(_ageMicroseconds * 10);
+
+		/// <summary>
+		/// The name set with <see cref="MQ2StateBus.SetInstanceName"/>, empty if none was set
+		/// </summary>
+		public string Name
+		{
+			get
+			{
+				fixed (byte* pName = _name)
+				{
+					var length = 0;
+					while (length < 64 && pName[length] != 0)
+					{
+						++length;
+					}
+
+					return Encoding.UTF8.GetString(pName, length);
+				}
+			}
+		}
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[Name: {Name}, ProcessId: {ProcessId}, StateSize: {StateSize}, PublishCount: {PublishCount}, Age: {Age.TotalMilliseconds:0} ms]";
+	}
+}
@@ -0,0 +1,66 @@
+﻿using System;
+using System.Runtime.InteropServices;
+
+namespace MQ2DotNetCore.MQ2Api
+{
+	/// <summary>
+	/// A message received through <see cref="MQ2StateBus.Receive"/>. Mirrors the SharedStateMessage struct in SharedStateBus.h
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	public unsafe struct StateBusMessage
+	{
+		public const int PayloadCapacity = 232;
+
+		private readonly int _senderIndex;
+		private readonly int _targetIndex;
+		private readonly uint _messageType;
+		private readonly uint _size;
+		private fixed byte _payload[PayloadCapacity];
+
+		/// <summary>
+		/// Slot of the instance that sent the message
+		/// </summary>
+		public int SenderIndex => _senderIndex;
+
+		/// <summary>
+		/// Slot the message was sent to, -1 for broadcasts
+		/// </summary>
+		public int TargetIndex => _targetIndex;
+
+		public uint MessageType => _messageType;
+		public int Size => (int)_size;
+
+		/// <summary>
+		/// Reads the payload as the struct it was sent as, throws if the payload is smaller than <typeparamref name="T"/>
+		/// </summary>
+		public T ReadPayload<T>() where T : unmanaged
+		{
+			if (sizeof(T) > _size)
+			{
+				throw new InvalidOperationException($"The {_size} byte payload is too small for a {typeof(T).Name}");
+			}
+
+			fixed (byte* pPayload = _payload)
+			{
+				return *(T*)pPayload;
+			}
+		}
+
+		/// <summary>
+		/// Copies the payload, returns the number of bytes copied
+		/// </summary>
+		public int CopyPayloadTo(Span<byte> destination)
+		{
+			fixed (byte* pPayload = _payload)
+			{
+				var size = Math.Min((int)_size, destination.Length);
+				new ReadOnlySpan<byte>(pPayload, size).CopyTo(destination);
+				return size;
+			}
+		}
+
+		/// <inheritdoc />
+		public override string ToString()
+			=> $"[SenderIndex: {SenderIndex}, TargetIndex: {TargetIndex}, MessageType: {MessageType}, Size: {Size}]";
+	}
+}
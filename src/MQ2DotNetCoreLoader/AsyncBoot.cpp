@@ -0,0 +1,122 @@
+#include "AsyncBoot.h"
+
+#include <cstdio>
+
+AsyncBoot g_asyncBoot;
+
+namespace
+{
+	const char* const PhaseNames[] = {
+		"hostfxr path",
+		"load hostfxr",
+		"initialize runtime",
+		"get runtime delegate",
+		"load entry assembly",
+		"prepare entry point",
+		"initialize entry point"
+	};
+	static_assert(sizeof(PhaseNames) / sizeof(PhaseNames[0]) == static_cast<uint32_t>(BootPhase::Count), "Every boot phase needs a name");
+}
+
+BootPolicy AsyncBoot::GetPolicy(LoaderCallback callback)
+{
+	switch (callback)
+	{
+	case LoaderCallback::WriteChatColor:
+	case LoaderCallback::IncomingChat:
+	case LoaderCallback::BeginZone:
+	case LoaderCallback::EndZone:
+	case LoaderCallback::Zoned:
+	case LoaderCallback::ReloadUI:
+	case LoaderCallback::CleanUI:
+	case LoaderCallback::SetGameState:
+		return BootPolicy::Queue;
+
+	default:
+		return BootPolicy::Drop;
+	}
+}
+
+void AsyncBoot::Defer(LoaderCallback callback, const char* line, uint32_t argument0, uint32_t argument1)
+{
+	if (GetPolicy(callback) != BootPolicy::Queue || m_queued.size() >= MaxQueuedCallbacks)
+	{
+		++m_droppedCount;
+		return;
+	}
+
+	m_queued.push_back(QueuedCallback{ callback, line ? line : "", { argument0, argument1 } });
+	++m_queuedCount;
+}
+
+std::string AsyncBoot::FormatTimings() const
+{
+	std::string timings;
+	char buffer[96];
+	uint64_t totalNanoseconds = 0;
+	for (uint32_t phase = 0; phase < static_cast<uint32_t>(BootPhase::Count); ++phase)
+	{
+		snprintf(buffer, sizeof(buffer), "%s %.1f ms, ", PhaseNames[phase], m_phaseNanoseconds[phase] / 1e6);
+		timings += buffer;
+		totalNanoseconds += m_phaseNanoseconds[phase];
+	}
+
+	snprintf(buffer, sizeof(buffer), "total %.1f ms, %llu callbacks queued, %llu dropped", totalNanoseconds / 1e6,
+		static_cast<unsigned long long>(m_queuedCount), static_cast<unsigned long long>(m_droppedCount));
+	return timings + buffer;
+}
+
+void AsyncBoot::Reset()
+{
+	SetState(BootState::Idle);
+	m_queued.clear();
+	m_queuedCount = 0;
+	m_droppedCount = 0;
+	for (auto& phaseNanoseconds : m_phaseNanoseconds)
+	{
+		phaseNanoseconds = 0;
+	}
+}
+
+void AsyncBoot::StartWarmup()
+{
+	m_warmupStart = std::chrono::steady_clock::now();
+	m_timeToFirstPulseNanoseconds = 0;
+	m_warmupPulseCount = 0;
+	m_warmupPulses.Reset();
+}
+
+bool AsyncBoot::RecordWarmupPulse(uint64_t nanoseconds)
+{
+	if (!IsWarmingUp())
+		return false;
+
+	if (m_warmupPulseCount == 0)
+	{
+		const auto elapsed = std::chrono::steady_clock::now() - m_warmupStart;
+		m_timeToFirstPulseNanoseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+	}
+
+	m_warmupPulses.Record(nanoseconds);
+	return ++m_warmupPulseCount == WarmupPulseCount;
+}
+
+void AsyncBoot::GetWarmupSummary(WarmupSummary* pSummary) const
+{
+	pSummary->TimeToFirstPulseNanoseconds = m_timeToFirstPulseNanoseconds;
+	pSummary->PulseCount = m_warmupPulseCount;
+	pSummary->IsPreWarmEnabled = m_isPreWarmEnabled ? 1 : 0;
+	m_warmupPulses.GetSummary(&pSummary->Pulses);
+}
+
+std::string AsyncBoot::FormatWarmup() const
+{
+	WarmupSummary summary;
+	GetWarmupSummary(&summary);
+
+	char buffer[192];
+	snprintf(buffer, sizeof(buffer), "first pulse after %.1f ms, first %u pulses p50 %.1f us, p99 %.1f us, max %.1f us, total %.1f ms%s",
+		summary.TimeToFirstPulseNanoseconds / 1e6, summary.PulseCount, summary.Pulses.P50Nanoseconds / 1e3, summary.Pulses.P99Nanoseconds / 1e3,
+		summary.Pulses.MaxNanoseconds / 1e3, summary.Pulses.TotalNanoseconds / 1e6, m_isPreWarmEnabled ? ", pre-warmed" : "");
+	return buffer;
+}
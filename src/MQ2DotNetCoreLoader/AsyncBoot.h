@@ -0,0 +1,162 @@
+#pragma once
+
+#include "CallbackTimings.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class BootState : uint32_t
+{
+	Idle,
+
+	// The background thread is starting the runtime and loading the entry assembly
+	Booting,
+
+	// The background thread is done, the managed InitializePlugin runs on the next pulse
+	HostReady,
+
+	Ready,
+	Failed
+};
+
+// Steps of starting the CLR and the managed side, in the order they run
+enum class BootPhase : uint32_t
+{
+	HostfxrPath = 0,
+	LoadHostfxr,
+	InitializeRuntime,
+	GetRuntimeDelegate,
+	LoadEntryAssembly,
+	PrepareEntryPoint,
+	InitializeEntryPoint,
+	Count
+};
+
+// Time from loading (or hot reloading) the managed side to the end of the first pulse it handled, and what the first
+// AsyncBoot::WarmupPulseCount pulses cost, which is where JIT stalls show up. Mirrored by WarmupSummary.cs.
+struct WarmupSummary
+{
+	uint64_t TimeToFirstPulseNanoseconds;
+	uint32_t PulseCount;
+	uint32_t IsPreWarmEnabled;
+	CallbackTimingSummary Pulses;
+};
+
+// What happens to a callback that arrives while the CLR is still booting
+enum class BootPolicy : uint8_t
+{
+	Drop,
+
+	// Replayed on the EQ thread, in arrival order, once the managed side is initialized
+	Queue
+};
+
+// State for booting the CLR off the EQ thread (AsyncBoot=1 in MQ2DotNetCoreLoader.ini). The runtime is started and the
+// entry assembly loaded and prepared on a background thread while the forwarders keep returning immediately, the managed
+// InitializePlugin then runs on the EQ thread during the first pulse after that. Callbacks that arrive in the meantime
+// are queued or dropped according to GetPolicy. Per frame callbacks are dropped, as are the spawn and ground item ones
+// since their pointers may be freed before they could be replayed (the spawn list is read directly once booted). Chat
+// lines are copied so they can be queued.
+//
+// The state is read from both threads, the queue is only touched from the EQ thread.
+class AsyncBoot
+{
+public:
+	// Past this many queued callbacks, new ones are dropped
+	static const size_t MaxQueuedCallbacks = 4096;
+
+	// Pulses in the warm-up window
+	static const uint32_t WarmupPulseCount = 100;
+
+	struct QueuedCallback
+	{
+		LoaderCallback Callback;
+		std::string Line;
+
+		// Color and filter for chat, the game state for SetGameState
+		uint32_t Arguments[2];
+	};
+
+	static BootPolicy GetPolicy(LoaderCallback callback);
+
+	BootState GetState() const { return m_state.load(std::memory_order_acquire); }
+	void SetState(BootState state) { m_state.store(state, std::memory_order_release); }
+	bool IsBooting() const { const BootState state = GetState(); return state == BootState::Booting || state == BootState::HostReady; }
+
+	// Queues the callback if its policy allows it and there's room, line is copied and may be null
+	void Defer(LoaderCallback callback, const char* line, uint32_t argument0, uint32_t argument1);
+
+	// Hands every queued callback to replay(QueuedCallback&) in arrival order and empties the queue. The queue is swapped out
+	// first, so the replayed callbacks can't add to it.
+	template<typename Replay>
+	void ReplayQueued(Replay replay)
+	{
+		std::vector<QueuedCallback> queued;
+		queued.swap(m_queued);
+		for (auto& queuedCallback : queued)
+		{
+			replay(queuedCallback);
+		}
+	}
+
+	void RecordPhase(BootPhase phase, uint64_t nanoseconds) { m_phaseNanoseconds[static_cast<uint32_t>(phase)] = nanoseconds; }
+
+	// One line with each phase's time, the total and the queued / dropped callback counts, for the loader log
+	std::string FormatTimings() const;
+
+	// Back to Idle with an empty queue and no timings
+	void Reset();
+
+	// PreWarm=1 in MQ2DotNetCoreLoader.ini, the managed side JITs its hot paths on a background thread while the game runs
+	bool IsPreWarmEnabled() const { return m_isPreWarmEnabled; }
+	void SetPreWarmEnabled(bool isEnabled) { m_isPreWarmEnabled = isEnabled; }
+
+	// Starts a new warm-up window, the time to the first pulse is measured from here. EQ thread only, like the window itself.
+	void StartWarmup();
+	bool IsWarmingUp() const { return m_warmupPulseCount < WarmupPulseCount; }
+
+	// Returns true for the pulse that completes the window
+	bool RecordWarmupPulse(uint64_t nanoseconds);
+	void GetWarmupSummary(WarmupSummary* pSummary) const;
+
+	// One line with the time to the first pulse and the window's pulse latencies, for the loader log
+	std::string FormatWarmup() const;
+
+private:
+	std::atomic<BootState> m_state{ BootState::Idle };
+	std::vector<QueuedCallback> m_queued;
+	uint64_t m_queuedCount{ 0 };
+	uint64_t m_droppedCount{ 0 };
+	uint64_t m_phaseNanoseconds[static_cast<uint32_t>(BootPhase::Count)]{};
+
+	bool m_isPreWarmEnabled{ false };
+	std::chrono::steady_clock::time_point m_warmupStart{};
+	uint64_t m_timeToFirstPulseNanoseconds{ 0 };
+	uint32_t m_warmupPulseCount{ WarmupPulseCount };
+	LatencyHistogram m_warmupPulses;
+};
+
+extern AsyncBoot g_asyncBoot;
+
+// Times the enclosing scope into a boot phase
+class BootPhaseTimer
+{
+public:
+	explicit BootPhaseTimer(BootPhase phase) : m_phase(phase), m_start(std::chrono::steady_clock::now()) {}
+
+	~BootPhaseTimer()
+	{
+		const auto elapsed = std::chrono::steady_clock::now() - m_start;
+		g_asyncBoot.RecordPhase(m_phase, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+	}
+
+	BootPhaseTimer(const BootPhaseTimer&) = delete;
+	BootPhaseTimer& operator=(const BootPhaseTimer&) = delete;
+
+private:
+	BootPhase m_phase;
+	std::chrono::steady_clock::time_point m_start;
+};
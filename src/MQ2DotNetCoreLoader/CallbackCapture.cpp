@@ -0,0 +1,200 @@
+#include "CallbackCapture.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+#else
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#endif
+
+CallbackCapture g_callbackCapture;
+
+namespace
+{
+	// Windows maps views at multiples of the allocation granularity, everything else at multiples of the page size
+	uint64_t getMappingGranularity()
+	{
+#ifdef _WIN32
+		SYSTEM_INFO systemInfo;
+		::GetSystemInfo(&systemInfo);
+		return systemInfo.dwAllocationGranularity;
+#else
+		return static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+	}
+
+	uint32_t alignRecordSize(uint32_t size)
+	{
+		return (size + 7) & ~7u;
+	}
+}
+
+bool CallbackCapture::Start(const char_t* path, uint64_t maxBytes)
+{
+	if (m_pWindow != nullptr)
+		return true;
+
+#ifdef _WIN32
+	const HANDLE fileHandle = ::CreateFileW(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	m_fileHandle = fileHandle;
+#else
+	m_descriptor = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (m_descriptor < 0)
+		return false;
+#endif
+
+	m_maxBytes = std::max(maxBytes, static_cast<uint64_t>(WindowSize));
+	m_writeOffset = 0;
+	m_recordCount = 0;
+	m_droppedCount = 0;
+	if (!mapWindow(0))
+	{
+		Stop();
+		return false;
+	}
+
+	CaptureFileHeader header{ { 'M', 'Q', '2', 'C' }, Version, static_cast<int64_t>(time(nullptr)) };
+	memcpy(m_pWindow, &header, sizeof(header));
+	m_writeOffset = sizeof(header);
+	m_start = std::chrono::steady_clock::now();
+	return true;
+}
+
+void CallbackCapture::Stop()
+{
+	unmapWindow();
+
+#ifdef _WIN32
+	if (m_fileHandle != nullptr)
+	{
+		LARGE_INTEGER length;
+		length.QuadPart = static_cast<LONGLONG>(m_writeOffset);
+		if (::SetFilePointerEx(static_cast<HANDLE>(m_fileHandle), length, nullptr, FILE_BEGIN))
+			::SetEndOfFile(static_cast<HANDLE>(m_fileHandle));
+
+		::CloseHandle(static_cast<HANDLE>(m_fileHandle));
+		m_fileHandle = nullptr;
+	}
+#else
+	if (m_descriptor >= 0)
+	{
+		// Best effort, an untrimmed capture still reads correctly since its zero filled tail ends it
+		[[maybe_unused]] const bool isTrimmed = ftruncate(m_descriptor, static_cast<off_t>(m_writeOffset)) == 0;
+		close(m_descriptor);
+		m_descriptor = -1;
+	}
+#endif
+
+	m_isSuspended = false;
+}
+
+void CallbackCapture::append(LoaderCallback callback, uint32_t argument0, uint32_t argument1, const void* pPayload, uint32_t payloadSize)
+{
+	if (payloadSize > MaxPayloadSize)
+		payloadSize = MaxPayloadSize;
+
+	const uint32_t recordSize = alignRecordSize(static_cast<uint32_t>(sizeof(CaptureRecordHeader)) + payloadSize);
+	if (m_writeOffset + recordSize > m_maxBytes)
+	{
+		++m_droppedCount;
+		return;
+	}
+
+	if (m_writeOffset + recordSize > m_windowOffset + WindowSize && !mapWindow(m_writeOffset))
+	{
+		++m_droppedCount;
+		return;
+	}
+
+	uint8_t* pRecord = m_pWindow + (m_writeOffset - m_windowOffset);
+	CaptureRecordHeader header;
+	header.Type = CaptureRecordMarker | static_cast<uint32_t>(callback);
+	header.PayloadSize = payloadSize;
+	header.Nanoseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count());
+	header.Arguments[0] = argument0;
+	header.Arguments[1] = argument1;
+	memcpy(pRecord, &header, sizeof(header));
+	if (payloadSize > 0)
+		memcpy(pRecord + sizeof(header), pPayload, payloadSize);
+
+	m_writeOffset += recordSize;
+	++m_recordCount;
+}
+
+void CallbackCapture::GetStatistics(CallbackCaptureStatistics* pStatistics) const
+{
+	if (pStatistics == nullptr)
+		return;
+
+	pStatistics->RecordCount = m_recordCount;
+	pStatistics->ByteCount = m_writeOffset;
+	pStatistics->DroppedCount = m_droppedCount;
+	pStatistics->IsCapturing = m_pWindow != nullptr ? 1 : 0;
+	pStatistics->Reserved = 0;
+}
+
+// Grows the file to cover the new window and maps it. The window starts at or just before offset, so the record being written
+// always fits.
+bool CallbackCapture::mapWindow(uint64_t offset)
+{
+	unmapWindow();
+
+	const uint64_t granularity = getMappingGranularity();
+	const uint64_t windowOffset = offset - offset % granularity;
+	const uint64_t fileSize = windowOffset + WindowSize;
+
+#ifdef _WIN32
+	const HANDLE mappingHandle = ::CreateFileMappingW(static_cast<HANDLE>(m_fileHandle), nullptr, PAGE_READWRITE,
+		static_cast<DWORD>(fileSize >> 32), static_cast<DWORD>(fileSize), nullptr);
+	if (mappingHandle == nullptr)
+		return false;
+
+	void* pView = ::MapViewOfFile(mappingHandle, FILE_MAP_WRITE, static_cast<DWORD>(windowOffset >> 32), static_cast<DWORD>(windowOffset), WindowSize);
+	if (pView == nullptr)
+	{
+		::CloseHandle(mappingHandle);
+		return false;
+	}
+
+	m_mappingHandle = mappingHandle;
+#else
+	if (ftruncate(m_descriptor, static_cast<off_t>(fileSize)) != 0)
+		return false;
+
+	void* pView = mmap(nullptr, WindowSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_descriptor, static_cast<off_t>(windowOffset));
+	if (pView == MAP_FAILED)
+		return false;
+#endif
+
+	m_pWindow = static_cast<uint8_t*>(pView);
+	m_windowOffset = windowOffset;
+	return true;
+}
+
+void CallbackCapture::unmapWindow()
+{
+	if (m_pWindow == nullptr)
+		return;
+
+#ifdef _WIN32
+	::UnmapViewOfFile(m_pWindow);
+	::CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+	m_mappingHandle = nullptr;
+#else
+	munmap(m_pWindow, WindowSize);
+#endif
+
+	m_pWindow = nullptr;
+}
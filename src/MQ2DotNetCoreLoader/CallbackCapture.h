@@ -0,0 +1,174 @@
+#pragma once
+
+#include "CallbackTimings.h"
+#include "includes/hostfxr.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// A capture file is a CaptureFileHeader followed by records, each a CaptureRecordHeader and its payload padded to 8 bytes. The
+// space after the last record is zero filled, so a capture that was never stopped (e.g. the client crashed) still reads up to
+// the last record that was written.
+struct CaptureFileHeader
+{
+	char Magic[4];
+	uint32_t Version;
+
+	// Wall clock time the capture started, seconds since the Unix epoch
+	int64_t StartTime;
+};
+
+struct CaptureRecordHeader
+{
+	// CaptureRecordMarker | LoaderCallback
+	uint32_t Type;
+	uint32_t PayloadSize;
+
+	// Since the capture started
+	uint64_t Nanoseconds;
+
+	// Color and Filter for chat, GameState for SetGameState, CaptureSeeded for spawns that were in the zone before the capture
+	uint32_t Arguments[2];
+};
+
+const uint32_t CaptureRecordMarker = 0xCA000000;
+const uint32_t CaptureSeeded = 1;
+
+// The client's SPAWNINFO and GROUNDITEM are far bigger than the stub's and change with every patch, so spawns and ground items
+// are captured as these instead, the fields the loader and the stub host read. Address identifies the spawn / item so its
+// removal can be matched with its addition.
+struct CapturedSpawn
+{
+	uint64_t Address;
+	char Name[64];
+	float X;
+	float Y;
+	float Z;
+	float Heading;
+	uint32_t SpawnID;
+	uint8_t Type;
+	uint8_t Level;
+	uint8_t StandState;
+	uint8_t Reserved;
+	int32_t HPCurrent;
+	int32_t HPMax;
+};
+
+struct CapturedGroundItem
+{
+	uint64_t Address;
+	char Name[64];
+	float X;
+	float Y;
+	float Z;
+	float Heading;
+	uint32_t ID;
+	uint32_t DropID;
+};
+
+// Layout is mirrored by MQ2DotNetCore.Interop.CallbackCaptureStatistics, keep them in sync
+struct CallbackCaptureStatistics
+{
+	uint64_t RecordCount;
+	uint64_t ByteCount;
+	uint64_t DroppedCount;
+	uint32_t IsCapturing;
+	uint32_t Reserved;
+};
+
+// Appends every callback the loader receives to a file, for LoaderReplay to feed back through the loader offline. The file is
+// written through a memory mapped window that slides along as it fills, so recording a callback is a copy into mapped memory
+// and the file only grows (and the window moves) once every WindowSize bytes. Not thread safe, the forwarders all run on the
+// EQ thread.
+class CallbackCapture
+{
+public:
+	static const uint32_t Version = 1;
+	static const size_t WindowSize = 16 * 1024 * 1024;
+	static const uint32_t MaxPayloadSize = 8 * 1024;
+
+	CallbackCapture() = default;
+	~CallbackCapture() { Stop(); }
+
+	CallbackCapture(const CallbackCapture&) = delete;
+	CallbackCapture& operator=(const CallbackCapture&) = delete;
+
+	// Creates (or overwrites) the file. Once it reaches maxBytes further records are dropped and counted.
+	bool Start(const char_t* path, uint64_t maxBytes);
+
+	// Trims the file to the records written and closes it
+	void Stop();
+
+	bool IsCapturing() const { return m_pWindow != nullptr && !m_isSuspended; }
+
+	// While suspended nothing is recorded, e.g. when the loader calls its own forwarders again
+	void SetSuspended(bool isSuspended) { m_isSuspended = isSuspended; }
+
+	// Payloads past MaxPayloadSize are truncated. Only costs the check while nothing is being captured.
+	void Record(LoaderCallback callback, uint32_t argument0 = 0, uint32_t argument1 = 0, const void* pPayload = nullptr, uint32_t payloadSize = 0)
+	{
+		if (IsCapturing())
+			append(callback, argument0, argument1, pPayload, payloadSize);
+	}
+
+	void GetStatistics(CallbackCaptureStatistics* pStatistics) const;
+
+private:
+	void append(LoaderCallback callback, uint32_t argument0, uint32_t argument1, const void* pPayload, uint32_t payloadSize);
+	bool mapWindow(uint64_t offset);
+	void unmapWindow();
+
+	uint8_t* m_pWindow{ nullptr };
+	uint64_t m_windowOffset{ 0 };
+	uint64_t m_writeOffset{ 0 };
+	uint64_t m_maxBytes{ 0 };
+	uint64_t m_recordCount{ 0 };
+	uint64_t m_droppedCount{ 0 };
+	bool m_isSuspended{ false };
+	std::chrono::steady_clock::time_point m_start;
+
+#ifdef _WIN32
+	void* m_fileHandle{ nullptr };
+	void* m_mappingHandle{ nullptr };
+#else
+	int m_descriptor{ -1 };
+#endif
+};
+
+extern CallbackCapture g_callbackCapture;
+
+struct CaptureRecord
+{
+	LoaderCallback Callback;
+	uint64_t Nanoseconds;
+	uint32_t Arguments[2];
+	const uint8_t* pPayload;
+	uint32_t PayloadSize;
+};
+
+// Maps a whole capture file read only and walks its records
+class CallbackCaptureReader
+{
+public:
+	CallbackCaptureReader() = default;
+	~CallbackCaptureReader() { Close(); }
+
+	CallbackCaptureReader(const CallbackCaptureReader&) = delete;
+	CallbackCaptureReader& operator=(const CallbackCaptureReader&) = delete;
+
+	// False if the file couldn't be mapped or isn't a capture of this version
+	bool Open(const char_t* path);
+	void Close();
+
+	const CaptureFileHeader* GetHeader() const { return reinterpret_cast<const CaptureFileHeader*>(m_pData); }
+
+	// False after the last record
+	bool Next(CaptureRecord* pRecord);
+	void Rewind() { m_offset = sizeof(CaptureFileHeader); }
+
+private:
+	const uint8_t* m_pData{ nullptr };
+	size_t m_size{ 0 };
+	size_t m_offset{ 0 };
+};
@@ -0,0 +1,109 @@
+#include "CallbackCapture.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+#else
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#endif
+
+bool CallbackCaptureReader::Open(const char_t* path)
+{
+	Close();
+
+#ifdef _WIN32
+	const HANDLE fileHandle = ::CreateFileW(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	const HANDLE mappingHandle = ::GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart >= static_cast<LONGLONG>(sizeof(CaptureFileHeader))
+		? ::CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr)
+		: nullptr;
+	::CloseHandle(fileHandle);
+	if (mappingHandle == nullptr)
+		return false;
+
+	// The view keeps the mapping alive
+	const void* pView = ::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	::CloseHandle(mappingHandle);
+	if (pView == nullptr)
+		return false;
+
+	m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	const int descriptor = open(path, O_RDONLY);
+	if (descriptor < 0)
+		return false;
+
+	struct stat fileStatus;
+	const void* pView = fstat(descriptor, &fileStatus) == 0 && fileStatus.st_size >= static_cast<off_t>(sizeof(CaptureFileHeader))
+		? mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0)
+		: MAP_FAILED;
+	close(descriptor);
+	if (pView == MAP_FAILED)
+		return false;
+
+	m_size = static_cast<size_t>(fileStatus.st_size);
+#endif
+
+	m_pData = static_cast<const uint8_t*>(pView);
+	const CaptureFileHeader* pHeader = GetHeader();
+	if (memcmp(pHeader->Magic, "MQ2C", sizeof(pHeader->Magic)) != 0 || pHeader->Version != CallbackCapture::Version)
+	{
+		Close();
+		return false;
+	}
+
+	Rewind();
+	return true;
+}
+
+void CallbackCaptureReader::Close()
+{
+	if (m_pData == nullptr)
+		return;
+
+#ifdef _WIN32
+	::UnmapViewOfFile(m_pData);
+#else
+	munmap(const_cast<uint8_t*>(m_pData), m_size);
+#endif
+
+	m_pData = nullptr;
+	m_size = 0;
+	m_offset = 0;
+}
+
+bool CallbackCaptureReader::Next(CaptureRecord* pRecord)
+{
+	if (m_pData == nullptr || m_offset + sizeof(CaptureRecordHeader) > m_size)
+		return false;
+
+	CaptureRecordHeader header;
+	memcpy(&header, m_pData + m_offset, sizeof(header));
+
+	// Zero filled past the last record of a capture that wasn't stopped
+	const uint32_t callback = header.Type & ~CaptureRecordMarker;
+	if ((header.Type & CaptureRecordMarker) != CaptureRecordMarker || callback >= static_cast<uint32_t>(LoaderCallback::Count)
+		|| header.PayloadSize > CallbackCapture::MaxPayloadSize || m_offset + sizeof(header) + header.PayloadSize > m_size)
+		return false;
+
+	pRecord->Callback = static_cast<LoaderCallback>(callback);
+	pRecord->Nanoseconds = header.Nanoseconds;
+	pRecord->Arguments[0] = header.Arguments[0];
+	pRecord->Arguments[1] = header.Arguments[1];
+	pRecord->pPayload = m_pData + m_offset + sizeof(header);
+	pRecord->PayloadSize = header.PayloadSize;
+
+	m_offset += (sizeof(header) + header.PayloadSize + 7) & ~static_cast<size_t>(7);
+	return true;
+}
@@ -0,0 +1,40 @@
+#include "CallbackSubscriptions.h"
+
+CallbackSubscriptions g_callbackSubscriptions;
+
+uint32_t CallbackSubscriptions::SetMask(uint32_t mask)
+{
+	m_mask.store(mask & AllCallbacks, std::memory_order_relaxed);
+	return m_version.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+uint32_t CallbackSubscriptions::GetMask(uint32_t* pVersion) const
+{
+	if (pVersion)
+		*pVersion = m_version.load(std::memory_order_relaxed);
+
+	return m_mask.load(std::memory_order_relaxed);
+}
+
+uint64_t CallbackSubscriptions::GetSkippedCount(uint32_t callback) const
+{
+	if (callback >= static_cast<uint32_t>(LoaderCallback::Count))
+		return 0;
+
+	return m_skippedCounts[callback].load(std::memory_order_relaxed);
+}
+
+void CallbackSubscriptions::ResetSkippedCounts()
+{
+	for (auto& skippedCount : m_skippedCounts)
+	{
+		skippedCount.store(0, std::memory_order_relaxed);
+	}
+}
+
+void CallbackSubscriptions::Reset()
+{
+	m_mask.store(AllCallbacks, std::memory_order_relaxed);
+	m_version.store(0, std::memory_order_relaxed);
+	ResetSkippedCounts();
+}
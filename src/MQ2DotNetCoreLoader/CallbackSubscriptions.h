@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CallbackTimings.h"
+
+#include <atomic>
+#include <cstdint>
+
+// Which PLUGIN_API callbacks the managed side wants forwarded, one bit per LoaderCallback. The managed side publishes a new
+// mask whenever a submodule adds the first or removes the last handler for an event, and for OnPulse whenever it has work
+// that needs pulsing, so forwarders can skip the transition into the CLR when nothing would run.
+//
+// Every bit is set until the first mask is published, so a managed build that doesn't publish one gets every callback. The
+// version goes up with every published mask so a reader can tell whether it changed since it last looked.
+class CallbackSubscriptions
+{
+public:
+	static const uint32_t AllCallbacks = (1u << static_cast<uint32_t>(LoaderCallback::Count)) - 1;
+
+	// False if the managed side doesn't want the callback, which is then counted as skipped
+	bool ShouldForward(LoaderCallback callback)
+	{
+		const uint32_t callbackIndex = static_cast<uint32_t>(callback);
+		if (m_mask.load(std::memory_order_relaxed) & (1u << callbackIndex))
+			return true;
+
+		m_skippedCounts[callbackIndex].fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	// Returns the new version. Bits for callbacks that don't exist are ignored.
+	uint32_t SetMask(uint32_t mask);
+
+	uint32_t GetMask(uint32_t* pVersion) const;
+
+	// Number of calls that weren't forwarded, 0 if the callback is out of range
+	uint64_t GetSkippedCount(uint32_t callback) const;
+
+	void ResetSkippedCounts();
+
+	// Back to forwarding everything
+	void Reset();
+
+private:
+	std::atomic<uint32_t> m_mask{ AllCallbacks };
+	std::atomic<uint32_t> m_version{ 0 };
+	std::atomic<uint64_t> m_skippedCounts[static_cast<uint32_t>(LoaderCallback::Count)]{};
+};
+
+extern CallbackSubscriptions g_callbackSubscriptions;
@@ -0,0 +1,135 @@
+#include "CallbackTimings.h"
+
+CallbackTimings g_callbackTimings;
+
+namespace
+{
+	inline uint32_t highestBit(uint64_t value)
+	{
+		uint32_t bit = 0;
+		while (value >>= 1)
+		{
+			++bit;
+		}
+
+		return bit;
+	}
+}
+
+uint32_t LatencyHistogram::ToBucket(uint64_t nanoseconds)
+{
+	if (nanoseconds < LinearLimit)
+	{
+		return static_cast<uint32_t>(nanoseconds);
+	}
+
+	const uint32_t exponent = highestBit(nanoseconds);
+	if (exponent >= MaxExponent)
+	{
+		return BucketCount - 1;
+	}
+
+	const uint32_t subBucket = static_cast<uint32_t>(nanoseconds >> (exponent - SubBucketBits)) & (SubBucketCount - 1);
+	return LinearLimit + (exponent - (SubBucketBits + 1)) * SubBucketCount + subBucket;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(uint32_t bucket)
+{
+	if (bucket < LinearLimit)
+	{
+		return bucket;
+	}
+
+	const uint32_t exponent = (bucket - LinearLimit) / SubBucketCount + SubBucketBits + 1;
+	const uint64_t subBucket = (bucket - LinearLimit) % SubBucketCount;
+	const uint64_t width = 1ull << (exponent - SubBucketBits);
+	return (SubBucketCount + subBucket) * width + width - 1;
+}
+
+void LatencyHistogram::Record(uint64_t nanoseconds)
+{
+	m_buckets[ToBucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+	m_count.fetch_add(1, std::memory_order_relaxed);
+	m_totalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+	// Only the EQ thread records, so a plain compare is enough, the atomic is just so readers on other threads are safe
+	if (nanoseconds > m_maxNanoseconds.load(std::memory_order_relaxed))
+	{
+		m_maxNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+	}
+}
+
+void LatencyHistogram::Reset()
+{
+	for (auto& bucket : m_buckets)
+	{
+		bucket.store(0, std::memory_order_relaxed);
+	}
+
+	m_count.store(0, std::memory_order_relaxed);
+	m_totalNanoseconds.store(0, std::memory_order_relaxed);
+	m_maxNanoseconds.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::GetSummary(CallbackTimingSummary* pSummary) const
+{
+	uint64_t counts[BucketCount];
+	uint64_t count = 0;
+	for (uint32_t bucket = 0; bucket < BucketCount; ++bucket)
+	{
+		counts[bucket] = m_buckets[bucket].load(std::memory_order_relaxed);
+		count += counts[bucket];
+	}
+
+	pSummary->Count = count;
+	pSummary->TotalNanoseconds = m_totalNanoseconds.load(std::memory_order_relaxed);
+	pSummary->MaxNanoseconds = m_maxNanoseconds.load(std::memory_order_relaxed);
+
+	// Percentiles are taken from the bucket counts rather than m_count so they're consistent with each other if a record
+	// lands mid read
+	uint64_t* const pPercentiles[] = { &pSummary->P50Nanoseconds, &pSummary->P90Nanoseconds, &pSummary->P99Nanoseconds };
+	const uint64_t thresholds[] = { (count * 50 + 99) / 100, (count * 90 + 99) / 100, (count * 99 + 99) / 100 };
+	uint64_t cumulative = 0;
+	size_t percentileIndex = 0;
+	for (uint32_t bucket = 0; bucket < BucketCount && percentileIndex < 3; ++bucket)
+	{
+		cumulative += counts[bucket];
+		while (percentileIndex < 3 && count > 0 && cumulative >= thresholds[percentileIndex])
+		{
+			*pPercentiles[percentileIndex++] = BucketUpperBound(bucket);
+		}
+	}
+
+	for (; percentileIndex < 3; ++percentileIndex)
+	{
+		*pPercentiles[percentileIndex] = 0;
+	}
+
+	// The max is exact, don't let a bucket bound report more than it
+	for (auto pPercentile : pPercentiles)
+	{
+		if (*pPercentile > pSummary->MaxNanoseconds)
+		{
+			*pPercentile = pSummary->MaxNanoseconds;
+		}
+	}
+}
+
+bool CallbackTimings::GetSummary(uint32_t callback, CallbackTimingSummary* pSummary) const
+{
+	if (callback >= static_cast<uint32_t>(LoaderCallback::Count) || pSummary == nullptr)
+	{
+		return false;
+	}
+
+	m_histograms[callback].GetSummary(pSummary);
+	return true;
+}
+
+void CallbackTimings::Reset()
+{
+	for (auto& histogram : m_histograms)
+	{
+		histogram.Reset();
+	}
+}
@@ -0,0 +1,376 @@
+#include "ChatFilter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+
+ChatFilter g_chatFilter;
+
+namespace
+{
+	inline unsigned char foldByte(unsigned char value)
+	{
+		return (value >= 'A' && value <= 'Z') ? static_cast<unsigned char>(value + ('a' - 'A')) : value;
+	}
+
+	std::string foldString(const char* text)
+	{
+		std::string folded(text);
+		for (auto& character : folded)
+		{
+			character = static_cast<char>(foldByte(static_cast<unsigned char>(character)));
+		}
+
+		return folded;
+	}
+
+	// Longest run of characters between wildcards, used as the automaton key for wildcard patterns
+	std::string longestLiteralSegment(const std::string& pattern)
+	{
+		std::string longest;
+		size_t segmentStart = 0;
+		for (size_t index = 0; index <= pattern.size(); ++index)
+		{
+			if (index == pattern.size() || pattern[index] == '*' || pattern[index] == '?')
+			{
+				if (index - segmentStart > longest.size())
+				{
+					longest = pattern.substr(segmentStart, index - segmentStart);
+				}
+
+				segmentStart = index + 1;
+			}
+		}
+
+		return longest;
+	}
+
+	// Case insensitive glob match of the whole line, * matches any run of characters and ? matches exactly one
+	bool globMatch(const std::string& pattern, const char* line)
+	{
+		const char* patternPosition = pattern.c_str();
+		const char* linePosition = line;
+		const char* starPattern = nullptr;
+		const char* starLine = nullptr;
+
+		while (*linePosition)
+		{
+			if (*patternPosition == '*')
+			{
+				starPattern = ++patternPosition;
+				starLine = linePosition;
+			}
+			else if (*patternPosition == '?'
+				|| (*patternPosition && static_cast<unsigned char>(*patternPosition) == foldByte(static_cast<unsigned char>(*linePosition))))
+			{
+				++patternPosition;
+				++linePosition;
+			}
+			else if (starPattern)
+			{
+				patternPosition = starPattern;
+				linePosition = ++starLine;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		while (*patternPosition == '*')
+		{
+			++patternPosition;
+		}
+
+		return *patternPosition == '\0';
+	}
+}
+
+ChatMatcher::ChatMatcher(std::vector<ChatPattern> patterns)
+	: m_patterns(std::move(patterns))
+{
+	std::vector<std::string> keys(m_patterns.size());
+	for (size_t patternIndex = 0; patternIndex < m_patterns.size(); ++patternIndex)
+	{
+		const auto& pattern = m_patterns[patternIndex];
+		keys[patternIndex] = pattern.IsWildcard ? longestLiteralSegment(pattern.Text) : pattern.Text;
+		if (keys[patternIndex].empty())
+		{
+			m_alwaysVerify.push_back(static_cast<uint32_t>(patternIndex));
+			continue;
+		}
+
+		// Only bytes that appear in a key get their own class, everything else shares class 0 and always leads back to the root
+		for (unsigned char character : keys[patternIndex])
+		{
+			if (m_byteClasses[character] == 0)
+			{
+				m_byteClasses[character] = static_cast<uint8_t>(m_classCount++);
+			}
+		}
+	}
+
+	for (int upper = 'A'; upper <= 'Z'; ++upper)
+	{
+		m_byteClasses[upper] = m_byteClasses[foldByte(static_cast<unsigned char>(upper))];
+	}
+
+	// Build the trie
+	std::vector<std::vector<uint32_t>> nodeOutputs(1);
+	m_transitions.assign(m_classCount, -1);
+	for (size_t patternIndex = 0; patternIndex < keys.size(); ++patternIndex)
+	{
+		if (keys[patternIndex].empty())
+		{
+			continue;
+		}
+
+		int32_t node = 0;
+		for (unsigned char character : keys[patternIndex])
+		{
+			int32_t& next = m_transitions[node * m_classCount + m_byteClasses[character]];
+			if (next < 0)
+			{
+				next = static_cast<int32_t>(nodeOutputs.size());
+				nodeOutputs.emplace_back();
+				m_transitions.resize(m_transitions.size() + m_classCount, -1);
+			}
+
+			// Re-read through the index since the resize above may have moved the storage
+			node = m_transitions[node * m_classCount + m_byteClasses[character]];
+		}
+
+		nodeOutputs[node].push_back(static_cast<uint32_t>(patternIndex));
+	}
+
+	// Breadth first pass to compute fail links and turn the trie into a full DFA
+	std::vector<int32_t> failLinks(nodeOutputs.size(), 0);
+	std::queue<int32_t> pending;
+	for (uint32_t characterClass = 0; characterClass < m_classCount; ++characterClass)
+	{
+		int32_t& next = m_transitions[characterClass];
+		if (next < 0)
+		{
+			next = 0;
+		}
+		else
+		{
+			failLinks[next] = 0;
+			pending.push(next);
+		}
+	}
+
+	while (!pending.empty())
+	{
+		const int32_t node = pending.front();
+		pending.pop();
+
+		const auto& failOutputs = nodeOutputs[failLinks[node]];
+		nodeOutputs[node].insert(nodeOutputs[node].end(), failOutputs.begin(), failOutputs.end());
+
+		for (uint32_t characterClass = 0; characterClass < m_classCount; ++characterClass)
+		{
+			int32_t& next = m_transitions[node * m_classCount + characterClass];
+			const int32_t failNext = m_transitions[failLinks[node] * m_classCount + characterClass];
+			if (next < 0)
+			{
+				next = failNext;
+			}
+			else
+			{
+				failLinks[next] = failNext;
+				pending.push(next);
+			}
+		}
+	}
+
+	m_outputOffsets.resize(nodeOutputs.size());
+	m_outputCounts.resize(nodeOutputs.size());
+	for (size_t node = 0; node < nodeOutputs.size(); ++node)
+	{
+		m_outputOffsets[node] = static_cast<uint32_t>(m_outputs.size());
+		m_outputCounts[node] = static_cast<uint32_t>(nodeOutputs[node].size());
+		m_outputs.insert(m_outputs.end(), nodeOutputs[node].begin(), nodeOutputs[node].end());
+	}
+}
+
+bool ChatMatcher::isCandidate(const ChatPattern& pattern, uint32_t source, uint32_t color, uint32_t filter) const
+{
+	if (pattern.SourceMask != 0 && (pattern.SourceMask & source) == 0)
+	{
+		return false;
+	}
+
+	if (pattern.Color != 0 && pattern.Color != color)
+	{
+		return false;
+	}
+
+	if (pattern.FilterMask != 0 && (source & ChatSourceMQ2) != 0)
+	{
+		if (filter >= 32 || (pattern.FilterMask & (1u << filter)) == 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+uint32_t ChatMatcher::Match(uint32_t source, const char* line, uint32_t color, uint32_t filter, int32_t* matchedIds, uint32_t matchedIdsCapacity) const
+{
+	if (line == nullptr || matchedIds == nullptr || matchedIdsCapacity == 0)
+	{
+		return 0;
+	}
+
+	// Stamps patterns that have already been evaluated for this line so repeated key hits don't re-run the glob, bumping
+	// the stamp per line avoids clearing the vector for every line
+	thread_local std::vector<uint32_t> evaluatedStamps;
+	thread_local uint32_t currentStamp = 0;
+	if (evaluatedStamps.size() < m_patterns.size() || ++currentStamp == 0)
+	{
+		evaluatedStamps.assign(std::max(evaluatedStamps.size(), m_patterns.size()), 0);
+		currentStamp = 1;
+	}
+
+	uint32_t matchedCount = 0;
+	auto evaluate = [&](uint32_t patternIndex)
+	{
+		if (evaluatedStamps[patternIndex] == currentStamp || matchedCount >= matchedIdsCapacity)
+		{
+			return;
+		}
+
+		evaluatedStamps[patternIndex] = currentStamp;
+
+		const auto& pattern = m_patterns[patternIndex];
+		if (!isCandidate(pattern, source, color, filter))
+		{
+			return;
+		}
+
+		if (pattern.IsWildcard && !globMatch(pattern.Text, line))
+		{
+			return;
+		}
+
+		matchedIds[matchedCount++] = pattern.Id;
+	};
+
+	int32_t node = 0;
+	for (const char* position = line; *position; ++position)
+	{
+		node = m_transitions[node * m_classCount + m_byteClasses[static_cast<unsigned char>(*position)]];
+
+		const uint32_t outputCount = m_outputCounts[node];
+		if (outputCount == 0)
+		{
+			continue;
+		}
+
+		const uint32_t* outputs = &m_outputs[m_outputOffsets[node]];
+		for (uint32_t outputIndex = 0; outputIndex < outputCount; ++outputIndex)
+		{
+			evaluate(outputs[outputIndex]);
+		}
+	}
+
+	for (uint32_t patternIndex : m_alwaysVerify)
+	{
+		evaluate(patternIndex);
+	}
+
+	return matchedCount;
+}
+
+int32_t ChatFilter::AddPattern(const char* text, uint32_t sourceMask, uint32_t color, uint32_t filterMask)
+{
+	if (text == nullptr || text[0] == '\0')
+	{
+		return 0;
+	}
+
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	ChatPattern pattern;
+	pattern.Id = m_nextId++;
+	pattern.Text = foldString(text);
+	pattern.IsWildcard = pattern.Text.find_first_of("*?") != std::string::npos;
+	pattern.SourceMask = sourceMask;
+	pattern.Color = color;
+	pattern.FilterMask = filterMask;
+	m_patterns.push_back(pattern);
+
+	rebuild();
+	return pattern.Id;
+}
+
+bool ChatFilter::RemovePattern(int32_t id)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	auto patternIterator = std::find_if(m_patterns.begin(), m_patterns.end(), [id](const ChatPattern& pattern) { return pattern.Id == id; });
+	if (patternIterator == m_patterns.end())
+	{
+		return false;
+	}
+
+	m_patterns.erase(patternIterator);
+	rebuild();
+	return true;
+}
+
+void ChatFilter::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	m_patterns.clear();
+	rebuild();
+}
+
+void ChatFilter::rebuild()
+{
+	std::shared_ptr<const ChatMatcher> matcher;
+	if (!m_patterns.empty())
+	{
+		matcher = std::make_shared<const ChatMatcher>(m_patterns);
+	}
+
+	std::atomic_store(&m_matcher, matcher);
+	m_patternCount.store(static_cast<uint32_t>(m_patterns.size()), std::memory_order_relaxed);
+}
+
+uint32_t ChatFilter::Match(uint32_t source, const char* line, uint32_t color, uint32_t filter, int32_t* matchedIds, uint32_t matchedIdsCapacity)
+{
+	auto matcher = std::atomic_load(&m_matcher);
+	if (!matcher)
+	{
+		return 0;
+	}
+
+	m_linesScanned.fetch_add(1, std::memory_order_relaxed);
+
+	const uint32_t matchedCount = matcher->Match(source, line, color, filter, matchedIds, matchedIdsCapacity);
+	if (matchedCount > 0)
+	{
+		m_linesMatched.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	return matchedCount;
+}
+
+void ChatFilter::GetStatistics(ChatFilterStatistics* statistics) const
+{
+	if (statistics == nullptr)
+	{
+		return;
+	}
+
+	auto matcher = std::atomic_load(&m_matcher);
+
+	statistics->LinesScanned = m_linesScanned.load(std::memory_order_relaxed);
+	statistics->LinesMatched = m_linesMatched.load(std::memory_order_relaxed);
+	statistics->PatternCount = matcher ? matcher->PatternCount() : 0;
+	statistics->NodeCount = matcher ? matcher->NodeCount() : 0;
+}
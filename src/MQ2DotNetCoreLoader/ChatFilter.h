@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Bits for ChatPattern::SourceMask
+enum ChatSource : uint32_t
+{
+	ChatSourceEQ = 0x1,		// OnIncomingChat
+	ChatSourceMQ2 = 0x2,	// OnWriteChatColor
+	ChatSourceAny = ChatSourceEQ | ChatSourceMQ2
+};
+
+// Layout is mirrored by MQ2DotNetCore.Interop.ChatFilterStatistics, keep them in sync
+struct ChatFilterStatistics
+{
+	uint64_t LinesScanned;
+	uint64_t LinesMatched;
+	uint32_t PatternCount;
+	uint32_t NodeCount;
+};
+
+struct ChatPattern
+{
+	int32_t Id;
+	std::string Text;		// Case folded
+	bool IsWildcard;		// Contains * or ?, matched against the whole line instead of as a substring
+	uint32_t SourceMask;	// ChatSource bits, 0 is treated as ChatSourceAny
+	uint32_t Color;			// 0 matches any color
+	uint32_t FilterMask;	// Bit N matches filter N (WriteChatColor only), 0 matches any filter
+};
+
+// Immutable Aho-Corasick automaton compiled from the registered patterns. Literal patterns are matched directly, wildcard
+// patterns use their longest literal segment as the automaton key and are verified against the whole line on a hit.
+class ChatMatcher
+{
+public:
+	explicit ChatMatcher(std::vector<ChatPattern> patterns);
+
+	uint32_t Match(uint32_t source, const char* line, uint32_t color, uint32_t filter, int32_t* matchedIds, uint32_t matchedIdsCapacity) const;
+
+	uint32_t NodeCount() const { return static_cast<uint32_t>(m_outputCounts.size()); }
+	uint32_t PatternCount() const { return static_cast<uint32_t>(m_patterns.size()); }
+
+private:
+	bool isCandidate(const ChatPattern& pattern, uint32_t source, uint32_t color, uint32_t filter) const;
+
+	std::vector<ChatPattern> m_patterns;
+
+	uint8_t m_byteClasses[256] = {};
+	uint32_t m_classCount{ 1 };
+
+	std::vector<int32_t> m_transitions;		// [node * m_classCount + class] -> next node
+	std::vector<uint32_t> m_outputOffsets;	// [node] -> first index into m_outputs
+	std::vector<uint32_t> m_outputCounts;	// [node] -> number of pattern indices ending at this node (including fail link outputs)
+	std::vector<uint32_t> m_outputs;		// Pattern indices
+	std::vector<uint32_t> m_alwaysVerify;	// Wildcard patterns without any literal segment, e.g. "*"
+};
+
+class ChatFilter
+{
+public:
+	static const uint32_t MaxMatchedIds = 32;
+
+	// Returns the new pattern id, or 0 if the pattern is empty
+	int32_t AddPattern(const char* text, uint32_t sourceMask, uint32_t color, uint32_t filterMask);
+	bool RemovePattern(int32_t id);
+	void Clear();
+
+	bool HasPatterns() const { return m_patternCount.load(std::memory_order_relaxed) > 0; }
+
+	// When true (the default) lines that don't match any pattern are still forwarded to the managed side
+	bool IsPassthrough() const { return m_isPassthrough.load(std::memory_order_relaxed); }
+	void SetPassthrough(bool isPassthrough) { m_isPassthrough.store(isPassthrough, std::memory_order_relaxed); }
+
+	uint32_t Match(uint32_t source, const char* line, uint32_t color, uint32_t filter, int32_t* matchedIds, uint32_t matchedIdsCapacity);
+
+	void GetStatistics(ChatFilterStatistics* statistics) const;
+
+private:
+	void rebuild();
+
+	std::mutex m_lock;
+	std::vector<ChatPattern> m_patterns;
+	int32_t m_nextId{ 1 };
+
+	// Swapped with std::atomic_store so matching never blocks on registration
+	std::shared_ptr<const ChatMatcher> m_matcher;
+
+	std::atomic<bool> m_isPassthrough{ true };
+	std::atomic<uint32_t> m_patternCount{ 0 };
+	std::atomic<uint64_t> m_linesScanned{ 0 };
+	std::atomic<uint64_t> m_linesMatched{ 0 };
+};
+
+extern ChatFilter g_chatFilter;
@@ -0,0 +1,355 @@
+#include "ExpressionPlan.h"
+#include "TextEncoding.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	// MQ2's ParseMacroData writes this for a ${..} that doesn't resolve
+	const char* const NullText = "NULL";
+
+	// Index of the } that closes the ${ at start, or npos if it is never closed
+	size_t findClosingBrace(const std::string& expression, size_t start)
+	{
+		int depth = 0;
+		for (size_t position = start; position < expression.size(); ++position)
+		{
+			if (expression[position] == '$' && position + 1 < expression.size() && expression[position + 1] == '{')
+			{
+				++depth;
+				++position;
+			}
+			else if (expression[position] == '}' && --depth == 0)
+			{
+				return position;
+			}
+		}
+
+		return std::string::npos;
+	}
+
+	void copyArgument(const std::string& source, std::vector<char>& destination)
+	{
+		const size_t length = std::min(source.size(), destination.size() - 1);
+		memcpy(destination.data(), source.data(), length);
+		destination[length] = '\0';
+	}
+}
+
+int32_t ExpressionPlanCache::Compile(const char* expression)
+{
+	if (expression == nullptr || expression[0] == '\0')
+	{
+		return 0;
+	}
+
+	auto existing = m_handlesByExpression.find(expression);
+	if (existing != m_handlesByExpression.end())
+	{
+		++m_plans[existing->second]->ReferenceCount;
+		return existing->second;
+	}
+
+	auto plan = std::make_unique<ExpressionPlan>();
+	plan->Expression = expression;
+	plan->ReferenceCount = 1;
+	compile(*plan);
+
+	const int32_t handle = m_nextHandle++;
+	m_handlesByExpression.emplace(plan->Expression, handle);
+	m_plans.emplace(handle, std::move(plan));
+	return handle;
+}
+
+bool ExpressionPlanCache::Release(int32_t handle)
+{
+	auto existing = m_plans.find(handle);
+	if (existing == m_plans.end())
+	{
+		return false;
+	}
+
+	if (--existing->second->ReferenceCount == 0)
+	{
+		m_handlesByExpression.erase(existing->second->Expression);
+		m_plans.erase(existing);
+	}
+
+	return true;
+}
+
+void ExpressionPlanCache::Clear()
+{
+	m_plans.clear();
+	m_handlesByExpression.clear();
+}
+
+void ExpressionPlanCache::Invalidate()
+{
+	for (auto& plan : m_plans)
+	{
+		plan.second->IsCompiled = false;
+	}
+}
+
+ExpressionPlan* ExpressionPlanCache::find(int32_t handle)
+{
+	auto existing = m_plans.find(handle);
+	if (existing == m_plans.end())
+	{
+		return nullptr;
+	}
+
+	auto& plan = *existing->second;
+	if (!plan.IsCompiled)
+	{
+		compile(plan);
+	}
+
+	return &plan;
+}
+
+void ExpressionPlanCache::compile(ExpressionPlan& plan)
+{
+	++m_compileCount;
+
+	plan.Segments.clear();
+	plan.HasConstantResult = false;
+
+	auto appendLiteral = [&plan](const std::string& text)
+	{
+		if (text.empty())
+		{
+			return;
+		}
+
+		if (!plan.Segments.empty() && plan.Segments.back().Kind == ExpressionPlan::SegmentKind::Literal)
+		{
+			plan.Segments.back().Text += text;
+			return;
+		}
+
+		plan.Segments.push_back({ ExpressionPlan::SegmentKind::Literal, text, nullptr, {}, {} });
+	};
+
+	const auto& expression = plan.Expression;
+	size_t position = 0;
+	while (position < expression.size())
+	{
+		const size_t start = expression.find("${", position);
+		const size_t end = start == std::string::npos ? std::string::npos : findClosingBrace(expression, start);
+		if (end == std::string::npos)
+		{
+			// ParseMacroData leaves an unterminated ${ alone too
+			appendLiteral(expression.substr(position));
+			break;
+		}
+
+		appendLiteral(expression.substr(position, start - position));
+
+		ExpressionPlan::Segment segment{ ExpressionPlan::SegmentKind::Chain, expression.substr(start, end - start + 1), nullptr, {}, {} };
+		if (!compileChain(expression.substr(start + 2, end - start - 2), segment))
+		{
+			segment.Kind = ExpressionPlan::SegmentKind::Fallback;
+			segment.Steps.clear();
+		}
+
+		plan.Segments.push_back(std::move(segment));
+		position = end + 1;
+	}
+
+	plan.IsConstant = std::all_of(plan.Segments.begin(), plan.Segments.end(), [](const ExpressionPlan::Segment& segment) { return segment.Kind == ExpressionPlan::SegmentKind::Literal; });
+	plan.IsCompiled = true;
+}
+
+// Splits TLO[index].Member[index]... and resolves the TLO. Fails for anything that needs ParseMacroData's full parser.
+bool ExpressionPlanCache::compileChain(const std::string& text, ExpressionPlan::Segment& segment)
+{
+	if (text.empty() || text.find('$') != std::string::npos)
+	{
+		return false;
+	}
+
+	bool isTopLevelObject = true;
+	int bracketDepth = 0;
+	size_t partStart = 0;
+	for (size_t position = 0; position <= text.size(); ++position)
+	{
+		const char character = position < text.size() ? text[position] : '.';
+		if (character == '[')
+		{
+			++bracketDepth;
+			continue;
+		}
+
+		if (character == ']')
+		{
+			if (--bracketDepth < 0)
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		if (character != '.' || bracketDepth != 0)
+		{
+			continue;
+		}
+
+		const std::string part = text.substr(partStart, position - partStart);
+		partStart = position + 1;
+
+		const size_t indexStart = part.find('[');
+		if (indexStart == 0 || part.empty() || (indexStart != std::string::npos && part.back() != ']'))
+		{
+			return false;
+		}
+
+		std::string name = part.substr(0, indexStart);
+		std::string index = indexStart == std::string::npos ? std::string() : part.substr(indexStart + 1, part.size() - indexStart - 2);
+		if (isTopLevelObject)
+		{
+			segment.TopLevelObject = m_pHost->FindTopLevelObject(name.c_str());
+			if (segment.TopLevelObject == nullptr)
+			{
+				return false;
+			}
+
+			segment.TopLevelIndex = std::move(index);
+			isTopLevelObject = false;
+		}
+		else
+		{
+			segment.Steps.push_back({ std::move(name), std::move(index) });
+		}
+	}
+
+	return bracketDepth == 0;
+}
+
+void ExpressionPlanCache::evaluateChain(const ExpressionPlan::Segment& segment, std::string& output)
+{
+	ExpressionHost::Value value{};
+	copyArgument(segment.TopLevelIndex, m_index);
+	bool isResolved = m_pHost->GetTopLevelObject(segment.TopLevelObject, m_index.data(), value) && value.Type != nullptr;
+
+	for (size_t stepIndex = 0; isResolved && stepIndex < segment.Steps.size(); ++stepIndex)
+	{
+		const auto& step = segment.Steps[stepIndex];
+		copyArgument(step.Member, m_member);
+		copyArgument(step.Index, m_index);
+
+		ExpressionHost::Value next{};
+		isResolved = m_pHost->GetMember(value, m_member.data(), m_index.data(), next) && next.Type != nullptr;
+		value = next;
+	}
+
+	m_buffer[0] = '\0';
+	if (!isResolved || !m_pHost->ToString(value, m_buffer.data()))
+	{
+		output += NullText;
+		return;
+	}
+
+	output += m_buffer.data();
+}
+
+bool ExpressionPlanCache::evaluate(ExpressionPlan& plan, std::string& output)
+{
+	++m_evaluationCount;
+	output.clear();
+
+	for (const auto& segment : plan.Segments)
+	{
+		switch (segment.Kind)
+		{
+			case ExpressionPlan::SegmentKind::Literal:
+				output += segment.Text;
+				break;
+
+			case ExpressionPlan::SegmentKind::Chain:
+				evaluateChain(segment, output);
+				break;
+
+			case ExpressionPlan::SegmentKind::Fallback:
+				++m_fallbackCount;
+				copyArgument(segment.Text, m_buffer);
+				if (!m_pHost->ParseMacroData(m_buffer.data(), m_buffer.size()))
+				{
+					return false;
+				}
+
+				output += m_buffer.data();
+				break;
+		}
+	}
+
+	return true;
+}
+
+bool ExpressionPlanCache::Evaluate(int32_t handle, char* pDestination, uint32_t capacity, uint32_t* pLength)
+{
+	auto pPlan = find(handle);
+	if (pPlan == nullptr || !evaluate(*pPlan, m_output))
+	{
+		return false;
+	}
+
+	if (pLength)
+	{
+		*pLength = static_cast<uint32_t>(utf8Length(m_output.data(), m_output.size()));
+	}
+
+	ansiToUtf8(m_output.data(), m_output.size(), pDestination, capacity, nullptr);
+	return true;
+}
+
+bool ExpressionPlanCache::Calculate(int32_t handle, double* pResult)
+{
+	auto pPlan = find(handle);
+	if (pPlan == nullptr || pResult == nullptr)
+	{
+		return false;
+	}
+
+	if (pPlan->HasConstantResult)
+	{
+		++m_evaluationCount;
+		*pResult = pPlan->ConstantResult;
+		return pPlan->ConstantResultSucceeded;
+	}
+
+	if (!evaluate(*pPlan, m_output))
+	{
+		return false;
+	}
+
+	copyArgument(m_output, m_buffer);
+	double result = 0.0;
+	const bool isSuccess = m_pHost->Calculate(m_buffer.data(), result);
+
+	if (pPlan->IsConstant)
+	{
+		pPlan->HasConstantResult = true;
+		pPlan->ConstantResultSucceeded = isSuccess;
+		pPlan->ConstantResult = result;
+	}
+
+	*pResult = result;
+	return isSuccess;
+}
+
+void ExpressionPlanCache::GetStatistics(ExpressionPlanStatistics* pStatistics) const
+{
+	if (pStatistics == nullptr)
+	{
+		return;
+	}
+
+	pStatistics->EvaluationCount = m_evaluationCount;
+	pStatistics->FallbackCount = m_fallbackCount;
+	pStatistics->PlanCount = static_cast<uint32_t>(m_plans.size());
+	pStatistics->CompileCount = m_compileCount;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Everything a plan needs from MQ2. Abstracted so the compiler and evaluator don't depend on the MQ2 headers and can be
+// benchmarked on their own. Values are an opaque copy of an MQ2TYPEVAR.
+class ExpressionHost
+{
+public:
+	struct Value
+	{
+		void* Type;
+		uint64_t Data;
+	};
+
+	// Buffers handed to the host are always at least this large, the same as MQ2's MAX_STRING
+	static const size_t BufferSize = 2048;
+
+	virtual ~ExpressionHost() = default;
+
+	// Returns the TLO's data item, or nullptr if there is no TLO with that name (e.g. a macro variable)
+	virtual void* FindTopLevelObject(const char* name) = 0;
+	virtual bool GetTopLevelObject(void* topLevelObject, char* index, Value& value) = 0;
+	virtual bool GetMember(const Value& value, char* member, char* index, Value& result) = 0;
+	virtual bool ToString(const Value& value, char* destination) = 0;
+
+	// Fallbacks for anything the compiler doesn't understand, same as MQ2's ParseMacroData / Calculate
+	virtual bool ParseMacroData(char* buffer, size_t bufferSize) = 0;
+	virtual bool Calculate(char* formula, double& result) = 0;
+};
+
+// Layout is mirrored by MQ2DotNetCore.Interop.ExpressionPlanStatistics, keep them in sync
+struct ExpressionPlanStatistics
+{
+	uint64_t EvaluationCount;
+	uint64_t FallbackCount;		// ${..} segments that had to go through ParseMacroData
+	uint32_t PlanCount;
+	uint32_t CompileCount;
+};
+
+// An expression split into literal text and ${..} segments. Simple member chains, e.g. ${Me.Buff[3].Duration}, keep their TLO
+// resolved and their members split so evaluating them is just the GetMember calls. Anything else (nested ${..}, macro
+// variables) is evaluated by handing the segment to ParseMacroData.
+struct ExpressionPlan
+{
+	enum class SegmentKind
+	{
+		Literal,
+		Chain,
+		Fallback
+	};
+
+	struct Step
+	{
+		std::string Member;
+		std::string Index;
+	};
+
+	struct Segment
+	{
+		SegmentKind Kind;
+		std::string Text;			// Literal text, or the whole ${..} for fallbacks
+		void* TopLevelObject;
+		std::string TopLevelIndex;
+		std::vector<Step> Steps;
+	};
+
+	std::string Expression;
+	std::vector<Segment> Segments;
+	uint32_t ReferenceCount{ 0 };
+	bool IsCompiled{ false };
+
+	// Constant folding, a plan without any ${..} segments is only evaluated / calculated once
+	bool IsConstant{ false };
+	bool HasConstantResult{ false };
+	bool ConstantResultSucceeded{ false };
+	double ConstantResult{ 0.0 };
+};
+
+// Compiled plans, shared by every caller that compiles the same expression text. Not thread safe, it is only touched from
+// the EQ thread.
+class ExpressionPlanCache
+{
+public:
+	explicit ExpressionPlanCache(ExpressionHost* pHost) : m_pHost(pHost) {}
+
+	// Returns a handle to the plan for the expression, or 0 if the expression is empty. Every Compile needs a matching Release.
+	int32_t Compile(const char* expression);
+	bool Release(int32_t handle);
+	void Clear();
+
+	// Re-resolves every plan's TLOs the next time it is evaluated, e.g. after zoning, a UI reload, a game state change or a plugin
+	// being loaded or unloaded
+	void Invalidate();
+
+	// Writes the parsed text as UTF-8 (null terminated, truncated to capacity) and sets pLength to its full length. Returns false
+	// if the handle is invalid.
+	bool Evaluate(int32_t handle, char* pDestination, uint32_t capacity, uint32_t* pLength);
+	bool Calculate(int32_t handle, double* pResult);
+
+	void GetStatistics(ExpressionPlanStatistics* pStatistics) const;
+
+private:
+	ExpressionPlan* find(int32_t handle);
+	void compile(ExpressionPlan& plan);
+	bool compileChain(const std::string& text, ExpressionPlan::Segment& segment);
+	bool evaluate(ExpressionPlan& plan, std::string& output);
+	void evaluateChain(const ExpressionPlan::Segment& segment, std::string& output);
+
+	ExpressionHost* m_pHost;
+	int32_t m_nextHandle{ 1 };
+	std::unordered_map<int32_t, std::unique_ptr<ExpressionPlan>> m_plans;
+	std::unordered_map<std::string, int32_t> m_handlesByExpression;
+
+	// Scratch space reused by every evaluation
+	std::string m_output;
+	std::vector<char> m_buffer = std::vector<char>(ExpressionHost::BufferSize);
+	std::vector<char> m_index = std::vector<char>(ExpressionHost::BufferSize);
+	std::vector<char> m_member = std::vector<char>(ExpressionHost::BufferSize);
+
+	uint64_t m_evaluationCount{ 0 };
+	uint64_t m_fallbackCount{ 0 };
+	uint32_t m_compileCount{ 0 };
+};
+
+extern ExpressionPlanCache g_expressionPlanCache;
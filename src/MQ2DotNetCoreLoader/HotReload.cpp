@@ -0,0 +1,61 @@
+#include "HotReload.h"
+
+#include <algorithm>
+
+LoaderHotReload g_hotReload;
+
+void LoaderHotReload::SetEntryPoints(component_entry_point_fn initialize, component_entry_point_fn unload)
+{
+	m_pfInitialize = initialize;
+	m_pfUnload = unload;
+}
+
+int32_t LoaderHotReload::Unload()
+{
+	if (m_pfUnload == nullptr)
+	{
+		return -1;
+	}
+
+	return m_pfUnload(nullptr, 0);
+}
+
+bool LoaderHotReload::Request()
+{
+	if (!m_isEnabled || m_pfInitialize == nullptr || m_pfUnload == nullptr)
+	{
+		return false;
+	}
+
+	m_isRequested.store(true, std::memory_order_release);
+	return true;
+}
+
+void LoaderHotReload::RecordReload(bool succeeded, uint64_t nanoseconds, int32_t leakedContextCount)
+{
+	++m_statistics.ReloadCount;
+	if (!succeeded)
+	{
+		++m_statistics.FailedReloadCount;
+	}
+
+	m_statistics.LeakedContextCount = leakedContextCount > 0 ? static_cast<uint32_t>(leakedContextCount) : 0;
+	m_statistics.LastReloadNanoseconds = nanoseconds;
+	m_statistics.LongestReloadNanoseconds = std::max(m_statistics.LongestReloadNanoseconds, nanoseconds);
+}
+
+void LoaderHotReload::GetStatistics(HotReloadStatistics* pStatistics) const
+{
+	*pStatistics = m_statistics;
+	pStatistics->IsEnabled = m_isEnabled ? 1 : 0;
+}
+
+void LoaderHotReload::Reset()
+{
+	m_isEnabled = false;
+	m_isReloading = false;
+	m_isRequested.store(false, std::memory_order_relaxed);
+	m_pfInitialize = nullptr;
+	m_pfUnload = nullptr;
+	m_statistics = HotReloadStatistics{};
+}
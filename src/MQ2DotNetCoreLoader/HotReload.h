@@ -0,0 +1,65 @@
+#pragma once
+
+#include "includes/coreclr_delegates.h"
+
+#include <atomic>
+#include <cstdint>
+
+// Layout is mirrored by MQ2DotNetCore.Interop.HotReloadStatistics, keep them in sync
+struct HotReloadStatistics
+{
+	uint32_t IsEnabled;
+	uint32_t ReloadCount;
+	uint32_t FailedReloadCount;
+
+	// Unloaded cores whose load context was still alive after the last reload, anything above 0 is a leak
+	uint32_t LeakedContextCount;
+	uint64_t LastReloadNanoseconds;
+	uint64_t LongestReloadNanoseconds;
+};
+
+// State for reloading MQ2DotNetCore.dll without restarting the client (HotReload=1 in MQ2DotNetCoreLoader.ini). The runtime
+// then starts MQ2DotNetCore.HotReloadHost instead of LoaderEntryPoint, which loads the core into a collectible load context,
+// and unloads it again through the managed Unload. The host is loaded from a copy of MQ2DotNetCore.dll made for the process
+// (see prepareHotReloadHostAssembly), since the runtime keeps that one loaded and locked until the client exits. A reload is only requested here, it runs at the start of the next pulse
+// where no managed code from the old core can still be on the stack.
+//
+// Requests may come from any thread, everything else happens on the EQ thread.
+class LoaderHotReload
+{
+public:
+	bool IsEnabled() const { return m_isEnabled; }
+	void SetEnabled(bool isEnabled) { m_isEnabled = isEnabled; }
+
+	void SetEntryPoints(component_entry_point_fn initialize, component_entry_point_fn unload);
+	component_entry_point_fn GetInitializeEntryPoint() const { return m_pfInitialize; }
+
+	// Unloads the current core's load context. Returns how many unloaded contexts are still alive, or -1 if that couldn't be
+	// determined.
+	int32_t Unload();
+
+	// False when hot reload is off or the host wasn't loaded
+	bool Request();
+	bool ConsumeRequest() { return m_isRequested.exchange(false, std::memory_order_acq_rel); }
+
+	// True while the old core shuts down for a reload, so it can hand its state over instead of dropping it
+	bool IsReloading() const { return m_isReloading; }
+	void SetReloading(bool isReloading) { m_isReloading = isReloading; }
+
+	void RecordReload(bool succeeded, uint64_t nanoseconds, int32_t leakedContextCount);
+
+	void GetStatistics(HotReloadStatistics* pStatistics) const;
+
+	// Disabled, without entry points or statistics
+	void Reset();
+
+private:
+	bool m_isEnabled{ false };
+	bool m_isReloading{ false };
+	std::atomic<bool> m_isRequested{ false };
+	component_entry_point_fn m_pfInitialize{ nullptr };
+	component_entry_point_fn m_pfUnload{ nullptr };
+	HotReloadStatistics m_statistics{};
+};
+
+extern LoaderHotReload g_hotReload;
@@ -0,0 +1,86 @@
+#include "InternTable.h"
+
+#include <cstring>
+
+InternTable::InternTable(ResolveType resolveType) : m_resolveType(resolveType)
+{
+}
+
+uint32_t InternTable::InternType(const char* name)
+{
+	if (name == nullptr || name[0] == '\0')
+		return 0;
+
+	const auto existing = m_typeIds.find(name);
+	if (existing != m_typeIds.end())
+	{
+		if (m_types[existing->second] == nullptr)
+			m_types[existing->second] = m_resolveType(name);
+
+		return existing->second;
+	}
+
+	if (m_typeCount == TypeCapacity)
+	{
+		++m_overflowCount;
+		return 0;
+	}
+
+	const uint32_t id = m_typeCount++;
+	m_typeNames[id].assign(name);
+	m_types[id] = m_resolveType(name);
+	m_typeIds.emplace(m_typeNames[id], id);
+	return id;
+}
+
+uint32_t InternTable::InternMember(const char* name)
+{
+	if (name == nullptr || name[0] == '\0')
+		return 0;
+
+	const auto existing = m_memberIds.find(name);
+	if (existing != m_memberIds.end())
+		return existing->second;
+
+	if (m_memberCount == MemberCapacity)
+	{
+		++m_overflowCount;
+		return 0;
+	}
+
+	const size_t length = strlen(name);
+	auto pName = std::make_unique<char[]>(length + 1);
+	memcpy(pName.get(), name, length + 1);
+
+	const uint32_t id = m_memberCount++;
+	m_memberNames[id] = pName.get();
+	m_memberNameStorage.push_back(std::move(pName));
+	m_memberIds.emplace(std::string(name, length), id);
+	return id;
+}
+
+void InternTable::Refresh()
+{
+	for (uint32_t id = 1; id < m_typeCount; ++id)
+	{
+		m_types[id] = m_resolveType(m_typeNames[id].c_str());
+	}
+}
+
+void InternTable::GetStatistics(InternTableStatistics* pStatistics) const
+{
+	if (pStatistics == nullptr)
+		return;
+
+	uint32_t unresolvedTypeCount = 0;
+	for (uint32_t id = 1; id < m_typeCount; ++id)
+	{
+		if (m_types[id] == nullptr)
+			++unresolvedTypeCount;
+	}
+
+	pStatistics->TypeCount = m_typeCount - 1;
+	pStatistics->UnresolvedTypeCount = unresolvedTypeCount;
+	pStatistics->MemberCount = m_memberCount - 1;
+	pStatistics->OverflowCount = m_overflowCount;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Layout is mirrored by MQ2DotNetCore.Interop.InternTableStatistics, keep them in sync
+struct InternTableStatistics
+{
+	uint32_t TypeCount;
+	uint32_t UnresolvedTypeCount;
+	uint32_t MemberCount;
+	uint32_t OverflowCount;
+};
+
+// Gives MQ2 type and member names ids that stay the same for the life of the process, so the managed side looks a name up
+// once instead of passing it across on every wrapper construction and every member read. Types are resolved to their
+// MQ2Type* through the resolver (FindMQ2DataType) into a fixed array indexed by id, which the managed side reads directly.
+// Plugins add and remove types as they load, so Refresh resolves every type again. Member ids map to an interned copy of the
+// name, which GetMember is called with as is, no conversion or copy. Id 0 is never handed out.
+//
+// Like the member cache this doesn't depend on MQ2 so it can be benchmarked on its own. Not thread safe, it is only touched
+// from the EQ thread.
+class InternTable
+{
+public:
+	// Returns the type's MQ2Type*, nullptr if no type has that name
+	using ResolveType = void*(*)(const char* name);
+
+	static const uint32_t TypeCapacity = 1024;
+	static const uint32_t MemberCapacity = 16384;
+
+	explicit InternTable(ResolveType resolveType);
+
+	InternTable(const InternTable&) = delete;
+	InternTable& operator=(const InternTable&) = delete;
+
+	// Returns the name's id, adding it if it's new, or 0 when the table is full. A type that didn't resolve before is resolved
+	// again, it may have been added by a plugin since.
+	uint32_t InternType(const char* name);
+	uint32_t InternMember(const char* name);
+
+	// Indexed by id, entries past the count have never been handed out. A type's entry is nullptr while it doesn't resolve.
+	void* const* GetTypes() const { return m_types; }
+	uint32_t GetTypeCount() const { return m_typeCount; }
+	char* const* GetMemberNames() const { return m_memberNames; }
+	uint32_t GetMemberCount() const { return m_memberCount; }
+
+	// MQ2's GetMember takes a PCHAR, the name is writable so it can be passed straight through. nullptr for an unknown id.
+	char* GetMemberName(uint32_t id) const { return id != 0 && id < m_memberCount ? m_memberNames[id] : nullptr; }
+
+	// Resolves every type again, e.g. after plugins were loaded or unloaded
+	void Refresh();
+
+	void GetStatistics(InternTableStatistics* pStatistics) const;
+
+private:
+	ResolveType m_resolveType;
+
+	void* m_types[TypeCapacity]{};
+	std::string m_typeNames[TypeCapacity];
+	uint32_t m_typeCount{ 1 };
+	std::unordered_map<std::string, uint32_t> m_typeIds;
+
+	char* m_memberNames[MemberCapacity]{};
+	std::vector<std::unique_ptr<char[]>> m_memberNameStorage;
+	uint32_t m_memberCount{ 1 };
+	std::unordered_map<std::string, uint32_t> m_memberIds;
+
+	uint32_t m_overflowCount{ 0 };
+};
+
+extern InternTable g_internTable;
@@ -0,0 +1,210 @@
+#include "InventoryIndex.h"
+
+#include <cstring>
+
+InventoryIndex g_inventoryIndex;
+
+namespace
+{
+	inline char foldCase(char character)
+	{
+		return character >= 'A' && character <= 'Z' ? static_cast<char>(character - 'A' + 'a') : character;
+	}
+
+	// FNV-1a of the folded name
+	uint64_t hashName(const char* foldedName, size_t length)
+	{
+		uint64_t hash = 0xCBF29CE484222325ull;
+		for (size_t index = 0; index < length; ++index)
+		{
+			hash ^= static_cast<uint8_t>(foldedName[index]);
+			hash *= 0x100000001B3ull;
+		}
+
+		return hash;
+	}
+
+	bool containsFolded(const char* text, size_t textLength, const char* foldedPart, size_t partLength)
+	{
+		if (partLength == 0)
+		{
+			return true;
+		}
+
+		for (size_t start = 0; start + partLength <= textLength; ++start)
+		{
+			if (text[start] == foldedPart[0] && memcmp(text + start, foldedPart, partLength) == 0)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+void InventoryIndex::Clear()
+{
+	m_slots.clear();
+	m_slotNameIds.clear();
+	m_nameOffsets.assign(1, 0);
+	m_names.clear();
+	m_byId.clear();
+	m_byName.clear();
+	m_nextById.clear();
+	m_nextByName.clear();
+
+	// Whatever is walked next doesn't match an empty index
+	m_isInvalidated = true;
+}
+
+void InventoryIndex::add(InventoryContainer container, uint16_t slot, int16_t bagSlot, uint32_t itemId, uint32_t stackCount, const char* name)
+{
+	const uint32_t index = static_cast<uint32_t>(m_slots.size());
+
+	InventorySlot inventorySlot{};
+	inventorySlot.ItemId = itemId;
+	inventorySlot.StackCount = stackCount;
+	inventorySlot.Slot = slot;
+	inventorySlot.BagSlot = bagSlot;
+	inventorySlot.Container = static_cast<uint8_t>(container);
+	m_slots.push_back(inventorySlot);
+	m_nextById.push_back(NoSlot);
+	m_nextByName.push_back(NoSlot);
+
+	const auto idChain = m_byId.emplace(itemId, std::make_pair(index, index));
+	if (!idChain.second)
+	{
+		m_nextById[idChain.first->second.second] = index;
+		idChain.first->second.second = index;
+	}
+
+	char foldedName[MaxNameLength];
+	const size_t nameLength = name ? strnlen(name, MaxNameLength) : 0;
+	for (size_t character = 0; character < nameLength; ++character)
+	{
+		foldedName[character] = foldCase(name[character]);
+	}
+
+	const auto nameChain = m_byName.emplace(hashName(foldedName, nameLength), NameChain{ index, index, 0 });
+	size_t chainNameLength = 0;
+	const char* chainName = nameChain.second ? nullptr : getName(nameChain.first->second.NameId, chainNameLength);
+	if (!nameChain.second)
+	{
+		m_nextByName[nameChain.first->second.Last] = index;
+		nameChain.first->second.Last = index;
+	}
+
+	if (chainName != nullptr && chainNameLength == nameLength && memcmp(chainName, foldedName, nameLength) == 0)
+	{
+		m_slotNameIds.push_back(nameChain.first->second.NameId);
+		return;
+	}
+
+	const uint32_t nameId = static_cast<uint32_t>(m_nameOffsets.size() - 1);
+	m_names.insert(m_names.end(), foldedName, foldedName + nameLength);
+	m_nameOffsets.push_back(static_cast<uint32_t>(m_names.size()));
+	m_slotNameIds.push_back(nameId);
+	if (nameChain.second)
+	{
+		nameChain.first->second.NameId = nameId;
+	}
+}
+
+template<typename IsMatch>
+uint32_t InventoryIndex::collect(uint32_t first, const std::vector<uint32_t>* pNext, IsMatch isMatch, uint32_t containerMask, InventorySlot* pSlots, uint32_t capacity, uint64_t* pTotalCount) const
+{
+	uint32_t matchCount = 0;
+	uint64_t totalCount = 0;
+	const uint32_t slotCount = static_cast<uint32_t>(m_slots.size());
+	for (uint32_t index = first; index != NoSlot && index < slotCount; index = pNext ? (*pNext)[index] : index + 1)
+	{
+		const InventorySlot& slot = m_slots[index];
+		if (!IsContainerMatch(containerMask, slot.Container) || !isMatch(index))
+		{
+			continue;
+		}
+
+		if (matchCount < capacity)
+		{
+			pSlots[matchCount] = slot;
+		}
+
+		++matchCount;
+		totalCount += slot.StackCount;
+	}
+
+	if (pTotalCount)
+	{
+		*pTotalCount = totalCount;
+	}
+
+	return matchCount;
+}
+
+uint32_t InventoryIndex::FindById(uint32_t itemId, uint32_t containerMask, InventorySlot* pSlots, uint32_t capacity, uint64_t* pTotalCount)
+{
+	++m_queryCount;
+
+	const auto chain = m_byId.find(itemId);
+	return collect(chain != m_byId.end() ? chain->second.first : NoSlot, &m_nextById, [](uint32_t) { return true; }, containerMask, pSlots, capacity, pTotalCount);
+}
+
+uint32_t InventoryIndex::FindByName(const char* name, size_t length, bool isExact, uint32_t containerMask, InventorySlot* pSlots, uint32_t capacity, uint64_t* pTotalCount)
+{
+	++m_queryCount;
+
+	// Longer names can't match anything
+	if (name == nullptr || length > MaxNameLength)
+	{
+		if (pTotalCount)
+		{
+			*pTotalCount = 0;
+		}
+
+		return 0;
+	}
+
+	char foldedName[MaxNameLength];
+	for (size_t character = 0; character < length; ++character)
+	{
+		foldedName[character] = foldCase(name[character]);
+	}
+
+	// Names sharing a hash are chained together
+	if (isExact)
+	{
+		const auto chain = m_byName.find(hashName(foldedName, length));
+		return collect(chain != m_byName.end() ? chain->second.First : NoSlot, &m_nextByName, [&](uint32_t index)
+		{
+			size_t slotNameLength = 0;
+			const char* slotName = getName(m_slotNameIds[index], slotNameLength);
+			return slotNameLength == length && memcmp(slotName, foldedName, length) == 0;
+		}, containerMask, pSlots, capacity, pTotalCount);
+	}
+
+	const uint32_t nameCount = static_cast<uint32_t>(m_nameOffsets.size() - 1);
+	m_isNameMatch.resize(nameCount);
+	for (uint32_t nameId = 0; nameId < nameCount; ++nameId)
+	{
+		size_t nameLength = 0;
+		const char* itemName = getName(nameId, nameLength);
+		m_isNameMatch[nameId] = containsFolded(itemName, nameLength, foldedName, length) ? 1 : 0;
+	}
+
+	return collect(0, nullptr, [this](uint32_t index) { return m_isNameMatch[m_slotNameIds[index]] != 0; }, containerMask, pSlots, capacity, pTotalCount);
+}
+
+void InventoryIndex::GetStatistics(InventoryIndexStatistics* pStatistics) const
+{
+	if (pStatistics == nullptr)
+	{
+		return;
+	}
+
+	pStatistics->SlotCount = static_cast<uint32_t>(m_slots.size());
+	pStatistics->ItemCount = static_cast<uint32_t>(m_byId.size());
+	pStatistics->CheckCount = m_checkCount;
+	pStatistics->RebuildCount = m_rebuildCount;
+	pStatistics->QueryCount = m_queryCount;
+}
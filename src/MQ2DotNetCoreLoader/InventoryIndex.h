@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Which of the character's item containers a slot is in, mirrored by MQ2DotNetCore.MQ2Api.InventoryContainer
+enum class InventoryContainer : uint8_t
+{
+	Inventory = 0,
+	Bank = 1,
+	SharedBank = 2
+};
+
+// Layout is mirrored by MQ2DotNetCore.MQ2Api.InventorySlot, keep them in sync
+struct InventorySlot
+{
+	uint32_t ItemId;
+	uint32_t StackCount;
+
+	// The slot in the container, numbered the same as MQ2's inventory / bank / shared bank arrays, and the slot in the bag that's
+	// in it (-1 for the item in the slot itself)
+	uint16_t Slot;
+	int16_t BagSlot;
+
+	uint8_t Container;
+	uint8_t Reserved[3];
+};
+
+// Layout is mirrored by MQ2DotNetCore.Interop.InventoryIndexStatistics, keep them in sync
+struct InventoryIndexStatistics
+{
+	uint32_t SlotCount;
+	uint32_t ItemCount;
+	uint64_t CheckCount;
+	uint64_t RebuildCount;
+	uint64_t QueryCount;
+};
+
+// Every item the character has on them, in the bank and in the shared bank (including what's in bags), keyed by item id and by
+// case folded name. Rebuilt lazily: the first query of a pulse walks the items once to fingerprint them, and only when that
+// differs from the items the index was built from (or the index was invalidated, e.g. by zoning) are the items walked again to
+// rebuild it. Name folding only covers ASCII, the same as MQ2's FindItem. Not thread safe, it is only touched from the EQ thread.
+class InventoryIndex
+{
+public:
+	static const uint32_t MaxNameLength = 64;
+
+	// containerMask is a bit mask of (1 << InventoryContainer), 0 matches every container
+	static bool IsContainerMatch(uint32_t containerMask, uint8_t container) { return containerMask == 0 || (containerMask & (1u << container)) != 0; }
+
+	// Forces a rebuild on the next query, for when the items may have changed without the fingerprint noticing (zoning)
+	void Invalidate() { m_isInvalidated = true; m_isChecked = false; }
+
+	// The next query checks the fingerprint again
+	void NextPulse() { m_isChecked = false; }
+
+	void Clear();
+
+	// walkItems(visit) calls visit(InventoryContainer container, uint16_t slot, int16_t bagSlot, uint32_t itemId, uint32_t stackCount,
+	// const char* name, const void* identity) for every item, identity being whatever tells two items apart when their id and
+	// stack count are the same (the item's address). Does nothing if the index was already checked this pulse.
+	template<typename WalkItems>
+	void Refresh(WalkItems walkItems)
+	{
+		if (m_isChecked)
+			return;
+
+		m_isChecked = true;
+		++m_checkCount;
+
+		uint64_t fingerprint = FingerprintSeed;
+		walkItems([&fingerprint](InventoryContainer container, uint16_t slot, int16_t bagSlot, uint32_t itemId, uint32_t stackCount, const char*, const void* identity)
+		{
+			fingerprint = mix(fingerprint, reinterpret_cast<uintptr_t>(identity));
+			fingerprint = mix(fingerprint, (static_cast<uint64_t>(itemId) << 32) | stackCount);
+			fingerprint = mix(fingerprint, (static_cast<uint64_t>(container) << 32) | (static_cast<uint64_t>(slot) << 16) | static_cast<uint16_t>(bagSlot));
+		});
+
+		if (!m_isInvalidated && fingerprint == m_fingerprint)
+			return;
+
+		Clear();
+		walkItems([this](InventoryContainer container, uint16_t slot, int16_t bagSlot, uint32_t itemId, uint32_t stackCount, const char* name, const void*)
+		{
+			add(container, slot, bagSlot, itemId, stackCount, name);
+		});
+
+		m_fingerprint = fingerprint;
+		m_isInvalidated = false;
+		++m_rebuildCount;
+	}
+
+	// Lookups write up to capacity slots, in container / slot order, and return the total number of matching slots, which can be
+	// larger than capacity. pTotalCount (optional) receives the sum of the stack counts of every match.
+	uint32_t FindById(uint32_t itemId, uint32_t containerMask, InventorySlot* pSlots, uint32_t capacity, uint64_t* pTotalCount);
+
+	// name is ANSI, the same as item names. Exact lookups go through the name map, partial ones (the name anywhere in the item's
+	// name, like MQ2's FindItem without =) scan the folded names.
+	uint32_t FindByName(const char* name, size_t length, bool isExact, uint32_t containerMask, InventorySlot* pSlots, uint32_t capacity, uint64_t* pTotalCount);
+
+	uint32_t SlotCount() const { return static_cast<uint32_t>(m_slots.size()); }
+	void GetStatistics(InventoryIndexStatistics* pStatistics) const;
+
+private:
+	static constexpr uint32_t NoSlot = 0xFFFFFFFF;
+	static constexpr uint64_t FingerprintSeed = 0xCBF29CE484222325ull;
+
+	static uint64_t mix(uint64_t hash, uint64_t value)
+	{
+		hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+		return hash * 0x100000001B3ull;
+	}
+
+	struct NameChain
+	{
+		uint32_t First;
+		uint32_t Last;
+		uint32_t NameId;
+	};
+
+	void add(InventoryContainer container, uint16_t slot, int16_t bagSlot, uint32_t itemId, uint32_t stackCount, const char* name);
+
+	// Writes the candidates isMatch(index) accepts to pSlots. Candidates are a chain through next, or every slot when pNext is null.
+	template<typename IsMatch>
+	uint32_t collect(uint32_t first, const std::vector<uint32_t>* pNext, IsMatch isMatch, uint32_t containerMask, InventorySlot* pSlots, uint32_t capacity, uint64_t* pTotalCount) const;
+
+	const char* getName(uint32_t nameId, size_t& length) const
+	{
+		length = m_nameOffsets[nameId + 1] - m_nameOffsets[nameId];
+		return m_names.data() + m_nameOffsets[nameId];
+	}
+
+	// Slots in the order they were walked, and the id of each one's name. Every distinct folded name is stored once, name n is at
+	// [m_nameOffsets[n], m_nameOffsets[n + 1]) in m_names, so partial lookups only test each name once.
+	std::vector<InventorySlot> m_slots;
+	std::vector<uint32_t> m_slotNameIds;
+	std::vector<uint32_t> m_nameOffsets{ 0 };
+	std::vector<char> m_names;
+	std::vector<uint8_t> m_isNameMatch;
+
+	// (first, last) slot per item id and per folded name hash, chained through m_nextById / m_nextByName in the order the slots
+	// were walked. A name whose hash collides with another one's is still chained with it but gets a name id of its own.
+	std::unordered_map<uint32_t, std::pair<uint32_t, uint32_t>> m_byId;
+	std::unordered_map<uint64_t, NameChain> m_byName;
+	std::vector<uint32_t> m_nextById;
+	std::vector<uint32_t> m_nextByName;
+
+	uint64_t m_fingerprint{ 0 };
+	bool m_isChecked{ false };
+	bool m_isInvalidated{ true };
+
+	uint64_t m_checkCount{ 0 };
+	uint64_t m_rebuildCount{ 0 };
+	uint64_t m_queryCount{ 0 };
+};
+
+extern InventoryIndex g_inventoryIndex;
@@ -0,0 +1,79 @@
+#include "LoaderEventRing.h"
+
+LoaderEventRing g_loaderEventRing;
+
+bool LoaderEventRing::TryEnqueue(LoaderEventType eventType, void* pointer, uint32_t id, uint64_t handle)
+{
+	const uint32_t tail = m_tail.load(std::memory_order_relaxed);
+	const uint32_t head = m_head.load(std::memory_order_acquire);
+
+	const uint32_t count = tail - head;
+	if (count >= Capacity)
+	{
+		return false;
+	}
+
+	LoaderEvent& loaderEvent = m_events[tail & (Capacity - 1)];
+	loaderEvent.Sequence = m_nextSequence.fetch_add(1, std::memory_order_relaxed);
+	loaderEvent.EventType = static_cast<uint32_t>(eventType);
+	loaderEvent.Pointer = pointer;
+	loaderEvent.Id = id;
+	loaderEvent.Handle = handle;
+
+	m_tail.store(tail + 1, std::memory_order_release);
+	m_totalEnqueued.fetch_add(1, std::memory_order_relaxed);
+
+	if (count + 1 > m_highWaterMark.load(std::memory_order_relaxed))
+	{
+		m_highWaterMark.store(count + 1, std::memory_order_relaxed);
+	}
+
+	return true;
+}
+
+uint32_t LoaderEventRing::Drain(LoaderEvent* destination, uint32_t destinationCapacity)
+{
+	if (destination == nullptr || destinationCapacity == 0)
+	{
+		return 0;
+	}
+
+	const uint32_t head = m_head.load(std::memory_order_relaxed);
+	const uint32_t tail = m_tail.load(std::memory_order_acquire);
+
+	uint32_t drainCount = tail - head;
+	if (drainCount > destinationCapacity)
+	{
+		drainCount = destinationCapacity;
+	}
+
+	for (uint32_t index = 0; index < drainCount; ++index)
+	{
+		destination[index] = m_events[(head + index) & (Capacity - 1)];
+	}
+
+	m_head.store(head + drainCount, std::memory_order_release);
+	return drainCount;
+}
+
+void LoaderEventRing::GetStatistics(LoaderEventRingStatistics* statistics) const
+{
+	if (statistics == nullptr)
+	{
+		return;
+	}
+
+	statistics->TotalEnqueued = m_totalEnqueued.load(std::memory_order_relaxed);
+	statistics->Capacity = Capacity;
+	statistics->Count = m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+	statistics->HighWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+	statistics->OverflowCount = m_overflowCount.load(std::memory_order_relaxed);
+}
+
+void LoaderEventRing::Reset()
+{
+	m_head.store(m_tail.load(std::memory_order_acquire), std::memory_order_release);
+	m_highWaterMark.store(0, std::memory_order_relaxed);
+	m_overflowCount.store(0, std::memory_order_relaxed);
+	m_totalEnqueued.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Spawn, ground item and zone events that can be batched instead of being forwarded to the managed side one at a time.
+// RemoveSpawn and RemoveGroundItem are never queued, spawns and ground items are freed as soon as the callback returns.
+enum class LoaderEventType : uint32_t
+{
+	None = 0,
+	AddSpawn = 1,
+	RemoveSpawn = 2,
+	AddGroundItem = 3,
+	RemoveGroundItem = 4,
+	BeginZone = 5,
+	EndZone = 6,
+	Zoned = 7
+};
+
+// Layout is mirrored by MQ2DotNetCore.Interop.LoaderEvent, keep them in sync
+struct LoaderEvent
+{
+	uint32_t Sequence;
+	uint32_t EventType;
+	void* Pointer;
+
+	// SpawnID / DropID, captured at enqueue time
+	uint32_t Id;
+
+	// The spawn's SpawnHandleTable handle, 0 for everything else and for spawns the table had no room for. It no longer resolves if
+	// the client zoned before the batch was drained.
+	uint64_t Handle;
+};
+
+// Layout is mirrored by MQ2DotNetCore.Interop.LoaderEventRingStatistics, keep them in sync
+struct LoaderEventRingStatistics
+{
+	uint64_t TotalEnqueued;
+	uint32_t Capacity;
+	uint32_t Count;
+	uint32_t HighWaterMark;
+	uint32_t OverflowCount;
+};
+
+// Preallocated single producer / single consumer ring. The forwarders produce, the managed OnPulse consumes.
+class LoaderEventRing
+{
+public:
+	static const uint32_t Capacity = 4096; // Must be a power of two
+
+	bool IsEnabled() const { return m_isEnabled.load(std::memory_order_relaxed); }
+	void SetEnabled(bool isEnabled) { m_isEnabled.store(isEnabled, std::memory_order_relaxed); }
+
+	// Returns false when the ring is full, the caller decides whether to flush and retry
+	bool TryEnqueue(LoaderEventType eventType, void* pointer, uint32_t id, uint64_t handle = 0);
+
+	// Copies up to destinationCapacity events into the destination buffer, returns the number copied
+	uint32_t Drain(LoaderEvent* destination, uint32_t destinationCapacity);
+
+	bool IsEmpty() const { return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire); }
+
+	void GetStatistics(LoaderEventRingStatistics* statistics) const;
+	void RecordOverflow() { m_overflowCount.fetch_add(1, std::memory_order_relaxed); }
+	void Reset();
+
+private:
+	LoaderEvent m_events[Capacity] = {};
+
+	std::atomic<bool> m_isEnabled{ false };
+	std::atomic<uint32_t> m_head{ 0 };	// Next slot to read
+	std::atomic<uint32_t> m_tail{ 0 };	// Next slot to write
+	std::atomic<uint32_t> m_nextSequence{ 1 };
+	std::atomic<uint32_t> m_highWaterMark{ 0 };
+	std::atomic<uint32_t> m_overflowCount{ 0 };
+	std::atomic<uint64_t> m_totalEnqueued{ 0 };
+};
+
+extern LoaderEventRing g_loaderEventRing;
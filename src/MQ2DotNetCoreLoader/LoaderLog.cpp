@@ -0,0 +1,233 @@
+#include "LoaderLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+LoaderLog g_loaderLog;
+
+namespace
+{
+	const char* const LevelNames[] = { "Trace", "Debug", "Information", "Warning", "Error", "Critical" };
+}
+
+LoaderLog::LoaderLog()
+{
+	for (uint32_t slotIndex = 0; slotIndex < SlotCount; ++slotIndex)
+	{
+		m_slots[slotIndex].Sequence.store(slotIndex, std::memory_order_relaxed);
+	}
+}
+
+LoaderLog::~LoaderLog()
+{
+	Stop();
+}
+
+bool LoaderLog::Write(LoaderLogLevel level, const char* category, size_t categoryLength, const char* message, size_t messageLength)
+{
+	categoryLength = category ? std::min<size_t>(categoryLength, MaxCategoryLength) : 0;
+	messageLength = message ? messageLength : 0;
+
+	const size_t messageCapacity = MaxRecordSlots * SlotPayloadSize - sizeof(RecordHeader) - categoryLength;
+	if (messageLength > messageCapacity)
+	{
+		messageLength = messageCapacity;
+		m_truncatedCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	const size_t recordSize = sizeof(RecordHeader) + categoryLength + messageLength;
+	const uint32_t slotCount = static_cast<uint32_t>((recordSize + SlotPayloadSize - 1) / SlotPayloadSize);
+
+	// Claim slotCount consecutive slots. Slots are freed in order, so if the last one is free for this lap all of them are.
+	uint64_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		const uint64_t lastPosition = position + slotCount - 1;
+		const int64_t difference = static_cast<int64_t>(getSlot(lastPosition).Sequence.load(std::memory_order_acquire) - lastPosition);
+		if (difference == 0)
+		{
+			if (m_enqueuePosition.compare_exchange_weak(position, position + slotCount, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+		{
+			m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		else
+		{
+			position = m_enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	const RecordHeader header{
+		std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count(),
+		static_cast<uint32_t>(level),
+		static_cast<uint32_t>(categoryLength),
+		static_cast<uint32_t>(messageLength)
+	};
+
+	size_t offset = 0;
+	const auto copyToSlots = [this, position, &offset](const void* pSource, size_t size)
+	{
+		const char* pBytes = static_cast<const char*>(pSource);
+		while (size > 0)
+		{
+			const size_t slotOffset = offset % SlotPayloadSize;
+			const size_t chunkSize = std::min<size_t>(size, SlotPayloadSize - slotOffset);
+			memcpy(getSlot(position + offset / SlotPayloadSize).Payload + slotOffset, pBytes, chunkSize);
+			pBytes += chunkSize;
+			offset += chunkSize;
+			size -= chunkSize;
+		}
+	};
+
+	copyToSlots(&header, sizeof(header));
+	copyToSlots(category, categoryLength);
+	copyToSlots(message, messageLength);
+
+	// The writer thread can't get past the first slot until it's published, so loading its position first keeps it at or
+	// behind this record's. Loaded after publishing it could already be past the record and the difference would wrap.
+	const uint64_t used = position + slotCount - m_dequeuePosition.load(std::memory_order_relaxed);
+
+	getSlot(position).Sequence.store(position + 1, std::memory_order_release);
+
+	if (used > m_highWaterMark.load(std::memory_order_relaxed))
+		m_highWaterMark.store(static_cast<uint32_t>(std::min<uint64_t>(used, SlotCount)), std::memory_order_relaxed);
+
+	return true;
+}
+
+bool LoaderLog::Start(const char_t* path)
+{
+	if (IsRunning())
+		return true;
+
+#ifdef _WIN32
+	if (_wfopen_s(&m_pFile, path, L"ab") != 0)
+		m_pFile = nullptr;
+#else
+	m_pFile = fopen(path, "ab");
+#endif
+	if (m_pFile == nullptr)
+		return false;
+
+	m_isStopping = false;
+	m_writerThread = std::thread([this]() { run(); });
+	m_isRunning.store(true, std::memory_order_release);
+	return true;
+}
+
+void LoaderLog::Stop()
+{
+	if (!m_writerThread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isStopping = true;
+	}
+
+	m_wake.notify_one();
+	m_writerThread.join();
+	m_isRunning.store(false, std::memory_order_release);
+
+	fclose(m_pFile);
+	m_pFile = nullptr;
+}
+
+void LoaderLog::GetStatistics(LoaderLogStatistics* pStatistics) const
+{
+	if (pStatistics == nullptr)
+		return;
+
+	pStatistics->WrittenCount = m_writtenCount.load(std::memory_order_relaxed);
+	pStatistics->DroppedCount = m_droppedCount.load(std::memory_order_relaxed);
+	pStatistics->TruncatedCount = m_truncatedCount.load(std::memory_order_relaxed);
+	pStatistics->Capacity = SlotCount;
+	pStatistics->HighWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+}
+
+void LoaderLog::run()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_isStopping)
+	{
+		m_wake.wait_for(lock, std::chrono::milliseconds(static_cast<int64_t>(FlushIntervalMilliseconds)));
+
+		lock.unlock();
+		drain();
+		lock.lock();
+	}
+
+	// Anything written before Stop was called
+	lock.unlock();
+	drain();
+}
+
+size_t LoaderLog::drain()
+{
+	size_t recordCount = 0;
+	uint64_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		Slot& firstSlot = getSlot(position);
+		if (firstSlot.Sequence.load(std::memory_order_acquire) != position + 1)
+			break;
+
+		RecordHeader header;
+		memcpy(&header, firstSlot.Payload, sizeof(header));
+
+		const size_t recordSize = sizeof(RecordHeader) + header.CategoryLength + header.MessageLength;
+		const uint32_t slotCount = static_cast<uint32_t>((recordSize + SlotPayloadSize - 1) / SlotPayloadSize);
+
+		m_record.resize(recordSize);
+		for (uint32_t slotIndex = 0; slotIndex < slotCount; ++slotIndex)
+		{
+			const size_t offset = slotIndex * static_cast<size_t>(SlotPayloadSize);
+			memcpy(&m_record[offset], getSlot(position + slotIndex).Payload, std::min<size_t>(SlotPayloadSize, recordSize - offset));
+		}
+
+		// Free the slots in order, producers rely on that when they check the last slot of the range they want
+		for (uint32_t slotIndex = 0; slotIndex < slotCount; ++slotIndex)
+		{
+			getSlot(position + slotIndex).Sequence.store(position + slotIndex + SlotCount, std::memory_order_release);
+		}
+
+		position += slotCount;
+		m_dequeuePosition.store(position, std::memory_order_release);
+
+		const time_t seconds = static_cast<time_t>(header.UnixMicroseconds / 1000000);
+		tm localTime{};
+#ifdef _WIN32
+		localtime_s(&localTime, &seconds);
+#else
+		localtime_r(&seconds, &localTime);
+#endif
+
+		char prefix[64];
+		const size_t prefixLength = strftime(prefix, sizeof(prefix), "[ %Y-%m-%d %H:%M:%S", &localTime);
+		snprintf(prefix + prefixLength, sizeof(prefix) - prefixLength, ".%03d ", static_cast<int>(header.UnixMicroseconds / 1000 % 1000));
+
+		m_batch += prefix;
+		m_batch.append(m_record, sizeof(RecordHeader), header.CategoryLength);
+		m_batch += ' ';
+		m_batch += header.Level < sizeof(LevelNames) / sizeof(LevelNames[0]) ? LevelNames[header.Level] : "None";
+		m_batch += " ]  ";
+		m_batch.append(m_record, sizeof(RecordHeader) + header.CategoryLength, header.MessageLength);
+		m_batch += "\n\n";
+		++recordCount;
+	}
+
+	if (!m_batch.empty())
+	{
+		fwrite(m_batch.data(), 1, m_batch.size(), m_pFile);
+		fflush(m_pFile);
+		m_batch.clear();
+		m_writtenCount.fetch_add(recordCount, std::memory_order_relaxed);
+	}
+
+	return recordCount;
+}
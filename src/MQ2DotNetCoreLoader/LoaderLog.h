@@ -0,0 +1,112 @@
+#pragma once
+
+#include "includes/hostfxr.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Same values as Microsoft.Extensions.Logging.LogLevel, which the managed side passes straight through
+enum class LoaderLogLevel : uint32_t
+{
+	Trace = 0,
+	Debug = 1,
+	Information = 2,
+	Warning = 3,
+	Error = 4,
+	Critical = 5
+};
+
+// Layout is mirrored by MQ2DotNetCore.Interop.LoaderLogStatistics, keep them in sync
+struct LoaderLogStatistics
+{
+	uint64_t WrittenCount;
+	uint64_t DroppedCount;
+	uint64_t TruncatedCount;
+	uint32_t Capacity;
+	uint32_t HighWaterMark;
+};
+
+// The log file shared by the loader and the managed loggers. Write copies the record into a preallocated multi producer /
+// single consumer ring of fixed size slots and returns, a background thread formats the queued records and appends them
+// to the file in batches. When the ring is full the record is dropped and counted, so logging never waits on the disk or
+// on another thread. A record takes as many consecutive slots as it needs, messages past MaxRecordSlots are truncated.
+class LoaderLog
+{
+public:
+	static const uint32_t SlotCount = 4096; // Must be a power of two
+	static const uint32_t SlotPayloadSize = 120;
+	static const uint32_t MaxRecordSlots = 256;
+	static const uint32_t MaxCategoryLength = 256;
+	static const uint32_t FlushIntervalMilliseconds = 50;
+
+	LoaderLog();
+	~LoaderLog();
+
+	LoaderLog(const LoaderLog&) = delete;
+	LoaderLog& operator=(const LoaderLog&) = delete;
+
+	// Safe to call from any thread, returns false if the record was dropped. Records written before Start are kept and
+	// written once it's called.
+	bool Write(LoaderLogLevel level, const char* category, size_t categoryLength, const char* message, size_t messageLength);
+
+	// Opens the file for appending and starts the writer thread, false if the file couldn't be opened
+	bool Start(const char_t* path);
+
+	// Writes everything still queued, then stops the writer thread and closes the file
+	void Stop();
+
+	bool IsRunning() const { return m_isRunning.load(std::memory_order_acquire); }
+
+	void GetStatistics(LoaderLogStatistics* pStatistics) const;
+
+private:
+	struct Slot
+	{
+		// position when the slot is free for the record starting at position, position + 1 once that record is published.
+		// Only the first slot of a record is published, its release covers the payload of the others.
+		std::atomic<uint64_t> Sequence;
+		char Payload[SlotPayloadSize];
+	};
+
+	struct RecordHeader
+	{
+		int64_t UnixMicroseconds;
+		uint32_t Level;
+		uint32_t CategoryLength;
+		uint32_t MessageLength;
+	};
+
+	Slot& getSlot(uint64_t position) { return m_slots[position & (SlotCount - 1)]; }
+	void run();
+
+	// Formats every published record into the batch and frees their slots, returns the number of records
+	size_t drain();
+
+	Slot m_slots[SlotCount];
+	std::atomic<uint64_t> m_enqueuePosition{ 0 };
+	std::atomic<uint64_t> m_dequeuePosition{ 0 };
+
+	std::atomic<uint64_t> m_writtenCount{ 0 };
+	std::atomic<uint64_t> m_droppedCount{ 0 };
+	std::atomic<uint64_t> m_truncatedCount{ 0 };
+	std::atomic<uint32_t> m_highWaterMark{ 0 };
+
+	// Only touched by the writer thread, and by Start / Stop while it isn't running
+	FILE* m_pFile{ nullptr };
+	std::string m_record;
+	std::string m_batch;
+
+	std::atomic<bool> m_isRunning{ false };
+	bool m_isStopping{ false };
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::thread m_writerThread;
+};
+
+extern LoaderLog g_loaderLog;
@@ -0,0 +1,272 @@
+#include "LoaderPlatform.h"
+
+#include <initializer_list>
+
+#ifdef _WIN32
+
+#include <windows.h>
+#include <strsafe.h>
+
+#else
+
+#include <dirent.h>
+#include <dlfcn.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+#include <time.h>
+
+#endif
+
+#ifdef _WIN32
+
+void* loadLibrary(const char_t* libraryPath)
+{
+	return ::LoadLibraryW(libraryPath);
+}
+
+void* getLibraryExport(void* library, const char* name)
+{
+	return library ? reinterpret_cast<void*>(::GetProcAddress(static_cast<HMODULE>(library), name)) : nullptr;
+}
+
+void buildLoaderPath(char_t* pDestination, size_t capacity, const char* directory, const char* subdirectory, const char* fileName)
+{
+	const size_t size = capacity * sizeof(char_t);
+	pDestination[0] = L'\0';
+	for (const char* part : { directory, subdirectory, fileName })
+	{
+		if (part == nullptr || part[0] == '\0')
+			continue;
+
+		if (pDestination[0] == L'\0')
+			StringCbPrintfW(pDestination, size, L"%hs", part);
+		else
+			StringCbPrintfW(pDestination + wcslen(pDestination), size - wcslen(pDestination) * sizeof(char_t), L"\\%hs", part);
+	}
+}
+
+int readLoaderSetting(const char_t* iniPath, const char* section, const char* key, int defaultValue)
+{
+	wchar_t wideSection[64];
+	wchar_t wideKey[64];
+	StringCbPrintfW(wideSection, sizeof(wideSection), L"%hs", section);
+	StringCbPrintfW(wideKey, sizeof(wideKey), L"%hs", key);
+	return static_cast<int>(::GetPrivateProfileIntW(wideSection, wideKey, defaultValue, iniPath));
+}
+
+int64_t getStopwatchTimestamp()
+{
+	LARGE_INTEGER counter;
+	::QueryPerformanceCounter(&counter);
+	return counter.QuadPart;
+}
+
+uint32_t getLoaderProcessId()
+{
+	return static_cast<uint32_t>(::GetCurrentProcessId());
+}
+
+bool copyLoaderFile(const char_t* sourcePath, const char_t* destinationPath)
+{
+	return ::CopyFileW(sourcePath, destinationPath, FALSE) != FALSE;
+}
+
+bool doesLoaderFileExist(const char_t* path)
+{
+	return ::GetFileAttributesW(path) != INVALID_FILE_ATTRIBUTES;
+}
+
+void deleteLoaderFiles(const char_t* directory, const char* fileNamePrefix)
+{
+	wchar_t pattern[MAX_PATH];
+	if (directory[0] == L'\0')
+		StringCbPrintfW(pattern, sizeof(pattern), L"%hs*", fileNamePrefix);
+	else
+		StringCbPrintfW(pattern, sizeof(pattern), L"%ws\\%hs*", directory, fileNamePrefix);
+
+	WIN32_FIND_DATAW findData;
+	HANDLE findHandle = ::FindFirstFileW(pattern, &findData);
+	if (findHandle == INVALID_HANDLE_VALUE)
+		return;
+
+	do
+	{
+		wchar_t path[MAX_PATH];
+		if (directory[0] == L'\0')
+			StringCbPrintfW(path, sizeof(path), L"%ws", findData.cFileName);
+		else
+			StringCbPrintfW(path, sizeof(path), L"%ws\\%ws", directory, findData.cFileName);
+
+		::DeleteFileW(path);
+	} while (::FindNextFileW(findHandle, &findData));
+
+	::FindClose(findHandle);
+}
+
+#else
+
+void* loadLibrary(const char_t* libraryPath)
+{
+	// RTLD_GLOBAL so the managed side's DllImports of already loaded libraries (MQ2Main.dll, MQ2DotNetCoreLoader.dll) resolve
+	// to the same handles
+	return dlopen(libraryPath, RTLD_NOW | RTLD_GLOBAL);
+}
+
+void* getLibraryExport(void* library, const char* name)
+{
+	return library ? dlsym(library, name) : nullptr;
+}
+
+void buildLoaderPath(char_t* pDestination, size_t capacity, const char* directory, const char* subdirectory, const char* fileName)
+{
+	size_t length = 0;
+	pDestination[0] = '\0';
+	for (const char* part : { directory, subdirectory, fileName })
+	{
+		if (part == nullptr || part[0] == '\0' || length + 1 >= capacity)
+			continue;
+
+		const int written = snprintf(pDestination + length, capacity - length, length == 0 ? "%s" : "/%s", part);
+		if (written > 0)
+			length += static_cast<size_t>(written);
+
+		if (length >= capacity)
+			length = capacity - 1;
+	}
+}
+
+int readLoaderSetting(const char_t* iniPath, const char* section, const char* key, int defaultValue)
+{
+	FILE* pFile = fopen(iniPath, "r");
+	if (pFile == nullptr)
+		return defaultValue;
+
+	int value = defaultValue;
+	bool isInSection = false;
+	char line[512];
+	while (fgets(line, sizeof(line), pFile))
+	{
+		char* pStart = line;
+		while (*pStart == ' ' || *pStart == '\t')
+			++pStart;
+
+		char* pEnd = pStart + strlen(pStart);
+		while (pEnd > pStart && (pEnd[-1] == '\n' || pEnd[-1] == '\r' || pEnd[-1] == ' ' || pEnd[-1] == '\t'))
+			*--pEnd = '\0';
+
+		if (*pStart == '[')
+		{
+			char* pClose = strchr(pStart, ']');
+			if (pClose)
+				*pClose = '\0';
+
+			isInSection = strcasecmp(pStart + 1, section) == 0;
+			continue;
+		}
+
+		char* pEquals = strchr(pStart, '=');
+		if (!isInSection || pEquals == nullptr)
+			continue;
+
+		char* pKeyEnd = pEquals;
+		while (pKeyEnd > pStart && (pKeyEnd[-1] == ' ' || pKeyEnd[-1] == '\t'))
+			--pKeyEnd;
+
+		*pKeyEnd = '\0';
+		if (strcasecmp(pStart, key) == 0)
+		{
+			value = atoi(pEquals + 1);
+			break;
+		}
+	}
+
+	fclose(pFile);
+	return value;
+}
+
+int64_t getStopwatchTimestamp()
+{
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+uint32_t getLoaderProcessId()
+{
+	return static_cast<uint32_t>(getpid());
+}
+
+bool copyLoaderFile(const char_t* sourcePath, const char_t* destinationPath)
+{
+	char temporaryPath[4096];
+	if (snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", destinationPath) >= static_cast<int>(sizeof(temporaryPath)))
+		return false;
+
+	FILE* pSource = fopen(sourcePath, "rb");
+	if (pSource == nullptr)
+		return false;
+
+	FILE* pDestination = fopen(temporaryPath, "wb");
+	if (pDestination == nullptr)
+	{
+		fclose(pSource);
+		return false;
+	}
+
+	bool isCopied = true;
+	char buffer[16384];
+	size_t read = 0;
+	while ((read = fread(buffer, 1, sizeof(buffer), pSource)) > 0)
+	{
+		if (fwrite(buffer, 1, read, pDestination) != read)
+		{
+			isCopied = false;
+			break;
+		}
+	}
+
+	isCopied = isCopied && !ferror(pSource);
+	fclose(pSource);
+	isCopied = fclose(pDestination) == 0 && isCopied;
+
+	if (isCopied && rename(temporaryPath, destinationPath) == 0)
+		return true;
+
+	remove(temporaryPath);
+	return false;
+}
+
+bool doesLoaderFileExist(const char_t* path)
+{
+	return access(path, F_OK) == 0;
+}
+
+void deleteLoaderFiles(const char_t* directory, const char* fileNamePrefix)
+{
+	DIR* pDirectory = opendir(directory[0] == '\0' ? "." : directory);
+	if (pDirectory == nullptr)
+		return;
+
+	const size_t prefixLength = strlen(fileNamePrefix);
+	while (dirent* pEntry = readdir(pDirectory))
+	{
+		if (strncmp(pEntry->d_name, fileNamePrefix, prefixLength) != 0)
+			continue;
+
+		char path[4096];
+		if (directory[0] == '\0')
+			snprintf(path, sizeof(path), "%s", pEntry->d_name);
+		else
+			snprintf(path, sizeof(path), "%s/%s", directory, pEntry->d_name);
+
+		unlink(path);
+	}
+
+	closedir(pDirectory);
+}
+
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "includes/hostfxr.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// The little bit of OS specific code the hosting logic needs, so the loader also builds against the stub MQ2 host (see
+// stub/MQ2Plugin.h) on Linux. LoadLibraryW / GetProcAddress on Windows, dlopen / dlsym everywhere else. Paths are char_t
+// like the hostfxr API, i.e. wchar_t on Windows and UTF-8 elsewhere.
+
+#ifdef _WIN32
+
+#define LOADER_TEXT(text) L##text
+#define LOADER_PATH_FORMAT "%ws"
+
+#else
+
+#define LOADER_TEXT(text) text
+#define LOADER_PATH_FORMAT "%s"
+
+#endif
+
+// Returns nullptr if the library couldn't be loaded
+void* loadLibrary(const char_t* libraryPath);
+
+// Returns nullptr if the library is null or doesn't export the name
+void* getLibraryExport(void* library, const char* name);
+
+// Joins the non empty parts with the platform's directory separator, e.g. gszINIPath, "MQ2DotNetCore", "MQ2DotNetCore.dll".
+// The result is truncated to fit the destination.
+void buildLoaderPath(char_t* pDestination, size_t capacity, const char* directory, const char* subdirectory, const char* fileName);
+
+// Reads an integer setting from an INI file, returns defaultValue if the file, section or key doesn't exist.
+// GetPrivateProfileInt on Windows, a minimal parser that ignores comments and quoting elsewhere.
+int readLoaderSetting(const char_t* iniPath, const char* section, const char* key, int defaultValue);
+
+// Monotonic timestamp in the units of .NET's Stopwatch.GetTimestamp, so the managed side can compare it against its own clock.
+// QueryPerformanceCounter on Windows, CLOCK_MONOTONIC nanoseconds elsewhere.
+int64_t getStopwatchTimestamp();
+
+uint32_t getLoaderProcessId();
+
+// Copies a file over the destination. Returns false if the source can't be read or the destination can't be written, e.g.
+// because it's a dll that's loaded, which Windows keeps locked. Elsewhere the copy is written next to the destination and
+// renamed over it, so a process that has the old file mapped keeps its copy.
+bool copyLoaderFile(const char_t* sourcePath, const char_t* destinationPath);
+
+bool doesLoaderFileExist(const char_t* path);
+
+// Deletes the files in the directory (the working directory if empty) whose names start with the prefix. Files that can't be
+// deleted, like dlls another process has loaded on Windows, are skipped.
+void deleteLoaderFiles(const char_t* directory, const char* fileNamePrefix);
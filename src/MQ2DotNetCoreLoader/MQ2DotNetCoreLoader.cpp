@@ -1,26 +1,48 @@
 #define TEST
 
-#ifdef MQ2SourceRootFolder
-
-#include "MQ2Plugin.h"
-
+#include "MQ2DotNetCoreLoader.h"
+#include "AsyncBoot.h"
+#include "CallbackCapture.h"
+#include "CallbackSubscriptions.h"
+#include "CallbackTimings.h"
+#include "ChatFilter.h"
+#include "ExpressionPlan.h"
+#include "HotReload.h"
+#include "InternTable.h"
+#include "InventoryIndex.h"
+#include "LoaderEventRing.h"
+#include "LoaderLog.h"
+#include "LoaderPlatform.h"
+#include "MemberBatch.h"
+#include "MemberCache.h"
+#include "PulseArena.h"
+#include "RuntimeProfile.h"
+#include "SharedStateBus.h"
+#include "SpawnChangeFeed.h"
+#include "SpawnHandleTable.h"
+#include "SpawnSnapshot.h"
+#include "SpawnSpatialIndex.h"
+#include "TextEncoding.h"
+
+#ifdef _WIN32
+#include "libs/nethost-win-x86/nethost.h"
 #else
-
-#include "../../../MQ2Plugin.h"
-
+#include <nethost.h>
 #endif
 
-#include "libs/nethost-win-x86/nethost.h"
-
 #include "includes/coreclr_delegates.h"
 #include "includes/hostfxr.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
 #include <ctime>
-#include <fstream>
 #include <memory>
 #include <stdexcept>
 #include <string>
-#include <strsafe.h>
+#include <thread>
 
 
 //#import <mscorlib.tlb> raw_interfaces_only			\
@@ -33,69 +55,293 @@ PLUGIN_VERSION(1.0);
 PreSetup("MQ2DotNetCoreLoader");
 
 bool g_bLoaded{ false };
-wchar_t g_entryAssemblyLibraryPath[MAX_PATH] = { 0 };
-wchar_t g_dotnetRuntimeConfigPath[MAX_PATH] = { 0 };
-wchar_t g_pluginLogFile[MAX_PATH] = { 0 };
+char_t g_entryAssemblyLibraryPath[MAX_PATH] = { 0 };
+char_t g_hotReloadHostAssemblyPath[MAX_PATH] = { 0 };
+char_t g_dotnetRuntimeConfigPath[MAX_PATH] = { 0 };
+char_t g_pluginLogFile[MAX_PATH] = { 0 };
+
+bool g_isSpawnSpatialIndexStale{ true };
+
+// Only used with AsyncBoot=1, the thread starting the CLR and the managed InitializePlugin it found
+std::thread g_bootThread;
+component_entry_point_fn g_pfInitializeEntryPoint{ nullptr };
+
+bool loadDotNetClr(bool shouldPrepareEntryPoint, component_entry_point_fn* pInitializePlugin);
+bool executeEntryPoint(component_entry_point_fn initializePlugin);
+void finishBoot();
+void reportBootResult();
+void performHotReload();
+void resetLoaderState();
+void clearManagedCallbacks();
+bool deferWhileBooting(LoaderCallback callback, const char* line, uint32_t argument0, uint32_t argument1);
+
+void enqueueLoaderEvent(LoaderEventType eventType, void* pointer, uint32_t id, uint64_t handle = 0);
+void drainQueuedLoaderEvents();
+
+void refreshSpawnSpatialIndex();
+void seedSpawnIndexes();
+void startCallbackCapture(const char_t* settingsPath);
+void captureChatLine(LoaderCallback callback, PCHAR Line, DWORD Color, DWORD Filter);
+void captureSpawn(LoaderCallback callback, PSPAWNINFO pSpawn, uint32_t flags);
+void captureGroundItem(LoaderCallback callback, PGROUNDITEM pGroundItem);
+
+int32_t typeToStringUtf8(MQ2Type* pThis, MQ2VARPTR VarPtr, char* pDestination, uint32_t capacity, uint32_t* pFlags);
+const char* typeToStringArena(MQ2Type* pThis, MQ2VARPTR VarPtr, uint32_t* pLength);
+int32_t parseMacroDataUtf8(const char* expression, char* pDestination, uint32_t capacity, uint32_t* pFlags);
+const char* parseMacroDataArena(const char* expression, uint32_t* pLength);
+bool getMemberUtf8(MQ2Type* pThis, MQ2VARPTR VarPtr, const char* pMember, uint32_t memberLength, const char* pIndex, uint32_t indexLength, MQ2TYPEVAR& Dest);
+bool getTopLevelObjectUtf8(const char* pName, uint32_t nameLength, const char* pIndex, uint32_t indexLength, MQ2TYPEVAR& Dest);
+const char* chatLineToUtf8(const char* pLine, char* pBuffer, uint32_t capacity, uint32_t* pLength);
 
-void* get_export(HMODULE hModule, const char* name);
+// Functions in the managed dll. All standard plugin callbacks except initialize, since there's no point having that
+extern "C" { __declspec(dllexport) fMQShutdownPlugin g_pfShutdownPlugin { nullptr }; }
+extern "C" { __declspec(dllexport) fMQCleanUI g_pfOnCleanUI { nullptr }; }
+extern "C" { __declspec(dllexport) fMQReloadUI g_pfOnReloadUI { nullptr }; }
+extern "C" { __declspec(dllexport) fMQDrawHUD g_pfOnDrawHUD { nullptr }; }
+extern "C" { __declspec(dllexport) fMQSetGameState g_pfSetGameState { nullptr }; }
+extern "C" { __declspec(dllexport) fMQPulse g_pfOnPulse { nullptr }; }
+extern "C" { __declspec(dllexport) fMQIncomingChat g_pfOnIncomingChat { nullptr }; }
+extern "C" { __declspec(dllexport) fMQWriteChatColor g_pfOnWriteChatColor { nullptr }; }
+extern "C" { __declspec(dllexport) fMQSpawn g_pfOnAddSpawn { nullptr }; }
+extern "C" { __declspec(dllexport) fMQSpawn g_pfOnRemoveSpawn { nullptr }; }
+extern "C" { __declspec(dllexport) fMQGroundItem g_pfOnAddGroundItem { nullptr }; }
+extern "C" { __declspec(dllexport) fMQGroundItem g_pfOnRemoveGroundItem { nullptr }; }
+extern "C" { __declspec(dllexport) fMQBeginZone g_pfBeginZone { nullptr }; }
+extern "C" { __declspec(dllexport) fMQEndZone g_pfEndZone { nullptr }; }
+extern "C" { __declspec(dllexport) fMQZoned g_pfOnZoned { nullptr }; }
+
+// Called when the loader event ring is full so the managed side can drain it before the next OnPulse
+typedef VOID(__cdecl* fLoaderEventsDrain)(VOID);
+extern "C" { __declspec(dllexport) fLoaderEventsDrain g_pfDrainLoaderEvents { nullptr }; }
+
+// Chat callbacks used when at least one chat pattern is registered, they also receive the ids of the patterns the line matched
+typedef DWORD(__cdecl* fIncomingChatMatched)(PCHAR Line, DWORD Color, const int32_t* pMatchedIds, uint32_t matchedIdCount);
+typedef DWORD(__cdecl* fWriteChatColorMatched)(PCHAR Line, DWORD Color, DWORD Filter, const int32_t* pMatchedIds, uint32_t matchedIdCount);
+extern "C" { __declspec(dllexport) fIncomingChatMatched g_pfOnIncomingChatMatched { nullptr }; }
+extern "C" { __declspec(dllexport) fWriteChatColorMatched g_pfOnWriteChatColorMatched { nullptr }; }
+
+// Callback ABI v2, every argument is blittable so the managed side's thunks don't marshal anything. Chat lines are UTF-8 pointer +
+// length (not counting the terminator) and the matched pattern ids are always passed, with a count of 0 when none matched. Only
+// called after the managed side selects v2, the callbacks above stay bound for v1.
+typedef DWORD(__cdecl* fIncomingChatV2)(const char* pLine, uint32_t lineLength, DWORD Color, const int32_t* pMatchedIds, uint32_t matchedIdCount);
+typedef DWORD(__cdecl* fWriteChatColorV2)(const char* pLine, uint32_t lineLength, DWORD Color, DWORD Filter, const int32_t* pMatchedIds, uint32_t matchedIdCount);
+extern "C" { __declspec(dllexport) fIncomingChatV2 g_pfOnIncomingChatV2 { nullptr }; }
+extern "C" { __declspec(dllexport) fWriteChatColorV2 g_pfOnWriteChatColorV2 { nullptr }; }
+
+// Callback ABI v2 spawn callbacks, also pass the spawn's SpawnHandleTable handle so the managed side doesn't have to look it up
+typedef VOID(__cdecl* fSpawnV2)(PSPAWNINFO pSpawn, uint64_t handle);
+extern "C" { __declspec(dllexport) fSpawnV2 g_pfOnAddSpawnV2 { nullptr }; }
+extern "C" { __declspec(dllexport) fSpawnV2 g_pfOnRemoveSpawnV2 { nullptr }; }
+
+// MAX_STRING characters of chat can take up to 3 bytes each in UTF-8
+const uint32_t ChatLineUtf8Capacity = MAX_STRING * 3;
+
+// Highest callback ABI version this loader knows, CallbackAbi in MQ2DotNetCoreLoader.ini can lower it
+const uint32_t LoaderAbiVersion = 2;
+uint32_t g_maxCallbackAbiVersion{ LoaderAbiVersion };
+uint32_t g_callbackAbiVersion{ 1 };
+
+// Read by the managed OnPulse to budget the continuations it runs. StartTimestamp is when the pulse started, in Stopwatch units,
+// BudgetMicroseconds comes from PulseBudgetMicroseconds in MQ2DotNetCoreLoader.ini (0 for no limit)
+struct PulseFrame
+{
+	int64_t StartTimestamp;
+	uint32_t BudgetMicroseconds;
+	uint32_t Reserved;
+};
+extern "C" { __declspec(dllexport) PulseFrame g_pulseFrame { 0, 0, 0 }; }
 
-void logToFile(std::string message);
+// Exported callback timing functions, every PLUGIN_API forwarder (including the managed handler it calls) is timed
+extern "C" __declspec(dllexport) bool CallbackTimings__GetSummary(uint32_t callback, CallbackTimingSummary * pSummary) { return g_callbackTimings.GetSummary(callback, pSummary); }
+extern "C" __declspec(dllexport) void CallbackTimings__Reset() { g_callbackTimings.Reset(); g_callbackSubscriptions.ResetSkippedCounts(); }
 
-bool loadDotNetClrAndExecuteEntryPoint();
+// Exported callback capture functions, only capturing with Capture=1 in MQ2DotNetCoreLoader.ini
+extern "C" __declspec(dllexport) void CallbackCapture__GetStatistics(CallbackCaptureStatistics * pStatistics) { g_callbackCapture.GetStatistics(pStatistics); }
 
-// Functions in the managed dll. All standard plugin callbacks except initialize, since there's no point having that
-extern "C" __declspec(dllexport) fMQShutdownPlugin g_pfShutdownPlugin { nullptr };
-extern "C" __declspec(dllexport) fMQCleanUI g_pfOnCleanUI { nullptr };
-extern "C" __declspec(dllexport) fMQReloadUI g_pfOnReloadUI { nullptr };
-extern "C" __declspec(dllexport) fMQDrawHUD g_pfOnDrawHUD { nullptr };
-extern "C" __declspec(dllexport) fMQSetGameState g_pfSetGameState { nullptr };
-extern "C" __declspec(dllexport) fMQPulse g_pfOnPulse { nullptr };
-extern "C" __declspec(dllexport) fMQIncomingChat g_pfOnIncomingChat { nullptr };
-extern "C" __declspec(dllexport) fMQWriteChatColor g_pfOnWriteChatColor { nullptr };
-extern "C" __declspec(dllexport) fMQSpawn g_pfOnAddSpawn { nullptr };
-extern "C" __declspec(dllexport) fMQSpawn g_pfOnRemoveSpawn { nullptr };
-extern "C" __declspec(dllexport) fMQGroundItem g_pfOnAddGroundItem { nullptr };
-extern "C" __declspec(dllexport) fMQGroundItem g_pfOnRemoveGroundItem { nullptr };
-extern "C" __declspec(dllexport) fMQBeginZone g_pfBeginZone { nullptr };
-extern "C" __declspec(dllexport) fMQEndZone g_pfEndZone { nullptr };
-extern "C" __declspec(dllexport) fMQZoned g_pfOnZoned { nullptr };
+// Exported callback subscription functions, forwarders skip the managed side for callbacks whose bit isn't set in the mask
+extern "C" __declspec(dllexport) uint32_t CallbackSubscriptions__SetMask(uint32_t mask) { return g_callbackSubscriptions.SetMask(mask); }
+extern "C" __declspec(dllexport) uint32_t CallbackSubscriptions__GetMask(uint32_t * pVersion) { return g_callbackSubscriptions.GetMask(pVersion); }
+extern "C" __declspec(dllexport) uint64_t CallbackSubscriptions__GetSkippedCount(uint32_t callback) { return g_callbackSubscriptions.GetSkippedCount(callback); }
+
+// Exported log functions, the managed loggers write into the same ring as the loader and nothing waits on the file
+extern "C" __declspec(dllexport) bool LoaderLog__Write(uint32_t level, const char* category, uint32_t categoryLength, const char* message, uint32_t messageLength) { return g_loaderLog.Write(static_cast<LoaderLogLevel>(level), category, categoryLength, message, messageLength); }
+extern "C" __declspec(dllexport) void LoaderLog__GetStatistics(LoaderLogStatistics * pStatistics) { g_loaderLog.GetStatistics(pStatistics); }
 
 // Exported helper functions to make things easier in the managed world
 extern "C" __declspec(dllexport) PCHAR __stdcall GetIniPath() { return gszINIPath; }
 
+// Exported callback ABI functions. The managed side binds the callbacks of every version it knows, then selects the highest one
+extern "C" __declspec(dllexport) uint32_t LoaderAbi__SelectVersion(uint32_t version) { g_callbackAbiVersion = std::clamp(version, 1u, g_maxCallbackAbiVersion); return g_callbackAbiVersion; }
+extern "C" __declspec(dllexport) uint32_t LoaderAbi__GetVersion() { return g_callbackAbiVersion; }
+
 // Exported MQ2Type functions
 extern "C" __declspec(dllexport) bool MQ2Type__FromData(MQ2Type * pThis, MQ2VARPTR & VarPtr, MQ2TYPEVAR & Source) { return pThis->FromData(VarPtr, Source); }
 extern "C" __declspec(dllexport) bool MQ2Type__FromString(MQ2Type * pThis, MQ2VARPTR & VarPtr, PCHAR Source) { return pThis->FromString(VarPtr, Source); }
 extern "C" __declspec(dllexport) void MQ2Type__InitVariable(MQ2Type * pThis, MQ2VARPTR & VarPtr) { pThis->InitVariable(VarPtr); }
 extern "C" __declspec(dllexport) void MQ2Type__FreeVariable(MQ2Type * pThis, MQ2VARPTR & VarPtr) { pThis->FreeVariable(VarPtr); }
-extern "C" __declspec(dllexport) bool MQ2Type__GetMember(MQ2Type * pThis, MQ2VARPTR VarPtr, PCHAR Member, PCHAR Index, MQ2TYPEVAR & Dest) { return pThis->GetMember(VarPtr, Member, Index, Dest); }
+extern "C" __declspec(dllexport) bool MQ2Type__GetMember(MQ2Type * pThis, MQ2VARPTR VarPtr, PCHAR Member, PCHAR Index, MQ2TYPEVAR & Dest) { return getMemberCached(pThis, VarPtr, Member, Index, Dest); }
 extern "C" __declspec(dllexport) bool MQ2Type__ToString(MQ2Type * pThis, MQ2VARPTR VarPtr, PCHAR Destination) { return pThis->ToString(VarPtr, Destination); }
 
+// Exported blittable MQ2Type functions (ABI v2), strings are UTF-8 pointer + length and the results 0 / 1
+extern "C" __declspec(dllexport) int32_t MQ2Type__FromStringUtf8(MQ2Type * pThis, MQ2VARPTR & VarPtr, const char* pSource, uint32_t sourceLength) { char source[MAX_STRING]; return utf8ToAnsi(pSource, sourceLength, source, sizeof(source)) && pThis->FromString(VarPtr, source) ? 1 : 0; }
+extern "C" __declspec(dllexport) int32_t MQ2Type__GetMemberUtf8(MQ2Type * pThis, MQ2VARPTR VarPtr, const char* pMember, uint32_t memberLength, const char* pIndex, uint32_t indexLength, MQ2TYPEVAR & Dest) { return getMemberUtf8(pThis, VarPtr, pMember, memberLength, pIndex, indexLength, Dest) ? 1 : 0; }
+extern "C" __declspec(dllexport) int32_t MQ2Type__GetMemberById(MQ2Type * pThis, MQ2VARPTR VarPtr, uint32_t memberId, const char* pIndex, uint32_t indexLength, MQ2TYPEVAR & Dest) { return getMemberById(pThis, VarPtr, memberId, pIndex, indexLength, Dest) ? 1 : 0; }
+
+// Exported intern table functions, type and member names get ids once so reads don't pass them as strings. The arrays are indexed by id.
+extern "C" __declspec(dllexport) uint32_t InternTable__InternType(const char* name) { return g_internTable.InternType(name); }
+extern "C" __declspec(dllexport) uint32_t InternTable__InternMember(const char* name) { return g_internTable.InternMember(name); }
+extern "C" __declspec(dllexport) void* const* InternTable__GetTypes(uint32_t * pCount) { *pCount = g_internTable.GetTypeCount(); return g_internTable.GetTypes(); }
+extern "C" __declspec(dllexport) char* const* InternTable__GetMemberNames(uint32_t * pCount) { *pCount = g_internTable.GetMemberCount(); return g_internTable.GetMemberNames(); }
+extern "C" __declspec(dllexport) void InternTable__GetStatistics(InternTableStatistics * pStatistics) { g_internTable.GetStatistics(pStatistics); }
+
+// Exported UTF-8 string functions. The *Utf8 versions write into a caller provided buffer and return the full length (-1 on
+// failure), the *Arena versions return a pointer into the pulse arena that stays valid until the start of the next OnPulse
+extern "C" __declspec(dllexport) int32_t MQ2Type__ToStringUtf8(MQ2Type * pThis, MQ2VARPTR VarPtr, char* pDestination, uint32_t capacity, uint32_t * pFlags) { return typeToStringUtf8(pThis, VarPtr, pDestination, capacity, pFlags); }
+extern "C" __declspec(dllexport) const char* MQ2Type__ToStringArena(MQ2Type * pThis, MQ2VARPTR VarPtr, uint32_t * pLength) { return typeToStringArena(pThis, VarPtr, pLength); }
+extern "C" __declspec(dllexport) int32_t MQ2Main__ParseMacroDataUtf8(const char* Expression, char* pDestination, uint32_t capacity, uint32_t * pFlags) { return parseMacroDataUtf8(Expression, pDestination, capacity, pFlags); }
+extern "C" __declspec(dllexport) const char* MQ2Main__ParseMacroDataArena(const char* Expression, uint32_t * pLength) { return parseMacroDataArena(Expression, pLength); }
+extern "C" __declspec(dllexport) uint32_t PulseArena__GetHighWaterMark() { return static_cast<uint32_t>(g_pulseArena.GetHighWaterMark()); }
+
+// Exported TLO lookup, saves the managed side marshaling the data item and a delegate per call and goes through the member cache
+extern "C" __declspec(dllexport) bool MQ2Main__GetTopLevelObject(PCHAR Name, PCHAR Index, MQ2TYPEVAR & Dest) { const auto pDataItem = FindMQ2Data(Name); return pDataItem && pDataItem->Function && getTopLevelObjectCached(pDataItem, Index, Dest); }
+extern "C" __declspec(dllexport) int32_t MQ2Main__GetTopLevelObjectUtf8(const char* pName, uint32_t nameLength, const char* pIndex, uint32_t indexLength, MQ2TYPEVAR & Dest) { return getTopLevelObjectUtf8(pName, nameLength, pIndex, indexLength, Dest) ? 1 : 0; }
+
+// Exported member cache functions. Off until the managed side enables it, entries are dropped at the start of every pulse
+extern "C" __declspec(dllexport) void MemberCache__SetEnabled(bool isEnabled) { g_memberCache.SetEnabled(isEnabled); }
+extern "C" __declspec(dllexport) void MemberCache__AddBypass(const char* member) { g_memberCache.AddBypass(member); }
+extern "C" __declspec(dllexport) void MemberCache__ClearBypass() { g_memberCache.ClearBypass(); }
+extern "C" __declspec(dllexport) void MemberCache__Invalidate() { g_memberCache.NextEpoch(); }
+extern "C" __declspec(dllexport) void MemberCache__GetStatistics(MemberCacheStatistics * pStatistics) { g_memberCache.GetStatistics(pStatistics); }
+extern "C" __declspec(dllexport) void MemberCache__ResetStatistics() { g_memberCache.ResetStatistics(); }
+
+// Exported member batch function, walks many GetMember chains in one call instead of one P/Invoke per member
+extern "C" __declspec(dllexport) uint32_t MemberBatch__Evaluate(const MemberBatchPath * pPaths, uint32_t pathCount, const MemberBatchStep * pSteps, uint32_t stepCount, const char* pStrings, uint32_t stringsSize, MemberBatchResult * pResults, char* pText, uint32_t textCapacity, uint32_t * pTextSize) { return evaluateMemberBatch(pPaths, pathCount, pSteps, stepCount, pStrings, stringsSize, pResults, pText, textCapacity, pTextSize); }
+
+// Exported expression plan functions, expressions are compiled once and the plans are re-resolved after zoning / UI reloads
+extern "C" __declspec(dllexport) int32_t ExpressionPlan__Compile(const char* Expression) { char expression[MAX_STRING]; return utf8ToAnsi(Expression, expression, sizeof(expression)) ? g_expressionPlanCache.Compile(expression) : 0; }
+extern "C" __declspec(dllexport) bool ExpressionPlan__Release(int32_t handle) { return g_expressionPlanCache.Release(handle); }
+extern "C" __declspec(dllexport) bool ExpressionPlan__Evaluate(int32_t handle, char* pDestination, uint32_t capacity, uint32_t * pLength) { return g_expressionPlanCache.Evaluate(handle, pDestination, capacity, pLength); }
+extern "C" __declspec(dllexport) bool ExpressionPlan__Calculate(int32_t handle, double* pResult) { return g_expressionPlanCache.Calculate(handle, pResult); }
+extern "C" __declspec(dllexport) void ExpressionPlan__Invalidate() { g_expressionPlanCache.Invalidate(); }
+extern "C" __declspec(dllexport) void ExpressionPlan__GetStatistics(ExpressionPlanStatistics * pStatistics) { g_expressionPlanCache.GetStatistics(pStatistics); }
+
+// Exported startup functions, the warm-up window covers the first pulses after the managed side was loaded or hot reloaded
+extern "C" __declspec(dllexport) bool AsyncBoot__IsPreWarmEnabled() { return g_asyncBoot.IsPreWarmEnabled(); }
+extern "C" __declspec(dllexport) void AsyncBoot__GetWarmupSummary(WarmupSummary * pSummary) { g_asyncBoot.GetWarmupSummary(pSummary); }
+
+// Exported hot reload functions, only do anything with HotReload=1 in MQ2DotNetCoreLoader.ini
+extern "C" __declspec(dllexport) bool LoaderHotReload__Request() { return g_hotReload.Request(); }
+extern "C" __declspec(dllexport) bool LoaderHotReload__IsReloading() { return g_hotReload.IsReloading(); }
+extern "C" __declspec(dllexport) void LoaderHotReload__GetStatistics(HotReloadStatistics * pStatistics) { g_hotReload.GetStatistics(pStatistics); }
+
+// Exported loader event ring functions, used when the managed side opts into batched spawn/ground item/zone events
+extern "C" __declspec(dllexport) void LoaderEventRing__SetEnabled(bool isEnabled) { g_loaderEventRing.SetEnabled(isEnabled); }
+extern "C" __declspec(dllexport) uint32_t LoaderEventRing__Drain(LoaderEvent * pDestination, uint32_t destinationCapacity) { return g_loaderEventRing.Drain(pDestination, destinationCapacity); }
+extern "C" __declspec(dllexport) void LoaderEventRing__GetStatistics(LoaderEventRingStatistics * pStatistics) { g_loaderEventRing.GetStatistics(pStatistics); }
+
+// Exported chat pre-filter functions, lines that don't match a registered pattern never have to cross into the managed side
+extern "C" __declspec(dllexport) int32_t ChatFilter__AddPattern(PCHAR Pattern, uint32_t sourceMask, uint32_t color, uint32_t filterMask) { return g_chatFilter.AddPattern(Pattern, sourceMask, color, filterMask); }
+extern "C" __declspec(dllexport) bool ChatFilter__RemovePattern(int32_t id) { return g_chatFilter.RemovePattern(id); }
+extern "C" __declspec(dllexport) void ChatFilter__SetPassthrough(bool isPassthrough) { g_chatFilter.SetPassthrough(isPassthrough); }
+extern "C" __declspec(dllexport) uint32_t ChatFilter__Match(uint32_t source, PCHAR Line, uint32_t color, uint32_t filter, int32_t * pMatchedIds, uint32_t matchedIdsCapacity) { return g_chatFilter.Match(source, Line, color, filter, pMatchedIds, matchedIdsCapacity); }
+extern "C" __declspec(dllexport) void ChatFilter__GetStatistics(ChatFilterStatistics * pStatistics) { g_chatFilter.GetStatistics(pStatistics); }
+
+// Exported shared state bus functions, lets the clients on one machine share their state and message each other without chat
+extern "C" __declspec(dllexport) bool SharedStateBus__Open(const char* name, const char* instanceName) { return g_sharedStateBus.Open(name, instanceName); }
+extern "C" __declspec(dllexport) void SharedStateBus__Close() { g_sharedStateBus.Close(); }
+extern "C" __declspec(dllexport) void SharedStateBus__SetInstanceName(const char* instanceName) { g_sharedStateBus.SetInstanceName(instanceName); }
+extern "C" __declspec(dllexport) bool SharedStateBus__Publish(const void* pState, uint32_t size) { return g_sharedStateBus.Publish(pState, size); }
+extern "C" __declspec(dllexport) bool SharedStateBus__GetInstance(uint32_t instanceIndex, SharedStateInstanceInfo * pInfo) { return g_sharedStateBus.GetInstance(instanceIndex, pInfo); }
+extern "C" __declspec(dllexport) int32_t SharedStateBus__ReadState(uint32_t instanceIndex, void* pDestination, uint32_t capacity) { return g_sharedStateBus.ReadState(instanceIndex, pDestination, capacity); }
+extern "C" __declspec(dllexport) bool SharedStateBus__Send(int32_t targetIndex, uint32_t messageType, const void* pPayload, uint32_t size) { return g_sharedStateBus.Send(targetIndex, messageType, pPayload, size); }
+extern "C" __declspec(dllexport) uint32_t SharedStateBus__Receive(SharedStateMessage * pMessages, uint32_t capacity) { return g_sharedStateBus.Receive(pMessages, capacity); }
+extern "C" __declspec(dllexport) void SharedStateBus__GetStatistics(SharedStateBusStatistics * pStatistics) { g_sharedStateBus.GetStatistics(pStatistics); }
+
+// Exported spawn handle table functions. The managed side resolves handles by reading the slots directly, Find is for the v1
+// spawn callbacks that only pass the pointer
+extern "C" __declspec(dllexport) const SpawnHandleSlot* SpawnHandleTable__GetSlots(uint32_t * pCapacity) { *pCapacity = SpawnHandleTable::Capacity; return g_spawnHandleTable.GetSlots(); }
+extern "C" __declspec(dllexport) uint32_t SpawnHandleTable__GetUsedSlotCount() { return g_spawnHandleTable.GetUsedSlotCount(); }
+extern "C" __declspec(dllexport) uint64_t SpawnHandleTable__Find(PSPAWNINFO pSpawn) { return g_spawnHandleTable.Find(pSpawn); }
+extern "C" __declspec(dllexport) void SpawnHandleTable__GetStatistics(SpawnHandleTableStatistics * pStatistics) { g_spawnHandleTable.GetStatistics(pStatistics); }
+
+// Exported spawn snapshot functions, copies the whole spawn list into a caller provided structure of arrays buffer in one call
+extern "C" __declspec(dllexport) void SpawnSnapshot__GetLayout(uint32_t capacity, SpawnSnapshotLayout * pLayout) { getSpawnSnapshotLayout(capacity, pLayout); }
+extern "C" __declspec(dllexport) uint32_t SpawnSnapshot__Capture(uint8_t * pBuffer, uint32_t bufferSize, uint32_t capacity, uint32_t * pTotalCount) { return captureSpawnSnapshot(pBuffer, bufferSize, capacity, pTotalCount); }
+extern "C" __declspec(dllexport) uint32_t SpawnSnapshot__CapturePulse(uint8_t * pBuffer, uint32_t bufferSize, uint32_t capacity, uint32_t * pTotalCount, PulseSnapshotFocus * pFocus) { return captureSpawnSnapshot(pBuffer, bufferSize, capacity, pTotalCount, pFocus); }
+
+// Exported spawn spatial index queries, positions are refreshed from the spawns at most once per pulse, on the first query after it
+extern "C" __declspec(dllexport) uint32_t SpawnSpatialIndex__QueryRadius(float x, float y, float radius, uint32_t typeMask, SpawnQueryResult * pResults, uint32_t capacity) { refreshSpawnSpatialIndex(); return g_spawnSpatialIndex.QueryRadius(x, y, radius, typeMask, pResults, capacity); }
+extern "C" __declspec(dllexport) uint32_t SpawnSpatialIndex__QueryBox(float minX, float minY, float maxX, float maxY, uint32_t typeMask, SpawnQueryResult * pResults, uint32_t capacity) { refreshSpawnSpatialIndex(); return g_spawnSpatialIndex.QueryBox(minX, minY, maxX, maxY, typeMask, pResults, capacity); }
+extern "C" __declspec(dllexport) uint32_t SpawnSpatialIndex__QueryNearest(float x, float y, uint32_t k, float maxRadius, uint32_t typeMask, SpawnQueryResult * pResults) { refreshSpawnSpatialIndex(); return g_spawnSpatialIndex.QueryNearest(x, y, k, maxRadius, typeMask, pResults); }
+
+// Exported spawn change feed functions. Tracking is off until the managed side picks the fields it wants, changes are diffed at
+// the start of every pulse and drained by the managed side during it
+extern "C" __declspec(dllexport) void SpawnChangeFeed__SetFields(uint32_t trackedFields) { g_spawnChangeFeed.SetTrackedFields(trackedFields); }
+extern "C" __declspec(dllexport) uint32_t SpawnChangeFeed__Drain(SpawnChange * pChanges, uint32_t capacity) { return g_spawnChangeFeed.Drain(pChanges, capacity); }
+
+// Exported inventory index functions. The first lookup of a pulse checks the index against the character's items, and it's only
+// rebuilt when they changed or the client zoned. Lookups return the matching slots and the total stack count in one call.
+extern "C" __declspec(dllexport) uint32_t InventoryIndex__FindById(uint32_t itemId, uint32_t containerMask, InventorySlot * pSlots, uint32_t capacity, uint64_t * pTotalCount) { refreshInventoryIndex(); return g_inventoryIndex.FindById(itemId, containerMask, pSlots, capacity, pTotalCount); }
+extern "C" __declspec(dllexport) uint32_t InventoryIndex__FindByName(const char* pName, uint32_t nameLength, bool isExact, uint32_t containerMask, InventorySlot * pSlots, uint32_t capacity, uint64_t * pTotalCount) { return findInventoryItemsByName(pName, nameLength, isExact, containerMask, pSlots, capacity, pTotalCount); }
+extern "C" __declspec(dllexport) void InventoryIndex__Invalidate() { g_inventoryIndex.Invalidate(); }
+extern "C" __declspec(dllexport) void InventoryIndex__GetStatistics(InventoryIndexStatistics * pStatistics) { g_inventoryIndex.GetStatistics(pStatistics); }
+
 PLUGIN_API VOID InitializePlugin(VOID)
 {
 	if (gszINIPath[0])
 	{
-		StringCbPrintfW(g_entryAssemblyLibraryPath, MAX_PATH, L"%hs\\%ws", gszINIPath, L"MQ2DotNetCore\\MQ2DotNetCore.dll");
-		StringCbPrintfW(g_dotnetRuntimeConfigPath, MAX_PATH, L"%hs\\%ws", gszINIPath, L"MQ2DotNetCore\\MQ2DotNetCore.runtimeconfig.json");
-		StringCbPrintfW(g_pluginLogFile, MAX_PATH, L"%hs\\%ws", gszINIPath, L"MQ2DotNetCore\\debug_plugin.log");
+		buildLoaderPath(g_entryAssemblyLibraryPath, MAX_PATH, gszINIPath, "MQ2DotNetCore", "MQ2DotNetCore.dll");
+		buildLoaderPath(g_dotnetRuntimeConfigPath, MAX_PATH, gszINIPath, "MQ2DotNetCore", "MQ2DotNetCore.runtimeconfig.json");
+		buildLoaderPath(g_pluginLogFile, MAX_PATH, gszINIPath, "MQ2DotNetCore", "debug_plugin.log");
 	}
 	else
 	{
 		// If loaded by the test program, INIPath won't be set
-		StringCbPrintfW(g_entryAssemblyLibraryPath, MAX_PATH, L"%ws", L"MQ2DotNetCore.dll");
-		StringCbPrintfW(g_dotnetRuntimeConfigPath, MAX_PATH, L"%ws", L"MQ2DotNetCore.runtimeconfig.json");
-		StringCbPrintfW(g_pluginLogFile, MAX_PATH, L"%ws", gszINIPath, L"debug_plugin.log");
+		buildLoaderPath(g_entryAssemblyLibraryPath, MAX_PATH, nullptr, nullptr, "MQ2DotNetCore.dll");
+		buildLoaderPath(g_dotnetRuntimeConfigPath, MAX_PATH, nullptr, nullptr, "MQ2DotNetCore.runtimeconfig.json");
+		buildLoaderPath(g_pluginLogFile, MAX_PATH, nullptr, nullptr, "debug_plugin.log");
 	}
 
-	g_bLoaded = loadDotNetClrAndExecuteEntryPoint();
-	if (g_bLoaded)
-	{
-		WriteChatf("[MQ2DotNetCoreLoader] Successfully loaded the .net core CLR.");
-	}
-	else
+	g_loaderLog.Start(g_pluginLogFile);
+
+	char_t settingsPath[MAX_PATH];
+	buildLoaderPath(settingsPath, MAX_PATH, gszINIPath, nullptr, "MQ2DotNetCoreLoader.ini");
+
+	const int pulseBudgetMicroseconds = readLoaderSetting(settingsPath, "Settings", "PulseBudgetMicroseconds", 2000);
+	g_pulseFrame.BudgetMicroseconds = pulseBudgetMicroseconds > 0 ? static_cast<uint32_t>(pulseBudgetMicroseconds) : 0;
+
+	g_hotReload.Reset();
+	g_hotReload.SetEnabled(readLoaderSetting(settingsPath, "Settings", "HotReload", 0) != 0);
+
+	const int callbackAbiVersion = readLoaderSetting(settingsPath, "Settings", "CallbackAbi", static_cast<int>(LoaderAbiVersion));
+	g_maxCallbackAbiVersion = static_cast<uint32_t>(std::clamp(callbackAbiVersion, 1, static_cast<int>(LoaderAbiVersion)));
+
+	g_runtimeProfile.Read(settingsPath);
+
+	if (readLoaderSetting(settingsPath, "Settings", "Capture", 0) != 0)
+		startCallbackCapture(settingsPath);
+
+	g_asyncBoot.Reset();
+	g_asyncBoot.SetPreWarmEnabled(readLoaderSetting(settingsPath, "Settings", "PreWarm", 0) != 0);
+	g_asyncBoot.StartWarmup();
+	if (readLoaderSetting(settingsPath, "Settings", "AsyncBoot", 0) != 0)
 	{
-		WriteChatf("[MQ2DotNetCoreLoader] Failed to load .net CLR and/or execute the entry point method!");
+		// The managed InitializePlugin still runs on this thread, from the first OnPulse after the boot thread is done
+		WriteChatf("[MQ2DotNetCoreLoader] Loading the .net core runtime in the background...");
+		g_asyncBoot.SetState(BootState::Booting);
+		g_bootThread = std::thread([]()
+		{
+			g_asyncBoot.SetState(loadDotNetClr(true, &g_pfInitializeEntryPoint) ? BootState::HostReady : BootState::Failed);
+		});
+		return;
 	}
+
+	WriteChatf("Loading .net core runtime and entry point...");
+
+	component_entry_point_fn initializeEntryPoint = nullptr;
+	g_bLoaded = loadDotNetClr(false, &initializeEntryPoint) && executeEntryPoint(initializeEntryPoint);
+	g_asyncBoot.SetState(g_bLoaded ? BootState::Ready : BootState::Failed);
+	reportBootResult();
 }
 
 // The rest of the PLUGIN_API functions just call the callback (which will be set to the managed version of the function) if they're set and the CLR is loaded
@@ -110,251 +356,1003 @@ PLUGIN_API VOID ShutdownPlugin(VOID)
 		g_pfShutdownPlugin();
 	}
 
+	// The CLR can't be stopped part way through starting, so unloading while it boots has to wait for it. The managed
+	// InitializePlugin never ran, so there's nothing else to shut down.
+	if (g_bootThread.joinable())
+		g_bootThread.join();
+
+	// Lets go of the core's load context, the host and the runtime itself stay loaded
+	if (g_bLoaded && g_hotReload.IsEnabled())
+		g_hotReload.Unload();
+
+	g_hotReload.Reset();
+	g_asyncBoot.Reset();
+
+	resetLoaderState();
+	g_callbackCapture.Stop();
+
+	// Last, so the managed side's shutdown logging still makes it to the file
+	g_loaderLog.Stop();
+
 	// TODO: Determine if there is a way to unload the loaded libraries (hostfxr ?) without crashing the process?
 
 	// TODO: Determine if the new hostfxr way of hosting the .net core runtime has a way it can be fully
 	// unloaded at runtime?
 }
 
+// Everything the managed side may have turned on or registered with the loader, back to how InitializePlugin found it
+void resetLoaderState()
+{
+	g_loaderEventRing.SetEnabled(false);
+	g_loaderEventRing.Reset();
+
+	g_chatFilter.Clear();
+	g_chatFilter.SetPassthrough(true);
+
+	g_spawnSpatialIndex.Clear();
+	g_spawnHandleTable.Clear();
+	g_spawnChangeFeed.SetTrackedFields(SpawnChangeFieldNone);
+
+	g_inventoryIndex.Clear();
+
+	g_expressionPlanCache.Clear();
+
+	g_memberCache.SetEnabled(false);
+	g_memberCache.ClearBypass();
+
+	g_callbackSubscriptions.Reset();
+
+	g_sharedStateBus.Close();
+}
+
+// The managed side binds these again when it initializes
+void clearManagedCallbacks()
+{
+	g_pfShutdownPlugin = nullptr;
+	g_pfOnCleanUI = nullptr;
+	g_pfOnReloadUI = nullptr;
+	g_pfOnDrawHUD = nullptr;
+	g_pfSetGameState = nullptr;
+	g_pfOnPulse = nullptr;
+	g_pfOnIncomingChat = nullptr;
+	g_pfOnWriteChatColor = nullptr;
+	g_pfOnAddSpawn = nullptr;
+	g_pfOnRemoveSpawn = nullptr;
+	g_pfOnAddGroundItem = nullptr;
+	g_pfOnRemoveGroundItem = nullptr;
+	g_pfBeginZone = nullptr;
+	g_pfEndZone = nullptr;
+	g_pfOnZoned = nullptr;
+	g_pfDrainLoaderEvents = nullptr;
+	g_pfOnIncomingChatMatched = nullptr;
+	g_pfOnWriteChatColorMatched = nullptr;
+	g_pfOnIncomingChatV2 = nullptr;
+	g_pfOnWriteChatColorV2 = nullptr;
+	g_pfOnAddSpawnV2 = nullptr;
+	g_pfOnRemoveSpawnV2 = nullptr;
+	g_callbackAbiVersion = 1;
+}
+
 PLUGIN_API VOID OnCleanUI(VOID)
 {
-	if (g_bLoaded && g_pfOnCleanUI)
+	CallbackTimer timer(LoaderCallback::CleanUI);
+	g_callbackCapture.Record(LoaderCallback::CleanUI);
+
+	if (!g_bLoaded && deferWhileBooting(LoaderCallback::CleanUI, nullptr, 0, 0))
+		return;
+
+	if (g_bLoaded && g_pfOnCleanUI && g_callbackSubscriptions.ShouldForward(LoaderCallback::CleanUI))
 		g_pfOnCleanUI();
 }
 
 PLUGIN_API VOID OnReloadUI(VOID)
 {
-	if (g_bLoaded && g_pfOnReloadUI)
+	CallbackTimer timer(LoaderCallback::ReloadUI);
+	g_callbackCapture.Record(LoaderCallback::ReloadUI);
+
+	if (!g_bLoaded && deferWhileBooting(LoaderCallback::ReloadUI, nullptr, 0, 0))
+		return;
+
+	g_expressionPlanCache.Invalidate();
+	g_memberCache.NextEpoch();
+	g_internTable.Refresh();
+
+	if (g_bLoaded && g_pfOnReloadUI && g_callbackSubscriptions.ShouldForward(LoaderCallback::ReloadUI))
 		g_pfOnReloadUI();
 }
 
 PLUGIN_API VOID OnDrawHUD(VOID)
 {
-	if (g_bLoaded && g_pfOnDrawHUD)
+	CallbackTimer timer(LoaderCallback::DrawHUD);
+	g_callbackCapture.Record(LoaderCallback::DrawHUD);
+
+	if (g_bLoaded && g_pfOnDrawHUD && g_callbackSubscriptions.ShouldForward(LoaderCallback::DrawHUD))
 		g_pfOnDrawHUD();
 }
 
 PLUGIN_API VOID SetGameState(DWORD GameState)
 {
-	if (g_bLoaded && g_pfSetGameState)
+	CallbackTimer timer(LoaderCallback::SetGameState);
+	g_callbackCapture.Record(LoaderCallback::SetGameState, GameState);
+
+	if (!g_bLoaded && deferWhileBooting(LoaderCallback::SetGameState, nullptr, GameState, 0))
+		return;
+
+	// MQ2 loads most plugins, and with them their types, around game state changes
+	g_internTable.Refresh();
+
+	// Camping to character select or entering the world swaps the character's data out
+	g_inventoryIndex.Invalidate();
+
+	// Compiled expression plans hold on to the TLOs they resolved, which plugins loaded with the game state may have replaced
+	g_expressionPlanCache.Invalidate();
+
+	if (g_bLoaded && g_pfSetGameState && g_callbackSubscriptions.ShouldForward(LoaderCallback::SetGameState))
 		g_pfSetGameState(GameState);
 }
 
+// Not forwarded to the managed side. A plugin that is loaded or unloaded adds or removes its TLOs, so compiled expression plans
+// and cached members resolve them again the next time they're used. MQ2 calls OnUnloadPlugin before the plugin is gone, which
+// is why nothing is re-resolved here.
+PLUGIN_API VOID OnLoadPlugin(PCHAR Name)
+{
+	g_expressionPlanCache.Invalidate();
+	g_memberCache.NextEpoch();
+}
+
+PLUGIN_API VOID OnUnloadPlugin(PCHAR Name)
+{
+	g_expressionPlanCache.Invalidate();
+	g_memberCache.NextEpoch();
+}
+
 PLUGIN_API VOID OnPulse(VOID)
 {
-	if (g_bLoaded && g_pfOnPulse)
+	// Timed on its own rather than as part of the pulse
+	if (g_bLoaded && g_hotReload.ConsumeRequest())
+		performHotReload();
+
+	CallbackTimer timer(LoaderCallback::Pulse);
+	g_callbackCapture.Record(LoaderCallback::Pulse);
+	g_pulseFrame.StartTimestamp = getStopwatchTimestamp();
+
+	if (!g_bLoaded && g_bootThread.joinable() && g_asyncBoot.GetState() != BootState::Booting)
+		finishBoot();
+
+	// The pulse that ran the managed InitializePlugin is in the boot timings instead
+	const bool isWarmupPulse = g_bLoaded && g_asyncBoot.IsWarmingUp();
+	const auto warmupPulseStart = isWarmupPulse ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+
+	g_isSpawnSpatialIndexStale = true;
+	g_inventoryIndex.NextPulse();
+	g_pulseArena.Reset();
+	g_memberCache.NextEpoch();
+
+	if (g_bLoaded)
+		g_spawnChangeFeed.Diff();
+
+	// Keeps this client's slot on the state bus while nothing is published
+	g_sharedStateBus.Heartbeat();
+
+	// Events still in the ring are drained by the managed OnPulse even when nothing asked for pulses
+	if (g_bLoaded && g_pfOnPulse && (!g_loaderEventRing.IsEmpty() || g_callbackSubscriptions.ShouldForward(LoaderCallback::Pulse)))
 		g_pfOnPulse();
+
+	if (isWarmupPulse)
+	{
+		const auto elapsed = std::chrono::steady_clock::now() - warmupPulseStart;
+		if (g_asyncBoot.RecordWarmupPulse(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count())))
+			logToFile("[ OnPulse() ]  Warm-up: %s", g_asyncBoot.FormatWarmup().c_str());
+	}
 }
 
 PLUGIN_API DWORD OnWriteChatColor(PCHAR Line, DWORD Color, DWORD Filter)
 {
-	if (g_bLoaded && g_pfOnWriteChatColor)
+	CallbackTimer timer(LoaderCallback::WriteChatColor);
+	captureChatLine(LoaderCallback::WriteChatColor, Line, Color, Filter);
+
+	if (!g_bLoaded)
+	{
+		deferWhileBooting(LoaderCallback::WriteChatColor, Line, Color, Filter);
+		return 0;
+	}
+
+	if (!g_callbackSubscriptions.ShouldForward(LoaderCallback::WriteChatColor))
+		return 0;
+
+	int32_t matchedIds[ChatFilter::MaxMatchedIds];
+	uint32_t matchedIdCount = 0;
+	if (g_chatFilter.HasPatterns())
+	{
+		matchedIdCount = g_chatFilter.Match(ChatSourceMQ2, Line, Color, Filter, matchedIds, ChatFilter::MaxMatchedIds);
+		if (matchedIdCount == 0 && !g_chatFilter.IsPassthrough())
+			return 0;
+	}
+
+	if (g_callbackAbiVersion >= 2 && g_pfOnWriteChatColorV2)
+	{
+		char buffer[ChatLineUtf8Capacity];
+		uint32_t lineLength = 0;
+		const char* pLine = chatLineToUtf8(Line, buffer, sizeof(buffer), &lineLength);
+		return g_pfOnWriteChatColorV2(pLine, lineLength, Color, Filter, matchedIds, matchedIdCount);
+	}
+
+	if (matchedIdCount > 0 && g_pfOnWriteChatColorMatched)
+		return g_pfOnWriteChatColorMatched(Line, Color, Filter, matchedIds, matchedIdCount);
+
+	if (g_pfOnWriteChatColor)
 		return g_pfOnWriteChatColor(Line, Color, Filter);
 	return 0;
 }
 
 PLUGIN_API DWORD OnIncomingChat(PCHAR Line, DWORD Color)
 {
-	if (g_bLoaded && g_pfOnIncomingChat)
+	CallbackTimer timer(LoaderCallback::IncomingChat);
+	captureChatLine(LoaderCallback::IncomingChat, Line, Color, 0);
+
+	if (!g_bLoaded)
+	{
+		deferWhileBooting(LoaderCallback::IncomingChat, Line, Color, 0);
+		return 0;
+	}
+
+	if (!g_callbackSubscriptions.ShouldForward(LoaderCallback::IncomingChat))
+		return 0;
+
+	int32_t matchedIds[ChatFilter::MaxMatchedIds];
+	uint32_t matchedIdCount = 0;
+	if (g_chatFilter.HasPatterns())
+	{
+		matchedIdCount = g_chatFilter.Match(ChatSourceEQ, Line, Color, 0, matchedIds, ChatFilter::MaxMatchedIds);
+		if (matchedIdCount == 0 && !g_chatFilter.IsPassthrough())
+			return 0;
+	}
+
+	if (g_callbackAbiVersion >= 2 && g_pfOnIncomingChatV2)
+	{
+		char buffer[ChatLineUtf8Capacity];
+		uint32_t lineLength = 0;
+		const char* pLine = chatLineToUtf8(Line, buffer, sizeof(buffer), &lineLength);
+		return g_pfOnIncomingChatV2(pLine, lineLength, Color, matchedIds, matchedIdCount);
+	}
+
+	if (matchedIdCount > 0 && g_pfOnIncomingChatMatched)
+		return g_pfOnIncomingChatMatched(Line, Color, matchedIds, matchedIdCount);
+
+	if (g_pfOnIncomingChat)
 		return g_pfOnIncomingChat(Line, Color);
 	return 0;
 }
 
 PLUGIN_API VOID OnAddSpawn(PSPAWNINFO pNewSpawn)
 {
-	if (g_bLoaded && g_pfOnAddSpawn)
+	CallbackTimer timer(LoaderCallback::AddSpawn);
+	captureSpawn(LoaderCallback::AddSpawn, pNewSpawn, 0);
+
+	if (!g_bLoaded)
+	{
+		deferWhileBooting(LoaderCallback::AddSpawn, nullptr, 0, 0);
+		return;
+	}
+
+	uint64_t handle = 0;
+	if (pNewSpawn)
+	{
+		g_spawnSpatialIndex.Insert(pNewSpawn->SpawnID, pNewSpawn, static_cast<uint8_t>(pNewSpawn->Type), pNewSpawn->X, pNewSpawn->Y, pNewSpawn->Z);
+		g_spawnChangeFeed.Add(pNewSpawn);
+		handle = g_spawnHandleTable.Add(pNewSpawn);
+	}
+
+	if (!g_callbackSubscriptions.ShouldForward(LoaderCallback::AddSpawn))
+		return;
+
+	if (g_loaderEventRing.IsEnabled())
+		enqueueLoaderEvent(LoaderEventType::AddSpawn, pNewSpawn, pNewSpawn ? pNewSpawn->SpawnID : 0, handle);
+	else if (g_callbackAbiVersion >= 2 && g_pfOnAddSpawnV2)
+		g_pfOnAddSpawnV2(pNewSpawn, handle);
+	else if (g_pfOnAddSpawn)
 		g_pfOnAddSpawn(pNewSpawn);
 }
 
 PLUGIN_API VOID OnRemoveSpawn(PSPAWNINFO pSpawn)
 {
-	if (g_bLoaded && g_pfOnRemoveSpawn)
-		g_pfOnRemoveSpawn(pSpawn);
+	CallbackTimer timer(LoaderCallback::RemoveSpawn);
+	captureSpawn(LoaderCallback::RemoveSpawn, pSpawn, 0);
+
+	if (!g_bLoaded)
+	{
+		deferWhileBooting(LoaderCallback::RemoveSpawn, nullptr, 0, 0);
+		return;
+	}
+
+	if (pSpawn)
+	{
+		g_spawnSpatialIndex.Remove(pSpawn->SpawnID);
+		g_spawnChangeFeed.Remove(pSpawn);
+	}
+
+	// Cached values may point at the spawn, e.g. Target
+	g_memberCache.NextEpoch();
+
+	// The handle still resolves during the handlers, the spawn isn't freed until this returns. Removals are never batched (see
+	// drainQueuedLoaderEvents) so handlers always see the spawn.
+	const uint64_t handle = g_spawnHandleTable.Find(pSpawn);
+	if (g_callbackSubscriptions.ShouldForward(LoaderCallback::RemoveSpawn))
+	{
+		drainQueuedLoaderEvents();
+
+		if (g_callbackAbiVersion >= 2 && g_pfOnRemoveSpawnV2)
+			g_pfOnRemoveSpawnV2(pSpawn, handle);
+		else if (g_pfOnRemoveSpawn)
+			g_pfOnRemoveSpawn(pSpawn);
+	}
+
+	g_spawnHandleTable.Remove(pSpawn);
 }
 
 PLUGIN_API VOID OnAddGroundItem(PGROUNDITEM pNewGroundItem)
 {
-	if (g_bLoaded && g_pfOnAddGroundItem)
+	CallbackTimer timer(LoaderCallback::AddGroundItem);
+	captureGroundItem(LoaderCallback::AddGroundItem, pNewGroundItem);
+
+	if (!g_bLoaded)
+	{
+		deferWhileBooting(LoaderCallback::AddGroundItem, nullptr, 0, 0);
+		return;
+	}
+
+	if (!g_callbackSubscriptions.ShouldForward(LoaderCallback::AddGroundItem))
+		return;
+
+	if (g_loaderEventRing.IsEnabled())
+		enqueueLoaderEvent(LoaderEventType::AddGroundItem, pNewGroundItem, pNewGroundItem ? pNewGroundItem->DropID : 0);
+	else if (g_pfOnAddGroundItem)
 		g_pfOnAddGroundItem(pNewGroundItem);
 }
 
 PLUGIN_API VOID OnRemoveGroundItem(PGROUNDITEM pGroundItem)
 {
-	if (g_bLoaded && g_pfOnRemoveGroundItem)
+	CallbackTimer timer(LoaderCallback::RemoveGroundItem);
+	captureGroundItem(LoaderCallback::RemoveGroundItem, pGroundItem);
+
+	if (!g_bLoaded)
+	{
+		deferWhileBooting(LoaderCallback::RemoveGroundItem, nullptr, 0, 0);
+		return;
+	}
+
+	g_memberCache.NextEpoch();
+
+	if (!g_callbackSubscriptions.ShouldForward(LoaderCallback::RemoveGroundItem))
+		return;
+
+	drainQueuedLoaderEvents();
+
+	if (g_pfOnRemoveGroundItem)
 		g_pfOnRemoveGroundItem(pGroundItem);
 }
 
 PLUGIN_API VOID BeginZone(VOID)
 {
-	if (g_bLoaded && g_pfBeginZone)
+	CallbackTimer timer(LoaderCallback::BeginZone);
+	g_callbackCapture.Record(LoaderCallback::BeginZone);
+
+	if (!g_bLoaded)
+	{
+		deferWhileBooting(LoaderCallback::BeginZone, nullptr, 0, 0);
+		return;
+	}
+
+	g_spawnSpatialIndex.Clear();
+	g_spawnHandleTable.Clear();
+	g_inventoryIndex.Invalidate();
+	g_memberCache.NextEpoch();
+
+	// Every spawn is about to go away, subscribers get BeginZone rather than a removal record per spawn
+	g_spawnChangeFeed.Clear();
+
+	if (!g_callbackSubscriptions.ShouldForward(LoaderCallback::BeginZone))
+		return;
+
+	if (g_loaderEventRing.IsEnabled())
+		enqueueLoaderEvent(LoaderEventType::BeginZone, nullptr, 0);
+	else if (g_pfBeginZone)
 		g_pfBeginZone();
 }
 
 PLUGIN_API VOID EndZone(VOID)
 {
-	if (g_bLoaded && g_pfEndZone)
+	CallbackTimer timer(LoaderCallback::EndZone);
+	g_callbackCapture.Record(LoaderCallback::EndZone);
+
+	if (!g_bLoaded)
+	{
+		deferWhileBooting(LoaderCallback::EndZone, nullptr, 0, 0);
+		return;
+	}
+
+	if (!g_callbackSubscriptions.ShouldForward(LoaderCallback::EndZone))
+		return;
+
+	if (g_loaderEventRing.IsEnabled())
+		enqueueLoaderEvent(LoaderEventType::EndZone, nullptr, 0);
+	else if (g_pfEndZone)
 		g_pfEndZone();
 }
 
 PLUGIN_API VOID OnZoned(VOID)
 {
-	if (g_bLoaded && g_pfOnZoned)
+	CallbackTimer timer(LoaderCallback::Zoned);
+	g_callbackCapture.Record(LoaderCallback::Zoned);
+
+	if (!g_bLoaded && deferWhileBooting(LoaderCallback::Zoned, nullptr, 0, 0))
+		return;
+
+	g_expressionPlanCache.Invalidate();
+	g_inventoryIndex.Invalidate();
+	g_memberCache.NextEpoch();
+
+	if (!g_bLoaded)
+		return;
+
+	if (!g_callbackSubscriptions.ShouldForward(LoaderCallback::Zoned))
+		return;
+
+	if (g_loaderEventRing.IsEnabled())
+		enqueueLoaderEvent(LoaderEventType::Zoned, nullptr, 0);
+	else if (g_pfOnZoned)
 		g_pfOnZoned();
 }
 
+// Events in the ring are drained by the managed side at the start of OnPulse. If a burst (e.g. zoning into a busy zone)
+// fills the ring first, ask the managed side to drain it early rather than dropping events or delivering them out of order
+void enqueueLoaderEvent(LoaderEventType eventType, void* pointer, uint32_t id, uint64_t handle)
+{
+	if (g_loaderEventRing.TryEnqueue(eventType, pointer, id, handle))
+		return;
+
+	g_loaderEventRing.RecordOverflow();
+	if (g_pfDrainLoaderEvents)
+	{
+		g_pfDrainLoaderEvents();
+		if (g_loaderEventRing.TryEnqueue(eventType, pointer, id, handle))
+			return;
+	}
+
+	logToFile("[ enqueueLoaderEvent(..) ]  The loader event ring is full, dropped event type: %u", static_cast<uint32_t>(eventType));
+}
+
+// EQ frees spawns and ground items as soon as their remove callback returns, so removals are never batched. What is already
+// queued is dispatched before them, keeping the order and letting a queued add for the same spawn / item still read it.
+void drainQueuedLoaderEvents()
+{
+	if (g_loaderEventRing.IsEnabled() && !g_loaderEventRing.IsEmpty() && g_pfDrainLoaderEvents)
+		g_pfDrainLoaderEvents();
+}
+
+// While the CLR boots in the background callbacks are queued for replay or dropped (see AsyncBoot::GetPolicy) instead of being
+// forwarded. Returns false once the boot is over, or if it was never started in the background.
+bool deferWhileBooting(LoaderCallback callback, const char* line, uint32_t argument0, uint32_t argument1)
+{
+	if (!g_asyncBoot.IsBooting())
+		return false;
+
+	g_asyncBoot.Defer(callback, line, argument0, argument1);
+	return true;
+}
+
+// Called from OnPulse once the boot thread is done. Runs the managed InitializePlugin on the EQ thread, then replays what was
+// queued while booting through the regular forwarders.
+void finishBoot()
+{
+	g_bootThread.join();
+
+	g_bLoaded = g_asyncBoot.GetState() == BootState::HostReady && executeEntryPoint(g_pfInitializeEntryPoint);
+	g_asyncBoot.SetState(g_bLoaded ? BootState::Ready : BootState::Failed);
+
+	// They were captured when EQ called them
+	g_callbackCapture.SetSuspended(true);
+	g_asyncBoot.ReplayQueued([](AsyncBoot::QueuedCallback& queued)
+	{
+		switch (queued.Callback)
+		{
+		case LoaderCallback::WriteChatColor: OnWriteChatColor(&queued.Line[0], queued.Arguments[0], queued.Arguments[1]); break;
+		case LoaderCallback::IncomingChat: OnIncomingChat(&queued.Line[0], queued.Arguments[0]); break;
+		case LoaderCallback::BeginZone: BeginZone(); break;
+		case LoaderCallback::EndZone: EndZone(); break;
+		case LoaderCallback::Zoned: OnZoned(); break;
+		case LoaderCallback::ReloadUI: OnReloadUI(); break;
+		case LoaderCallback::CleanUI: OnCleanUI(); break;
+		case LoaderCallback::SetGameState: SetGameState(queued.Arguments[0]); break;
+		default: break;
+		}
+	});
+	g_callbackCapture.SetSuspended(false);
+
+	reportBootResult();
+}
+
+// Spawns are seeded after any queued zone callbacks were replayed, BeginZone empties the indexes
+void reportBootResult()
+{
+	if (g_bLoaded)
+	{
+		seedSpawnIndexes();
+		WriteChatf("[MQ2DotNetCoreLoader] Successfully loaded the .net core CLR.");
+	}
+	else
+	{
+		WriteChatf("[MQ2DotNetCoreLoader] Failed to load .net CLR and/or execute the entry point method!");
+	}
+
+	logToFile("[ reportBootResult() ]  Startup timings: %s", g_asyncBoot.FormatTimings().c_str());
+}
+
+// Runs at the start of the pulse after a reload was requested. The old core shuts down the same way it would on unload, its
+// load context is unloaded, and the host loads MQ2DotNetCore.dll from disk again into a new one, whose InitializePlugin binds
+// the callbacks again. Spawns are seeded again since the shutdown cleared the spatial index and handle table.
+void performHotReload()
+{
+	logToFile("[ performHotReload() ]  Reloading MQ2DotNetCore...");
+	const auto start = std::chrono::steady_clock::now();
+	g_asyncBoot.StartWarmup();
+
+	g_hotReload.SetReloading(true);
+	if (g_pfShutdownPlugin)
+		g_pfShutdownPlugin();
+	g_hotReload.SetReloading(false);
+
+	g_bLoaded = false;
+	clearManagedCallbacks();
+	resetLoaderState();
+
+	const int32_t leakedContextCount = g_hotReload.Unload();
+	g_bLoaded = executeEntryPoint(g_hotReload.GetInitializeEntryPoint());
+	if (g_bLoaded)
+		seedSpawnIndexes();
+
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	const auto nanoseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+	g_hotReload.RecordReload(g_bLoaded, nanoseconds, leakedContextCount);
+
+	logToFile("[ performHotReload() ]  Reload %s in %.1f ms, %d unloaded load contexts still alive", g_bLoaded ? "succeeded" : "failed", nanoseconds / 1e6, leakedContextCount);
+	if (g_bLoaded)
+		WriteChatf("[MQ2DotNetCoreLoader] Reloaded MQ2DotNetCore in %.1f ms.", nanoseconds / 1e6);
+	else
+		WriteChatf("[MQ2DotNetCoreLoader] Failed to reload MQ2DotNetCore, see debug_plugin.log!");
+}
+
+// Positions are only read back from the spawns when something queries the index, and at most once per pulse
+void refreshSpawnSpatialIndex()
+{
+	if (!g_isSpawnSpatialIndexStale)
+		return;
+
+	g_isSpawnSpatialIndexStale = false;
+	g_spawnSpatialIndex.RefreshPositions([](void* pointer, float& x, float& y, float& z, uint8_t& type)
+	{
+		const auto pSpawn = static_cast<PSPAWNINFO>(pointer);
+		x = pSpawn->X;
+		y = pSpawn->Y;
+		z = pSpawn->Z;
+		type = static_cast<uint8_t>(pSpawn->Type);
+		return true;
+	});
+}
+
+// Copies ANSI text into the pulse arena as UTF-8
+const char* copyToArena(const char* pText, uint32_t* pLength)
+{
+	const size_t length = strnlen(pText, MAX_STRING - 1);
+	const size_t encodedLength = utf8Length(pText, length);
+	const auto pResult = g_pulseArena.Allocate(encodedLength + 1);
+	if (pResult == nullptr)
+		return nullptr;
+
+	ansiToUtf8(pText, length, pResult, static_cast<uint32_t>(encodedLength + 1), nullptr);
+	if (pLength)
+		*pLength = static_cast<uint32_t>(encodedLength);
+
+	return pResult;
+}
+
+// Copies ANSI text into a caller buffer as UTF-8 and returns the full encoded length
+int32_t copyToUtf8(const char* pText, char* pDestination, uint32_t capacity, uint32_t* pFlags)
+{
+	const size_t length = strnlen(pText, MAX_STRING - 1);
+	bool isTruncated = false;
+	ansiToUtf8(pText, length, pDestination, capacity, &isTruncated);
+	if (pFlags)
+		*pFlags = isTruncated ? TextResultTruncated : 0;
+
+	return static_cast<int32_t>(utf8Length(pText, length));
+}
+
+// Chat lines are handed to the v2 callbacks as they are when they're ASCII, which nearly all are, and otherwise converted into
+// pBuffer. Reads the same MAX_STRING - 1 characters copyToArena does.
+const char* chatLineToUtf8(const char* pLine, char* pBuffer, uint32_t capacity, uint32_t* pLength)
+{
+	const size_t length = strnlen(pLine, MAX_STRING - 1);
+	const auto pBytes = reinterpret_cast<const unsigned char*>(pLine);
+	if (std::all_of(pBytes, pBytes + length, [](unsigned char value) { return value < 0x80; }))
+	{
+		*pLength = static_cast<uint32_t>(length);
+		return pLine;
+	}
+
+	*pLength = ansiToUtf8(pLine, length, pBuffer, capacity, nullptr);
+	return pBuffer;
+}
+
+bool getMemberUtf8(MQ2Type* pThis, MQ2VARPTR VarPtr, const char* pMember, uint32_t memberLength, const char* pIndex, uint32_t indexLength, MQ2TYPEVAR& Dest)
+{
+	char member[MAX_STRING];
+	char index[MAX_STRING];
+	return pThis != nullptr
+		&& utf8ToAnsi(pMember, memberLength, member, sizeof(member))
+		&& utf8ToAnsi(pIndex, indexLength, index, sizeof(index))
+		&& getMemberCached(pThis, VarPtr, member, index, Dest);
+}
+
+bool getTopLevelObjectUtf8(const char* pName, uint32_t nameLength, const char* pIndex, uint32_t indexLength, MQ2TYPEVAR& Dest)
+{
+	char name[MAX_STRING];
+	char index[MAX_STRING];
+	if (!utf8ToAnsi(pName, nameLength, name, sizeof(name)) || !utf8ToAnsi(pIndex, indexLength, index, sizeof(index)))
+		return false;
+
+	const auto pDataItem = FindMQ2Data(name);
+	return pDataItem && pDataItem->Function && getTopLevelObjectCached(pDataItem, index, Dest);
+}
+
+// MQ2's ToString doesn't take a size, the destination has to be MAX_STRING
+int32_t typeToStringUtf8(MQ2Type* pThis, MQ2VARPTR VarPtr, char* pDestination, uint32_t capacity, uint32_t* pFlags)
+{
+	char buffer[MAX_STRING] = { 0 };
+	if (pThis == nullptr || !pThis->ToString(VarPtr, buffer))
+		return -1;
+
+	return copyToUtf8(buffer, pDestination, capacity, pFlags);
+}
+
+const char* typeToStringArena(MQ2Type* pThis, MQ2VARPTR VarPtr, uint32_t* pLength)
+{
+	char buffer[MAX_STRING] = { 0 };
+	if (pThis == nullptr || !pThis->ToString(VarPtr, buffer))
+		return nullptr;
+
+	return copyToArena(buffer, pLength);
+}
+
+// ParseMacroData works in place, so the expression is converted into a MAX_STRING scratch buffer first
+int32_t parseMacroDataUtf8(const char* expression, char* pDestination, uint32_t capacity, uint32_t* pFlags)
+{
+	char buffer[MAX_STRING];
+	if (expression == nullptr || !utf8ToAnsi(expression, buffer, sizeof(buffer)) || !ParseMacroData(buffer, sizeof(buffer)))
+		return -1;
+
+	return copyToUtf8(buffer, pDestination, capacity, pFlags);
+}
+
+const char* parseMacroDataArena(const char* expression, uint32_t* pLength)
+{
+	char buffer[MAX_STRING];
+	if (expression == nullptr || !utf8ToAnsi(expression, buffer, sizeof(buffer)) || !ParseMacroData(buffer, sizeof(buffer)))
+		return nullptr;
+
+	return copyToArena(buffer, pLength);
+}
+
+// Spawns that were already in the zone when the loader initialized never went through OnAddSpawn
+void seedSpawnIndexes()
+{
+	if (!pSpawnManager)
+		return;
+
+	for (auto pSpawn = ((PSPAWNMANAGER)pSpawnManager)->FirstSpawn; pSpawn; pSpawn = pSpawn->pNext)
+	{
+		g_spawnSpatialIndex.Insert(pSpawn->SpawnID, pSpawn, static_cast<uint8_t>(pSpawn->Type), pSpawn->X, pSpawn->Y, pSpawn->Z);
+		g_spawnHandleTable.Add(pSpawn);
+	}
+}
+
+// Writes MQ2DotNetCore/capture-<date>-<time>.mq2capture. Spawns already in the zone are captured first, flagged as seeded, so a
+// replay starts with the same spawn list.
+void startCallbackCapture(const char_t* settingsPath)
+{
+	const time_t now = time(nullptr);
+	char fileName[64];
+	strftime(fileName, sizeof(fileName), "capture-%Y%m%d-%H%M%S.mq2capture", localtime(&now));
+
+	char_t capturePath[MAX_PATH];
+	buildLoaderPath(capturePath, MAX_PATH, gszINIPath, gszINIPath[0] ? "MQ2DotNetCore" : nullptr, fileName);
+
+	const int maxMegabytes = readLoaderSetting(settingsPath, "Settings", "CaptureMaxMegabytes", 1024);
+	if (!g_callbackCapture.Start(capturePath, static_cast<uint64_t>(std::max(maxMegabytes, 1)) * 1024 * 1024))
+	{
+		logToFile("[ startCallbackCapture(..) ]  Couldn't create the capture file " LOADER_PATH_FORMAT, capturePath);
+		return;
+	}
+
+	logToFile("[ startCallbackCapture(..) ]  Capturing callbacks to " LOADER_PATH_FORMAT, capturePath);
+	if (pSpawnManager)
+	{
+		for (auto pSpawn = ((PSPAWNMANAGER)pSpawnManager)->FirstSpawn; pSpawn; pSpawn = pSpawn->pNext)
+		{
+			captureSpawn(LoaderCallback::AddSpawn, pSpawn, CaptureSeeded);
+		}
+	}
+}
+
+// Captures are recorded before the forwarders do anything else, so a replay calls them with what EQ called them with
+void captureChatLine(LoaderCallback callback, PCHAR Line, DWORD Color, DWORD Filter)
+{
+	if (g_callbackCapture.IsCapturing())
+		g_callbackCapture.Record(callback, Color, Filter, Line, Line ? static_cast<uint32_t>(strlen(Line)) : 0);
+}
+
+void captureSpawn(LoaderCallback callback, PSPAWNINFO pSpawn, uint32_t flags)
+{
+	if (!g_callbackCapture.IsCapturing() || !pSpawn)
+		return;
+
+	CapturedSpawn captured{};
+	captured.Address = reinterpret_cast<uintptr_t>(pSpawn);
+	strncpy(captured.Name, pSpawn->Name, sizeof(captured.Name) - 1);
+	captured.X = pSpawn->X;
+	captured.Y = pSpawn->Y;
+	captured.Z = pSpawn->Z;
+	captured.Heading = pSpawn->Heading;
+	captured.SpawnID = pSpawn->SpawnID;
+	captured.Type = static_cast<uint8_t>(pSpawn->Type);
+	captured.Level = static_cast<uint8_t>(pSpawn->Level);
+	captured.StandState = static_cast<uint8_t>(pSpawn->StandState);
+	captured.HPCurrent = static_cast<int32_t>(pSpawn->HPCurrent);
+	captured.HPMax = static_cast<int32_t>(pSpawn->HPMax);
+	g_callbackCapture.Record(callback, flags, 0, &captured, sizeof(captured));
+}
+
+void captureGroundItem(LoaderCallback callback, PGROUNDITEM pGroundItem)
+{
+	if (!g_callbackCapture.IsCapturing() || !pGroundItem)
+		return;
+
+	CapturedGroundItem captured{};
+	captured.Address = reinterpret_cast<uintptr_t>(pGroundItem);
+	strncpy(captured.Name, pGroundItem->Name, sizeof(captured.Name) - 1);
+	captured.X = pGroundItem->X;
+	captured.Y = pGroundItem->Y;
+	captured.Z = pGroundItem->Z;
+	captured.Heading = pGroundItem->Heading;
+	captured.ID = pGroundItem->ID;
+	captured.DropID = pGroundItem->DropID;
+	g_callbackCapture.Record(callback, 0, 0, &captured, sizeof(captured));
+}
+
 /********************************************************************************************
  * Function used to load and activate .NET Core
  * See: https://github.com/dotnet/samples/blob/master/core/hosting/HostWithHostFxr/src/NativeHost/nativehost.cpp
  ********************************************************************************************/
 
-void* get_export(HMODULE hModule, const char* name)
-{
-	void* f = ::GetProcAddress(hModule, name);
-	return f;
-}
-
 // DEBUGGING this plugin is a bitch since it loads libraries + the .net core runtime on initialization
 // and then y they can't be unloaded, and the basic logging in MQ2 isn't as nice as I'd like so we'll
 // log output to our own file when the loader is initializing
 
-template<typename ... Args>
-std::string formatString(const std::string& format, Args ... args)
+// Formats into a stack buffer and hands the line to the log writer thread, so it's also cheap enough to call from the game
+// thread and safe to call from the boot thread when AsyncBoot is enabled. Until the log file is open lines go to chat.
+void logToFile(const char* format, ...)
 {
-	size_t size = snprintf(nullptr, 0, format.c_str(), args ...) + 1; // Extra space for '\0'
-	if (size <= 0) { throw std::runtime_error("Error during formatting."); }
-	std::unique_ptr<char[]> buf(new char[size]);
-	snprintf(buf.get(), size, format.c_str(), args ...);
-	return std::string(buf.get(), buf.get() + size - 1); // We don't want the '\0' inside
+	char message[2048];
+	va_list arguments;
+	va_start(arguments, format);
+	const int length = vsnprintf(message, sizeof(message), format, arguments);
+	va_end(arguments);
+
+	if (length < 0)
+		return;
+
+	if (!g_loaderLog.IsRunning())
+	{
+		WriteChatfSafe("%s", message);
+		return;
+	}
+
+	static const char category[] = "MQ2DotNetCoreLoader";
+	g_loaderLog.Write(LoaderLogLevel::Information, category, sizeof(category) - 1, message, std::min<size_t>(static_cast<size_t>(length), sizeof(message) - 1));
 }
 
-void logToFile(std::string message)
+// Sets the [Runtime] settings from MQ2DotNetCoreLoader.ini on a context whose runtime hasn't started yet
+void applyRuntimeProfile(hostfxr_handle hostfxrContext, hostfxr_set_runtime_property_value_fn setRuntimeProperty)
 {
-	std::fstream logFilestream;
-	logFilestream.open(g_pluginLogFile, std::fstream::in | std::fstream::out | std::fstream::app);
-	if (!logFilestream)
+	for (uint32_t index = 0; index < g_runtimeProfile.GetPropertyCount(); ++index)
 	{
-		char* messageCString = new char[message.length() + 1];
-		std::strcpy(messageCString, message.c_str());
-		WriteChatf(messageCString);
-		return;
+		const RuntimeProperty& property = g_runtimeProfile.GetProperties()[index];
+		const int32_t returnCode = setRuntimeProperty ? setRuntimeProperty(hostfxrContext, property.Name, property.Value) : -1;
+		if (returnCode == 0)
+			logToFile("[ applyRuntimeProfile(..) ]  " LOADER_PATH_FORMAT " = " LOADER_PATH_FORMAT, property.Name, property.Value);
+		else
+			logToFile("[ applyRuntimeProfile(..) ]  Couldn't set " LOADER_PATH_FORMAT ", hostfxr returned %d", property.Name, returnCode);
 	}
+}
 
-	time_t rawtime;
-	struct tm* timeinfo;
-	char buffer[80];
+// The runtime never unloads the assembly hostfxr loads the hot reload host from, and Windows keeps a loaded dll locked, so the
+// host is loaded from a copy made for this process and MQ2DotNetCore.dll itself stays replaceable. Copies left behind by clients
+// that exited are deleted first, the ones still loaded by a running client can't be and are skipped.
+const char_t* prepareHotReloadHostAssembly()
+{
+	const char* subdirectory = gszINIPath[0] ? "MQ2DotNetCore" : nullptr;
+	char_t directory[MAX_PATH];
+	buildLoaderPath(directory, MAX_PATH, gszINIPath, subdirectory, nullptr);
+	deleteLoaderFiles(directory, "MQ2DotNetCore.HotReloadHost.");
 
-	time(&rawtime);
-	timeinfo = localtime(&rawtime);
+	char fileName[64];
+	snprintf(fileName, sizeof(fileName), "MQ2DotNetCore.HotReloadHost.%u.dll", getLoaderProcessId());
+	buildLoaderPath(g_hotReloadHostAssemblyPath, MAX_PATH, gszINIPath, subdirectory, fileName);
 
-	strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", timeinfo);
-	std::string timestampString(buffer);
+	if (!copyLoaderFile(g_entryAssemblyLibraryPath, g_hotReloadHostAssemblyPath))
+	{
+		// Reloading the plugin reuses the runtime, which still has this process' copy loaded from the last time
+		if (!doesLoaderFileExist(g_hotReloadHostAssemblyPath))
+		{
+			logToFile("[ prepareHotReloadHostAssembly() ]  Couldn't copy the entry assembly to " LOADER_PATH_FORMAT ", loading the host from the entry assembly", g_hotReloadHostAssemblyPath);
+			return g_entryAssemblyLibraryPath;
+		}
+
+		logToFile("[ prepareHotReloadHostAssembly() ]  Reusing the existing copy " LOADER_PATH_FORMAT, g_hotReloadHostAssemblyPath);
+		return g_hotReloadHostAssemblyPath;
+	}
 
-	logFilestream << "[ " << timestampString << " MQ2DotNetCoreLoader ]  " << message << "\n\n";
+	// The component's dependencies are resolved from the deps.json named after the assembly it's loaded from
+	char_t depsPath[MAX_PATH];
+	char_t hostDepsPath[MAX_PATH];
+	snprintf(fileName, sizeof(fileName), "MQ2DotNetCore.HotReloadHost.%u.deps.json", getLoaderProcessId());
+	buildLoaderPath(depsPath, MAX_PATH, gszINIPath, subdirectory, "MQ2DotNetCore.deps.json");
+	buildLoaderPath(hostDepsPath, MAX_PATH, gszINIPath, subdirectory, fileName);
+	copyLoaderFile(depsPath, hostDepsPath);
 
-	logFilestream.close();
+	return g_hotReloadHostAssemblyPath;
 }
 
-bool loadDotNetClrAndExecuteEntryPoint()
+// Starts the CLR, loads MQ2DotNetCore.dll and finds the managed InitializePlugin. Nothing in here calls into MQ2 or EQ, so it can
+// run on the boot thread. shouldPrepareEntryPoint also has the managed side load its dependencies and JIT the entry point
+// before returning, which is only worth it when that happens off the EQ thread.
+bool loadDotNetClr(bool shouldPrepareEntryPoint, component_entry_point_fn* pInitializePlugin)
 {
-	WriteChatf("Loading .net core runtime and entry point...");
-
-	const char_t* entryPointDotNetType = L"MQ2DotNetCore.LoaderEntryPoint, MQ2DotNetCore";
-	const char_t* entryPointMethodName = L"InitializePlugin";
+	// With hot reload the host loads the entry point into a collectible context of its own
+	const char_t* entryPointDotNetType = g_hotReload.IsEnabled()
+		? LOADER_TEXT("MQ2DotNetCore.HotReloadHost, MQ2DotNetCore")
+		: LOADER_TEXT("MQ2DotNetCore.LoaderEntryPoint, MQ2DotNetCore");
+	const char_t* entryPointMethodName = LOADER_TEXT("InitializePlugin");
+	const char_t* entryAssemblyPath = g_hotReload.IsEnabled() ? prepareHotReloadHostAssembly() : g_entryAssemblyLibraryPath;
 
 	//logToFile(std::string ("MQ2DotNetCore.dll"));
-	logToFile(formatString("Entry Assembly Path: %ws", g_entryAssemblyLibraryPath));
-	logToFile(formatString("Entry Point .Net Type: %ws", entryPointDotNetType));
-	logToFile(formatString("Entry Point Method Name: %ws", entryPointMethodName));
+	logToFile("Entry Assembly Path: " LOADER_PATH_FORMAT, entryAssemblyPath);
+	logToFile("Entry Point .Net Type: " LOADER_PATH_FORMAT, entryPointDotNetType);
+	logToFile("Entry Point Method Name: " LOADER_PATH_FORMAT, entryPointMethodName);
 
-	logToFile("[ loadDotNetClrAndExecuteEntryPoint() ]  Using nethost library to locate the hostfxr path...");
+	logToFile("[ loadDotNetClr() ]  Using nethost library to locate the hostfxr path...");
 
 
 	hostfxr_initialize_for_runtime_config_fn hostfxrInitializeFunctionPointer = nullptr;
 	hostfxr_get_runtime_delegate_fn hostfxrGetRuntimeDelegateFunctionPointer = nullptr;
 	hostfxr_close_fn hostfxrCloseFunctionPointer = nullptr;
+	hostfxr_set_runtime_property_value_fn hostfxrSetRuntimePropertyFunctionPointer = nullptr;
 
 	// Pre-allocate a large buffer for the path to hostfxr
 	char_t hostfxrPathBuffer[MAX_PATH];
 	size_t hostfxrPathBufferSize = sizeof(hostfxrPathBuffer) / sizeof(char_t);
-	int getHostfxrPathReturnCode = get_hostfxr_path(hostfxrPathBuffer, &hostfxrPathBufferSize, nullptr);
+	int getHostfxrPathReturnCode = 0;
+	{
+		BootPhaseTimer phaseTimer(BootPhase::HostfxrPath);
+		getHostfxrPathReturnCode = get_hostfxr_path(hostfxrPathBuffer, &hostfxrPathBufferSize, nullptr);
+	}
+
 	if (getHostfxrPathReturnCode != 0)
 	{
-		logToFile(formatString("[ loadDotNetClrAndExecuteEntryPoint() ]  get_hostfxr_path(..) failed w/ return code: %d", getHostfxrPathReturnCode));
+		logToFile("[ loadDotNetClr() ]  get_hostfxr_path(..) failed w/ return code: %d", getHostfxrPathReturnCode);
 		return false;
 	}
 
-	logToFile(formatString("[ loadDotNetClrAndExecuteEntryPoint() ]  Loading the hostfxr library from:  %w", hostfxrPathBuffer));
+	logToFile("[ loadDotNetClr() ]  Loading the hostfxr library from:  " LOADER_PATH_FORMAT, hostfxrPathBuffer);
 	//WriteChatf("[MQ2DotNetCoreLoader - loadDotNetClrAndExecuteEntryPoint()] Loading the hostfxr library...");
 
 	// Load hostfxr and get desired exports
-	HMODULE hostfxrLibraryHandle = ::LoadLibraryW(hostfxrPathBuffer);
-	hostfxrInitializeFunctionPointer = (hostfxr_initialize_for_runtime_config_fn)get_export(hostfxrLibraryHandle, "hostfxr_initialize_for_runtime_config");
-	hostfxrGetRuntimeDelegateFunctionPointer = (hostfxr_get_runtime_delegate_fn)get_export(hostfxrLibraryHandle, "hostfxr_get_runtime_delegate");
-	hostfxrCloseFunctionPointer = (hostfxr_close_fn)get_export(hostfxrLibraryHandle, "hostfxr_close");
+	{
+		BootPhaseTimer phaseTimer(BootPhase::LoadHostfxr);
+		void* hostfxrLibraryHandle = loadLibrary(hostfxrPathBuffer);
+		hostfxrInitializeFunctionPointer = (hostfxr_initialize_for_runtime_config_fn)getLibraryExport(hostfxrLibraryHandle, "hostfxr_initialize_for_runtime_config");
+		hostfxrGetRuntimeDelegateFunctionPointer = (hostfxr_get_runtime_delegate_fn)getLibraryExport(hostfxrLibraryHandle, "hostfxr_get_runtime_delegate");
+		hostfxrCloseFunctionPointer = (hostfxr_close_fn)getLibraryExport(hostfxrLibraryHandle, "hostfxr_close");
+		hostfxrSetRuntimePropertyFunctionPointer = (hostfxr_set_runtime_property_value_fn)getLibraryExport(hostfxrLibraryHandle, "hostfxr_set_runtime_property_value");
+	}
 
 
 	bool areAllFunctionPointersSet = true;
 	if (!hostfxrInitializeFunctionPointer || hostfxrInitializeFunctionPointer == nullptr)
 	{
 		areAllFunctionPointersSet = false;
-		logToFile("[ loadDotNetClrAndExecuteEntryPoint() ]  get_export(..) failed to locate/set the hostfxrInitializeFunctionPointer");
+		logToFile("[ loadDotNetClr() ]  getLibraryExport(..) failed to locate/set the hostfxrInitializeFunctionPointer");
 	}
 
 	if (!hostfxrGetRuntimeDelegateFunctionPointer || hostfxrGetRuntimeDelegateFunctionPointer == nullptr)
 	{
 		areAllFunctionPointersSet = false;
-		logToFile("[ loadDotNetClrAndExecuteEntryPoint() ]  get_export(..) failed to locate/set the hostfxrGetRuntimeDelegateFunctionPointer");
+		logToFile("[ loadDotNetClr() ]  getLibraryExport(..) failed to locate/set the hostfxrGetRuntimeDelegateFunctionPointer");
 	}
 
 	if (!hostfxrCloseFunctionPointer || hostfxrCloseFunctionPointer == nullptr)
 	{
 		areAllFunctionPointersSet = false;
-		logToFile("[ loadDotNetClrAndExecuteEntryPoint() ]  get_export(..) failed to locate/set the hostfxrCloseFunctionPointer");
+		logToFile("[ loadDotNetClr() ]  getLibraryExport(..) failed to locate/set the hostfxrCloseFunctionPointer");
 	}
 
 	if (!areAllFunctionPointersSet) {
 		return false;
 	}
 
-	logToFile("[ loadDotNetClrAndExecuteEntryPoint() ]  hostfxr library loaded, initializing .net core runtime...");
+	logToFile("[ loadDotNetClr() ]  hostfxr library loaded, initializing .net core runtime...");
 
 	// Load .NET Core
 	void* hostfxrLoadAssemblyAndGetFunctionPointer = nullptr;
 	hostfxr_handle hostfxr_context = nullptr;
-	int hostfxrInitializeReturnCode = hostfxrInitializeFunctionPointer(g_dotnetRuntimeConfigPath, nullptr, &hostfxr_context);
-	if (hostfxrInitializeReturnCode != 0)
+	int hostfxrInitializeReturnCode = 0;
+	{
+		BootPhaseTimer phaseTimer(BootPhase::InitializeRuntime);
+		hostfxrInitializeReturnCode = hostfxrInitializeFunctionPointer(g_dotnetRuntimeConfigPath, nullptr, &hostfxr_context);
+	}
+
+	// 1 and 2 mean the runtime was already started, by an earlier load of this plugin, which is fine once the core is unloadable
+	const bool isRuntimeAlreadyLoaded = hostfxrInitializeReturnCode == 1 || hostfxrInitializeReturnCode == 2;
+	if (hostfxrInitializeReturnCode != 0 && !(isRuntimeAlreadyLoaded && g_hotReload.IsEnabled()))
 	{
-		logToFile(formatString("[ loadDotNetClrAndExecuteEntryPoint() ]  The hostfxr inititialize(..) (function pointer) call returned a non zero exit code: %d!", hostfxrInitializeReturnCode));
+		logToFile("[ loadDotNetClr() ]  The hostfxr inititialize(..) (function pointer) call returned a non zero exit code: %d!", hostfxrInitializeReturnCode);
 		hostfxrCloseFunctionPointer(hostfxr_context);
-		return nullptr;
+		return false;
 	}
 
 	if (hostfxr_context == nullptr)
 	{
-		logToFile("[ loadDotNetClrAndExecuteEntryPoint() ]  The hostfxr inititialize(..) (function pointer) did not succeed, the hostfxr_context is equal to the nullptr value!");
+		logToFile("[ loadDotNetClr() ]  The hostfxr inititialize(..) (function pointer) did not succeed, the hostfxr_context is equal to the nullptr value!");
 		hostfxrCloseFunctionPointer(hostfxr_context);
-		return nullptr;
+		return false;
+	}
+
+	// The runtime only starts when the first delegate is requested, until then its properties can still be changed
+	if (g_runtimeProfile.GetPropertyCount() > 0)
+	{
+		if (isRuntimeAlreadyLoaded)
+		{
+			logToFile("[ loadDotNetClr() ]  The .net runtime is already running, the [Runtime] settings only take effect after restarting the client");
+		}
+		else
+		{
+			applyRuntimeProfile(hostfxr_context, hostfxrSetRuntimePropertyFunctionPointer);
+		}
 	}
 
-	logToFile("[ loadDotNetClrAndExecuteEntryPoint() ]  Getting the hdt_load_assembly_and_get_function_pointer from the .net runtime...");
+	logToFile("[ loadDotNetClr() ]  Getting the hdt_load_assembly_and_get_function_pointer from the .net runtime...");
 
 	// Get the load assembly function pointer
-	int hostfxrGetDelegateFunctionPointerReturnCode = hostfxrGetRuntimeDelegateFunctionPointer(
-		hostfxr_context,
-		hdt_load_assembly_and_get_function_pointer,
-		&hostfxrLoadAssemblyAndGetFunctionPointer
-	);
+	int hostfxrGetDelegateFunctionPointerReturnCode = 0;
+	{
+		BootPhaseTimer phaseTimer(BootPhase::GetRuntimeDelegate);
+		hostfxrGetDelegateFunctionPointerReturnCode = hostfxrGetRuntimeDelegateFunctionPointer(
+			hostfxr_context,
+			hdt_load_assembly_and_get_function_pointer,
+			&hostfxrLoadAssemblyAndGetFunctionPointer
+		);
+	}
 
 	if (hostfxrGetDelegateFunctionPointerReturnCode != 0)
 	{
-		logToFile(formatString("[ loadDotNetClrAndExecuteEntryPoint() ]  The hostfxr getRuntimeDelegate(..) (function pointer) call returned a non zero exit code: %d!", hostfxrGetDelegateFunctionPointerReturnCode));
+		logToFile("[ loadDotNetClr() ]  The hostfxr getRuntimeDelegate(..) (function pointer) call returned a non zero exit code: %d!", hostfxrGetDelegateFunctionPointerReturnCode);
 		hostfxrCloseFunctionPointer(hostfxr_context);
 		return false;
 	}
 
 	if (hostfxrLoadAssemblyAndGetFunctionPointer == nullptr)
 	{
-		logToFile("[ loadDotNetClrAndExecuteEntryPoint() ]  The hostfxr getRuntimeDelegate(..) (function pointer) call returned a did not succeed, the hostfxrLoadAssemblyAndGetFunctionPointer is set to a nullptr value!");
+		logToFile("[ loadDotNetClr() ]  The hostfxr getRuntimeDelegate(..) (function pointer) call returned a did not succeed, the hostfxrLoadAssemblyAndGetFunctionPointer is set to a nullptr value!");
 		hostfxrCloseFunctionPointer(hostfxr_context);
 		return false;
 	}
@@ -368,54 +1366,104 @@ bool loadDotNetClrAndExecuteEntryPoint()
 	//typedef void (CORECLR_DELEGATE_CALLTYPE* custom_entry_point_fn)(lib_args args);
 	//custom_entry_point_fn custom = nullptr;
 
-	logToFile("[ loadDotNetClrAndExecuteEntryPoint() ]  Loading the entry point assembly and method...");
+	logToFile("[ loadDotNetClr() ]  Loading the entry point assembly and method...");
 
 	// Function pointer to managed delegate
 	component_entry_point_fn initializePluginFunctionPointer = nullptr;
-	int loadEntryPointReturnCode = dotnetLoadAssemblyAndGetFunctionPointer(
-		//L"MQ2DotNetCore.dll",
-		g_entryAssemblyLibraryPath,
-		entryPointDotNetType,
-		entryPointMethodName,
-		nullptr, // Pass nullptr for default delegate type
-		nullptr,
-		(void**)&initializePluginFunctionPointer
-	);
-
-	logToFile("[ loadDotNetClrAndExecuteEntryPoint() ]  Closing the hostfxr context...");
+	int loadEntryPointReturnCode = 0;
+	{
+		BootPhaseTimer phaseTimer(BootPhase::LoadEntryAssembly);
+		loadEntryPointReturnCode = dotnetLoadAssemblyAndGetFunctionPointer(
+			//L"MQ2DotNetCore.dll",
+			entryAssemblyPath,
+			entryPointDotNetType,
+			entryPointMethodName,
+			nullptr, // Pass nullptr for default delegate type
+			nullptr,
+			(void**)&initializePluginFunctionPointer
+		);
+	}
+
+	component_entry_point_fn unloadFunctionPointer = nullptr;
+	if (g_hotReload.IsEnabled() && loadEntryPointReturnCode == 0)
+	{
+		loadEntryPointReturnCode = dotnetLoadAssemblyAndGetFunctionPointer(
+			entryAssemblyPath,
+			entryPointDotNetType,
+			LOADER_TEXT("Unload"),
+			nullptr,
+			nullptr,
+			(void**)&unloadFunctionPointer
+		);
+	}
+
+	// Optional, a failure here only means more work is left for the managed InitializePlugin
+	if (shouldPrepareEntryPoint && loadEntryPointReturnCode == 0)
+	{
+		logToFile("[ loadDotNetClr() ]  Preparing the entry point...");
+
+		BootPhaseTimer phaseTimer(BootPhase::PrepareEntryPoint);
+		component_entry_point_fn prepareFunctionPointer = nullptr;
+		const int loadPrepareReturnCode = dotnetLoadAssemblyAndGetFunctionPointer(
+			entryAssemblyPath,
+			LOADER_TEXT("MQ2DotNetCore.LoaderBootPreparation, MQ2DotNetCore"),
+			LOADER_TEXT("Prepare"),
+			nullptr,
+			nullptr,
+			(void**)&prepareFunctionPointer
+		);
+
+		const int prepareReturnCode = loadPrepareReturnCode == 0 && prepareFunctionPointer ? prepareFunctionPointer(nullptr, 0) : loadPrepareReturnCode;
+		if (prepareReturnCode != 0)
+			logToFile("[ loadDotNetClr() ]  Preparing the entry point failed with return code: %d, continuing without it", prepareReturnCode);
+	}
+
+	logToFile("[ loadDotNetClr() ]  Closing the hostfxr context...");
 	hostfxrCloseFunctionPointer(hostfxr_context);
 
 	if (loadEntryPointReturnCode != 0)
 	{
-		logToFile(formatString("[ loadDotNetClrAndExecuteEntryPoint() ]  The loadEntryPointReturnCode is non zero: %d", loadEntryPointReturnCode));
+		logToFile("[ loadDotNetClr() ]  The loadEntryPointReturnCode is non zero: %d", loadEntryPointReturnCode);
 		return false;
 	}
 
 	if (initializePluginFunctionPointer == nullptr)
 	{
-		logToFile("[ loadDotNetClrAndExecuteEntryPoint() ]  The initializePluginFunctionPointer is set to the nullptr value!");
+		logToFile("[ loadDotNetClr() ]  The initializePluginFunctionPointer is set to the nullptr value!");
 		return false;
 	}
 
+	*pInitializePlugin = initializePluginFunctionPointer;
+	if (g_hotReload.IsEnabled())
+		g_hotReload.SetEntryPoints(initializePluginFunctionPointer, unloadFunctionPointer);
+
+	return true;
+}
+
+// Runs the managed InitializePlugin, which registers commands and data types with MQ2, so it has to be on the EQ thread
+bool executeEntryPoint(component_entry_point_fn initializePlugin)
+{
+	BootPhaseTimer phaseTimer(BootPhase::InitializeEntryPoint);
+
 	struct entryPointArguments
 	{
 		const char_t* message;
 	};
 
 
-	wchar_t loaderAssemblyPath[MAX_PATH] = { 0 };
-	StringCbPrintfW(loaderAssemblyPath, MAX_PATH, L"%hs\\%ws", gszINIPath, L"MQ2DotNetCoreLoader.dll");
+	char_t loaderAssemblyPath[MAX_PATH] = { 0 };
+	buildLoaderPath(loaderAssemblyPath, MAX_PATH, gszINIPath, nullptr, "MQ2DotNetCoreLoader.dll");
 	entryPointArguments args
 	{
 		loaderAssemblyPath
 	};
 
-	logToFile("[ loadDotNetClrAndExecuteEntryPoint() ]  Calling the InitializePlugin(..) entry point method...");
+	logToFile("[ executeEntryPoint() ]  Calling the InitializePlugin(..) entry point method...");
 
-	int initializePluginEntryPointMethodReturnCode = initializePluginFunctionPointer(&args, sizeof(args));
+	int initializePluginEntryPointMethodReturnCode = initializePlugin(&args, sizeof(args));
 	if (initializePluginEntryPointMethodReturnCode != 0)
 	{
-		logToFile(formatString("[ loadDotNetClrAndExecuteEntryPoint() ]  The InitializePlugin(..) entry point method returned a non zero return code: %d", initializePluginEntryPointMethodReturnCode));
+		logToFile("[ executeEntryPoint() ]  The InitializePlugin(..) entry point method returned a non zero return code: %d", initializePluginEntryPointMethodReturnCode);
 		return false;
 	}
 
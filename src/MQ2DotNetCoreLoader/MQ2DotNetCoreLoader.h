@@ -0,0 +1,40 @@
+#pragma once
+
+#ifdef MQ2SourceRootFolder
+
+#include "MQ2Plugin.h"
+
+#else
+
+#include "../../../MQ2Plugin.h"
+
+#endif
+
+#include "LoaderPlatform.h"
+
+#include <cstdint>
+#include <cstdio>
+
+// Shared declarations for the loader's translation units. Only MQ2DotNetCoreLoader.cpp should use PreSetup/PLUGIN_VERSION.
+
+extern bool g_bLoaded;
+extern char_t g_pluginLogFile[MAX_PATH];
+
+// printf style, lines longer than 2047 characters are truncated
+void logToFile(const char* format, ...);
+
+// Current HP as a 0 - 100 percentage, shared by the spawn snapshot and the spawn change feed
+uint8_t getSpawnHPPercent(PSPAWNINFO pSpawn);
+
+// GetMember / TLO reads that go through the per pulse member cache when it's enabled, shared by the exports, member batches
+// and expression plans
+bool getMemberCached(MQ2Type* pType, MQ2VARPTR VarPtr, PCHAR Member, PCHAR Index, MQ2TYPEVAR& Dest);
+bool getTopLevelObjectCached(PMQ2DATAITEM pDataItem, PCHAR Index, MQ2TYPEVAR& Dest);
+
+// GetMember with a member id from the intern table, the index is UTF-8
+bool getMemberById(MQ2Type* pType, MQ2VARPTR VarPtr, uint32_t memberId, const char* pIndex, uint32_t indexLength, MQ2TYPEVAR& Dest);
+
+// The inventory index's lazy refresh, and name lookups with a UTF-8 name
+struct InventorySlot;
+void refreshInventoryIndex();
+uint32_t findInventoryItemsByName(const char* pName, uint32_t nameLength, bool isExact, uint32_t containerMask, InventorySlot* pSlots, uint32_t capacity, uint64_t* pTotalCount);
@@ -0,0 +1,79 @@
+#include "MQ2DotNetCoreLoader.h"
+#include "ExpressionPlan.h"
+
+#include <cstring>
+
+namespace
+{
+	static_assert(sizeof(ExpressionHost::Value) == sizeof(MQ2TYPEVAR), "ExpressionHost::Value must be able to hold an MQ2TYPEVAR");
+
+	inline ExpressionHost::Value toValue(const MQ2TYPEVAR& typeVar)
+	{
+		ExpressionHost::Value value;
+		memcpy(&value, &typeVar, sizeof(value));
+		return value;
+	}
+
+	inline MQ2TYPEVAR toTypeVar(const ExpressionHost::Value& value)
+	{
+		MQ2TYPEVAR typeVar;
+		memcpy(&typeVar, &value, sizeof(typeVar));
+		return typeVar;
+	}
+
+	// Expression plan host backed by MQ2Main
+	class MQ2ExpressionHost : public ExpressionHost
+	{
+	public:
+		void* FindTopLevelObject(const char* name) override
+		{
+			const auto pDataItem = FindMQ2Data(const_cast<PCHAR>(name));
+			return pDataItem && pDataItem->Function ? pDataItem : nullptr;
+		}
+
+		bool GetTopLevelObject(void* topLevelObject, char* index, Value& value) override
+		{
+			MQ2TYPEVAR typeVar{};
+			if (!getTopLevelObjectCached(static_cast<PMQ2DATAITEM>(topLevelObject), index, typeVar))
+			{
+				return false;
+			}
+
+			value = toValue(typeVar);
+			return true;
+		}
+
+		bool GetMember(const Value& value, char* member, char* index, Value& result) override
+		{
+			const auto typeVar = toTypeVar(value);
+			MQ2TYPEVAR resultTypeVar{};
+			if (!getMemberCached(typeVar.Type, typeVar.VarPtr, member, index, resultTypeVar))
+			{
+				return false;
+			}
+
+			result = toValue(resultTypeVar);
+			return true;
+		}
+
+		bool ToString(const Value& value, char* destination) override
+		{
+			const auto typeVar = toTypeVar(value);
+			return typeVar.Type->ToString(typeVar.VarPtr, destination);
+		}
+
+		bool ParseMacroData(char* buffer, size_t bufferSize) override
+		{
+			return ::ParseMacroData(buffer, bufferSize) != 0;
+		}
+
+		bool Calculate(char* formula, double& result) override
+		{
+			return ::Calculate(formula, result) != 0;
+		}
+	};
+
+	MQ2ExpressionHost g_mq2ExpressionHost;
+}
+
+ExpressionPlanCache g_expressionPlanCache(&g_mq2ExpressionHost);
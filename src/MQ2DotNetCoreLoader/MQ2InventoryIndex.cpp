@@ -0,0 +1,81 @@
+#include "MQ2DotNetCoreLoader.h"
+#include "InventoryIndex.h"
+#include "TextEncoding.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	// Items that don't stack have a StackCount of 0 or 1 depending on the client, they count as one either way
+	inline uint32_t getStackCount(PCONTENTS pContents)
+	{
+		return std::max<uint32_t>(1, pContents->StackCount);
+	}
+
+	// The items in slots and, for bags, the items in them. Bags are walked up to their slot count, the same as MQ2's FindItem.
+	template<typename Visit>
+	void walkContainer(InventoryContainer container, PCONTENTS* pSlots, uint32_t slotCount, Visit& visit)
+	{
+		for (uint32_t slot = 0; slot < slotCount; ++slot)
+		{
+			const PCONTENTS pContents = pSlots[slot];
+			const PITEMINFO pItem = pContents ? GetItemFromContents(pContents) : nullptr;
+			if (pItem == nullptr)
+				continue;
+
+			visit(container, static_cast<uint16_t>(slot), static_cast<int16_t>(-1), static_cast<uint32_t>(pItem->ItemNumber), getStackCount(pContents), pItem->Name, pContents);
+
+			const auto pBagItems = pContents->Contents.ContainedItems.pItems;
+			if (pItem->Type != ITEMTYPE_PACK || pBagItems == nullptr)
+				continue;
+
+			const uint32_t bagSlotCount = std::min<uint32_t>(pItem->Slots, pContents->Contents.ContainedItems.Size);
+			for (uint32_t bagSlot = 0; bagSlot < bagSlotCount; ++bagSlot)
+			{
+				const PCONTENTS pBagContents = pBagItems->Item[bagSlot];
+				const PITEMINFO pBagItem = pBagContents ? GetItemFromContents(pBagContents) : nullptr;
+				if (pBagItem != nullptr)
+					visit(container, static_cast<uint16_t>(slot), static_cast<int16_t>(bagSlot), static_cast<uint32_t>(pBagItem->ItemNumber), getStackCount(pBagContents), pBagItem->Name, pBagContents);
+			}
+		}
+	}
+
+	// Nothing is walked at character select or while the character's data isn't there yet
+	template<typename Visit>
+	void walkItems(Visit visit)
+	{
+		const PCHARINFO2 pCharInfo2 = GetCharInfo2();
+		if (pCharInfo2 && pCharInfo2->pInventoryArray)
+			walkContainer(InventoryContainer::Inventory, pCharInfo2->pInventoryArray->InventoryArray, NUM_INV_SLOTS, visit);
+
+		const PCHARINFO pCharInfo = GetCharInfo();
+		if (pCharInfo && pCharInfo->pBankArray)
+			walkContainer(InventoryContainer::Bank, pCharInfo->pBankArray->Bank, NUM_BANK_SLOTS, visit);
+
+		if (pCharInfo && pCharInfo->pSharedBankArray)
+			walkContainer(InventoryContainer::SharedBank, pCharInfo->pSharedBankArray->SharedBank, NUM_SHAREDBANK_SLOTS, visit);
+	}
+}
+
+void refreshInventoryIndex()
+{
+	g_inventoryIndex.Refresh([](auto visit) { walkItems(visit); });
+}
+
+// Item names are ANSI, a name that doesn't convert can't match any of them
+uint32_t findInventoryItemsByName(const char* pName, uint32_t nameLength, bool isExact, uint32_t containerMask, InventorySlot* pSlots, uint32_t capacity, uint64_t* pTotalCount)
+{
+	refreshInventoryIndex();
+
+	char name[ITEM_NAME_LEN + 1];
+	if (pName == nullptr || !utf8ToAnsi(pName, nameLength, name, sizeof(name)))
+	{
+		if (pTotalCount)
+			*pTotalCount = 0;
+
+		return 0;
+	}
+
+	return g_inventoryIndex.FindByName(name, strnlen(name, sizeof(name)), isExact, containerMask, pSlots, capacity, pTotalCount);
+}
@@ -0,0 +1,104 @@
+#include "MQ2DotNetCoreLoader.h"
+#include "InternTable.h"
+#include "MemberCache.h"
+#include "PulseArena.h"
+#include "TextEncoding.h"
+
+#include <cstring>
+
+namespace
+{
+	static_assert(sizeof(MemberCache::Value) == sizeof(MQ2TYPEVAR), "MemberCache::Value must be able to hold an MQ2TYPEVAR");
+
+	inline MemberCache::Value toValue(const MQ2TYPEVAR& typeVar)
+	{
+		MemberCache::Value value;
+		memcpy(&value, &typeVar, sizeof(value));
+		return value;
+	}
+
+	inline MQ2TYPEVAR toTypeVar(const MemberCache::Value& value)
+	{
+		MQ2TYPEVAR typeVar;
+		memcpy(&typeVar, &value, sizeof(typeVar));
+		return typeVar;
+	}
+
+	inline uint64_t toData(MQ2VARPTR VarPtr)
+	{
+		uint64_t data;
+		memcpy(&data, &VarPtr, sizeof(data));
+		return data;
+	}
+
+	// String results point into MQ2's shared temporary buffers, which the next GetMember call overwrites. Cached strings are
+	// copied into the pulse arena, which is reset at the same time as the cache.
+	bool pinValue(MemberCache::Value& value)
+	{
+		auto typeVar = toTypeVar(value);
+		if (typeVar.Type != pStringType || typeVar.VarPtr.Ptr == nullptr)
+			return true;
+
+		const auto pString = static_cast<const char*>(typeVar.VarPtr.Ptr);
+		const size_t length = strnlen(pString, MAX_STRING - 1);
+		const auto pCopy = g_pulseArena.Allocate(length + 1);
+		if (pCopy == nullptr)
+			return false;
+
+		memcpy(pCopy, pString, length);
+		pCopy[length] = '\0';
+		typeVar.VarPtr.Ptr = pCopy;
+		value = toValue(typeVar);
+		return true;
+	}
+
+	void* resolveType(const char* name)
+	{
+		return FindMQ2DataType(const_cast<PCHAR>(name));
+	}
+}
+
+MemberCache g_memberCache(&pinValue);
+InternTable g_internTable(&resolveType);
+
+bool getMemberCached(MQ2Type* pType, MQ2VARPTR VarPtr, PCHAR Member, PCHAR Index, MQ2TYPEVAR& Dest)
+{
+	MemberCache::Value value{};
+	const bool isSuccess = g_memberCache.Get(pType, toData(VarPtr), Member, Index, value, [&](MemberCache::Value& result)
+	{
+		MQ2TYPEVAR typeVar{};
+		const bool isReadSuccess = pType->GetMember(VarPtr, Member, Index, typeVar);
+		result = toValue(typeVar);
+		return isReadSuccess;
+	});
+
+	Dest = toTypeVar(value);
+	return isSuccess;
+}
+
+// The member name is the intern table's copy, only the index has to be converted
+bool getMemberById(MQ2Type* pType, MQ2VARPTR VarPtr, uint32_t memberId, const char* pIndex, uint32_t indexLength, MQ2TYPEVAR& Dest)
+{
+	const auto pMember = g_internTable.GetMemberName(memberId);
+	char index[MAX_STRING];
+	return pType != nullptr
+		&& pMember != nullptr
+		&& utf8ToAnsi(pIndex, indexLength, index, sizeof(index))
+		&& getMemberCached(pType, VarPtr, pMember, index, Dest);
+}
+
+// TLOs are keyed by their data item with a null type
+bool getTopLevelObjectCached(PMQ2DATAITEM pDataItem, PCHAR Index, MQ2TYPEVAR& Dest)
+{
+	MemberCache::Value value{};
+	const bool isSuccess = g_memberCache.Get(nullptr, reinterpret_cast<uintptr_t>(pDataItem), pDataItem->Name, Index, value, [&](MemberCache::Value& result)
+	{
+		MQ2TYPEVAR typeVar{};
+		const bool isReadSuccess = pDataItem->Function(Index, typeVar) != 0;
+		result = toValue(typeVar);
+		return isReadSuccess;
+	});
+
+	Dest = toTypeVar(value);
+	return isSuccess;
+}
@@ -0,0 +1,140 @@
+#include "MemberBatch.h"
+#include "TextEncoding.h"
+
+#include <cstring>
+
+namespace
+{
+	// GetMember / TLO functions take a non const index and some of them write to it, so every argument is copied (and converted
+	// from UTF-8) into a scratch buffer rather than handing MQ2 the caller's string table
+	bool copyString(const char* pStrings, uint32_t stringsSize, uint32_t offset, char* pDestination, size_t destinationSize)
+	{
+		if (offset == MemberBatchNoString)
+		{
+			pDestination[0] = '\0';
+			return true;
+		}
+
+		if (offset >= stringsSize)
+		{
+			return false;
+		}
+
+		const size_t length = strnlen(pStrings + offset, stringsSize - offset);
+		if (length == stringsSize - offset)
+		{
+			return false;
+		}
+
+		return utf8ToAnsi(pStrings + offset, pDestination, destinationSize);
+	}
+
+	bool resolveRoot(const MemberBatchPath& path, const char* pStrings, uint32_t stringsSize, MQ2TYPEVAR& value)
+	{
+		if (path.RootNameOffset == MemberBatchNoString)
+		{
+			value = path.Root;
+			return value.Type != nullptr;
+		}
+
+		char name[MAX_STRING];
+		char index[MAX_STRING];
+		if (!copyString(pStrings, stringsSize, path.RootNameOffset, name, sizeof(name))
+			|| !copyString(pStrings, stringsSize, path.RootIndexOffset, index, sizeof(index)))
+		{
+			return false;
+		}
+
+		const auto pDataItem = FindMQ2Data(name);
+		if (pDataItem == nullptr || pDataItem->Function == nullptr)
+		{
+			return false;
+		}
+
+		value.Type = nullptr;
+		return getTopLevelObjectCached(pDataItem, index, value) && value.Type != nullptr;
+	}
+
+	bool walkPath(const MemberBatchPath& path, const MemberBatchStep* pSteps, uint32_t stepCount, const char* pStrings, uint32_t stringsSize, MQ2TYPEVAR& value)
+	{
+		if (path.FirstStep > stepCount || path.StepCount > stepCount - path.FirstStep)
+		{
+			return false;
+		}
+
+		if (!resolveRoot(path, pStrings, stringsSize, value))
+		{
+			return false;
+		}
+
+		char member[MAX_STRING];
+		char index[MAX_STRING];
+		for (uint32_t stepIndex = path.FirstStep; stepIndex < path.FirstStep + path.StepCount; ++stepIndex)
+		{
+			const auto& step = pSteps[stepIndex];
+			if (!copyString(pStrings, stringsSize, step.MemberOffset, member, sizeof(member))
+				|| !copyString(pStrings, stringsSize, step.IndexOffset, index, sizeof(index)))
+			{
+				return false;
+			}
+
+			MQ2TYPEVAR next{};
+			if (!getMemberCached(value.Type, value.VarPtr, member, index, next) || next.Type == nullptr)
+			{
+				return false;
+			}
+
+			value = next;
+		}
+
+		return true;
+	}
+}
+
+uint32_t evaluateMemberBatch(const MemberBatchPath* pPaths, uint32_t pathCount, const MemberBatchStep* pSteps, uint32_t stepCount,
+	const char* pStrings, uint32_t stringsSize, MemberBatchResult* pResults, char* pText, uint32_t textCapacity, uint32_t* pTextSize)
+{
+	if (pPaths == nullptr || pResults == nullptr || (stepCount > 0 && pSteps == nullptr) || (stringsSize > 0 && pStrings == nullptr))
+	{
+		return 0;
+	}
+
+	uint32_t successCount = 0;
+	uint32_t textSize = 0;
+	uint32_t requiredTextSize = 0;
+	for (uint32_t pathIndex = 0; pathIndex < pathCount; ++pathIndex)
+	{
+		auto& result = pResults[pathIndex];
+		result.Value = MQ2TYPEVAR{};
+		result.TextOffset = MemberBatchNoString;
+		result.IsSuccess = walkPath(pPaths[pathIndex], pSteps, stepCount, pStrings, stringsSize, result.Value) ? 1 : 0;
+		if (!result.IsSuccess)
+		{
+			result.Value = MQ2TYPEVAR{};
+			continue;
+		}
+
+		++successCount;
+
+		if (result.Value.Type == pStringType && result.Value.VarPtr.Ptr != nullptr)
+		{
+			const auto pString = static_cast<const char*>(result.Value.VarPtr.Ptr);
+			const size_t length = strnlen(pString, MAX_STRING - 1);
+			const size_t encodedLength = utf8Length(pString, length);
+			requiredTextSize += static_cast<uint32_t>(encodedLength + 1);
+			if (pText != nullptr && textSize + encodedLength + 1 <= textCapacity)
+			{
+				ansiToUtf8(pString, length, pText + textSize, static_cast<uint32_t>(encodedLength + 1), nullptr);
+				result.TextOffset = textSize;
+				textSize += static_cast<uint32_t>(encodedLength + 1);
+			}
+		}
+	}
+
+	if (pTextSize)
+	{
+		*pTextSize = requiredTextSize;
+	}
+
+	return successCount;
+}
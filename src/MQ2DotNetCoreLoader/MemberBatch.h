@@ -0,0 +1,43 @@
+#pragma once
+
+#include "MQ2DotNetCoreLoader.h"
+
+#include <cstdint>
+
+// Marks an unused string offset, e.g. a member with no index or a path that starts from a caller supplied root
+const uint32_t MemberBatchNoString = 0xFFFFFFFF;
+
+// One member chain, e.g. Me.Buff[3].Duration.TotalSeconds. The chain starts from Root, or from the TLO named by RootNameOffset
+// (with RootIndexOffset as its index) when that is set, and then calls GetMember for steps [FirstStep, FirstStep + StepCount).
+// Layout is mirrored by MQ2DotNetCore.Interop.MemberBatchPath, keep them in sync
+struct MemberBatchPath
+{
+	MQ2TYPEVAR Root;
+	uint32_t RootNameOffset;
+	uint32_t RootIndexOffset;
+	uint32_t FirstStep;
+	uint32_t StepCount;
+};
+
+// Offsets of the null terminated member name and index in the batch's string table. Layout is mirrored by
+// MQ2DotNetCore.Interop.MemberBatchStep, keep them in sync
+struct MemberBatchStep
+{
+	uint32_t MemberOffset;
+	uint32_t IndexOffset;
+};
+
+// Final value of a chain. MQ2 returns strings in shared temporary buffers that the next GetMember call overwrites, so string
+// results are also copied into the caller's text buffer, as UTF-8. Layout is mirrored by MQ2DotNetCore.Interop.MemberBatchResult, keep
+// them in sync
+struct MemberBatchResult
+{
+	MQ2TYPEVAR Value;
+	uint32_t IsSuccess;
+	uint32_t TextOffset;		// MemberBatchNoString unless Value is a string that fit in the text buffer
+};
+
+// Walks every path and writes one result per path. Returns the number of paths that resolved. pTextSize receives the text buffer
+// size every string result would have needed, if that is larger than textCapacity some of them weren't copied.
+uint32_t evaluateMemberBatch(const MemberBatchPath* pPaths, uint32_t pathCount, const MemberBatchStep* pSteps, uint32_t stepCount,
+	const char* pStrings, uint32_t stringsSize, MemberBatchResult* pResults, char* pText, uint32_t textCapacity, uint32_t* pTextSize);
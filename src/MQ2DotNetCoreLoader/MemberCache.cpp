@@ -0,0 +1,157 @@
+#include "MemberCache.h"
+
+#include <cstring>
+
+namespace
+{
+	inline char foldCharacter(char character)
+	{
+		return (character >= 'A' && character <= 'Z') ? static_cast<char>(character + ('a' - 'A')) : character;
+	}
+
+	// FNV-1a
+	inline uint64_t hashBytes(uint64_t hash, const void* pBytes, size_t length)
+	{
+		const auto pByte = static_cast<const unsigned char*>(pBytes);
+		for (size_t index = 0; index < length; ++index)
+		{
+			hash = (hash ^ pByte[index]) * 1099511628211ull;
+		}
+
+		return hash;
+	}
+}
+
+void MemberCache::SetEnabled(bool isEnabled)
+{
+	m_isEnabled = isEnabled;
+	NextEpoch();
+}
+
+void MemberCache::AddBypass(const char* member)
+{
+	if (member == nullptr || member[0] == '\0')
+	{
+		return;
+	}
+
+	std::string folded(member);
+	for (auto& character : folded)
+	{
+		character = foldCharacter(character);
+	}
+
+	m_bypassedMembers.insert(std::move(folded));
+}
+
+void MemberCache::ClearBypass()
+{
+	m_bypassedMembers.clear();
+}
+
+void MemberCache::NextEpoch()
+{
+	m_entryCount = 0;
+	if (++m_epoch != 0)
+	{
+		return;
+	}
+
+	// Wrapped, make sure nothing from 2^32 pulses ago comes back to life
+	for (auto& slot : m_slots)
+	{
+		slot.Epoch = 0;
+	}
+
+	m_epoch = 1;
+}
+
+void MemberCache::GetStatistics(MemberCacheStatistics* pStatistics) const
+{
+	if (pStatistics == nullptr)
+	{
+		return;
+	}
+
+	pStatistics->Hits = m_hits;
+	pStatistics->Misses = m_misses;
+	pStatistics->Bypassed = m_bypassed;
+	pStatistics->EntryCount = m_entryCount;
+	pStatistics->BypassedMemberCount = static_cast<uint32_t>(m_bypassedMembers.size());
+}
+
+void MemberCache::ResetStatistics()
+{
+	m_hits = 0;
+	m_misses = 0;
+	m_bypassed = 0;
+}
+
+uint64_t MemberCache::hashKey(const void* type, uint64_t data, const char* member, const char* index)
+{
+	uint64_t hash = 14695981039346656037ull;
+	hash = hashBytes(hash, &type, sizeof(type));
+	hash = hashBytes(hash, &data, sizeof(data));
+	hash = hashBytes(hash, member, strlen(member) + 1);
+	return index ? hashBytes(hash, index, strlen(index)) : hash;
+}
+
+bool MemberCache::isBypassed(const char* member) const
+{
+	if (m_bypassedMembers.empty())
+	{
+		return false;
+	}
+
+	m_foldedMember.assign(member);
+	for (auto& character : m_foldedMember)
+	{
+		character = foldCharacter(character);
+	}
+
+	return m_bypassedMembers.count(m_foldedMember) != 0;
+}
+
+const MemberCache::Slot* MemberCache::find(uint64_t hash, const void* type, uint64_t data, const char* member, const char* index) const
+{
+	for (uint32_t probe = 0; probe < MaxProbeCount; ++probe)
+	{
+		const Slot& slot = m_slots[(hash + probe) & (SlotCount - 1)];
+		if (slot.Epoch == m_epoch
+			&& slot.Hash == hash
+			&& slot.Type == type
+			&& slot.Data == data
+			&& slot.Member == member
+			&& slot.Index == (index ? index : ""))
+		{
+			return &slot;
+		}
+	}
+
+	return nullptr;
+}
+
+void MemberCache::store(uint64_t hash, const void* type, uint64_t data, bool isSuccess, const Value& value)
+{
+	// Take the first free (or stale) slot in the probe range, if they're all in use this pulse overwrite the first one
+	Slot* pSlot = &m_slots[hash & (SlotCount - 1)];
+	for (uint32_t probe = 0; probe < MaxProbeCount; ++probe)
+	{
+		Slot& slot = m_slots[(hash + probe) & (SlotCount - 1)];
+		if (slot.Epoch != m_epoch)
+		{
+			pSlot = &slot;
+			++m_entryCount;
+			break;
+		}
+	}
+
+	pSlot->Epoch = m_epoch;
+	pSlot->IsSuccess = isSuccess;
+	pSlot->Hash = hash;
+	pSlot->Type = type;
+	pSlot->Data = data;
+	pSlot->Member.swap(m_keyMember);
+	pSlot->Index.swap(m_keyIndex);
+	pSlot->Result = value;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Layout is mirrored by MQ2DotNetCore.Interop.MemberCacheStatistics, keep them in sync
+struct MemberCacheStatistics
+{
+	uint64_t Hits;
+	uint64_t Misses;
+	uint64_t Bypassed;
+	uint32_t EntryCount;
+	uint32_t BypassedMemberCount;
+};
+
+// Memoizes TLO and member reads for the rest of the pulse. Game state doesn't change while the plugins are running, so every
+// read of e.g. Me.PctHPs after the first one in a pulse is a wasted GetMember call. Entries are keyed by (type, data, member,
+// index), with a null type for TLOs, and live in a fixed size open addressed table. Clearing is an epoch bump, entries from an
+// older epoch are treated as empty, so the per pulse cost doesn't depend on how much was cached. Members whose value can
+// change from one call to the next (e.g. Math.Rand) are registered as bypassed and always read through. Off by default. Not
+// thread safe, it is only touched from the EQ thread.
+//
+// Like the expression plans this doesn't depend on MQ2 so it can be benchmarked on its own. Values are an opaque copy of an
+// MQ2TYPEVAR.
+class MemberCache
+{
+public:
+	struct Value
+	{
+		void* Type;
+		uint64_t Data;
+	};
+
+	// Called before a value is stored, e.g. to copy strings out of MQ2's shared temporary buffers. Returning false skips
+	// caching the value.
+	using PinValue = bool(*)(Value& value);
+
+	static const uint32_t SlotCount = 4096;
+	static const uint32_t MaxProbeCount = 8;
+
+	explicit MemberCache(PinValue pinValue) : m_pinValue(pinValue), m_slots(SlotCount) {}
+
+	bool IsEnabled() const { return m_isEnabled; }
+	void SetEnabled(bool isEnabled);
+
+	// Member (or TLO) names that are never cached, matched case insensitively like MQ2 does
+	void AddBypass(const char* member);
+	void ClearBypass();
+
+	// Drops every entry, called at the start of each pulse and whenever game state may have changed mid pulse
+	void NextEpoch();
+
+	// Returns the cached result for the key if there is one, otherwise calls read(Value&) and caches what it returns. index may
+	// be modified by read, like MQ2's GetMember, so the key is copied first.
+	template<typename Read>
+	bool Get(const void* type, uint64_t data, const char* member, const char* index, Value& value, Read read)
+	{
+		if (!m_isEnabled || member == nullptr)
+		{
+			return read(value);
+		}
+
+		if (isBypassed(member))
+		{
+			++m_bypassed;
+			return read(value);
+		}
+
+		const uint64_t hash = hashKey(type, data, member, index);
+		if (const Slot* pSlot = find(hash, type, data, member, index))
+		{
+			++m_hits;
+			value = pSlot->Result;
+			return pSlot->IsSuccess;
+		}
+
+		++m_misses;
+		m_keyMember.assign(member);
+		m_keyIndex.assign(index ? index : "");
+
+		const bool isSuccess = read(value);
+		Value pinnedValue = value;
+		if (isSuccess && m_pinValue && !m_pinValue(pinnedValue))
+		{
+			return isSuccess;
+		}
+
+		store(hash, type, data, isSuccess, pinnedValue);
+		value = pinnedValue;
+		return isSuccess;
+	}
+
+	void GetStatistics(MemberCacheStatistics* pStatistics) const;
+	void ResetStatistics();
+
+private:
+	struct Slot
+	{
+		uint32_t Epoch{ 0 };
+		bool IsSuccess{ false };
+		uint64_t Hash{ 0 };
+		const void* Type{ nullptr };
+		uint64_t Data{ 0 };
+		std::string Member;
+		std::string Index;
+		Value Result{};
+	};
+
+	static uint64_t hashKey(const void* type, uint64_t data, const char* member, const char* index);
+	bool isBypassed(const char* member) const;
+	const Slot* find(uint64_t hash, const void* type, uint64_t data, const char* member, const char* index) const;
+	void store(uint64_t hash, const void* type, uint64_t data, bool isSuccess, const Value& value);
+
+	PinValue m_pinValue;
+	bool m_isEnabled{ false };
+	uint32_t m_epoch{ 1 };
+	uint32_t m_entryCount{ 0 };
+	std::vector<Slot> m_slots;
+	std::unordered_set<std::string> m_bypassedMembers;
+	std::string m_keyMember;
+	std::string m_keyIndex;
+	mutable std::string m_foldedMember;
+
+	uint64_t m_hits{ 0 };
+	uint64_t m_misses{ 0 };
+	uint64_t m_bypassed{ 0 };
+};
+
+extern MemberCache g_memberCache;
@@ -0,0 +1,49 @@
+#include "PulseArena.h"
+
+PulseArena g_pulseArena;
+
+char* PulseArena::Allocate(size_t size)
+{
+	if (size == 0 || size > ChunkSize)
+	{
+		return nullptr;
+	}
+
+	if (m_chunks.empty() || m_chunkUsed + size > ChunkSize)
+	{
+		const size_t nextChunkIndex = m_chunks.empty() ? 0 : m_chunkIndex + 1;
+		if ((nextChunkIndex + 1) * ChunkSize > MaxSize)
+		{
+			return nullptr;
+		}
+
+		if (nextChunkIndex == m_chunks.size())
+		{
+			m_chunks.emplace_back(new char[ChunkSize]);
+		}
+
+		m_chunkIndex = nextChunkIndex;
+		m_chunkUsed = 0;
+	}
+
+	char* pAllocation = m_chunks[m_chunkIndex].get() + m_chunkUsed;
+	m_chunkUsed += (size + 7) & ~static_cast<size_t>(7);
+	if (m_chunkUsed > ChunkSize)
+	{
+		m_chunkUsed = ChunkSize;
+	}
+
+	const size_t usedSize = GetUsedSize();
+	if (usedSize > m_highWaterMark)
+	{
+		m_highWaterMark = usedSize;
+	}
+
+	return pAllocation;
+}
+
+void PulseArena::Reset()
+{
+	m_chunkIndex = 0;
+	m_chunkUsed = 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Bump allocator for results handed to the managed side that only need to live until the next pulse, e.g. strings read with
+// the *Arena exports. Reset at the start of every OnPulse, chunks are kept so steady state allocates nothing. Not thread safe,
+// it is only touched from the EQ thread.
+class PulseArena
+{
+public:
+	static const size_t ChunkSize = 64 * 1024;
+
+	// Allocations fail once this much is in use, e.g. if the arena is used while pulses aren't happening
+	static const size_t MaxSize = 4 * 1024 * 1024;
+
+	// Returns nullptr if size is larger than a chunk or the arena is full
+	char* Allocate(size_t size);
+	void Reset();
+
+	size_t GetUsedSize() const { return m_chunkIndex * ChunkSize + m_chunkUsed; }
+	size_t GetHighWaterMark() const { return m_highWaterMark; }
+
+private:
+	std::vector<std::unique_ptr<char[]>> m_chunks;
+	size_t m_chunkIndex{ 0 };
+	size_t m_chunkUsed{ 0 };
+	size_t m_highWaterMark{ 0 };
+};
+
+extern PulseArena g_pulseArena;
@@ -0,0 +1,78 @@
+#include "RuntimeProfile.h"
+
+#include <cstdio>
+
+RuntimeProfile g_runtimeProfile;
+
+namespace
+{
+	enum class RuntimeSettingKind
+	{
+		Boolean,
+		Number,
+		Megabytes
+	};
+
+	struct RuntimeSetting
+	{
+		const char* Key;
+		const char_t* Property;
+		RuntimeSettingKind Kind;
+	};
+
+	// TieredPGO needs .NET 6 or later, 3.1 ignores it
+	const RuntimeSetting RuntimeSettings[] = {
+		{ "GCServer", LOADER_TEXT("System.GC.Server"), RuntimeSettingKind::Boolean },
+		{ "GCConcurrent", LOADER_TEXT("System.GC.Concurrent"), RuntimeSettingKind::Boolean },
+		{ "GCRetainVM", LOADER_TEXT("System.GC.RetainVM"), RuntimeSettingKind::Boolean },
+		{ "GCNoAffinitize", LOADER_TEXT("System.GC.NoAffinitize"), RuntimeSettingKind::Boolean },
+		{ "GCHeapCount", LOADER_TEXT("System.GC.HeapCount"), RuntimeSettingKind::Number },
+		{ "GCHeapHardLimitMegabytes", LOADER_TEXT("System.GC.HeapHardLimit"), RuntimeSettingKind::Megabytes },
+		{ "TieredCompilation", LOADER_TEXT("System.Runtime.TieredCompilation"), RuntimeSettingKind::Boolean },
+		{ "TieredCompilationQuickJit", LOADER_TEXT("System.Runtime.TieredCompilation.QuickJit"), RuntimeSettingKind::Boolean },
+		{ "TieredCompilationQuickJitForLoops", LOADER_TEXT("System.Runtime.TieredCompilation.QuickJitForLoops"), RuntimeSettingKind::Boolean },
+		{ "TieredPGO", LOADER_TEXT("System.Runtime.TieredPGO"), RuntimeSettingKind::Boolean }
+	};
+	static_assert(sizeof(RuntimeSettings) / sizeof(RuntimeSettings[0]) <= RuntimeProfile::MaxPropertyCount, "RuntimeProfile::MaxPropertyCount is too small");
+}
+
+void RuntimeProfile::Read(const char_t* settingsPath)
+{
+	m_propertyCount = 0;
+	for (const auto& setting : RuntimeSettings)
+	{
+		// Settings are never negative, -1 means the setting isn't in the section
+		const int value = readLoaderSetting(settingsPath, "Runtime", setting.Key, -1);
+		if (value < 0)
+			continue;
+
+		// Numbers are passed as hex, which the runtime reads whether it parses them with a base of 0 or 16
+		char formatted[24];
+		switch (setting.Kind)
+		{
+		case RuntimeSettingKind::Boolean: snprintf(formatted, sizeof(formatted), "%s", value != 0 ? "true" : "false"); break;
+		case RuntimeSettingKind::Number: snprintf(formatted, sizeof(formatted), "0x%x", static_cast<unsigned int>(value)); break;
+		case RuntimeSettingKind::Megabytes: snprintf(formatted, sizeof(formatted), "0x%llx", static_cast<unsigned long long>(value) * 1024 * 1024); break;
+		}
+
+		add(setting.Property, formatted);
+	}
+}
+
+void RuntimeProfile::add(const char_t* name, const char* value)
+{
+	if (m_propertyCount == MaxPropertyCount)
+		return;
+
+	// Values are ASCII, widening them is a copy
+	RuntimeProperty& property = m_properties[m_propertyCount++];
+	property.Name = name;
+
+	size_t length = 0;
+	for (; value[length] != '\0' && length + 1 < sizeof(property.Value) / sizeof(property.Value[0]); ++length)
+	{
+		property.Value[length] = static_cast<char_t>(value[length]);
+	}
+
+	property.Value[length] = 0;
+}
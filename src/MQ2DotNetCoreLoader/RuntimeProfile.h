@@ -0,0 +1,35 @@
+#pragma once
+
+#include "LoaderPlatform.h"
+
+#include <cstdint>
+
+// A runtime property as hostfxr_set_runtime_property_value takes it, e.g. System.GC.Concurrent = false
+struct RuntimeProperty
+{
+	const char_t* Name;
+	char_t Value[24];
+};
+
+// The [Runtime] section of MQ2DotNetCoreLoader.ini as runtime properties, set on the hostfxr context before the runtime starts.
+// They override MQ2DotNetCore.runtimeconfig.json, so the GC and JIT can be tuned per machine without editing the build output.
+// Settings that aren't in the section keep the runtimeconfig's value, or the runtime's default. Only takes effect when the
+// runtime is started, not when a running one is reused.
+class RuntimeProfile
+{
+public:
+	static const uint32_t MaxPropertyCount = 16;
+
+	void Read(const char_t* settingsPath);
+
+	uint32_t GetPropertyCount() const { return m_propertyCount; }
+	const RuntimeProperty* GetProperties() const { return m_properties; }
+
+private:
+	void add(const char_t* name, const char* value);
+
+	RuntimeProperty m_properties[MaxPropertyCount]{};
+	uint32_t m_propertyCount{ 0 };
+};
+
+extern RuntimeProfile g_runtimeProfile;
@@ -0,0 +1,486 @@
+#include "SharedStateBus.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+#else
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#endif
+
+SharedStateBus g_sharedStateBus;
+
+namespace
+{
+	enum class RegionState : uint32_t
+	{
+		Uninitialized = 0,
+		Initializing = 1,
+		Ready = 2
+	};
+
+	int64_t nowNanoseconds()
+	{
+		// steady_clock is CLOCK_MONOTONIC / QueryPerformanceCounter, both are the same for every process on the machine
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	uint32_t currentProcessId()
+	{
+#ifdef _WIN32
+		return static_cast<uint32_t>(::GetCurrentProcessId());
+#else
+		return static_cast<uint32_t>(getpid());
+#endif
+	}
+
+	void copyName(char* pDestination, size_t capacity, const char* name)
+	{
+		size_t length = 0;
+		if (name)
+		{
+			while (length + 1 < capacity && name[length] != '\0')
+			{
+				++length;
+			}
+
+			memcpy(pDestination, name, length);
+		}
+
+		memset(pDestination + length, 0, capacity - length);
+	}
+}
+
+// Every field other than the atomics is only written before State becomes Ready
+struct SharedStateBus::Header
+{
+	std::atomic<uint32_t> State;
+	uint32_t Version;
+	uint32_t InstanceCapacity;
+	uint32_t StateCapacity;
+	uint32_t RingCapacity;
+	uint32_t MessageSize;
+
+	alignas(64) std::atomic<uint64_t> WritePosition;
+};
+
+struct alignas(64) SharedStateBus::InstanceSlot
+{
+	// Process id of the owner, 0 while the slot is free
+	std::atomic<uint32_t> OwnerId;
+
+	// Odd while the owner is writing the name or state
+	std::atomic<uint32_t> Sequence;
+	std::atomic<int64_t> HeartbeatNanoseconds;
+	std::atomic<uint64_t> PublishCount;
+	uint32_t StateSize;
+	char Name[64];
+	uint8_t State[StateCapacity];
+};
+
+struct SharedStateBus::MessageCell
+{
+	// 2 * position + 1 while the message for that position is being written, 2 * position + 2 once it's published
+	std::atomic<uint64_t> Stamp;
+	SharedStateMessage Message;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+	"The atomics live in memory shared between processes, so they have to be lock free");
+
+SharedStateBus::~SharedStateBus()
+{
+	Close();
+}
+
+size_t SharedStateBus::getSlotsOffset()
+{
+	return (sizeof(Header) + 63) / 64 * 64;
+}
+
+SharedStateBus::InstanceSlot* SharedStateBus::getSlot(uint32_t instanceIndex) const
+{
+	return reinterpret_cast<InstanceSlot*>(reinterpret_cast<char*>(m_pHeader) + getSlotsOffset()) + instanceIndex;
+}
+
+SharedStateBus::MessageCell* SharedStateBus::getCell(uint64_t position) const
+{
+	const auto pCells = reinterpret_cast<MessageCell*>(reinterpret_cast<char*>(m_pHeader) + getSlotsOffset() + sizeof(InstanceSlot) * InstanceCapacity);
+	return pCells + (position & (RingCapacity - 1));
+}
+
+bool SharedStateBus::Open(const char* name, const char* instanceName)
+{
+	if (IsOpen())
+		return true;
+
+	if (name == nullptr || name[0] == '\0')
+		return false;
+
+	m_mappingSize = getSlotsOffset() + sizeof(InstanceSlot) * InstanceCapacity + sizeof(MessageCell) * RingCapacity;
+
+#ifdef _WIN32
+	char mappingName[128];
+	snprintf(mappingName, sizeof(mappingName), "Local\\%s", name);
+
+	// Created zero filled
+	const HANDLE mappingHandle = ::CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(m_mappingSize), mappingName);
+	if (mappingHandle == nullptr)
+		return false;
+
+	void* pView = ::MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, m_mappingSize);
+	if (pView == nullptr)
+	{
+		::CloseHandle(mappingHandle);
+		return false;
+	}
+
+	m_mappingHandle = mappingHandle;
+#else
+	char mappingName[128];
+	snprintf(mappingName, sizeof(mappingName), "/%s", name);
+
+	const int descriptor = shm_open(mappingName, O_CREAT | O_RDWR, 0600);
+	if (descriptor < 0)
+		return false;
+
+	// Growing a new (empty) object zero fills it, every instance asks for the same size
+	void* pView = ftruncate(descriptor, static_cast<off_t>(m_mappingSize)) == 0
+		? mmap(nullptr, m_mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0)
+		: MAP_FAILED;
+	close(descriptor);
+
+	if (pView == MAP_FAILED)
+		return false;
+#endif
+
+	m_pHeader = static_cast<Header*>(pView);
+
+	uint32_t expected = static_cast<uint32_t>(RegionState::Uninitialized);
+	if (m_pHeader->State.compare_exchange_strong(expected, static_cast<uint32_t>(RegionState::Initializing), std::memory_order_acq_rel))
+	{
+		m_pHeader->Version = Version;
+		m_pHeader->InstanceCapacity = InstanceCapacity;
+		m_pHeader->StateCapacity = StateCapacity;
+		m_pHeader->RingCapacity = RingCapacity;
+		m_pHeader->MessageSize = sizeof(SharedStateMessage);
+		m_pHeader->State.store(static_cast<uint32_t>(RegionState::Ready), std::memory_order_release);
+	}
+	else
+	{
+		// Another instance is setting the region up, it only has a few fields to write
+		for (int attempt = 0; attempt < 1000 && m_pHeader->State.load(std::memory_order_acquire) != static_cast<uint32_t>(RegionState::Ready); ++attempt)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	const bool isCompatible = m_pHeader->State.load(std::memory_order_acquire) == static_cast<uint32_t>(RegionState::Ready)
+		&& m_pHeader->Version == Version
+		&& m_pHeader->InstanceCapacity == InstanceCapacity
+		&& m_pHeader->StateCapacity == StateCapacity
+		&& m_pHeader->RingCapacity == RingCapacity
+		&& m_pHeader->MessageSize == sizeof(SharedStateMessage);
+
+	m_processId = currentProcessId();
+	copyName(m_instanceName, sizeof(m_instanceName), instanceName);
+	if (!isCompatible || !claimSlot(m_instanceName))
+	{
+		Close();
+		return false;
+	}
+
+	// Only messages sent from now on
+	m_readPosition = m_pHeader->WritePosition.load(std::memory_order_acquire);
+	return true;
+}
+
+bool SharedStateBus::claimSlot(const char* instanceName)
+{
+	const int64_t now = nowNanoseconds();
+	for (uint32_t instanceIndex = 0; instanceIndex < InstanceCapacity; ++instanceIndex)
+	{
+		InstanceSlot* pSlot = getSlot(instanceIndex);
+		uint32_t ownerId = pSlot->OwnerId.load(std::memory_order_acquire);
+
+		// Slots of instances that stopped heartbeating (e.g. crashed clients) are taken over
+		const bool isStale = ownerId != 0 && now - pSlot->HeartbeatNanoseconds.load(std::memory_order_relaxed) > StaleAfterMilliseconds * 1000000;
+		if (ownerId != 0 && !isStale)
+			continue;
+
+		if (!pSlot->OwnerId.compare_exchange_strong(ownerId, m_processId, std::memory_order_acq_rel))
+			continue;
+
+		m_instanceIndex = static_cast<int32_t>(instanceIndex);
+		pSlot->HeartbeatNanoseconds.store(now, std::memory_order_relaxed);
+		pSlot->PublishCount.store(0, std::memory_order_relaxed);
+
+		const uint32_t sequence = pSlot->Sequence.load(std::memory_order_relaxed);
+		pSlot->Sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		pSlot->StateSize = 0;
+		copyName(pSlot->Name, sizeof(pSlot->Name), instanceName);
+		pSlot->Sequence.store(sequence + 2, std::memory_order_release);
+		return true;
+	}
+
+	return false;
+}
+
+// Another instance takes the slot over once this one's heartbeat is stale, e.g. after the client was suspended for a while.
+// Checked before writing to the slot so this instance never writes over the new owner's state.
+bool SharedStateBus::ensureSlot()
+{
+	if (!IsOpen())
+		return false;
+
+	if (m_instanceIndex >= 0)
+	{
+		if (getSlot(static_cast<uint32_t>(m_instanceIndex))->OwnerId.load(std::memory_order_acquire) == m_processId)
+			return true;
+
+		++m_lostSlotCount;
+		m_instanceIndex = -1;
+	}
+
+	return claimSlot(m_instanceName);
+}
+
+void SharedStateBus::Close()
+{
+	if (!IsOpen())
+		return;
+
+	if (m_instanceIndex >= 0)
+	{
+		uint32_t ownerId = m_processId;
+		getSlot(static_cast<uint32_t>(m_instanceIndex))->OwnerId.compare_exchange_strong(ownerId, 0, std::memory_order_acq_rel);
+	}
+
+#ifdef _WIN32
+	::UnmapViewOfFile(m_pHeader);
+	::CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+#else
+	munmap(m_pHeader, m_mappingSize);
+#endif
+
+	m_pHeader = nullptr;
+	m_mappingHandle = nullptr;
+	m_instanceIndex = -1;
+}
+
+void SharedStateBus::SetInstanceName(const char* instanceName)
+{
+	copyName(m_instanceName, sizeof(m_instanceName), instanceName);
+	if (!ensureSlot())
+		return;
+
+	InstanceSlot* pSlot = getSlot(static_cast<uint32_t>(m_instanceIndex));
+	const uint32_t sequence = pSlot->Sequence.load(std::memory_order_relaxed);
+	pSlot->Sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	copyName(pSlot->Name, sizeof(pSlot->Name), instanceName);
+	pSlot->Sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool SharedStateBus::Publish(const void* pState, uint32_t size)
+{
+	if (size > StateCapacity || (pState == nullptr && size > 0) || !ensureSlot())
+		return false;
+
+	InstanceSlot* pSlot = getSlot(static_cast<uint32_t>(m_instanceIndex));
+	const uint32_t sequence = pSlot->Sequence.load(std::memory_order_relaxed);
+	pSlot->Sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	if (size > 0)
+		memcpy(pSlot->State, pState, size);
+
+	pSlot->StateSize = size;
+	pSlot->Sequence.store(sequence + 2, std::memory_order_release);
+
+	pSlot->PublishCount.fetch_add(1, std::memory_order_relaxed);
+	pSlot->HeartbeatNanoseconds.store(nowNanoseconds(), std::memory_order_relaxed);
+	++m_publishedCount;
+	return true;
+}
+
+void SharedStateBus::Heartbeat()
+{
+	if (ensureSlot())
+		getSlot(static_cast<uint32_t>(m_instanceIndex))->HeartbeatNanoseconds.store(nowNanoseconds(), std::memory_order_relaxed);
+}
+
+bool SharedStateBus::GetInstance(uint32_t instanceIndex, SharedStateInstanceInfo* pInfo) const
+{
+	if (!IsOpen() || instanceIndex >= InstanceCapacity || pInfo == nullptr)
+		return false;
+
+	const InstanceSlot* pSlot = getSlot(instanceIndex);
+	pInfo->ProcessId = pSlot->OwnerId.load(std::memory_order_acquire);
+	if (pInfo->ProcessId == 0)
+		return false;
+
+	for (int attempt = 0; attempt < 16; ++attempt)
+	{
+		const uint32_t sequence = pSlot->Sequence.load(std::memory_order_acquire);
+		if (sequence & 1)
+			continue;
+
+		pInfo->StateSize = pSlot->StateSize;
+		memcpy(pInfo->Name, pSlot->Name, sizeof(pInfo->Name));
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (pSlot->Sequence.load(std::memory_order_relaxed) == sequence)
+			break;
+	}
+
+	pInfo->Name[sizeof(pInfo->Name) - 1] = '\0';
+	pInfo->PublishCount = pSlot->PublishCount.load(std::memory_order_relaxed);
+	pInfo->AgeMicroseconds = (nowNanoseconds() - pSlot->HeartbeatNanoseconds.load(std::memory_order_relaxed)) / 1000;
+	return true;
+}
+
+int32_t SharedStateBus::ReadState(uint32_t instanceIndex, void* pDestination, uint32_t capacity)
+{
+	if (!IsOpen() || instanceIndex >= InstanceCapacity || pDestination == nullptr)
+		return -1;
+
+	const InstanceSlot* pSlot = getSlot(instanceIndex);
+	if (pSlot->OwnerId.load(std::memory_order_acquire) == 0)
+		return -1;
+
+	// The publisher never waits for readers, so a read that overlaps a publish just tries again
+	for (int attempt = 0; attempt < 16; ++attempt)
+	{
+		const uint32_t sequence = pSlot->Sequence.load(std::memory_order_acquire);
+		if (sequence & 1)
+			continue;
+
+		const uint32_t size = pSlot->StateSize;
+		if (size > StateCapacity)
+			continue;
+
+		if (size > capacity)
+			return -1;
+
+		memcpy(pDestination, pSlot->State, size);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (pSlot->Sequence.load(std::memory_order_relaxed) == sequence)
+			return static_cast<int32_t>(size);
+	}
+
+	++m_tornReadCount;
+	return -1;
+}
+
+bool SharedStateBus::Send(int32_t targetIndex, uint32_t messageType, const void* pPayload, uint32_t size)
+{
+	// The slot is checked too since receivers take the sender index for the slot's owner
+	if (size > MessagePayloadCapacity || (pPayload == nullptr && size > 0) || !ensureSlot())
+		return false;
+
+	const uint64_t position = m_pHeader->WritePosition.fetch_add(1, std::memory_order_acq_rel);
+	MessageCell* pCell = getCell(position);
+
+	pCell->Stamp.store(position * 2 + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	pCell->Message.SenderIndex = m_instanceIndex;
+	pCell->Message.TargetIndex = targetIndex < 0 ? -1 : targetIndex;
+	pCell->Message.MessageType = messageType;
+	pCell->Message.Size = size;
+	if (size > 0)
+		memcpy(pCell->Message.Payload, pPayload, size);
+
+	pCell->Stamp.store(position * 2 + 2, std::memory_order_release);
+	++m_sentCount;
+	return true;
+}
+
+uint32_t SharedStateBus::Receive(SharedStateMessage* pMessages, uint32_t capacity)
+{
+	if (!IsOpen() || pMessages == nullptr)
+		return 0;
+
+	const uint64_t writePosition = m_pHeader->WritePosition.load(std::memory_order_acquire);
+	if (writePosition - m_readPosition > RingCapacity)
+	{
+		m_missedCount += writePosition - RingCapacity - m_readPosition;
+		m_readPosition = writePosition - RingCapacity;
+	}
+
+	uint32_t count = 0;
+	while (m_readPosition < writePosition && count < capacity)
+	{
+		const MessageCell* pCell = getCell(m_readPosition);
+		const uint64_t publishedStamp = m_readPosition * 2 + 2;
+		const uint64_t stamp = pCell->Stamp.load(std::memory_order_acquire);
+
+		// Claimed but still being written, the rest waits for the next call so messages stay in order. A sender that died before
+		// publishing it would hold every reader up, so a message that stays pending for too long is skipped.
+		if (stamp < publishedStamp)
+		{
+			const int64_t now = nowNanoseconds();
+			if (m_pendingPosition != m_readPosition)
+			{
+				m_pendingPosition = m_readPosition;
+				m_pendingSinceNanoseconds = now;
+			}
+
+			if (now - m_pendingSinceNanoseconds < AbandonedAfterMilliseconds * 1000000)
+				break;
+
+			++m_readPosition;
+			++m_missedCount;
+			continue;
+		}
+
+		++m_readPosition;
+		if (stamp > publishedStamp)
+		{
+			++m_missedCount;
+			continue;
+		}
+
+		SharedStateMessage& message = pMessages[count];
+		message = pCell->Message;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (pCell->Stamp.load(std::memory_order_relaxed) != publishedStamp || message.Size > MessagePayloadCapacity)
+		{
+			++m_missedCount;
+			continue;
+		}
+
+		if (message.SenderIndex == m_instanceIndex || (message.TargetIndex >= 0 && message.TargetIndex != m_instanceIndex))
+			continue;
+
+		++count;
+	}
+
+	m_receivedCount += count;
+	return count;
+}
+
+void SharedStateBus::GetStatistics(SharedStateBusStatistics* pStatistics) const
+{
+	if (pStatistics == nullptr)
+		return;
+
+	pStatistics->PublishedCount = m_publishedCount;
+	pStatistics->SentCount = m_sentCount;
+	pStatistics->ReceivedCount = m_receivedCount;
+	pStatistics->MissedCount = m_missedCount;
+	pStatistics->TornReadCount = m_tornReadCount;
+	pStatistics->LostSlotCount = m_lostSlotCount;
+	pStatistics->InstanceIndex = m_instanceIndex;
+	pStatistics->InstanceCapacity = InstanceCapacity;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Layout is mirrored by MQ2DotNetCore.MQ2Api.StateBusInstance, keep them in sync
+struct SharedStateInstanceInfo
+{
+	uint32_t ProcessId;
+	uint32_t StateSize;
+	uint64_t PublishCount;
+
+	// Since the instance last published or pulsed
+	int64_t AgeMicroseconds;
+	char Name[64];
+};
+
+// Layout is mirrored by MQ2DotNetCore.MQ2Api.StateBusMessage, keep them in sync
+struct SharedStateMessage
+{
+	int32_t SenderIndex;
+
+	// -1 for broadcasts
+	int32_t TargetIndex;
+	uint32_t MessageType;
+	uint32_t Size;
+	uint8_t Payload[232];
+};
+
+// Layout is mirrored by MQ2DotNetCore.Interop.SharedStateBusStatistics, keep them in sync
+struct SharedStateBusStatistics
+{
+	uint64_t PublishedCount;
+	uint64_t SentCount;
+	uint64_t ReceivedCount;
+
+	// Messages overwritten before this instance read them
+	uint64_t MissedCount;
+
+	// State reads that kept racing the publisher and gave up
+	uint64_t TornReadCount;
+
+	// Times another instance took this one's slot over (its heartbeat went stale) and a new slot had to be claimed
+	uint64_t LostSlotCount;
+	int32_t InstanceIndex;
+	uint32_t InstanceCapacity;
+};
+
+// A named shared memory region that the clients on one machine use to share state without going through chat. Every instance
+// claims one of InstanceCapacity slots and publishes its state (an opaque blob of up to StateCapacity bytes) into it, guarded
+// by a per slot sequence lock, so readers in other processes copy a consistent state without taking a lock or making the
+// publisher wait. Messages go through a broadcast ring: any instance appends (claiming a cell with one fetch_add), every
+// instance reads it with its own cursor, and one that falls more than RingCapacity messages behind skips ahead and counts
+// what it missed. Nothing ever blocks, so a stalled or crashed client can't hang the others: its slot is reused once its
+// heartbeat is older than StaleAfterMilliseconds, and a message it claimed but never finished writing is skipped once it has
+// been pending for AbandonedAfterMilliseconds. A client that was only stalled notices its slot was taken over the next time it
+// publishes or heartbeats and claims another one.
+//
+// CreateFileMapping on Windows, shm_open / mmap everywhere else. The region is left behind when the last instance closes so
+// a client that starts later finds the same layout. Within a process the bus is only used from the EQ thread.
+class SharedStateBus
+{
+public:
+	static const uint32_t Version = 1;
+	static const uint32_t InstanceCapacity = 16;
+	static const uint32_t StateCapacity = 256;
+	static const uint32_t RingCapacity = 1024; // Must be a power of two
+	static const uint32_t MessagePayloadCapacity = sizeof(SharedStateMessage::Payload);
+	static const int64_t StaleAfterMilliseconds = 15000;
+	static const int64_t AbandonedAfterMilliseconds = 1000;
+
+	SharedStateBus() = default;
+	~SharedStateBus();
+
+	SharedStateBus(const SharedStateBus&) = delete;
+	SharedStateBus& operator=(const SharedStateBus&) = delete;
+
+	// Maps (creating it if needed) the region and claims a slot. False if the region can't be mapped, has a different layout
+	// or every slot is taken.
+	bool Open(const char* name, const char* instanceName);
+
+	// Frees the slot and unmaps the region
+	void Close();
+
+	bool IsOpen() const { return m_pHeader != nullptr; }
+	int32_t GetInstanceIndex() const { return m_instanceIndex; }
+
+	void SetInstanceName(const char* instanceName);
+
+	// Copies the state into this instance's slot, false if it's too large, the bus isn't open or the slot was taken over and
+	// there's no free one left to claim
+	bool Publish(const void* pState, uint32_t size);
+
+	// Keeps the slot from being reclaimed while the instance has nothing new to publish
+	void Heartbeat();
+
+	// False if the slot isn't claimed
+	bool GetInstance(uint32_t instanceIndex, SharedStateInstanceInfo* pInfo) const;
+
+	// Copies the instance's last published state, returns its size or -1 if the slot isn't claimed, the destination is too
+	// small or the read kept racing the publisher
+	int32_t ReadState(uint32_t instanceIndex, void* pDestination, uint32_t capacity);
+
+	// targetIndex -1 broadcasts to every other instance, false if the payload is too large, the bus isn't open or this instance
+	// has no slot
+	bool Send(int32_t targetIndex, uint32_t messageType, const void* pPayload, uint32_t size);
+
+	// Copies messages sent to this instance (or broadcast) since the last call, oldest first. Returns the number copied.
+	uint32_t Receive(SharedStateMessage* pMessages, uint32_t capacity);
+
+	void GetStatistics(SharedStateBusStatistics* pStatistics) const;
+
+private:
+	struct Header;
+	struct InstanceSlot;
+	struct MessageCell;
+
+	static size_t getSlotsOffset();
+	InstanceSlot* getSlot(uint32_t instanceIndex) const;
+	MessageCell* getCell(uint64_t position) const;
+	bool claimSlot(const char* instanceName);
+	bool ensureSlot();
+
+	Header* m_pHeader{ nullptr };
+	size_t m_mappingSize{ 0 };
+	void* m_mappingHandle{ nullptr };
+	int32_t m_instanceIndex{ -1 };
+	uint32_t m_processId{ 0 };
+
+	// Kept to claim a new slot with if this one's is taken over
+	char m_instanceName[64]{};
+
+	// Position of the next message this instance reads, and when Receive first found it claimed but not yet published
+	uint64_t m_readPosition{ 0 };
+	uint64_t m_pendingPosition{ UINT64_MAX };
+	int64_t m_pendingSinceNanoseconds{ 0 };
+
+	uint64_t m_publishedCount{ 0 };
+	uint64_t m_sentCount{ 0 };
+	uint64_t m_receivedCount{ 0 };
+	uint64_t m_missedCount{ 0 };
+	uint64_t m_tornReadCount{ 0 };
+	uint64_t m_lostSlotCount{ 0 };
+};
+
+extern SharedStateBus g_sharedStateBus;
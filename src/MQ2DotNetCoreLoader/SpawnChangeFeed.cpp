@@ -0,0 +1,177 @@
+#include "SpawnChangeFeed.h"
+
+SpawnChangeFeed g_spawnChangeFeed;
+
+void SpawnChangeFeed::SetTrackedFields(uint32_t trackedFields)
+{
+	const bool wasEnabled = IsEnabled();
+	m_trackedFields = trackedFields & SpawnChangeFieldAll;
+
+	if (!IsEnabled())
+	{
+		Clear();
+		return;
+	}
+
+	if (!wasEnabled && pSpawnManager)
+	{
+		for (auto pSpawn = ((PSPAWNMANAGER)pSpawnManager)->FirstSpawn; pSpawn; pSpawn = pSpawn->pNext)
+		{
+			Add(pSpawn);
+		}
+	}
+}
+
+void SpawnChangeFeed::capture(PSPAWNINFO pSpawn, SpawnChange& change) const
+{
+	change.SpawnId = pSpawn->SpawnID;
+	change.X = pSpawn->X;
+	change.Y = pSpawn->Y;
+	change.Z = pSpawn->Z;
+	change.Heading = pSpawn->Heading * 0.703125f; // 512 units per circle
+	change.TargetOfTargetId = static_cast<uint32_t>(pSpawn->TargetOfTarget);
+	change.HPPercent = getSpawnHPPercent(pSpawn);
+	change.Level = static_cast<uint8_t>(pSpawn->Level);
+	change.Type = static_cast<uint8_t>(pSpawn->Type);
+	change.StandState = static_cast<uint8_t>(pSpawn->StandState);
+}
+
+void SpawnChangeFeed::queue(const SpawnChange& change)
+{
+	if (m_pending.size() - m_drainPosition >= MaxPendingChanges)
+	{
+		m_pending.clear();
+		m_drainPosition = 0;
+	}
+
+	m_pending.push_back(change);
+}
+
+void SpawnChangeFeed::Add(PSPAWNINFO pSpawn)
+{
+	if (!IsEnabled() || pSpawn == nullptr || m_idToIndex.count(pSpawn->SpawnID))
+	{
+		return;
+	}
+
+	SpawnChange change{};
+	capture(pSpawn, change);
+
+	m_idToIndex.emplace(pSpawn->SpawnID, static_cast<uint32_t>(m_spawns.size()));
+	m_spawns.push_back(pSpawn);
+	m_previous.push_back(change);
+	m_isNew.push_back(true);
+}
+
+void SpawnChangeFeed::Remove(PSPAWNINFO pSpawn)
+{
+	if (!IsEnabled() || pSpawn == nullptr)
+	{
+		return;
+	}
+
+	auto existing = m_idToIndex.find(pSpawn->SpawnID);
+	if (existing == m_idToIndex.end())
+	{
+		return;
+	}
+
+	// A spawn that comes and goes between two pulses is never published at all
+	const uint32_t index = existing->second;
+	if (!m_isNew[index])
+	{
+		SpawnChange change = m_previous[index];
+		change.ChangedFields = SpawnChangeFieldRemoved;
+		queue(change);
+	}
+
+	const uint32_t lastIndex = static_cast<uint32_t>(m_spawns.size() - 1);
+	if (index != lastIndex)
+	{
+		m_spawns[index] = m_spawns[lastIndex];
+		m_previous[index] = m_previous[lastIndex];
+		m_isNew[index] = m_isNew[lastIndex];
+		m_idToIndex[m_previous[index].SpawnId] = index;
+	}
+
+	m_spawns.pop_back();
+	m_previous.pop_back();
+	m_isNew.pop_back();
+	m_idToIndex.erase(existing);
+}
+
+void SpawnChangeFeed::Clear()
+{
+	m_spawns.clear();
+	m_previous.clear();
+	m_isNew.clear();
+	m_idToIndex.clear();
+	m_pending.clear();
+	m_drainPosition = 0;
+}
+
+void SpawnChangeFeed::Diff()
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+
+	SpawnChange current;
+	for (uint32_t index = 0; index < m_spawns.size(); ++index)
+	{
+		capture(m_spawns[index], current);
+		const auto& previous = m_previous[index];
+
+		uint32_t changedFields = 0;
+		if (m_isNew[index])
+		{
+			changedFields = SpawnChangeFieldAdded;
+			m_isNew[index] = false;
+		}
+		else
+		{
+			if (current.X != previous.X || current.Y != previous.Y || current.Z != previous.Z) changedFields |= SpawnChangeFieldPosition;
+			if (current.Heading != previous.Heading) changedFields |= SpawnChangeFieldHeading;
+			if (current.HPPercent != previous.HPPercent) changedFields |= SpawnChangeFieldHPPercent;
+			if (current.Level != previous.Level) changedFields |= SpawnChangeFieldLevel;
+			if (current.Type != previous.Type) changedFields |= SpawnChangeFieldType;
+			if (current.StandState != previous.StandState) changedFields |= SpawnChangeFieldStandState;
+			if (current.TargetOfTargetId != previous.TargetOfTargetId) changedFields |= SpawnChangeFieldTargetOfTarget;
+
+			changedFields &= m_trackedFields;
+			if (changedFields == 0)
+			{
+				continue;
+			}
+		}
+
+		current.ChangedFields = changedFields;
+		m_previous[index] = current;
+		queue(current);
+	}
+}
+
+uint32_t SpawnChangeFeed::Drain(SpawnChange* pDestination, uint32_t destinationCapacity)
+{
+	if (pDestination == nullptr || destinationCapacity == 0)
+	{
+		return 0;
+	}
+
+	const uint32_t available = static_cast<uint32_t>(m_pending.size()) - m_drainPosition;
+	const uint32_t drainCount = available < destinationCapacity ? available : destinationCapacity;
+	for (uint32_t index = 0; index < drainCount; ++index)
+	{
+		pDestination[index] = m_pending[m_drainPosition + index];
+	}
+
+	m_drainPosition += drainCount;
+	if (m_drainPosition == m_pending.size())
+	{
+		m_pending.clear();
+		m_drainPosition = 0;
+	}
+
+	return drainCount;
+}
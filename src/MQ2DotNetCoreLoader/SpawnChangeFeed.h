@@ -0,0 +1,85 @@
+#pragma once
+
+#include "MQ2DotNetCoreLoader.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Bits for SpawnChange::ChangedFields and the tracked field mask. Mirrored by MQ2DotNetCore.MQ2Api.SpawnChangeFields
+enum SpawnChangeField : uint32_t
+{
+	SpawnChangeFieldNone = 0,
+	SpawnChangeFieldPosition = 0x01,		// X, Y, Z
+	SpawnChangeFieldHeading = 0x02,
+	SpawnChangeFieldHPPercent = 0x04,
+	SpawnChangeFieldLevel = 0x08,
+	SpawnChangeFieldType = 0x10,			// e.g. NPC -> corpse
+	SpawnChangeFieldStandState = 0x20,
+	SpawnChangeFieldTargetOfTarget = 0x40,
+	SpawnChangeFieldAll = 0x7F,
+
+	// Only ever set on records, they can't be tracked / untracked
+	SpawnChangeFieldAdded = 0x40000000,
+	SpawnChangeFieldRemoved = 0x80000000
+};
+
+// A spawn's current values and which of them changed since the previous pulse. Layout is mirrored by
+// MQ2DotNetCore.MQ2Api.SpawnChange, keep them in sync
+struct SpawnChange
+{
+	uint32_t SpawnId;
+	uint32_t ChangedFields;
+	float X;
+	float Y;
+	float Z;
+	float Heading;				// Degrees
+	uint32_t TargetOfTargetId;
+	uint8_t HPPercent;
+	uint8_t Level;
+	uint8_t Type;
+	uint8_t StandState;
+};
+
+// Keeps the previous pulse's values of every spawn and publishes the spawns whose tracked fields changed. Spawns are tracked
+// from OnAddSpawn / OnRemoveSpawn so the per pulse diff walks a flat array instead of looking every spawn up by id.
+class SpawnChangeFeed
+{
+public:
+	// Records that haven't been drained by the time this many are pending are dropped, e.g. when nothing on the managed side is
+	// listening
+	static const uint32_t MaxPendingChanges = 16384;
+
+	bool IsEnabled() const { return m_trackedFields != SpawnChangeFieldNone; }
+	uint32_t GetTrackedFields() const { return m_trackedFields; }
+
+	// Enabling the feed seeds it from the current spawn list, disabling it drops everything
+	void SetTrackedFields(uint32_t trackedFields);
+
+	void Add(PSPAWNINFO pSpawn);
+	void Remove(PSPAWNINFO pSpawn);
+	void Clear();
+
+	// Compares every tracked spawn against the previous pulse and queues a record for each one that changed
+	void Diff();
+
+	// Copies up to destinationCapacity queued records into the destination buffer and returns the number copied
+	uint32_t Drain(SpawnChange* pDestination, uint32_t destinationCapacity);
+
+private:
+	void capture(PSPAWNINFO pSpawn, SpawnChange& change) const;
+	void queue(const SpawnChange& change);
+
+	uint32_t m_trackedFields{ SpawnChangeFieldNone };
+
+	// Tracked spawns, swap removed
+	std::vector<PSPAWNINFO> m_spawns;
+	std::vector<SpawnChange> m_previous;
+	std::vector<bool> m_isNew;
+	std::unordered_map<uint32_t, uint32_t> m_idToIndex;
+
+	std::vector<SpawnChange> m_pending;
+	uint32_t m_drainPosition{ 0 };
+};
+
+extern SpawnChangeFeed g_spawnChangeFeed;
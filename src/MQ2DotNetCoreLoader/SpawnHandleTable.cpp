@@ -0,0 +1,108 @@
+#include "SpawnHandleTable.h"
+
+SpawnHandleTable g_spawnHandleTable;
+
+SpawnHandleTable::SpawnHandleTable()
+{
+	for (auto& slot : m_slots)
+	{
+		slot.Pointer = nullptr;
+		slot.Generation = 1;
+		slot.NextFree = NoSlot;
+	}
+}
+
+uint64_t SpawnHandleTable::Add(void* pointer)
+{
+	if (pointer == nullptr)
+		return 0;
+
+	const auto existing = m_pointerToIndex.find(pointer);
+	if (existing != m_pointerToIndex.end())
+		return MakeHandle(existing->second, m_slots[existing->second].Generation);
+
+	uint32_t index = m_firstFree;
+	if (index != NoSlot)
+	{
+		m_firstFree = m_slots[index].NextFree;
+	}
+	else if (m_usedSlotCount < Capacity)
+	{
+		index = m_usedSlotCount++;
+	}
+	else
+	{
+		++m_overflowCount;
+		return 0;
+	}
+
+	SpawnHandleSlot& slot = m_slots[index];
+	slot.Pointer = pointer;
+	slot.NextFree = NoSlot;
+	m_pointerToIndex.emplace(pointer, index);
+	return MakeHandle(index, slot.Generation);
+}
+
+uint64_t SpawnHandleTable::Remove(void* pointer)
+{
+	const auto existing = m_pointerToIndex.find(pointer);
+	if (existing == m_pointerToIndex.end())
+		return 0;
+
+	const uint32_t index = existing->second;
+	const uint64_t handle = MakeHandle(index, m_slots[index].Generation);
+	m_pointerToIndex.erase(existing);
+	release(index);
+	return handle;
+}
+
+uint64_t SpawnHandleTable::Find(void* pointer) const
+{
+	const auto existing = m_pointerToIndex.find(pointer);
+	return existing == m_pointerToIndex.end() ? 0 : MakeHandle(existing->second, m_slots[existing->second].Generation);
+}
+
+void* SpawnHandleTable::Resolve(uint64_t handle) const
+{
+	const auto index = static_cast<uint32_t>(handle);
+	const auto generation = static_cast<uint32_t>(handle >> 32);
+	if (index >= m_usedSlotCount || m_slots[index].Generation != generation)
+		return nullptr;
+
+	return m_slots[index].Pointer;
+}
+
+void SpawnHandleTable::Clear()
+{
+	for (uint32_t index = 0; index < m_usedSlotCount; ++index)
+	{
+		if (m_slots[index].Pointer != nullptr)
+			release(index);
+	}
+
+	m_pointerToIndex.clear();
+}
+
+void SpawnHandleTable::GetStatistics(SpawnHandleTableStatistics* pStatistics) const
+{
+	if (pStatistics == nullptr)
+		return;
+
+	pStatistics->Capacity = Capacity;
+	pStatistics->Count = static_cast<uint32_t>(m_pointerToIndex.size());
+	pStatistics->UsedSlotCount = m_usedSlotCount;
+	pStatistics->OverflowCount = m_overflowCount;
+}
+
+void SpawnHandleTable::release(uint32_t index)
+{
+	SpawnHandleSlot& slot = m_slots[index];
+	slot.Pointer = nullptr;
+
+	// Skips 0 when it wraps, which would make the slot's first handle look like no handle
+	if (++slot.Generation == 0)
+		slot.Generation = 1;
+
+	slot.NextFree = m_firstFree;
+	m_firstFree = index;
+}
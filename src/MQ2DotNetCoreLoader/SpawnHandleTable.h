@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+// Layout is mirrored by MQ2DotNetCore.Interop.SpawnHandleSlot, keep them in sync
+struct SpawnHandleSlot
+{
+	// The spawn, nullptr while the slot is free
+	void* Pointer;
+
+	// Bumped every time the slot is freed, a handle only resolves while its generation matches
+	uint32_t Generation;
+	uint32_t NextFree;
+};
+
+// Layout is mirrored by MQ2DotNetCore.Interop.SpawnHandleTableStatistics, keep them in sync
+struct SpawnHandleTableStatistics
+{
+	uint32_t Capacity;
+	uint32_t Count;
+	uint32_t UsedSlotCount;
+	uint32_t OverflowCount;
+};
+
+// Gives every spawn in the zone a handle: its slot's index in the low 32 bits and the slot's generation in the high 32. When a
+// spawn is removed its slot's generation is bumped, so handles to it stop resolving even after the slot is reused, and zoning
+// does the same for every slot. The slots are a fixed array the managed side reads directly, resolving a handle is a bounds
+// check and a generation compare. Not thread safe, it is only touched from the EQ thread.
+class SpawnHandleTable
+{
+public:
+	static const uint32_t Capacity = 8192;
+	static const uint32_t NoSlot = 0xFFFFFFFF;
+
+	// Generations start at 1, so 0 is never a valid handle
+	static uint64_t MakeHandle(uint32_t index, uint32_t generation) { return (static_cast<uint64_t>(generation) << 32) | index; }
+
+	SpawnHandleTable();
+
+	// Adding a spawn that already has a handle returns that handle. Returns 0 when every slot is in use.
+	uint64_t Add(void* pointer);
+
+	// Frees the spawn's slot and returns the handle it had, 0 if it didn't have one
+	uint64_t Remove(void* pointer);
+
+	uint64_t Find(void* pointer) const;
+	void* Resolve(uint64_t handle) const;
+
+	// Frees every slot, e.g. when zoning. Generations carry on, so handles from before don't resolve after.
+	void Clear();
+
+	const SpawnHandleSlot* GetSlots() const { return m_slots; }
+
+	// Slots past this have never been handed out
+	uint32_t GetUsedSlotCount() const { return m_usedSlotCount; }
+
+	void GetStatistics(SpawnHandleTableStatistics* pStatistics) const;
+
+private:
+	void release(uint32_t index);
+
+	SpawnHandleSlot m_slots[Capacity];
+	uint32_t m_usedSlotCount{ 0 };
+	uint32_t m_firstFree{ NoSlot };
+	uint32_t m_overflowCount{ 0 };
+	std::unordered_map<void*, uint32_t> m_pointerToIndex;
+};
+
+extern SpawnHandleTable g_spawnHandleTable;
@@ -0,0 +1,142 @@
+#include "MQ2DotNetCoreLoader.h"
+#include "SpawnSnapshot.h"
+
+#include <algorithm>
+
+namespace
+{
+	// SPAWNINFO::Name is a char[64], so reserving this much per spawn means the string table can never overflow
+	const uint32_t MaxNameLength = 64;
+
+	inline uint32_t alignUp(uint32_t value)
+	{
+		return (value + 7) & ~7u;
+	}
+}
+
+uint8_t getSpawnHPPercent(PSPAWNINFO pSpawn)
+{
+	const int64_t current = pSpawn->HPCurrent;
+	const int64_t maximum = pSpawn->HPMax;
+	if (maximum <= 0 || current <= 0)
+	{
+		return 0;
+	}
+
+	return static_cast<uint8_t>(std::min<int64_t>(100, current * 100 / maximum));
+}
+
+void getSpawnSnapshotLayout(uint32_t capacity, SpawnSnapshotLayout* pLayout)
+{
+	if (pLayout == nullptr)
+	{
+		return;
+	}
+
+	uint32_t offset = 0;
+	auto reserve = [&offset, capacity](uint32_t elementSize)
+	{
+		const uint32_t arrayOffset = offset;
+		offset = alignUp(offset + elementSize * capacity);
+		return arrayOffset;
+	};
+
+	pLayout->Capacity = capacity;
+	pLayout->IdsOffset = reserve(sizeof(uint32_t));
+	pLayout->XOffset = reserve(sizeof(float));
+	pLayout->YOffset = reserve(sizeof(float));
+	pLayout->ZOffset = reserve(sizeof(float));
+	pLayout->HeadingsOffset = reserve(sizeof(float));
+	pLayout->NameOffsetsOffset = reserve(sizeof(uint32_t));
+	pLayout->TypesOffset = reserve(sizeof(uint8_t));
+	pLayout->LevelsOffset = reserve(sizeof(uint8_t));
+	pLayout->HPPercentsOffset = reserve(sizeof(uint8_t));
+	pLayout->NamesCapacity = capacity * MaxNameLength;
+	pLayout->NamesOffset = reserve(MaxNameLength);
+	pLayout->TotalSize = offset;
+}
+
+uint32_t captureSpawnSnapshot(uint8_t* pBuffer, uint32_t bufferSize, uint32_t capacity, uint32_t* pTotalCount, PulseSnapshotFocus* pFocus)
+{
+	if (pTotalCount)
+	{
+		*pTotalCount = 0;
+	}
+
+	const PSPAWNINFO pCharacter = pLocalPlayer;
+	const PSPAWNINFO pTargetSpawn = (PSPAWNINFO)pTarget;
+	if (pFocus)
+	{
+		pFocus->CharacterSpawnId = pCharacter ? pCharacter->SpawnID : 0;
+		pFocus->TargetSpawnId = pTargetSpawn ? pTargetSpawn->SpawnID : 0;
+		pFocus->CharacterIndex = -1;
+		pFocus->TargetIndex = -1;
+	}
+
+	SpawnSnapshotLayout layout;
+	getSpawnSnapshotLayout(capacity, &layout);
+	if (pBuffer == nullptr || bufferSize < layout.TotalSize || !pSpawnManager)
+	{
+		return 0;
+	}
+
+	auto ids = reinterpret_cast<uint32_t*>(pBuffer + layout.IdsOffset);
+	auto xs = reinterpret_cast<float*>(pBuffer + layout.XOffset);
+	auto ys = reinterpret_cast<float*>(pBuffer + layout.YOffset);
+	auto zs = reinterpret_cast<float*>(pBuffer + layout.ZOffset);
+	auto headings = reinterpret_cast<float*>(pBuffer + layout.HeadingsOffset);
+	auto nameOffsets = reinterpret_cast<uint32_t*>(pBuffer + layout.NameOffsetsOffset);
+	auto types = pBuffer + layout.TypesOffset;
+	auto levels = pBuffer + layout.LevelsOffset;
+	auto hpPercents = pBuffer + layout.HPPercentsOffset;
+	auto names = reinterpret_cast<char*>(pBuffer + layout.NamesOffset);
+
+	uint32_t count = 0;
+	uint32_t totalCount = 0;
+	uint32_t namesSize = 0;
+	for (auto pSpawn = ((PSPAWNMANAGER)pSpawnManager)->FirstSpawn; pSpawn; pSpawn = pSpawn->pNext)
+	{
+		++totalCount;
+		if (count == capacity)
+		{
+			continue;
+		}
+
+		ids[count] = pSpawn->SpawnID;
+		xs[count] = pSpawn->X;
+		ys[count] = pSpawn->Y;
+		zs[count] = pSpawn->Z;
+		headings[count] = pSpawn->Heading * 0.703125f; // 512 units per circle
+		types[count] = static_cast<uint8_t>(pSpawn->Type);
+		levels[count] = static_cast<uint8_t>(pSpawn->Level);
+		hpPercents[count] = getSpawnHPPercent(pSpawn);
+
+		if (pFocus)
+		{
+			if (pSpawn == pCharacter)
+			{
+				pFocus->CharacterIndex = static_cast<int32_t>(count);
+			}
+
+			if (pSpawn == pTargetSpawn)
+			{
+				pFocus->TargetIndex = static_cast<int32_t>(count);
+			}
+		}
+
+		const size_t nameLength = strnlen(pSpawn->Name, MaxNameLength - 1);
+		memcpy(names + namesSize, pSpawn->Name, nameLength);
+		names[namesSize + nameLength] = '\0';
+		nameOffsets[count] = namesSize;
+		namesSize += static_cast<uint32_t>(nameLength + 1);
+
+		++count;
+	}
+
+	if (pTotalCount)
+	{
+		*pTotalCount = totalCount;
+	}
+
+	return count;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+// Byte offsets of each array in a spawn snapshot buffer. Every array holds Capacity entries, so entry i of the X array is at
+// XOffset + i * sizeof(float). Layout is mirrored by MQ2DotNetCore.Interop.SpawnSnapshotLayout, keep them in sync
+struct SpawnSnapshotLayout
+{
+	uint32_t Capacity;
+	uint32_t IdsOffset;			// uint32_t SpawnID
+	uint32_t XOffset;			// float
+	uint32_t YOffset;			// float
+	uint32_t ZOffset;			// float
+	uint32_t HeadingsOffset;	// float, degrees
+	uint32_t NameOffsetsOffset;	// uint32_t offset of the spawn's null terminated name, relative to NamesOffset
+	uint32_t TypesOffset;		// uint8_t SPAWNINFO::Type
+	uint32_t LevelsOffset;		// uint8_t
+	uint32_t HPPercentsOffset;	// uint8_t
+	uint32_t NamesOffset;		// Packed string table
+	uint32_t NamesCapacity;
+	uint32_t TotalSize;
+};
+
+// Where the character and their target are in a snapshot, found in the same pass that copies the spawns. Layout is mirrored by
+// MQ2DotNetCore.Interop.PulseSnapshotFocus, keep them in sync
+struct PulseSnapshotFocus
+{
+	uint32_t CharacterSpawnId;	// 0 when there's no local player, e.g. at character select
+	uint32_t TargetSpawnId;		// 0 when nothing is targeted
+	int32_t CharacterIndex;		// Index in the snapshot, -1 if the spawn didn't fit
+	int32_t TargetIndex;
+};
+
+// Computes the layout of a snapshot buffer that can hold up to capacity spawns
+void getSpawnSnapshotLayout(uint32_t capacity, SpawnSnapshotLayout* pLayout);
+
+// Walks the spawn list once and writes up to capacity spawns into the buffer in the layout above. Returns the number of spawns
+// written, pTotalCount receives the number of spawns in the zone so the caller can grow the buffer if it was too small. pFocus
+// is optional.
+uint32_t captureSpawnSnapshot(uint8_t* pBuffer, uint32_t bufferSize, uint32_t capacity, uint32_t* pTotalCount, PulseSnapshotFocus* pFocus = nullptr);
@@ -0,0 +1,417 @@
+#include "SpawnSpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+SpawnSpatialIndex g_spawnSpatialIndex;
+
+namespace
+{
+	// The grid is sized for roughly this many spawns per cell, with a cap on the cells per axis so a spawn with bogus
+	// coordinates can't blow up the grid
+	const uint32_t CellsPerSpawn = 2;
+	const uint32_t MinimumCellCount = 64;
+	const uint32_t MaximumCellCount = 1 << 16;
+	const float MaximumCellsPerAxis = 1024.0f;
+
+	// Below this many spawns a straight pass over the sorted arrays beats walking rings of cells for nearest queries
+	const uint32_t LinearNearestThreshold = 256;
+}
+
+void SpawnSpatialIndex::Insert(uint32_t spawnId, void* pointer, uint8_t type, float x, float y, float z)
+{
+	if (pointer == nullptr)
+	{
+		return;
+	}
+
+	auto existing = m_idToIndex.find(spawnId);
+	if (existing != m_idToIndex.end())
+	{
+		const uint32_t index = existing->second;
+		m_pointers[index] = pointer;
+		m_types[index] = type;
+		m_xs[index] = x;
+		m_ys[index] = y;
+		m_zs[index] = z;
+	}
+	else
+	{
+		m_idToIndex.emplace(spawnId, static_cast<uint32_t>(m_ids.size()));
+		m_ids.push_back(spawnId);
+		m_pointers.push_back(pointer);
+		m_types.push_back(type);
+		m_xs.push_back(x);
+		m_ys.push_back(y);
+		m_zs.push_back(z);
+	}
+
+	m_isGridDirty = true;
+}
+
+bool SpawnSpatialIndex::Remove(uint32_t spawnId)
+{
+	auto existing = m_idToIndex.find(spawnId);
+	if (existing == m_idToIndex.end())
+	{
+		return false;
+	}
+
+	// Swap remove, the last entry moves into the freed slot
+	const uint32_t index = existing->second;
+	const uint32_t lastIndex = static_cast<uint32_t>(m_ids.size() - 1);
+	if (index != lastIndex)
+	{
+		m_ids[index] = m_ids[lastIndex];
+		m_pointers[index] = m_pointers[lastIndex];
+		m_types[index] = m_types[lastIndex];
+		m_xs[index] = m_xs[lastIndex];
+		m_ys[index] = m_ys[lastIndex];
+		m_zs[index] = m_zs[lastIndex];
+		m_idToIndex[m_ids[index]] = index;
+	}
+
+	m_ids.pop_back();
+	m_pointers.pop_back();
+	m_types.pop_back();
+	m_xs.pop_back();
+	m_ys.pop_back();
+	m_zs.pop_back();
+	m_idToIndex.erase(spawnId);
+
+	m_isGridDirty = true;
+	return true;
+}
+
+void SpawnSpatialIndex::Clear()
+{
+	m_ids.clear();
+	m_pointers.clear();
+	m_types.clear();
+	m_xs.clear();
+	m_ys.clear();
+	m_zs.clear();
+	m_idToIndex.clear();
+
+	m_isGridDirty = true;
+}
+
+namespace
+{
+	// std::floor is a library call without SSE4.1, and this runs for every spawn on every rebuild
+	inline int32_t floorToInt(float value)
+	{
+		value = std::max(-1.0e9f, std::min(1.0e9f, value));
+		const int32_t truncated = static_cast<int32_t>(value);
+		return value < truncated ? truncated - 1 : truncated;
+	}
+}
+
+int32_t SpawnSpatialIndex::toColumn(float x) const
+{
+	return floorToInt((x - m_originX) * m_inverseCellSize);
+}
+
+int32_t SpawnSpatialIndex::toRow(float y) const
+{
+	return floorToInt((y - m_originY) * m_inverseCellSize);
+}
+
+// Both ends are clamped to the grid. A rectangle that lies entirely outside of it has no cells, rather than a crossed range
+// that would index past the cell starts.
+bool SpawnSpatialIndex::toCellRange(float minX, float minY, float maxX, float maxY, int32_t& firstColumn, int32_t& lastColumn, int32_t& firstRow, int32_t& lastRow) const
+{
+	firstColumn = toColumn(minX);
+	lastColumn = toColumn(maxX);
+	firstRow = toRow(minY);
+	lastRow = toRow(maxY);
+	if (lastColumn < 0 || firstColumn > m_columns - 1 || lastRow < 0 || firstRow > m_rows - 1)
+	{
+		return false;
+	}
+
+	firstColumn = std::min(m_columns - 1, std::max(0, firstColumn));
+	lastColumn = std::min(m_columns - 1, std::max(0, lastColumn));
+	firstRow = std::min(m_rows - 1, std::max(0, firstRow));
+	lastRow = std::min(m_rows - 1, std::max(0, lastRow));
+	return firstColumn <= lastColumn && firstRow <= lastRow;
+}
+
+void SpawnSpatialIndex::rebuild()
+{
+	m_isGridDirty = false;
+
+	const uint32_t count = static_cast<uint32_t>(m_ids.size());
+	if (count == 0)
+	{
+		m_columns = 0;
+		m_rows = 0;
+		m_cellStarts.assign(1, 0);
+		return;
+	}
+
+	const auto xBounds = std::minmax_element(m_xs.begin(), m_xs.end());
+	const auto yBounds = std::minmax_element(m_ys.begin(), m_ys.end());
+	const float width = *xBounds.second - *xBounds.first;
+	const float height = *yBounds.second - *yBounds.first;
+
+	const uint32_t targetCellCount = std::max(MinimumCellCount, std::min(MaximumCellCount, count * CellsPerSpawn));
+	m_cellSize = std::max({
+		MinimumCellSize,
+		std::sqrt(width * height / targetCellCount),
+		width / MaximumCellsPerAxis,
+		height / MaximumCellsPerAxis
+	});
+	m_inverseCellSize = 1.0f / m_cellSize;
+	m_originX = *xBounds.first;
+	m_originY = *yBounds.first;
+	m_columns = toColumn(*xBounds.second) + 1;
+	m_rows = toRow(*yBounds.second) + 1;
+
+	// Counting sort of the entries by cell
+	const uint32_t cellCount = static_cast<uint32_t>(m_columns * m_rows);
+	m_cellStarts.assign(cellCount + 1, 0);
+	m_cellOfEntry.resize(count);
+	for (uint32_t index = 0; index < count; ++index)
+	{
+		const int32_t column = std::min(m_columns - 1, toColumn(m_xs[index]));
+		const int32_t row = std::min(m_rows - 1, toRow(m_ys[index]));
+		const uint32_t cell = static_cast<uint32_t>(row * m_columns + column);
+		m_cellOfEntry[index] = cell;
+		++m_cellStarts[cell + 1];
+	}
+
+	for (uint32_t cell = 0; cell < cellCount; ++cell)
+	{
+		m_cellStarts[cell + 1] += m_cellStarts[cell];
+	}
+
+	m_sortedIds.resize(count);
+	m_sortedTypes.resize(count);
+	m_sortedXs.resize(count);
+	m_sortedYs.resize(count);
+
+	// Fill each cell from its end so m_cellStarts can double as the write cursor
+	for (uint32_t index = count; index-- > 0;)
+	{
+		const uint32_t position = --m_cellStarts[m_cellOfEntry[index] + 1];
+		m_sortedIds[position] = m_ids[index];
+		m_sortedTypes[position] = m_types[index];
+		m_sortedXs[position] = m_xs[index];
+		m_sortedYs[position] = m_ys[index];
+	}
+
+	// The decrements above left m_cellStarts[c + 1] pointing at the start of cell c, shift everything down by one
+	for (uint32_t cell = 0; cell < cellCount; ++cell)
+	{
+		m_cellStarts[cell] = m_cellStarts[cell + 1];
+	}
+
+	m_cellStarts[cellCount] = count;
+}
+
+uint32_t SpawnSpatialIndex::QueryRadius(float x, float y, float radius, uint32_t typeMask, SpawnQueryResult* pResults, uint32_t capacity)
+{
+	ensureBuilt();
+	if (radius < 0.0f || m_columns == 0)
+	{
+		return 0;
+	}
+
+	int32_t firstColumn, lastColumn, firstRow, lastRow;
+	if (!toCellRange(x - radius, y - radius, x + radius, y + radius, firstColumn, lastColumn, firstRow, lastRow))
+	{
+		return 0;
+	}
+
+	const float radiusSquared = radius * radius;
+	uint32_t matchCount = 0;
+	for (int32_t row = firstRow; row <= lastRow; ++row)
+	{
+		// Cells in a row are adjacent in the sorted arrays, so the whole column range is a single run
+		const uint32_t end = m_cellStarts[row * m_columns + lastColumn + 1];
+		for (uint32_t position = m_cellStarts[row * m_columns + firstColumn]; position < end; ++position)
+		{
+			const float deltaX = m_sortedXs[position] - x;
+			const float deltaY = m_sortedYs[position] - y;
+			const float distanceSquared = deltaX * deltaX + deltaY * deltaY;
+			if (distanceSquared > radiusSquared || !IsTypeMatch(typeMask, m_sortedTypes[position]))
+			{
+				continue;
+			}
+
+			if (pResults && matchCount < capacity)
+			{
+				pResults[matchCount] = { m_sortedIds[position], std::sqrt(distanceSquared) };
+			}
+
+			++matchCount;
+		}
+	}
+
+	return matchCount;
+}
+
+uint32_t SpawnSpatialIndex::QueryBox(float minX, float minY, float maxX, float maxY, uint32_t typeMask, SpawnQueryResult* pResults, uint32_t capacity)
+{
+	ensureBuilt();
+	if (minX > maxX || minY > maxY || m_columns == 0)
+	{
+		return 0;
+	}
+
+	int32_t firstColumn, lastColumn, firstRow, lastRow;
+	if (!toCellRange(minX, minY, maxX, maxY, firstColumn, lastColumn, firstRow, lastRow))
+	{
+		return 0;
+	}
+
+	const float centerX = (minX + maxX) * 0.5f;
+	const float centerY = (minY + maxY) * 0.5f;
+
+	uint32_t matchCount = 0;
+	for (int32_t row = firstRow; row <= lastRow; ++row)
+	{
+		const uint32_t end = m_cellStarts[row * m_columns + lastColumn + 1];
+		for (uint32_t position = m_cellStarts[row * m_columns + firstColumn]; position < end; ++position)
+		{
+			const float entryX = m_sortedXs[position];
+			const float entryY = m_sortedYs[position];
+			if (entryX < minX || entryX > maxX || entryY < minY || entryY > maxY || !IsTypeMatch(typeMask, m_sortedTypes[position]))
+			{
+				continue;
+			}
+
+			if (pResults && matchCount < capacity)
+			{
+				const float deltaX = entryX - centerX;
+				const float deltaY = entryY - centerY;
+				pResults[matchCount] = { m_sortedIds[position], std::sqrt(deltaX * deltaX + deltaY * deltaY) };
+			}
+
+			++matchCount;
+		}
+	}
+
+	return matchCount;
+}
+
+uint32_t SpawnSpatialIndex::QueryNearest(float x, float y, uint32_t k, float maxRadius, uint32_t typeMask, SpawnQueryResult* pResults)
+{
+	ensureBuilt();
+	if (k == 0 || pResults == nullptr || m_columns == 0)
+	{
+		return 0;
+	}
+
+	const float maxRadiusSquared = maxRadius > 0.0f ? maxRadius * maxRadius : std::numeric_limits<float>::max();
+
+	// Max heap on distance so the current worst candidate is always at the front
+	auto& candidates = m_nearestCandidates;
+	candidates.clear();
+
+	auto considerRun = [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t position = begin; position < end; ++position)
+		{
+			if (!IsTypeMatch(typeMask, m_sortedTypes[position]))
+			{
+				continue;
+			}
+
+			const float deltaX = m_sortedXs[position] - x;
+			const float deltaY = m_sortedYs[position] - y;
+			const float distanceSquared = deltaX * deltaX + deltaY * deltaY;
+			if (distanceSquared > maxRadiusSquared)
+			{
+				continue;
+			}
+
+			if (candidates.size() < k)
+			{
+				candidates.emplace_back(distanceSquared, position);
+				std::push_heap(candidates.begin(), candidates.end());
+			}
+			else if (distanceSquared < candidates.front().first)
+			{
+				std::pop_heap(candidates.begin(), candidates.end());
+				candidates.back() = { distanceSquared, position };
+				std::push_heap(candidates.begin(), candidates.end());
+			}
+		}
+	};
+
+	auto considerRow = [&](int32_t row, int32_t firstColumn, int32_t lastColumn)
+	{
+		firstColumn = std::max(0, firstColumn);
+		lastColumn = std::min(m_columns - 1, lastColumn);
+		if (row < 0 || row >= m_rows || firstColumn > lastColumn)
+		{
+			return;
+		}
+
+		considerRun(m_cellStarts[row * m_columns + firstColumn], m_cellStarts[row * m_columns + lastColumn + 1]);
+	};
+
+	const int32_t centerColumn = toColumn(x);
+	const int32_t centerRow = toRow(y);
+	const int32_t lastRing = std::max({ std::abs(centerColumn), std::abs(m_columns - 1 - centerColumn), std::abs(centerRow), std::abs(m_rows - 1 - centerRow) });
+
+	if (m_sortedIds.size() <= LinearNearestThreshold || lastRing > m_columns + m_rows)
+	{
+		// Few spawns, or far outside the populated area where walking rings of empty cells would cost more than checking everything
+		considerRun(0, static_cast<uint32_t>(m_sortedIds.size()));
+	}
+	else
+	{
+		// Search outward one ring of cells at a time. Every spawn in ring r is outside the square of cells covered by the
+		// previous rings, so once the distance to the edge of that square is further than the current k-th candidate nothing
+		// further out can improve the result.
+		for (int32_t ring = 0; ring <= lastRing; ++ring)
+		{
+			if (ring > 0)
+			{
+				const float ringDistance = std::max(0.0f, std::min({
+					x - (m_originX + (centerColumn - ring + 1) * m_cellSize),
+					(m_originX + (centerColumn + ring) * m_cellSize) - x,
+					y - (m_originY + (centerRow - ring + 1) * m_cellSize),
+					(m_originY + (centerRow + ring) * m_cellSize) - y
+				}));
+				const float ringDistanceSquared = ringDistance * ringDistance;
+				if (ringDistanceSquared > maxRadiusSquared || (candidates.size() == k && ringDistanceSquared > candidates.front().first))
+				{
+					break;
+				}
+			}
+
+			if (ring == 0)
+			{
+				considerRow(centerRow, centerColumn, centerColumn);
+				continue;
+			}
+
+			considerRow(centerRow - ring, centerColumn - ring, centerColumn + ring);
+			considerRow(centerRow + ring, centerColumn - ring, centerColumn + ring);
+
+			const int32_t firstSideRow = std::max(0, centerRow - ring + 1);
+			const int32_t lastSideRow = std::min(m_rows - 1, centerRow + ring - 1);
+			for (int32_t row = firstSideRow; row <= lastSideRow; ++row)
+			{
+				considerRow(row, centerColumn - ring, centerColumn - ring);
+				considerRow(row, centerColumn + ring, centerColumn + ring);
+			}
+		}
+	}
+
+	std::sort_heap(candidates.begin(), candidates.end());
+
+	const uint32_t resultCount = static_cast<uint32_t>(candidates.size());
+	for (uint32_t resultIndex = 0; resultIndex < resultCount; ++resultIndex)
+	{
+		pResults[resultIndex] = { m_sortedIds[candidates[resultIndex].second], std::sqrt(candidates[resultIndex].first) };
+	}
+
+	return resultCount;
+}
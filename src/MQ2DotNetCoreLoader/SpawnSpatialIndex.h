@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Layout is mirrored by MQ2DotNetCore.MQ2Api.SpawnQueryResult, keep them in sync
+struct SpawnQueryResult
+{
+	uint32_t SpawnId;
+	float Distance;
+};
+
+// Uniform grid over the X/Y plane. The set of spawns is maintained incrementally as they are added to and removed from the
+// zone. Positions are refreshed in bulk once per pulse, which also rebuilds the grid with a counting sort so every cell's
+// spawns are contiguous and a query only touches a handful of short array ranges. Distances are 2D, the same as MQ2's
+// Spawn.Distance. Not thread safe, it is only touched from the EQ thread.
+class SpawnSpatialIndex
+{
+public:
+	static constexpr float MinimumCellSize = 32.0f;
+
+	// typeMask is a bit mask of (1 << SPAWNINFO::Type), 0 matches every type
+	static bool IsTypeMatch(uint32_t typeMask, uint8_t type) { return typeMask == 0 || (typeMask & (1u << type)) != 0; }
+
+	// Inserting an id that is already indexed just updates it
+	void Insert(uint32_t spawnId, void* pointer, uint8_t type, float x, float y, float z);
+	bool Remove(uint32_t spawnId);
+	void Clear();
+
+	uint32_t Count() const { return static_cast<uint32_t>(m_ids.size()); }
+	uint32_t CellCount() const { return static_cast<uint32_t>(m_columns * m_rows); }
+
+	// Calls readSpawn(void* pointer, float& x, float& y, float& z, uint8_t& type) for every indexed spawn, then rebuilds the
+	// grid. Entries where readSpawn returns false keep their previous values.
+	template<typename ReadSpawn>
+	void RefreshPositions(ReadSpawn readSpawn)
+	{
+		for (size_t index = 0; index < m_ids.size(); ++index)
+		{
+			readSpawn(m_pointers[index], m_xs[index], m_ys[index], m_zs[index], m_types[index]);
+		}
+
+		rebuild();
+	}
+
+	// Radius and box queries write up to capacity results in no particular order and return the total number of matches, which
+	// can be larger than capacity. Box results carry their distance from the center of the box.
+	uint32_t QueryRadius(float x, float y, float radius, uint32_t typeMask, SpawnQueryResult* pResults, uint32_t capacity);
+	uint32_t QueryBox(float minX, float minY, float maxX, float maxY, uint32_t typeMask, SpawnQueryResult* pResults, uint32_t capacity);
+
+	// Writes the (up to) k nearest spawns within maxRadius, sorted by distance, and returns the number written. A maxRadius <= 0
+	// means unlimited.
+	uint32_t QueryNearest(float x, float y, uint32_t k, float maxRadius, uint32_t typeMask, SpawnQueryResult* pResults);
+
+private:
+	void ensureBuilt() { if (m_isGridDirty) rebuild(); }
+	void rebuild();
+
+	int32_t toColumn(float x) const;
+	int32_t toRow(float y) const;
+
+	// The cells covering the rectangle, false if it doesn't overlap the grid
+	bool toCellRange(float minX, float minY, float maxX, float maxY, int32_t& firstColumn, int32_t& lastColumn, int32_t& firstRow, int32_t& lastRow) const;
+
+	// Entries, in insertion order (swap removed)
+	std::vector<uint32_t> m_ids;
+	std::vector<void*> m_pointers;
+	std::vector<uint8_t> m_types;
+	std::vector<float> m_xs;
+	std::vector<float> m_ys;
+	std::vector<float> m_zs;
+	std::unordered_map<uint32_t, uint32_t> m_idToIndex;
+
+	// Grid, rebuilt from the entries. Cell c holds sorted entries [m_cellStarts[c], m_cellStarts[c + 1]), cells are row major.
+	bool m_isGridDirty{ false };
+	float m_originX{ 0.0f };
+	float m_originY{ 0.0f };
+	float m_cellSize{ MinimumCellSize };
+	float m_inverseCellSize{ 1.0f / MinimumCellSize };
+	int32_t m_columns{ 0 };
+	int32_t m_rows{ 0 };
+	std::vector<uint32_t> m_cellStarts;
+	std::vector<uint32_t> m_sortedIds;
+	std::vector<uint8_t> m_sortedTypes;
+	std::vector<float> m_sortedXs;
+	std::vector<float> m_sortedYs;
+	std::vector<uint32_t> m_cellOfEntry;
+	std::vector<std::pair<float, uint32_t>> m_nearestCandidates;
+};
+
+extern SpawnSpatialIndex g_spawnSpatialIndex;
@@ -0,0 +1,148 @@
+#include "TextEncoding.h"
+
+#include <cstring>
+
+namespace
+{
+	// Unicode code points of Windows-1252 0x80 - 0x9F, the rest of the upper half maps to the same Latin-1 code point. Undefined
+	// bytes map to themselves, the same as Windows' MultiByteToWideChar.
+	const uint16_t Windows1252HighControls[32] = {
+		0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021, 0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+		0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014, 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+	};
+
+	inline uint32_t toCodePoint(unsigned char value)
+	{
+		return value >= 0x80 && value < 0xA0 ? Windows1252HighControls[value - 0x80] : value;
+	}
+
+	inline uint32_t encodedLength(uint32_t codePoint)
+	{
+		return codePoint < 0x80 ? 1 : codePoint < 0x800 ? 2 : 3;
+	}
+
+	inline int toAnsi(uint32_t codePoint)
+	{
+		if (codePoint < 0x80 || (codePoint >= 0xA0 && codePoint <= 0xFF))
+		{
+			return static_cast<int>(codePoint);
+		}
+
+		for (int index = 0; index < 32; ++index)
+		{
+			if (Windows1252HighControls[index] == codePoint)
+			{
+				return 0x80 + index;
+			}
+		}
+
+		return -1;
+	}
+}
+
+uint32_t ansiToUtf8(const char* pSource, size_t length, char* pDestination, uint32_t capacity, bool* pIsTruncated)
+{
+	if (pIsTruncated)
+	{
+		*pIsTruncated = false;
+	}
+
+	if (pDestination == nullptr || capacity == 0)
+	{
+		if (pIsTruncated && length > 0)
+		{
+			*pIsTruncated = true;
+		}
+
+		return 0;
+	}
+
+	uint32_t written = 0;
+	for (size_t index = 0; index < length; ++index)
+	{
+		const uint32_t codePoint = toCodePoint(static_cast<unsigned char>(pSource[index]));
+		const uint32_t codePointLength = encodedLength(codePoint);
+		if (written + codePointLength >= capacity)
+		{
+			if (pIsTruncated)
+			{
+				*pIsTruncated = true;
+			}
+
+			break;
+		}
+
+		if (codePointLength == 1)
+		{
+			pDestination[written] = static_cast<char>(codePoint);
+		}
+		else if (codePointLength == 2)
+		{
+			pDestination[written] = static_cast<char>(0xC0 | (codePoint >> 6));
+			pDestination[written + 1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+		else
+		{
+			pDestination[written] = static_cast<char>(0xE0 | (codePoint >> 12));
+			pDestination[written + 1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			pDestination[written + 2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+
+		written += codePointLength;
+	}
+
+	pDestination[written] = '\0';
+	return written;
+}
+
+size_t utf8Length(const char* pSource, size_t length)
+{
+	size_t total = 0;
+	for (size_t index = 0; index < length; ++index)
+	{
+		total += encodedLength(toCodePoint(static_cast<unsigned char>(pSource[index])));
+	}
+
+	return total;
+}
+
+bool utf8ToAnsi(const char* pSource, char* pDestination, size_t capacity)
+{
+	return utf8ToAnsi(pSource, pSource == nullptr ? 0 : strlen(pSource), pDestination, capacity);
+}
+
+bool utf8ToAnsi(const char* pSource, size_t length, char* pDestination, size_t capacity)
+{
+	if (pDestination == nullptr || capacity == 0)
+	{
+		return length == 0;
+	}
+
+	size_t written = 0;
+	const auto pBytes = reinterpret_cast<const unsigned char*>(pSource);
+	size_t index = 0;
+	while (index < length)
+	{
+		if (written + 1 >= capacity)
+		{
+			pDestination[written] = '\0';
+			return false;
+		}
+
+		uint32_t codePoint = pBytes[index];
+		size_t continuationCount = codePoint < 0x80 ? 0 : codePoint >= 0xF0 ? 3 : codePoint >= 0xE0 ? 2 : codePoint >= 0xC0 ? 1 : 0;
+		codePoint = continuationCount == 3 ? (codePoint & 0x07) : continuationCount == 2 ? (codePoint & 0x0F) : continuationCount == 1 ? (codePoint & 0x1F) : codePoint;
+		++index;
+
+		for (; continuationCount > 0 && index < length && (pBytes[index] & 0xC0) == 0x80; --continuationCount, ++index)
+		{
+			codePoint = (codePoint << 6) | (pBytes[index] & 0x3F);
+		}
+
+		const int ansi = continuationCount == 0 ? toAnsi(codePoint) : -1;
+		pDestination[written++] = ansi < 0 ? '?' : static_cast<char>(ansi);
+	}
+
+	pDestination[written] = '\0';
+	return true;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// MQ2 and EQ strings are in the Windows-1252 code page, the managed side works in UTF-8. ASCII, which is nearly every string
+// MQ2 produces, is copied as is.
+
+// Bit for the flags written by the UTF-8 string exports
+const uint32_t TextResultTruncated = 0x1;
+
+// Converts length bytes of Windows-1252 text to UTF-8. Always null terminates when capacity > 0 and never splits a multi byte
+// character. Returns the number of bytes written, excluding the terminator, and sets *pIsTruncated if the text didn't fit.
+uint32_t ansiToUtf8(const char* pSource, size_t length, char* pDestination, uint32_t capacity, bool* pIsTruncated);
+
+// Number of bytes the UTF-8 form of the text needs, excluding the terminator
+size_t utf8Length(const char* pSource, size_t length);
+
+// Converts null terminated UTF-8 text to Windows-1252, characters outside the code page become '?'. Always null terminates when
+// capacity > 0. Returns false if the text didn't fit.
+bool utf8ToAnsi(const char* pSource, char* pDestination, size_t capacity);
+
+// Same as above for length bytes of UTF-8 text, which doesn't need to be null terminated
+bool utf8ToAnsi(const char* pSource, size_t length, char* pDestination, size_t capacity);
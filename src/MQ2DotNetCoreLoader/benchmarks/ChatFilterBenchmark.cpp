@@ -0,0 +1,199 @@
+// Replays a chat corpus through the loader's chat pre-filter and compares it against forwarding every line.
+//
+// Usage: ChatFilterBenchmark [corpus file] [iterations]
+//
+// Without a corpus file a synthetic raid log is generated. Every forwarded line costs the managed side at least one string
+// and one ChatLineEventArgs (plus an int[] for the matched ids), so the forwarded line counts are reported as the managed
+// allocations each mode would cause. The marshaling itself is approximated by copying the line into a std::string.
+
+#include "../ChatFilter.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct ChatLine
+	{
+		uint32_t Source;
+		uint32_t Color;
+		uint32_t Filter;
+		std::string Text;
+	};
+
+	std::vector<ChatLine> generateCorpus(size_t lineCount)
+	{
+		static const char* const names[] = { "Bristlebane", "Tunare", "Rallos", "Cazic", "Innoruuk", "Karana", "Solusek", "Erollisi" };
+		static const char* const templates[] = {
+			"%s hits a frost giant for %d points of damage.",
+			"%s tells the raid, 'Incoming in %d'",
+			"A frost giant hits %s for %d points of damage.",
+			"%s begins to cast a spell. <%d>",
+			"%s has been slain by a frost giant! (%d)",
+			"%s tells you, 'invite me please %d'",
+			"You have been healed for %d points by %s.",
+			"[MQ2] %s ran macro step %d",
+			"%s shouts, 'Train to zone! %d'",
+			"Your target resisted the %s spell. %d"
+		};
+
+		std::mt19937 random(12345);
+		std::vector<ChatLine> corpus;
+		corpus.reserve(lineCount);
+
+		char buffer[256];
+		for (size_t lineIndex = 0; lineIndex < lineCount; ++lineIndex)
+		{
+			// Roughly 80% of a raid log is melee / casting spam that no pattern cares about
+			const auto roll = random() % 100;
+			const size_t templateIndex = roll < 80 ? (roll % 4 == 1 ? 0 : roll % 4) : 4 + roll % 6;
+			const auto name = names[random() % (sizeof(names) / sizeof(names[0]))];
+			const int value = static_cast<int>(random() % 10000);
+
+			if (templateIndex == 6)
+			{
+				snprintf(buffer, sizeof(buffer), templates[templateIndex], value, name);
+			}
+			else
+			{
+				snprintf(buffer, sizeof(buffer), templates[templateIndex], name, value);
+			}
+
+			const bool isMQ2 = templateIndex == 7;
+			corpus.push_back({ isMQ2 ? ChatSourceMQ2 : ChatSourceEQ, static_cast<uint32_t>(random() % 20), isMQ2 ? 1u : 0u, buffer });
+		}
+
+		return corpus;
+	}
+
+	std::vector<ChatLine> loadCorpus(const char* path)
+	{
+		std::vector<ChatLine> corpus;
+		std::ifstream input(path);
+		std::string line;
+		while (std::getline(input, line))
+		{
+			corpus.push_back({ ChatSourceEQ, 0, 0, line });
+		}
+
+		return corpus;
+	}
+
+	void registerPatterns(ChatFilter& chatFilter)
+	{
+		static const char* const literals[] = {
+			"has been slain by", "tells the raid", "train to zone", "your target resisted", "you have been healed",
+			"lost your feign death", "you feel yourself starting to appear", "your spell fizzles", "you are stunned",
+			"you have gained a level", "you have become better at", "loot this corpse", "is not in range", "you can't see your target",
+			"insufficient mana", "you have entered", "the door is locked", "a mysterious voice whispers", "you are out of food",
+			"you are out of drink"
+		};
+
+		static const char* const wildcards[] = {
+			"* tells you, '*'", "* tells the group, '*'", "* says out of character, '*'", "* auctions, 'wts *'", "[mq2] * ran macro *",
+			"you have been summoned by *", "* begins to cast *gate*", "* invites you to join a group.", "you receive * from *",
+			"* has been awakened by *"
+		};
+
+		for (auto literal : literals)
+		{
+			chatFilter.AddPattern(literal, ChatSourceAny, 0, 0);
+		}
+
+		for (auto wildcard : wildcards)
+		{
+			chatFilter.AddPattern(wildcard, ChatSourceAny, 0, 0);
+		}
+	}
+
+	struct RunResult
+	{
+		double Seconds;
+		uint64_t LinesForwarded;
+		uint64_t BytesMarshaled;
+	};
+
+	RunResult runUnfiltered(const std::vector<ChatLine>& corpus, int iterations)
+	{
+		RunResult result{};
+		const auto start = std::chrono::steady_clock::now();
+
+		for (int iteration = 0; iteration < iterations; ++iteration)
+		{
+			for (const auto& chatLine : corpus)
+			{
+				std::string marshaled(chatLine.Text.c_str());
+				result.BytesMarshaled += marshaled.size();
+				++result.LinesForwarded;
+			}
+		}
+
+		result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return result;
+	}
+
+	RunResult runFiltered(ChatFilter& chatFilter, const std::vector<ChatLine>& corpus, int iterations)
+	{
+		RunResult result{};
+		int32_t matchedIds[ChatFilter::MaxMatchedIds];
+		const auto start = std::chrono::steady_clock::now();
+
+		for (int iteration = 0; iteration < iterations; ++iteration)
+		{
+			for (const auto& chatLine : corpus)
+			{
+				if (chatFilter.Match(chatLine.Source, chatLine.Text.c_str(), chatLine.Color, chatLine.Filter, matchedIds, ChatFilter::MaxMatchedIds) == 0)
+				{
+					continue;
+				}
+
+				std::string marshaled(chatLine.Text.c_str());
+				result.BytesMarshaled += marshaled.size();
+				++result.LinesForwarded;
+			}
+		}
+
+		result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return result;
+	}
+
+	void printResult(const char* name, const RunResult& result, uint64_t totalLines)
+	{
+		printf("%-12s %12.0f lines/sec %12llu lines forwarded (%5.1f%%) %12llu managed allocations %14llu bytes marshaled\n",
+			name,
+			totalLines / result.Seconds,
+			static_cast<unsigned long long>(result.LinesForwarded),
+			100.0 * result.LinesForwarded / totalLines,
+			static_cast<unsigned long long>(result.LinesForwarded * 2),
+			static_cast<unsigned long long>(result.BytesMarshaled));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const auto corpus = argc > 1 ? loadCorpus(argv[1]) : generateCorpus(200000);
+	const int iterations = argc > 2 ? atoi(argv[2]) : 10;
+	if (corpus.empty() || iterations <= 0)
+	{
+		fprintf(stderr, "Usage: %s [corpus file] [iterations]\n", argv[0]);
+		return 1;
+	}
+
+	ChatFilter chatFilter;
+	registerPatterns(chatFilter);
+
+	ChatFilterStatistics statistics{};
+	chatFilter.GetStatistics(&statistics);
+	printf("Corpus: %zu lines x %d iterations, %u patterns compiled into %u automaton nodes\n",
+		corpus.size(), iterations, statistics.PatternCount, statistics.NodeCount);
+
+	const uint64_t totalLines = static_cast<uint64_t>(corpus.size()) * iterations;
+	printResult("unfiltered", runUnfiltered(corpus, iterations), totalLines);
+	printResult("filtered", runFiltered(chatFilter, corpus, iterations), totalLines);
+	return 0;
+}
@@ -0,0 +1,260 @@
+// Compares evaluating compiled expression plans against re-parsing the expression text every time, the way
+// MQ2.Parse / MQ2.Calculate do through ParseMacroData.
+//
+// Usage: ExpressionPlanBenchmark [iterations]
+//
+// MQ2 itself isn't available here, so a fake host provides a few TLOs and members. Its ParseMacroData does what MQ2's does:
+// find the innermost ${..}, split it into TLO and members, look the TLO and every member up by name and splice the result
+// back into the buffer. Both sides pay the same for the actual member reads, the difference is the parsing and lookups.
+// The managed Parse also allocates the result string per call, approximated here with a std::string.
+
+#include "../ExpressionPlan.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+
+namespace
+{
+	typedef bool(*FakeMember)(uint64_t data, const char* index, ExpressionHost::Value& result);
+
+	struct FakeType
+	{
+		const char* Name;
+		std::map<std::string, FakeMember> Members;
+	};
+
+	FakeType intType{ "int", {} };
+	FakeType spawnType{ "spawn", {} };
+	FakeType characterType{ "character", {} };
+	FakeType buffType{ "buff", {} };
+
+	struct FakeTopLevelObject
+	{
+		FakeType* Type;
+		uint64_t Data;
+	};
+
+	std::map<std::string, FakeTopLevelObject> topLevelObjects;
+
+	void registerFakes()
+	{
+		intType.Members["Abs"] = [](uint64_t data, const char*, ExpressionHost::Value& result) { result = { &intType, static_cast<uint64_t>(std::llabs(static_cast<int64_t>(data))) }; return true; };
+		characterType.Members["PctHPs"] = [](uint64_t, const char*, ExpressionHost::Value& result) { result = { &intType, 87 }; return true; };
+		characterType.Members["PctMana"] = [](uint64_t, const char*, ExpressionHost::Value& result) { result = { &intType, 42 }; return true; };
+		characterType.Members["Buff"] = [](uint64_t, const char* index, ExpressionHost::Value& result) { result = { &buffType, static_cast<uint64_t>(atoi(index)) }; return true; };
+		buffType.Members["Duration"] = [](uint64_t data, const char*, ExpressionHost::Value& result) { result = { &intType, data * 60 }; return true; };
+		spawnType.Members["ID"] = [](uint64_t data, const char*, ExpressionHost::Value& result) { result = { &intType, data }; return true; };
+		spawnType.Members["PctHPs"] = [](uint64_t, const char*, ExpressionHost::Value& result) { result = { &intType, 12 }; return true; };
+		spawnType.Members["Distance"] = [](uint64_t, const char*, ExpressionHost::Value& result) { result = { &intType, 35 }; return true; };
+
+		topLevelObjects["Me"] = { &characterType, 1 };
+		topLevelObjects["Target"] = { &spawnType, 1234 };
+	}
+
+	class FakeHost : public ExpressionHost
+	{
+	public:
+		void* FindTopLevelObject(const char* name) override
+		{
+			auto existing = topLevelObjects.find(name);
+			return existing == topLevelObjects.end() ? nullptr : &existing->second;
+		}
+
+		bool GetTopLevelObject(void* topLevelObject, char*, Value& value) override
+		{
+			const auto pTopLevelObject = static_cast<FakeTopLevelObject*>(topLevelObject);
+			value = { pTopLevelObject->Type, pTopLevelObject->Data };
+			return true;
+		}
+
+		bool GetMember(const Value& value, char* member, char* index, Value& result) override
+		{
+			const auto& members = static_cast<FakeType*>(value.Type)->Members;
+			auto existing = members.find(member);
+			return existing != members.end() && existing->second(value.Data, index, result);
+		}
+
+		bool ToString(const Value& value, char* destination) override
+		{
+			snprintf(destination, BufferSize, "%lld", static_cast<long long>(value.Data));
+			return true;
+		}
+
+		// Re-parses the buffer from scratch, innermost ${..} first, like MQ2's ParseMacroData
+		bool ParseMacroData(char* buffer, size_t bufferSize) override
+		{
+			while (true)
+			{
+				char* start = nullptr;
+				for (char* position = buffer; *position; ++position)
+				{
+					if (position[0] == '$' && position[1] == '{')
+						start = position;
+					else if (*position == '}' && start)
+						break;
+				}
+
+				char* end = start ? strchr(start, '}') : nullptr;
+				if (end == nullptr)
+					return true;
+
+				std::string inner(start + 2, end);
+				std::string replacement = evaluateInner(inner);
+				std::string rest(end + 1);
+
+				const size_t prefixLength = start - buffer;
+				if (prefixLength + replacement.size() + rest.size() + 1 > bufferSize)
+					return false;
+
+				memcpy(buffer + prefixLength, replacement.c_str(), replacement.size());
+				memcpy(buffer + prefixLength + replacement.size(), rest.c_str(), rest.size() + 1);
+			}
+		}
+
+		bool Calculate(char* formula, double& result) override
+		{
+			// Only the comparisons the benchmark expressions use
+			char* operatorPosition = strpbrk(formula, "<>");
+			if (operatorPosition == nullptr)
+			{
+				result = strtod(formula, nullptr);
+				return true;
+			}
+
+			const double left = strtod(formula, nullptr);
+			const double right = strtod(operatorPosition + 1, nullptr);
+			result = (*operatorPosition == '<' ? left < right : left > right) ? 1.0 : 0.0;
+			return true;
+		}
+
+	private:
+		std::string evaluateInner(const std::string& inner)
+		{
+			Value value{};
+			bool isResolved = false;
+			size_t partStart = 0;
+			for (size_t position = 0; position <= inner.size(); ++position)
+			{
+				if (position < inner.size() && inner[position] != '.')
+					continue;
+
+				std::string part = inner.substr(partStart, position - partStart);
+				partStart = position + 1;
+
+				std::string index;
+				const size_t indexStart = part.find('[');
+				if (indexStart != std::string::npos)
+				{
+					index = part.substr(indexStart + 1, part.size() - indexStart - 2);
+					part.resize(indexStart);
+				}
+
+				if (!isResolved)
+				{
+					void* topLevelObject = FindTopLevelObject(part.c_str());
+					if (topLevelObject == nullptr || !GetTopLevelObject(topLevelObject, &index[0], value))
+						return "NULL";
+
+					isResolved = true;
+				}
+				else if (!GetMember(value, &part[0], &index[0], value))
+				{
+					return "NULL";
+				}
+			}
+
+			char text[BufferSize];
+			ToString(value, text);
+			return text;
+		}
+	};
+
+	const char* const expressions[] = {
+		"${Me.PctHPs}",
+		"${Me.PctHPs} < 50",
+		"${Target.ID}",
+		"${Target.PctHPs} < 20",
+		"${Me.Buff[3].Duration}",
+		"Mana: ${Me.PctMana}% HP: ${Me.PctHPs}% Target: ${Target.ID} (${Target.Distance})",
+		"1 > 0"
+	};
+	const size_t expressionCount = sizeof(expressions) / sizeof(expressions[0]);
+}
+
+int main(int argc, char* argv[])
+{
+	const int iterations = argc > 1 ? atoi(argv[1]) : 200000;
+	if (iterations <= 0)
+	{
+		fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+		return 1;
+	}
+
+	registerFakes();
+
+	FakeHost host;
+	ExpressionPlanCache cache(&host);
+
+	int32_t handles[expressionCount];
+	for (size_t expressionIndex = 0; expressionIndex < expressionCount; ++expressionIndex)
+	{
+		handles[expressionIndex] = cache.Compile(expressions[expressionIndex]);
+	}
+
+	// Correctness check, both paths must produce the same text
+	char planText[ExpressionHost::BufferSize];
+	for (size_t expressionIndex = 0; expressionIndex < expressionCount; ++expressionIndex)
+	{
+		std::string reparsed(expressions[expressionIndex]);
+		reparsed.resize(ExpressionHost::BufferSize);
+		host.ParseMacroData(&reparsed[0], reparsed.size());
+
+		uint32_t length = 0;
+		cache.Evaluate(handles[expressionIndex], planText, sizeof(planText), &length);
+		if (strcmp(planText, reparsed.c_str()) != 0)
+		{
+			fprintf(stderr, "Mismatch for \"%s\": plan \"%s\", reparse \"%s\"\n", expressions[expressionIndex], planText, reparsed.c_str());
+			return 1;
+		}
+	}
+
+	uint64_t checksum = 0;
+	const auto reparseStart = std::chrono::steady_clock::now();
+	for (int iteration = 0; iteration < iterations; ++iteration)
+	{
+		for (size_t expressionIndex = 0; expressionIndex < expressionCount; ++expressionIndex)
+		{
+			std::string buffer(expressions[expressionIndex]);
+			buffer.resize(ExpressionHost::BufferSize);
+			host.ParseMacroData(&buffer[0], buffer.size());
+
+			double result = 0.0;
+			host.Calculate(&buffer[0], result);
+			checksum += static_cast<uint64_t>(result) + buffer[0];
+		}
+	}
+	const double reparseSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - reparseStart).count();
+
+	const auto planStart = std::chrono::steady_clock::now();
+	for (int iteration = 0; iteration < iterations; ++iteration)
+	{
+		for (size_t expressionIndex = 0; expressionIndex < expressionCount; ++expressionIndex)
+		{
+			double result = 0.0;
+			cache.Calculate(handles[expressionIndex], &result);
+			checksum += static_cast<uint64_t>(result);
+		}
+	}
+	const double planSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - planStart).count();
+
+	const double evaluationCount = static_cast<double>(iterations) * expressionCount;
+	printf("%zu expressions x %d iterations\n", expressionCount, iterations);
+	printf("reparse %10.1f ns/expression\n", reparseSeconds * 1e9 / evaluationCount);
+	printf("plan    %10.1f ns/expression  (%.1fx)  [%llu]\n", planSeconds * 1e9 / evaluationCount, reparseSeconds / planSeconds,
+		static_cast<unsigned long long>(checksum));
+	return 0;
+}
@@ -0,0 +1,235 @@
+// Compares the loader's inventory index against a FindItem style scan for lookups by id, by exact name and by partial name.
+//
+// Usage: InventoryIndexBenchmark [queries per size]
+//
+// Items are spread over inventory, bank and shared bank bags the way the loader walks them, with a few hundred distinct items
+// so most ids and names have several stacks. The scan case folds every item's name on every lookup like MQ2's FindItem does,
+// a managed FindItem is slower still since every item is a TLO or member read. The check is the per pulse cost when nothing
+// changed, the rebuild the cost when something did. Every query is also checked against the scan so the benchmark doubles as
+// a correctness test.
+
+#include "../InventoryIndex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct Item
+	{
+		InventoryContainer Container;
+		uint16_t Slot;
+		int16_t BagSlot;
+		uint32_t ItemId;
+		uint32_t StackCount;
+		char Name[InventoryIndex::MaxNameLength];
+	};
+
+	const uint32_t DistinctItemCount = 300;
+	const uint32_t BagSlotCount = 40;
+	const uint32_t ContainerMask = 0;
+
+	const char* const NameWords[] = { "Bone", "Chip", "Silk", "Diamond", "Water", "Flask", "Rune", "Scroll", "Velium", "Ore", "Spider", "Fang" };
+
+	template<typename Visit>
+	void walkItems(const std::vector<Item>& items, Visit visit)
+	{
+		for (const auto& item : items)
+		{
+			visit(item.Container, item.Slot, item.BagSlot, item.ItemId, item.StackCount, item.Name, &item);
+		}
+	}
+
+	std::string fold(const char* text)
+	{
+		std::string folded(text);
+		std::transform(folded.begin(), folded.end(), folded.begin(), [](char character) { return character >= 'A' && character <= 'Z' ? static_cast<char>(character - 'A' + 'a') : character; });
+		return folded;
+	}
+
+	uint32_t scanByName(const std::vector<Item>& items, const char* name, bool isExact, uint64_t& totalCount)
+	{
+		const std::string foldedName = fold(name);
+		uint32_t matchCount = 0;
+		totalCount = 0;
+		for (const auto& item : items)
+		{
+			const std::string foldedItemName = fold(item.Name);
+			if (isExact ? foldedItemName == foldedName : foldedItemName.find(foldedName) != std::string::npos)
+			{
+				++matchCount;
+				totalCount += item.StackCount;
+			}
+		}
+
+		return matchCount;
+	}
+
+	uint32_t scanById(const std::vector<Item>& items, uint32_t itemId, uint64_t& totalCount)
+	{
+		uint32_t matchCount = 0;
+		totalCount = 0;
+		for (const auto& item : items)
+		{
+			if (item.ItemId == itemId)
+			{
+				++matchCount;
+				totalCount += item.StackCount;
+			}
+		}
+
+		return matchCount;
+	}
+
+	template<typename Query>
+	double timeQueries(uint32_t queryCount, Query query, uint64_t& checksum)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (uint32_t queryIndex = 0; queryIndex < queryCount; ++queryIndex)
+		{
+			checksum += query(queryIndex);
+		}
+
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / queryCount;
+	}
+
+	bool runSize(uint32_t itemCount, uint32_t queryCount)
+	{
+		std::mt19937 random(itemCount);
+
+		std::vector<std::string> names(DistinctItemCount);
+		for (uint32_t nameIndex = 0; nameIndex < DistinctItemCount; ++nameIndex)
+		{
+			names[nameIndex] = std::string(NameWords[random() % 12]) + " " + NameWords[random() % 12] + " " + std::to_string(nameIndex);
+		}
+
+		std::vector<Item> items(itemCount);
+		for (uint32_t itemIndex = 0; itemIndex < itemCount; ++itemIndex)
+		{
+			const uint32_t bag = itemIndex / BagSlotCount;
+			const uint32_t distinctIndex = random() % DistinctItemCount;
+			Item& item = items[itemIndex];
+			item.Container = bag < 10 ? InventoryContainer::Inventory : bag < 34 ? InventoryContainer::Bank : InventoryContainer::SharedBank;
+			item.Slot = static_cast<uint16_t>(bag < 10 ? 23 + bag : bag < 34 ? bag - 10 : bag - 34);
+			item.BagSlot = static_cast<int16_t>(itemIndex % BagSlotCount);
+			item.ItemId = 1000 + distinctIndex;
+			item.StackCount = 1 + random() % 100;
+			snprintf(item.Name, sizeof(item.Name), "%s", names[distinctIndex].c_str());
+		}
+
+		InventoryIndex index;
+		auto walk = [&items](auto visit) { walkItems(items, visit); };
+
+		// The first refresh builds the index, time the steady state check that happens on the first query of every pulse and
+		// then a rebuild after a stack count changed
+		index.Refresh(walk);
+		const uint32_t pulseCount = 1000;
+		const auto checkStart = std::chrono::steady_clock::now();
+		for (uint32_t pulse = 0; pulse < pulseCount; ++pulse)
+		{
+			index.NextPulse();
+			index.Refresh(walk);
+		}
+
+		const double checkMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - checkStart).count() / pulseCount;
+
+		const auto rebuildStart = std::chrono::steady_clock::now();
+		for (uint32_t pulse = 0; pulse < pulseCount; ++pulse)
+		{
+			++items[pulse % itemCount].StackCount;
+			index.NextPulse();
+			index.Refresh(walk);
+		}
+
+		const double rebuildMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - rebuildStart).count() / pulseCount;
+
+		InventoryIndexStatistics statistics{};
+		index.GetStatistics(&statistics);
+		if (statistics.RebuildCount != pulseCount + 1 || statistics.SlotCount != itemCount)
+		{
+			fprintf(stderr, "Expected %u rebuilds of %u slots, got %llu of %u\n", pulseCount + 1, itemCount, static_cast<unsigned long long>(statistics.RebuildCount), statistics.SlotCount);
+			return false;
+		}
+
+		// Partial lookups use a word plus the start of a number, so they match a handful of names
+		std::vector<std::string> exactNames(queryCount), partialNames(queryCount);
+		std::vector<uint32_t> itemIds(queryCount);
+		for (uint32_t queryIndex = 0; queryIndex < queryCount; ++queryIndex)
+		{
+			const uint32_t distinctIndex = random() % DistinctItemCount;
+			itemIds[queryIndex] = 1000 + distinctIndex;
+			exactNames[queryIndex] = fold(names[distinctIndex].c_str());
+			exactNames[queryIndex][0] = static_cast<char>(exactNames[queryIndex][0] - 'a' + 'A');
+			partialNames[queryIndex] = std::string(NameWords[random() % 12]).substr(1) + " " + std::to_string(random() % 30);
+		}
+
+		// Correctness check against the scan
+		std::vector<InventorySlot> slots(itemCount);
+		for (uint32_t queryIndex = 0; queryIndex < std::min<uint32_t>(queryCount, 1000); ++queryIndex)
+		{
+			uint64_t indexTotal = 0;
+			uint64_t scanTotal = 0;
+			uint32_t indexCount = index.FindById(itemIds[queryIndex], ContainerMask, slots.data(), itemCount, &indexTotal);
+			uint32_t scanCount = scanById(items, itemIds[queryIndex], scanTotal);
+			const bool isIdMatch = indexCount == scanCount && indexTotal == scanTotal
+				&& std::all_of(slots.begin(), slots.begin() + indexCount, [&](const InventorySlot& slot) { return slot.ItemId == itemIds[queryIndex]; });
+
+			indexCount = index.FindByName(exactNames[queryIndex].c_str(), exactNames[queryIndex].size(), true, ContainerMask, slots.data(), itemCount, &indexTotal);
+			scanCount = scanByName(items, exactNames[queryIndex].c_str(), true, scanTotal);
+			const bool isExactMatch = indexCount == scanCount && indexTotal == scanTotal;
+
+			indexCount = index.FindByName(partialNames[queryIndex].c_str(), partialNames[queryIndex].size(), false, ContainerMask, slots.data(), itemCount, &indexTotal);
+			scanCount = scanByName(items, partialNames[queryIndex].c_str(), false, scanTotal);
+			const bool isPartialMatch = indexCount == scanCount && indexTotal == scanTotal;
+
+			if (!isIdMatch || !isExactMatch || !isPartialMatch)
+			{
+				fprintf(stderr, "Lookup mismatch with %u items for id %u / '%s' / '%s'\n", itemCount, itemIds[queryIndex], exactNames[queryIndex].c_str(), partialNames[queryIndex].c_str());
+				return false;
+			}
+		}
+
+		uint64_t checksum = 0;
+		uint64_t totalCount = 0;
+		InventorySlot* pSlots = slots.data();
+
+		const double indexById = timeQueries(queryCount, [&](uint32_t queryIndex) { return index.FindById(itemIds[queryIndex], ContainerMask, pSlots, itemCount, &totalCount); }, checksum);
+		const double scanByIdTime = timeQueries(queryCount, [&](uint32_t queryIndex) { return scanById(items, itemIds[queryIndex], totalCount); }, checksum);
+		const double indexExact = timeQueries(queryCount, [&](uint32_t queryIndex) { return index.FindByName(exactNames[queryIndex].c_str(), exactNames[queryIndex].size(), true, ContainerMask, pSlots, itemCount, &totalCount); }, checksum);
+		const double scanExact = timeQueries(queryCount, [&](uint32_t queryIndex) { return scanByName(items, exactNames[queryIndex].c_str(), true, totalCount); }, checksum);
+		const double indexPartial = timeQueries(queryCount, [&](uint32_t queryIndex) { return index.FindByName(partialNames[queryIndex].c_str(), partialNames[queryIndex].size(), false, ContainerMask, pSlots, itemCount, &totalCount); }, checksum);
+		const double scanPartial = timeQueries(queryCount, [&](uint32_t queryIndex) { return scanByName(items, partialNames[queryIndex].c_str(), false, totalCount); }, checksum);
+
+		printf("%5u items  check %6.1f us  rebuild %6.1f us  id %7.1f ns (scan %8.1f ns)  exact %7.1f ns (scan %9.1f ns)  partial %8.1f ns (scan %9.1f ns)  [%llu]\n",
+			itemCount, checkMicroseconds, rebuildMicroseconds, indexById, scanByIdTime, indexExact, scanExact, indexPartial, scanPartial,
+			static_cast<unsigned long long>(checksum));
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const uint32_t queryCount = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 20000;
+	if (queryCount == 0)
+	{
+		fprintf(stderr, "Usage: %s [queries per size]\n", argv[0]);
+		return 1;
+	}
+
+	// A character with a few bags, with full inventory bags, and with full inventory, bank and shared bank bags
+	for (uint32_t itemCount : { 100u, 400u, 1440u })
+	{
+		if (!runSize(itemCount, queryCount))
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,368 @@
+// Measures what each plugin callback costs end to end: the loader's forwarder, the native to managed transition and
+// MQ2DotNetCore's handler (with no programs running). The CLR is hosted through hostfxr exactly like in game, against the
+// fake MQ2Main.dll from stub/, then OnPulse, chat and spawn floods are driven through the loader's PLUGIN_API functions.
+//
+// Usage: LoaderCallbackBenchmark [MQ2 folder] [iterations]
+//
+// The MQ2 folder defaults to the one the benchmark is in, i.e. <build>/bin, and needs the managed build in an MQ2DotNetCore
+// subfolder (configure with -DMQ2DOTNETCORE_BUILD_MANAGED=ON). If hostfxr can't be found set DOTNET_ROOT.
+//
+// Every callback is run twice, once with the managed function pointer cleared so only the loader's side runs, and once
+// normally. The difference is the cost of crossing into the managed side and running its handler.
+//
+// To measure the asynchronous boot put AsyncBoot=1 under [Settings] in MQ2DotNetCoreLoader.ini in the MQ2 folder, the
+// InitializePlugin time is then how long the game thread is blocked and "ready after" how long until the managed side runs.
+// The chat callbacks are also run with every callback subscribed, once through each callback ABI: v1 marshals the line to a
+// string in the managed thunk, v2 passes it as a UTF-8 pointer + length and nothing is marshaled.
+//
+// Before the throughput runs the first frames after the managed side is ready are timed one by one, each a pulse, chat lines,
+// a spawn and a HUD draw with every callback subscribed. That is where the JIT shows up, compare them with and without PreWarm=1
+// under [Settings] in MQ2DotNetCoreLoader.ini. The loader's own warm-up summary (the first pulses only) is printed with them.
+//
+// With HotReload=1 the core is also reloaded a few times at the end, printing how long that took and whether the unloaded
+// copies were collected.
+
+#include "MQ2Plugin.h"
+#include "../AsyncBoot.h"
+#include "../CallbackSubscriptions.h"
+#include "../HotReload.h"
+#include "../LoaderPlatform.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+PLUGIN_API VOID InitializePlugin(VOID);
+PLUGIN_API VOID ShutdownPlugin(VOID);
+PLUGIN_API VOID OnPulse(VOID);
+PLUGIN_API VOID OnDrawHUD(VOID);
+PLUGIN_API DWORD OnWriteChatColor(PCHAR Line, DWORD Color, DWORD Filter);
+PLUGIN_API DWORD OnIncomingChat(PCHAR Line, DWORD Color);
+PLUGIN_API VOID OnAddSpawn(PSPAWNINFO pNewSpawn);
+PLUGIN_API VOID OnRemoveSpawn(PSPAWNINFO pSpawn);
+
+namespace
+{
+	// The managed function pointers are looked up the same way the managed side sets them. Declaring them extern here would
+	// give the executable its own copy of each one on Linux, which the loader would then use instead of the ones the
+	// managed side writes to.
+	struct ManagedPointers
+	{
+		void** ppPulse;
+		void** ppDrawHUD;
+		void** ppWriteChatColor;
+		void** ppIncomingChat;
+		void** ppWriteChatColorV2;
+		void** ppIncomingChatV2;
+		void** ppAddSpawn;
+		void** ppRemoveSpawn;
+		void** ppAddSpawnV2;
+		void** ppRemoveSpawnV2;
+	};
+
+	const DWORD UserColorDefault = 273;
+
+	std::vector<std::string> generateChatLines(size_t count)
+	{
+		const char* const templates[] = {
+			"You have been healed for %d points by %s.",
+			"%s hits YOU for %d points of damage.",
+			"You gain experience!!",
+			"%s tells you, 'invite %d'",
+			"Your target resisted the %s spell."
+		};
+		const char* const names[] = { "a_gnoll_pup", "Soandso", "a decaying skeleton", "Fippy Darkpaw" };
+
+		std::vector<std::string> lines;
+		char buffer[MAX_STRING];
+		for (size_t lineIndex = 0; lineIndex < count; ++lineIndex)
+		{
+			const int value = static_cast<int>(lineIndex * 7919 % 2000);
+			const char* name = names[lineIndex % 4];
+			switch (lineIndex % 5)
+			{
+			case 0: snprintf(buffer, sizeof(buffer), templates[0], value, name); break;
+			case 1: snprintf(buffer, sizeof(buffer), templates[1], name, value); break;
+			case 2: snprintf(buffer, sizeof(buffer), "%s", templates[2]); break;
+			case 3: snprintf(buffer, sizeof(buffer), templates[3], name, value); break;
+			default: snprintf(buffer, sizeof(buffer), templates[4], name); break;
+			}
+
+			lines.emplace_back(buffer);
+		}
+
+		return lines;
+	}
+
+	std::vector<SPAWNINFO> generateSpawns(size_t count)
+	{
+		std::vector<SPAWNINFO> spawns(count);
+		for (size_t spawnIndex = 0; spawnIndex < count; ++spawnIndex)
+		{
+			auto& spawn = spawns[spawnIndex];
+			snprintf(spawn.Name, sizeof(spawn.Name), "a_gnoll%02zu", spawnIndex);
+			spawn.SpawnID = static_cast<DWORD>(spawnIndex + 1);
+			spawn.Type = 1;
+			spawn.Level = static_cast<BYTE>(1 + spawnIndex % 60);
+			spawn.X = static_cast<float>(spawnIndex % 64) * 10.0f;
+			spawn.Y = static_cast<float>(spawnIndex / 64) * 10.0f;
+			spawn.HPCurrent = 100;
+			spawn.HPMax = 100;
+		}
+
+		return spawns;
+	}
+
+	// Runs callCount calls of call(index) and returns the time per call in ns
+	template<typename Call>
+	double timeCalls(uint64_t callCount, Call call)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (uint64_t callIndex = 0; callIndex < callCount; ++callIndex)
+		{
+			call(callIndex);
+		}
+
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / callCount;
+	}
+
+	// Times the calls with the managed function pointers cleared and then normally. Each pass is preceded by a warm up of
+	// a tenth of the calls so the managed side is jitted before it's timed.
+	template<typename Call>
+	void runScenario(const char* name, uint64_t callCount, std::vector<void**> managedPointers, Call call)
+	{
+		std::vector<void*> savedPointers;
+		for (auto ppPointer : managedPointers)
+		{
+			savedPointers.push_back(*ppPointer);
+			*ppPointer = nullptr;
+		}
+
+		timeCalls(callCount / 10, call);
+		const double loaderNanoseconds = timeCalls(callCount, call);
+
+		for (size_t pointerIndex = 0; pointerIndex < managedPointers.size(); ++pointerIndex)
+		{
+			*managedPointers[pointerIndex] = savedPointers[pointerIndex];
+		}
+
+		timeCalls(callCount / 10, call);
+		const double managedNanoseconds = timeCalls(callCount, call);
+
+		printf("%-16s %12.0f calls/sec %10.1f ns/call  loader only %8.1f ns/call  transition %10.1f ns\n",
+			name, 1e9 / managedNanoseconds, managedNanoseconds, loaderNanoseconds, managedNanoseconds - loaderNanoseconds);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const auto mq2Folder = std::filesystem::weakly_canonical(std::filesystem::absolute(argc > 1 ? std::filesystem::path(argv[1]) : std::filesystem::path(argv[0]).parent_path()));
+	const long long iterations = argc > 2 ? atoll(argv[2]) : 1000000;
+	if (iterations <= 0 || mq2Folder.string().size() >= MAX_PATH)
+	{
+		fprintf(stderr, "Usage: %s [MQ2 folder] [iterations]\n", argv[0]);
+		return 1;
+	}
+
+	if (!std::filesystem::exists(mq2Folder / "MQ2DotNetCore" / "MQ2DotNetCore.dll"))
+	{
+		fprintf(stderr, "%s doesn't exist, configure with -DMQ2DOTNETCORE_BUILD_MANAGED=ON or pass the MQ2 folder\n",
+			(mq2Folder / "MQ2DotNetCore" / "MQ2DotNetCore.dll").string().c_str());
+		return 1;
+	}
+
+	snprintf(gszINIPath, sizeof(gszINIPath), "%s", mq2Folder.string().c_str());
+
+	char_t loaderPath[MAX_PATH];
+	buildLoaderPath(loaderPath, MAX_PATH, gszINIPath, nullptr, "MQ2DotNetCoreLoader.dll");
+	void* loaderLibrary = loadLibrary(loaderPath);
+	const ManagedPointers managed{
+		static_cast<void**>(getLibraryExport(loaderLibrary, "g_pfOnPulse")),
+		static_cast<void**>(getLibraryExport(loaderLibrary, "g_pfOnDrawHUD")),
+		static_cast<void**>(getLibraryExport(loaderLibrary, "g_pfOnWriteChatColor")),
+		static_cast<void**>(getLibraryExport(loaderLibrary, "g_pfOnIncomingChat")),
+		static_cast<void**>(getLibraryExport(loaderLibrary, "g_pfOnWriteChatColorV2")),
+		static_cast<void**>(getLibraryExport(loaderLibrary, "g_pfOnIncomingChatV2")),
+		static_cast<void**>(getLibraryExport(loaderLibrary, "g_pfOnAddSpawn")),
+		static_cast<void**>(getLibraryExport(loaderLibrary, "g_pfOnRemoveSpawn")),
+		static_cast<void**>(getLibraryExport(loaderLibrary, "g_pfOnAddSpawnV2")),
+		static_cast<void**>(getLibraryExport(loaderLibrary, "g_pfOnRemoveSpawnV2"))
+	};
+	if (!managed.ppPulse || !managed.ppDrawHUD || !managed.ppWriteChatColor || !managed.ppIncomingChat || !managed.ppWriteChatColorV2 || !managed.ppIncomingChatV2 || !managed.ppAddSpawn || !managed.ppRemoveSpawn
+		|| !managed.ppAddSpawnV2 || !managed.ppRemoveSpawnV2)
+	{
+		fprintf(stderr, "Couldn't find the managed function pointers in MQ2DotNetCoreLoader.dll\n");
+		return 1;
+	}
+
+	const auto initializeStart = std::chrono::steady_clock::now();
+	InitializePlugin();
+	const double initializeMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - initializeStart).count();
+
+	// With AsyncBoot=1 the managed side is initialized from a later OnPulse, pulse like the game would until it is
+	while (*managed.ppPulse == nullptr && std::chrono::steady_clock::now() - initializeStart < std::chrono::seconds(30))
+	{
+		OnPulse();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	const double readyMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - initializeStart).count();
+	if (*managed.ppPulse == nullptr)
+	{
+		fprintf(stderr, "The managed side didn't initialize, see %s\n", (mq2Folder / "MQ2DotNetCore" / "debug_plugin.log").string().c_str());
+		return 1;
+	}
+
+	printf("InitializePlugin %.1f ms, ready after %.1f ms, %lld iterations\n", initializeMilliseconds, readyMilliseconds, iterations);
+
+	auto chatLines = generateChatLines(4096);
+	auto spawns = generateSpawns(512);
+
+	// Paced like the ready loop above, so a background warm-up gets to run between frames like it would in game
+	typedef uint32_t (*fSetSubscriptionMask)(uint32_t);
+	typedef uint32_t (*fGetSubscriptionMask)(uint32_t*);
+	typedef void (*fGetWarmupSummary)(WarmupSummary*);
+	const auto setSubscriptionMask = reinterpret_cast<fSetSubscriptionMask>(getLibraryExport(loaderLibrary, "CallbackSubscriptions__SetMask"));
+	const auto getSubscriptionMask = reinterpret_cast<fGetSubscriptionMask>(getLibraryExport(loaderLibrary, "CallbackSubscriptions__GetMask"));
+	const auto getWarmupSummary = reinterpret_cast<fGetWarmupSummary>(getLibraryExport(loaderLibrary, "AsyncBoot__GetWarmupSummary"));
+	if (setSubscriptionMask && getSubscriptionMask && getWarmupSummary)
+	{
+		// The managed side publishes its own mask from the first pulse it handles, that is the one to go back to afterwards
+		uint32_t publishedMask = 0;
+		setSubscriptionMask(CallbackSubscriptions::AllCallbacks);
+
+		std::vector<double> frameMicroseconds;
+		for (uint32_t frameIndex = 0; frameIndex < AsyncBoot::WarmupPulseCount; ++frameIndex)
+		{
+			const auto frameStart = std::chrono::steady_clock::now();
+			OnPulse();
+			if (frameIndex == 0)
+			{
+				publishedMask = getSubscriptionMask(nullptr);
+				setSubscriptionMask(CallbackSubscriptions::AllCallbacks);
+			}
+
+			OnWriteChatColor(&chatLines[frameIndex][0], UserColorDefault, 0);
+			OnIncomingChat(&chatLines[frameIndex + 1][0], UserColorDefault);
+			OnAddSpawn(&spawns[frameIndex]);
+			OnRemoveSpawn(&spawns[frameIndex]);
+			OnDrawHUD();
+			frameMicroseconds.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - frameStart).count());
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		setSubscriptionMask(publishedMask);
+
+		const double firstFrameMicroseconds = frameMicroseconds[0];
+		double totalMicroseconds = 0;
+		for (const double microseconds : frameMicroseconds)
+		{
+			totalMicroseconds += microseconds;
+		}
+
+		std::sort(frameMicroseconds.begin(), frameMicroseconds.end());
+		printf("First %zu frames  first %.1f us, p50 %.1f us, p99 %.1f us, max %.1f us, total %.1f ms\n", frameMicroseconds.size(), firstFrameMicroseconds,
+			frameMicroseconds[frameMicroseconds.size() / 2], frameMicroseconds[frameMicroseconds.size() * 99 / 100], frameMicroseconds.back(), totalMicroseconds / 1000);
+
+		WarmupSummary warmup;
+		getWarmupSummary(&warmup);
+		printf("Loader warm-up   first pulse after %.1f ms, first %u pulses p50 %.1f us, p99 %.1f us, max %.1f us%s\n", warmup.TimeToFirstPulseNanoseconds / 1e6,
+			warmup.PulseCount, warmup.Pulses.P50Nanoseconds / 1e3, warmup.Pulses.P99Nanoseconds / 1e3, warmup.Pulses.MaxNanoseconds / 1e3,
+			warmup.IsPreWarmEnabled ? ", pre-warmed" : "");
+	}
+
+	const uint64_t callCount = static_cast<uint64_t>(iterations);
+	runScenario("OnPulse", callCount, { managed.ppPulse }, [](uint64_t) { OnPulse(); });
+	runScenario("OnDrawHUD", callCount, { managed.ppDrawHUD }, [](uint64_t) { OnDrawHUD(); });
+
+	runScenario("OnWriteChatColor", callCount, { managed.ppWriteChatColor }, [&](uint64_t callIndex)
+	{
+		OnWriteChatColor(&chatLines[callIndex & 4095][0], UserColorDefault, 0);
+	});
+	runScenario("OnIncomingChat", callCount, { managed.ppIncomingChat }, [&](uint64_t callIndex)
+	{
+		OnIncomingChat(&chatLines[callIndex & 4095][0], UserColorDefault);
+	});
+
+	// Each call adds a spawn and removes the one added 256 calls earlier, like a busy zone churning
+	const auto churnSpawns = [&](uint64_t callIndex)
+	{
+		OnAddSpawn(&spawns[callIndex & 511]);
+		if (callIndex >= 256)
+			OnRemoveSpawn(&spawns[(callIndex - 256) & 511]);
+	};
+	runScenario("OnAdd/RemoveSpawn", callCount, { managed.ppAddSpawn, managed.ppRemoveSpawn, managed.ppAddSpawnV2, managed.ppRemoveSpawnV2 }, churnSpawns);
+
+	// Nothing subscribes to chat or spawns with no programs running, so the loader skips them above. Subscribed, they show what
+	// crossing into the managed side costs through each ABI.
+	typedef uint32_t (*fSelectAbiVersion)(uint32_t);
+	typedef uint32_t (*fGetAbiVersion)();
+	const auto selectAbiVersion = reinterpret_cast<fSelectAbiVersion>(getLibraryExport(loaderLibrary, "LoaderAbi__SelectVersion"));
+	const auto getAbiVersion = reinterpret_cast<fGetAbiVersion>(getLibraryExport(loaderLibrary, "LoaderAbi__GetVersion"));
+	if (setSubscriptionMask && getSubscriptionMask && selectAbiVersion && getAbiVersion)
+	{
+		const uint32_t savedMask = getSubscriptionMask(nullptr);
+		const uint32_t savedAbiVersion = getAbiVersion();
+		setSubscriptionMask(CallbackSubscriptions::AllCallbacks);
+
+		for (uint32_t abiVersion = 1; abiVersion <= 2; ++abiVersion)
+		{
+			if (selectAbiVersion(abiVersion) != abiVersion)
+			{
+				printf("Callback ABI v%u is turned off by CallbackAbi in MQ2DotNetCoreLoader.ini\n", abiVersion);
+				continue;
+			}
+
+			char name[32];
+			snprintf(name, sizeof(name), "WriteChat v%u", abiVersion);
+			runScenario(name, callCount, abiVersion == 1 ? std::vector<void**>{ managed.ppWriteChatColor } : std::vector<void**>{ managed.ppWriteChatColor, managed.ppWriteChatColorV2 }, [&](uint64_t callIndex)
+			{
+				OnWriteChatColor(&chatLines[callIndex & 4095][0], UserColorDefault, 0);
+			});
+
+			snprintf(name, sizeof(name), "IncomingChat v%u", abiVersion);
+			runScenario(name, callCount, abiVersion == 1 ? std::vector<void**>{ managed.ppIncomingChat } : std::vector<void**>{ managed.ppIncomingChat, managed.ppIncomingChatV2 }, [&](uint64_t callIndex)
+			{
+				OnIncomingChat(&chatLines[callIndex & 4095][0], UserColorDefault);
+			});
+
+			// v1 looks the spawn's handle up with another call into the loader
+			snprintf(name, sizeof(name), "Spawns v%u", abiVersion);
+			runScenario(name, callCount, abiVersion == 1 ? std::vector<void**>{ managed.ppAddSpawn, managed.ppRemoveSpawn } : std::vector<void**>{ managed.ppAddSpawn, managed.ppRemoveSpawn, managed.ppAddSpawnV2, managed.ppRemoveSpawnV2 }, churnSpawns);
+		}
+
+		selectAbiVersion(savedAbiVersion);
+		setSubscriptionMask(savedMask);
+	}
+
+	// A reload runs at the start of the pulse after it was requested
+	typedef bool (*fRequestHotReload)();
+	typedef void (*fGetHotReloadStatistics)(HotReloadStatistics*);
+	const auto requestHotReload = reinterpret_cast<fRequestHotReload>(getLibraryExport(loaderLibrary, "LoaderHotReload__Request"));
+	const auto getHotReloadStatistics = reinterpret_cast<fGetHotReloadStatistics>(getLibraryExport(loaderLibrary, "LoaderHotReload__GetStatistics"));
+	if (requestHotReload && getHotReloadStatistics && requestHotReload())
+	{
+		const uint32_t reloadCount = 5;
+		for (uint32_t reloadIndex = 0; reloadIndex < reloadCount; ++reloadIndex)
+		{
+			if (reloadIndex > 0)
+				requestHotReload();
+
+			OnPulse();
+		}
+
+		HotReloadStatistics statistics;
+		getHotReloadStatistics(&statistics);
+		printf("Hot reload       %u reloads, %u failed, last %.1f ms, longest %.1f ms, %u unloaded load contexts still alive\n",
+			statistics.ReloadCount, statistics.FailedReloadCount, statistics.LastReloadNanoseconds / 1e6, statistics.LongestReloadNanoseconds / 1e6,
+			statistics.LeakedContextCount);
+	}
+
+	ShutdownPlugin();
+	return 0;
+}
@@ -0,0 +1,375 @@
+// Feeds a capture written with Capture=1 (see CallbackCapture.h) back through the loader's PLUGIN_API functions, so a real
+// session's callbacks, e.g. a raid, can be profiled offline. The CLR and the fake MQ2Main.dll are hosted the same way as in
+// LoaderCallbackBenchmark.
+//
+// Usage: LoaderReplay <capture file> [MQ2 folder] [--realtime]
+//
+// By default records are replayed back to back, which shows the throughput. With --realtime each one waits until the time it
+// was captured at, which reproduces the pacing of the session, and how far behind schedule the replay fell is reported too.
+// Either way the loader's callback timings are printed for every callback at the end.
+//
+// Spawns and ground items are rebuilt from the captured fields. Spawns that were in the zone when the capture started are put
+// in the spawn list before the loader initializes, so it finds them the way it did in game.
+
+#include "MQ2Plugin.h"
+#include "../CallbackCapture.h"
+#include "../LoaderPlatform.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+PLUGIN_API VOID InitializePlugin(VOID);
+PLUGIN_API VOID ShutdownPlugin(VOID);
+PLUGIN_API VOID OnCleanUI(VOID);
+PLUGIN_API VOID OnReloadUI(VOID);
+PLUGIN_API VOID OnDrawHUD(VOID);
+PLUGIN_API VOID SetGameState(DWORD GameState);
+PLUGIN_API VOID OnPulse(VOID);
+PLUGIN_API DWORD OnWriteChatColor(PCHAR Line, DWORD Color, DWORD Filter);
+PLUGIN_API DWORD OnIncomingChat(PCHAR Line, DWORD Color);
+PLUGIN_API VOID OnAddSpawn(PSPAWNINFO pNewSpawn);
+PLUGIN_API VOID OnRemoveSpawn(PSPAWNINFO pSpawn);
+PLUGIN_API VOID OnAddGroundItem(PGROUNDITEM pNewGroundItem);
+PLUGIN_API VOID OnRemoveGroundItem(PGROUNDITEM pGroundItem);
+PLUGIN_API VOID BeginZone(VOID);
+PLUGIN_API VOID EndZone(VOID);
+PLUGIN_API VOID OnZoned(VOID);
+
+namespace
+{
+	const char* const CallbackNames[] = {
+		"OnPulse", "OnDrawHUD", "OnWriteChatColor", "OnIncomingChat", "OnAddSpawn", "OnRemoveSpawn", "OnAddGroundItem",
+		"OnRemoveGroundItem", "BeginZone", "EndZone", "OnZoned", "OnReloadUI", "OnCleanUI", "SetGameState"
+	};
+	static_assert(sizeof(CallbackNames) / sizeof(CallbackNames[0]) == static_cast<size_t>(LoaderCallback::Count), "A callback is missing a name");
+
+	// Owns the rebuilt spawns and ground items by their captured address. Spawns are also linked into the stub's spawn list,
+	// which the loader and the managed side walk.
+	class ReplayWorld
+	{
+	public:
+		~ReplayWorld()
+		{
+			while (!m_spawns.empty())
+				RemoveSpawn(m_spawns.begin()->first);
+		}
+
+		PSPAWNINFO AddSpawn(const CapturedSpawn& captured)
+		{
+			auto& pSpawn = m_spawns[captured.Address];
+			if (!pSpawn)
+			{
+				pSpawn = std::make_unique<SPAWNINFO>();
+				link(pSpawn.get());
+			}
+
+			snprintf(pSpawn->Name, sizeof(pSpawn->Name), "%.*s", static_cast<int>(sizeof(captured.Name)), captured.Name);
+			pSpawn->X = captured.X;
+			pSpawn->Y = captured.Y;
+			pSpawn->Z = captured.Z;
+			pSpawn->Heading = captured.Heading;
+			pSpawn->SpawnID = captured.SpawnID;
+			pSpawn->Type = captured.Type;
+			pSpawn->Level = captured.Level;
+			pSpawn->StandState = captured.StandState;
+			pSpawn->HPCurrent = captured.HPCurrent;
+			pSpawn->HPMax = captured.HPMax;
+			return pSpawn.get();
+		}
+
+		// The spawn stays alive until RemoveSpawn, like in game where it's freed after OnRemoveSpawn returns
+		PSPAWNINFO FindSpawn(const CapturedSpawn& captured)
+		{
+			const auto existing = m_spawns.find(captured.Address);
+			return existing != m_spawns.end() ? existing->second.get() : AddSpawn(captured);
+		}
+
+		void RemoveSpawn(uint64_t address)
+		{
+			const auto existing = m_spawns.find(address);
+			if (existing == m_spawns.end())
+				return;
+
+			unlink(existing->second.get());
+			m_spawns.erase(existing);
+		}
+
+		PGROUNDITEM FindGroundItem(const CapturedGroundItem& captured)
+		{
+			auto& pGroundItem = m_groundItems[captured.Address];
+			if (!pGroundItem)
+				pGroundItem = std::make_unique<GROUNDITEM>();
+
+			snprintf(pGroundItem->Name, sizeof(pGroundItem->Name), "%.*s", static_cast<int>(sizeof(captured.Name)), captured.Name);
+			pGroundItem->X = captured.X;
+			pGroundItem->Y = captured.Y;
+			pGroundItem->Z = captured.Z;
+			pGroundItem->Heading = captured.Heading;
+			pGroundItem->ID = captured.ID;
+			pGroundItem->DropID = captured.DropID;
+			return pGroundItem.get();
+		}
+
+		void RemoveGroundItem(uint64_t address) { m_groundItems.erase(address); }
+
+		size_t GetSpawnCount() const { return m_spawns.size(); }
+
+	private:
+		static void link(PSPAWNINFO pSpawn)
+		{
+			pSpawn->pPrev = pSpawnManager->LastSpawn;
+			pSpawn->pNext = nullptr;
+			if (pSpawnManager->LastSpawn)
+				pSpawnManager->LastSpawn->pNext = pSpawn;
+			else
+				pSpawnManager->FirstSpawn = pSpawn;
+
+			pSpawnManager->LastSpawn = pSpawn;
+		}
+
+		static void unlink(PSPAWNINFO pSpawn)
+		{
+			if (pSpawn->pPrev)
+				pSpawn->pPrev->pNext = pSpawn->pNext;
+			else
+				pSpawnManager->FirstSpawn = pSpawn->pNext;
+
+			if (pSpawn->pNext)
+				pSpawn->pNext->pPrev = pSpawn->pPrev;
+			else
+				pSpawnManager->LastSpawn = pSpawn->pPrev;
+		}
+
+		std::unordered_map<uint64_t, std::unique_ptr<SPAWNINFO>> m_spawns;
+		std::unordered_map<uint64_t, std::unique_ptr<GROUNDITEM>> m_groundItems;
+	};
+
+	template<typename Captured>
+	bool readPayload(const CaptureRecord& record, Captured* pCaptured)
+	{
+		if (record.PayloadSize != sizeof(Captured))
+			return false;
+
+		memcpy(pCaptured, record.pPayload, sizeof(Captured));
+		return true;
+	}
+
+	void dispatch(const CaptureRecord& record, ReplayWorld& world)
+	{
+		switch (record.Callback)
+		{
+		case LoaderCallback::Pulse: OnPulse(); break;
+		case LoaderCallback::DrawHUD: OnDrawHUD(); break;
+		case LoaderCallback::BeginZone: BeginZone(); break;
+		case LoaderCallback::EndZone: EndZone(); break;
+		case LoaderCallback::Zoned: OnZoned(); break;
+		case LoaderCallback::ReloadUI: OnReloadUI(); break;
+		case LoaderCallback::CleanUI: OnCleanUI(); break;
+		case LoaderCallback::SetGameState: SetGameState(record.Arguments[0]); break;
+
+		case LoaderCallback::WriteChatColor:
+		case LoaderCallback::IncomingChat:
+		{
+			// The forwarders take a writable line, like MQ2 passes them
+			char line[CallbackCapture::MaxPayloadSize + 1];
+			memcpy(line, record.pPayload, record.PayloadSize);
+			line[record.PayloadSize] = '\0';
+			if (record.Callback == LoaderCallback::WriteChatColor)
+				OnWriteChatColor(line, record.Arguments[0], record.Arguments[1]);
+			else
+				OnIncomingChat(line, record.Arguments[0]);
+			break;
+		}
+
+		case LoaderCallback::AddSpawn:
+		case LoaderCallback::RemoveSpawn:
+		{
+			CapturedSpawn captured;
+			if (!readPayload(record, &captured))
+				break;
+
+			if (record.Callback == LoaderCallback::AddSpawn)
+			{
+				OnAddSpawn(world.AddSpawn(captured));
+			}
+			else
+			{
+				OnRemoveSpawn(world.FindSpawn(captured));
+				world.RemoveSpawn(captured.Address);
+			}
+			break;
+		}
+
+		case LoaderCallback::AddGroundItem:
+		case LoaderCallback::RemoveGroundItem:
+		{
+			CapturedGroundItem captured;
+			if (!readPayload(record, &captured))
+				break;
+
+			if (record.Callback == LoaderCallback::AddGroundItem)
+			{
+				OnAddGroundItem(world.FindGroundItem(captured));
+			}
+			else
+			{
+				OnRemoveGroundItem(world.FindGroundItem(captured));
+				world.RemoveGroundItem(captured.Address);
+			}
+			break;
+		}
+
+		default:
+			break;
+		}
+	}
+
+	bool isSeededSpawn(const CaptureRecord& record)
+	{
+		return record.Callback == LoaderCallback::AddSpawn && (record.Arguments[0] & CaptureSeeded) != 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const char* capturePath = nullptr;
+	const char* folder = nullptr;
+	bool isRealtime = false;
+	for (int argumentIndex = 1; argumentIndex < argc; ++argumentIndex)
+	{
+		if (strcmp(argv[argumentIndex], "--realtime") == 0)
+			isRealtime = true;
+		else if (!capturePath)
+			capturePath = argv[argumentIndex];
+		else if (!folder)
+			folder = argv[argumentIndex];
+	}
+
+	const auto mq2Folder = std::filesystem::weakly_canonical(std::filesystem::absolute(folder ? std::filesystem::path(folder) : std::filesystem::path(argv[0]).parent_path()));
+	if (!capturePath || mq2Folder.string().size() >= MAX_PATH)
+	{
+		fprintf(stderr, "Usage: %s <capture file> [MQ2 folder] [--realtime]\n", argv[0]);
+		return 1;
+	}
+
+	CallbackCaptureReader reader;
+	if (!reader.Open(std::filesystem::path(capturePath).c_str()))
+	{
+		fprintf(stderr, "%s isn't a version %u capture\n", capturePath, CallbackCapture::Version);
+		return 1;
+	}
+
+	if (!std::filesystem::exists(mq2Folder / "MQ2DotNetCore" / "MQ2DotNetCore.dll"))
+	{
+		fprintf(stderr, "%s doesn't exist, configure with -DMQ2DOTNETCORE_BUILD_MANAGED=ON or pass the MQ2 folder\n",
+			(mq2Folder / "MQ2DotNetCore" / "MQ2DotNetCore.dll").string().c_str());
+		return 1;
+	}
+
+	snprintf(gszINIPath, sizeof(gszINIPath), "%s", mq2Folder.string().c_str());
+
+	char_t loaderPath[MAX_PATH];
+	buildLoaderPath(loaderPath, MAX_PATH, gszINIPath, nullptr, "MQ2DotNetCoreLoader.dll");
+	void* loaderLibrary = loadLibrary(loaderPath);
+
+	typedef bool (*fGetTimingSummary)(uint32_t, CallbackTimingSummary*);
+	typedef void (*fResetTimings)();
+	const auto ppPulse = static_cast<void**>(getLibraryExport(loaderLibrary, "g_pfOnPulse"));
+	const auto getTimingSummary = reinterpret_cast<fGetTimingSummary>(getLibraryExport(loaderLibrary, "CallbackTimings__GetSummary"));
+	const auto resetTimings = reinterpret_cast<fResetTimings>(getLibraryExport(loaderLibrary, "CallbackTimings__Reset"));
+	if (!ppPulse || !getTimingSummary || !resetTimings)
+	{
+		fprintf(stderr, "Couldn't find the callback timing functions in MQ2DotNetCoreLoader.dll\n");
+		return 1;
+	}
+
+	ReplayWorld world;
+	CaptureRecord record;
+	uint64_t recordCount = 0;
+	uint64_t captureNanoseconds = 0;
+	while (reader.Next(&record))
+	{
+		if (isSeededSpawn(record))
+		{
+			CapturedSpawn captured;
+			if (readPayload(record, &captured))
+				world.AddSpawn(captured);
+		}
+		else
+		{
+			++recordCount;
+			captureNanoseconds = record.Nanoseconds;
+		}
+	}
+
+	printf("%llu callbacks over %.1f s, %zu spawns in the zone at the start\n",
+		static_cast<unsigned long long>(recordCount), captureNanoseconds / 1e9, world.GetSpawnCount());
+
+	InitializePlugin();
+
+	// With AsyncBoot=1 the managed side is initialized from a later OnPulse
+	const auto initializeStart = std::chrono::steady_clock::now();
+	while (*ppPulse == nullptr && std::chrono::steady_clock::now() - initializeStart < std::chrono::seconds(30))
+	{
+		OnPulse();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	if (*ppPulse == nullptr)
+	{
+		fprintf(stderr, "The managed side didn't initialize, see %s\n", (mq2Folder / "MQ2DotNetCore" / "debug_plugin.log").string().c_str());
+		return 1;
+	}
+
+	resetTimings();
+	reader.Rewind();
+
+	uint64_t totalLagNanoseconds = 0;
+	uint64_t maxLagNanoseconds = 0;
+	const auto replayStart = std::chrono::steady_clock::now();
+	while (reader.Next(&record))
+	{
+		if (isSeededSpawn(record))
+			continue;
+
+		if (isRealtime)
+		{
+			const auto scheduled = replayStart + std::chrono::nanoseconds(record.Nanoseconds);
+			std::this_thread::sleep_until(scheduled);
+
+			const auto lag = static_cast<uint64_t>(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - scheduled).count()));
+			totalLagNanoseconds += lag;
+			maxLagNanoseconds = std::max(maxLagNanoseconds, lag);
+		}
+
+		dispatch(record, world);
+	}
+
+	const double replaySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - replayStart).count();
+	printf("Replayed in %.3f s, %.0f callbacks/sec\n", replaySeconds, recordCount / replaySeconds);
+	if (isRealtime && recordCount > 0)
+		printf("Behind schedule by %.1f us on average, %.1f us at most\n", totalLagNanoseconds / 1e3 / recordCount, maxLagNanoseconds / 1e3);
+
+	printf("%-20s %10s %10s %10s %10s %10s %10s\n", "Callback", "Count", "Mean ns", "P50 ns", "P90 ns", "P99 ns", "Max ns");
+	for (uint32_t callback = 0; callback < static_cast<uint32_t>(LoaderCallback::Count); ++callback)
+	{
+		CallbackTimingSummary summary;
+		if (!getTimingSummary(callback, &summary) || summary.Count == 0)
+			continue;
+
+		printf("%-20s %10llu %10.0f %10llu %10llu %10llu %10llu\n", CallbackNames[callback], static_cast<unsigned long long>(summary.Count),
+			static_cast<double>(summary.TotalNanoseconds) / summary.Count, static_cast<unsigned long long>(summary.P50Nanoseconds),
+			static_cast<unsigned long long>(summary.P90Nanoseconds), static_cast<unsigned long long>(summary.P99Nanoseconds),
+			static_cast<unsigned long long>(summary.MaxNanoseconds));
+	}
+
+	ShutdownPlugin();
+	return 0;
+}
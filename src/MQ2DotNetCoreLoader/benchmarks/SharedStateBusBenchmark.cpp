@@ -0,0 +1,242 @@
+// Runs several client processes against one shared state bus, the way multiboxed clients on one machine would use it. Every
+// client publishes its state and broadcasts a message each pulse, then reads every other client's state and its messages.
+//
+// Usage: SharedStateBusBenchmark [clients] [pulses] [pulse microseconds]
+//
+// States are checked for torn reads (every field of a published state carries the same pulse number) and every client
+// checks it received every other client's messages in order. POSIX only, the clients are forked.
+
+#include "../SharedStateBus.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	const uint32_t PulseMessageType = 1;
+	const uint32_t DoneMessageType = 2;
+
+	// What a client would publish: HP, mana, target and position. Every field is derived from the pulse so readers can tell a
+	// torn copy from a consistent one.
+	struct ClientState
+	{
+		uint32_t Pulse;
+		uint32_t SpawnId;
+		uint32_t TargetId;
+		uint8_t HPPercent;
+		uint8_t ManaPercent;
+		uint8_t EndurancePercent;
+		uint8_t Reserved;
+		float X;
+		float Y;
+		float Z;
+		uint32_t Check;
+	};
+
+	ClientState makeState(uint32_t clientIndex, uint32_t pulse)
+	{
+		const auto value = static_cast<float>(pulse);
+		return ClientState{ pulse, clientIndex + 1, pulse * 7, static_cast<uint8_t>(pulse % 101), static_cast<uint8_t>(pulse % 97),
+			static_cast<uint8_t>(pulse % 89), 0, value, -value, value * 0.5f, pulse ^ 0x5a5a5a5au };
+	}
+
+	bool isConsistent(const ClientState& state)
+	{
+		const ClientState expected = makeState(state.SpawnId - 1, state.Pulse);
+		return state.TargetId == expected.TargetId && state.HPPercent == expected.HPPercent && state.ManaPercent == expected.ManaPercent
+			&& state.EndurancePercent == expected.EndurancePercent && state.X == expected.X && state.Y == expected.Y
+			&& state.Z == expected.Z && state.Check == expected.Check;
+	}
+
+	double elapsedNanoseconds(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	int runClient(const char* busName, uint32_t clientIndex, uint32_t clientCount, uint32_t pulseCount, uint32_t pulseMicroseconds)
+	{
+		char instanceName[32];
+		snprintf(instanceName, sizeof(instanceName), "Client%u", clientIndex);
+
+		SharedStateBus bus;
+		if (!bus.Open(busName, instanceName))
+		{
+			fprintf(stderr, "%s couldn't open the bus\n", instanceName);
+			return 1;
+		}
+
+		// Wait for everyone, so no client sends before the others started reading
+		const auto waitStart = std::chrono::steady_clock::now();
+		for (;;)
+		{
+			uint32_t openCount = 0;
+			SharedStateInstanceInfo info;
+			for (uint32_t instanceIndex = 0; instanceIndex < SharedStateBus::InstanceCapacity; ++instanceIndex)
+			{
+				openCount += bus.GetInstance(instanceIndex, &info) ? 1 : 0;
+			}
+
+			if (openCount >= clientCount)
+				break;
+
+			if (elapsedNanoseconds(waitStart) > 10e9)
+			{
+				fprintf(stderr, "%s timed out waiting for the other clients\n", instanceName);
+				return 1;
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		// The last pulse number seen from each instance, messages have to arrive in order
+		std::vector<int64_t> lastPulses(SharedStateBus::InstanceCapacity, -1);
+		std::vector<SharedStateMessage> messages(256);
+		uint64_t receivedCount = 0;
+		uint64_t outOfOrderCount = 0;
+		uint64_t tornCount = 0;
+		uint64_t readCount = 0;
+		uint32_t doneCount = 0;
+		double publishNanoseconds = 0;
+		double readNanoseconds = 0;
+		double sendNanoseconds = 0;
+		double receiveNanoseconds = 0;
+
+		const auto receiveAll = [&]()
+		{
+			const auto start = std::chrono::steady_clock::now();
+			uint32_t count;
+			while ((count = bus.Receive(messages.data(), static_cast<uint32_t>(messages.size()))) > 0)
+			{
+				for (uint32_t messageIndex = 0; messageIndex < count; ++messageIndex)
+				{
+					const SharedStateMessage& message = messages[messageIndex];
+					if (message.MessageType == DoneMessageType)
+					{
+						++doneCount;
+						continue;
+					}
+
+					uint32_t pulse;
+					memcpy(&pulse, message.Payload, sizeof(pulse));
+					int64_t& lastPulse = lastPulses[static_cast<uint32_t>(message.SenderIndex)];
+					outOfOrderCount += static_cast<int64_t>(pulse) != lastPulse + 1 ? 1 : 0;
+					lastPulse = pulse;
+					++receivedCount;
+				}
+			}
+
+			receiveNanoseconds += elapsedNanoseconds(start);
+		};
+
+		for (uint32_t pulse = 0; pulse < pulseCount; ++pulse)
+		{
+			const auto pulseStart = std::chrono::steady_clock::now();
+
+			const ClientState state = makeState(clientIndex, pulse);
+			auto start = std::chrono::steady_clock::now();
+			bus.Publish(&state, sizeof(state));
+			publishNanoseconds += elapsedNanoseconds(start);
+
+			start = std::chrono::steady_clock::now();
+			bus.Send(-1, PulseMessageType, &pulse, sizeof(pulse));
+			sendNanoseconds += elapsedNanoseconds(start);
+
+			start = std::chrono::steady_clock::now();
+			for (uint32_t instanceIndex = 0; instanceIndex < SharedStateBus::InstanceCapacity; ++instanceIndex)
+			{
+				ClientState otherState;
+				if (static_cast<int32_t>(instanceIndex) != bus.GetInstanceIndex() && bus.ReadState(instanceIndex, &otherState, sizeof(otherState)) == sizeof(otherState))
+				{
+					tornCount += isConsistent(otherState) ? 0 : 1;
+					++readCount;
+				}
+			}
+			readNanoseconds += elapsedNanoseconds(start);
+
+			receiveAll();
+
+			const auto pulseElapsed = std::chrono::steady_clock::now() - pulseStart;
+			if (pulseElapsed < std::chrono::microseconds(pulseMicroseconds))
+				std::this_thread::sleep_for(std::chrono::microseconds(pulseMicroseconds) - pulseElapsed);
+		}
+
+		bus.Send(-1, DoneMessageType, nullptr, 0);
+		const auto drainStart = std::chrono::steady_clock::now();
+		while (doneCount + 1 < clientCount && elapsedNanoseconds(drainStart) < 10e9)
+		{
+			receiveAll();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		SharedStateBusStatistics statistics;
+		bus.GetStatistics(&statistics);
+		const uint64_t expectedCount = static_cast<uint64_t>(clientCount - 1) * pulseCount;
+		printf("%-9s slot %2d  publish %6.1f ns  read %u states %7.1f ns  send %6.1f ns  receive %7.1f ns/pulse  received %llu/%llu  missed %llu  out of order %llu  torn %llu/%llu (retries gave up %llu)\n",
+			instanceName, statistics.InstanceIndex, publishNanoseconds / pulseCount, clientCount - 1, readNanoseconds / pulseCount,
+			sendNanoseconds / pulseCount, receiveNanoseconds / pulseCount, static_cast<unsigned long long>(receivedCount),
+			static_cast<unsigned long long>(expectedCount), static_cast<unsigned long long>(statistics.MissedCount),
+			static_cast<unsigned long long>(outOfOrderCount), static_cast<unsigned long long>(tornCount),
+			static_cast<unsigned long long>(readCount), static_cast<unsigned long long>(statistics.TornReadCount));
+		fflush(stdout);
+
+		bus.Close();
+		return receivedCount == expectedCount && outOfOrderCount == 0 && tornCount == 0 ? 0 : 1;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const uint32_t clientCount = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 6;
+	const uint32_t pulseCount = argc > 2 ? static_cast<uint32_t>(atoi(argv[2])) : 2000;
+	const uint32_t pulseMicroseconds = argc > 3 ? static_cast<uint32_t>(atoi(argv[3])) : 1000;
+	if (clientCount < 2 || clientCount > SharedStateBus::InstanceCapacity || pulseCount == 0)
+	{
+		fprintf(stderr, "Usage: %s [clients, 2 - %u] [pulses] [pulse microseconds]\n", argv[0], SharedStateBus::InstanceCapacity);
+		return 1;
+	}
+
+#ifdef _WIN32
+	fprintf(stderr, "%s forks its clients and only runs on POSIX systems\n", argv[0]);
+	return 1;
+#else
+	char busName[64];
+	snprintf(busName, sizeof(busName), "MQ2DotNetCoreStateBusBenchmark.%d", static_cast<int>(getpid()));
+
+	std::vector<pid_t> clients;
+	for (uint32_t clientIndex = 0; clientIndex < clientCount; ++clientIndex)
+	{
+		const pid_t pid = fork();
+		if (pid == 0)
+		{
+			_exit(runClient(busName, clientIndex, clientCount, pulseCount, pulseMicroseconds));
+		}
+
+		clients.push_back(pid);
+	}
+
+	int failedCount = 0;
+	for (const pid_t pid : clients)
+	{
+		int status = 0;
+		waitpid(pid, &status, 0);
+		failedCount += WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : 1;
+	}
+
+	char mappingName[72];
+	snprintf(mappingName, sizeof(mappingName), "/%s", busName);
+	shm_unlink(mappingName);
+
+	printf("%u clients, %u pulses: %s\n", clientCount, pulseCount, failedCount == 0 ? "ok" : "FAILED");
+	return failedCount == 0 ? 0 : 1;
+#endif
+}
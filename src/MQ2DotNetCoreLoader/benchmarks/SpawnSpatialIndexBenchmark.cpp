@@ -0,0 +1,219 @@
+// Compares the loader's spawn spatial index against a linear scan for radius, box and k-nearest queries.
+//
+// Usage: SpawnSpatialIndexBenchmark [queries per size]
+//
+// Spawns are scattered over a 4000 x 4000 area, roughly the size of an outdoor zone. The linear scan runs over a flat array
+// of positions, which is the best case for a scan. The managed MQ2Spawns.GetAll() scan is far slower than this since every
+// position read is a GetMember round trip. Every query is also checked against the scan so the benchmark doubles as a
+// correctness test.
+
+#include "../SpawnSpatialIndex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+	struct Spawn
+	{
+		uint32_t Id;
+		uint8_t Type;
+		float X, Y, Z;
+	};
+
+	const float ZoneHalfSize = 2000.0f;
+	const float QueryRadius = 150.0f;
+	const uint32_t NearestCount = 10;
+	const uint32_t TypeMask = 1u << 1; // NPCs
+
+	uint32_t scanRadius(const std::vector<Spawn>& spawns, float x, float y, float radius, uint32_t typeMask, SpawnQueryResult* pResults, uint32_t capacity)
+	{
+		uint32_t matchCount = 0;
+		for (const auto& spawn : spawns)
+		{
+			const float deltaX = spawn.X - x;
+			const float deltaY = spawn.Y - y;
+			const float distanceSquared = deltaX * deltaX + deltaY * deltaY;
+			if (SpawnSpatialIndex::IsTypeMatch(typeMask, spawn.Type) && distanceSquared <= radius * radius)
+			{
+				if (matchCount < capacity)
+				{
+					pResults[matchCount] = { spawn.Id, std::sqrt(distanceSquared) };
+				}
+
+				++matchCount;
+			}
+		}
+
+		return matchCount;
+	}
+
+	uint32_t scanNearest(const std::vector<Spawn>& spawns, float x, float y, uint32_t k, uint32_t typeMask, SpawnQueryResult* pResults)
+	{
+		thread_local std::vector<SpawnQueryResult> all;
+		all.clear();
+		for (const auto& spawn : spawns)
+		{
+			if (SpawnSpatialIndex::IsTypeMatch(typeMask, spawn.Type))
+			{
+				const float deltaX = spawn.X - x;
+				const float deltaY = spawn.Y - y;
+				all.push_back({ spawn.Id, std::sqrt(deltaX * deltaX + deltaY * deltaY) });
+			}
+		}
+
+		const uint32_t resultCount = std::min<uint32_t>(k, static_cast<uint32_t>(all.size()));
+		std::partial_sort(all.begin(), all.begin() + resultCount, all.end(), [](const SpawnQueryResult& left, const SpawnQueryResult& right) { return left.Distance < right.Distance; });
+		std::copy(all.begin(), all.begin() + resultCount, pResults);
+		return resultCount;
+	}
+
+	template<typename Query>
+	double timeQueries(const std::vector<std::pair<float, float>>& points, Query query, uint64_t& checksum)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (const auto& point : points)
+		{
+			checksum += query(point.first, point.second);
+		}
+
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / points.size();
+	}
+
+	bool runSize(uint32_t spawnCount, uint32_t queryCount)
+	{
+		std::mt19937 random(spawnCount);
+		std::uniform_real_distribution<float> coordinate(-ZoneHalfSize, ZoneHalfSize);
+
+		std::vector<Spawn> spawns(spawnCount);
+		SpawnSpatialIndex index;
+		for (uint32_t spawnIndex = 0; spawnIndex < spawnCount; ++spawnIndex)
+		{
+			spawns[spawnIndex] = { spawnIndex + 1, static_cast<uint8_t>(random() % 3), coordinate(random), coordinate(random), 0.0f };
+			index.Insert(spawns[spawnIndex].Id, &spawns[spawnIndex], spawns[spawnIndex].Type, spawns[spawnIndex].X, spawns[spawnIndex].Y, 0.0f);
+		}
+
+		// Simulate one pulse of movement so the refresh path is exercised too
+		std::uniform_real_distribution<float> step(-10.0f, 10.0f);
+		for (auto& spawn : spawns)
+		{
+			spawn.X += step(random);
+			spawn.Y += step(random);
+		}
+
+		auto readSpawn = [](void* pointer, float& x, float& y, float& z, uint8_t& type)
+		{
+			const auto pSpawn = static_cast<Spawn*>(pointer);
+			x = pSpawn->X;
+			y = pSpawn->Y;
+			z = pSpawn->Z;
+			type = pSpawn->Type;
+			return true;
+		};
+
+		// The first refresh sizes the grid buffers, time the steady state one that happens every pulse
+		index.RefreshPositions(readSpawn);
+		const auto refreshStart = std::chrono::steady_clock::now();
+		index.RefreshPositions(readSpawn);
+		const double refreshMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - refreshStart).count();
+
+		std::vector<std::pair<float, float>> points(queryCount);
+		for (auto& point : points)
+		{
+			point = { coordinate(random), coordinate(random) };
+		}
+
+		// Correctness check against the scan
+		std::vector<SpawnQueryResult> indexResults(spawnCount), scanResults(spawnCount);
+		for (uint32_t pointIndex = 0; pointIndex < std::min<uint32_t>(queryCount, 1000); ++pointIndex)
+		{
+			const auto& point = points[pointIndex];
+			const uint32_t indexCount = index.QueryRadius(point.first, point.second, QueryRadius, TypeMask, indexResults.data(), spawnCount);
+			const uint32_t scanCount = scanRadius(spawns, point.first, point.second, QueryRadius, TypeMask, scanResults.data(), spawnCount);
+			auto byId = [](const SpawnQueryResult& left, const SpawnQueryResult& right) { return left.SpawnId < right.SpawnId; };
+			std::sort(indexResults.begin(), indexResults.begin() + indexCount, byId);
+			std::sort(scanResults.begin(), scanResults.begin() + scanCount, byId);
+			if (indexCount != scanCount || !std::equal(indexResults.begin(), indexResults.begin() + indexCount, scanResults.begin(), [](const SpawnQueryResult& left, const SpawnQueryResult& right) { return left.SpawnId == right.SpawnId; }))
+			{
+				fprintf(stderr, "Radius query mismatch with %u spawns at (%f, %f)\n", spawnCount, point.first, point.second);
+				return false;
+			}
+
+			const uint32_t indexNearestCount = index.QueryNearest(point.first, point.second, NearestCount, 0.0f, TypeMask, indexResults.data());
+			const uint32_t scanNearestCount = scanNearest(spawns, point.first, point.second, NearestCount, TypeMask, scanResults.data());
+			if (indexNearestCount != scanNearestCount
+				|| !std::equal(indexResults.begin(), indexResults.begin() + indexNearestCount, scanResults.begin(), [](const SpawnQueryResult& left, const SpawnQueryResult& right) { return std::fabs(left.Distance - right.Distance) < 0.001f; }))
+			{
+				fprintf(stderr, "Nearest query mismatch with %u spawns at (%f, %f)\n", spawnCount, point.first, point.second);
+				return false;
+			}
+		}
+
+		// Queries that miss the grid entirely, on each side and level with its first and last rows, and one that only just reaches
+		// its edge
+		const float offGrid = ZoneHalfSize * 3.0f;
+		const auto yBounds = std::minmax_element(spawns.begin(), spawns.end(), [](const Spawn& left, const Spawn& right) { return left.Y < right.Y; });
+		const float minY = yBounds.first->Y;
+		const float maxY = yBounds.second->Y;
+		const std::pair<float, float> offGridPoints[] = {
+			{ -offGrid, 0.0f }, { offGrid, 0.0f }, { 0.0f, -offGrid }, { 0.0f, offGrid }, { offGrid, offGrid },
+			{ offGrid, maxY }, { offGrid, minY }, { -offGrid, maxY }, { -offGrid, minY },
+			{ -ZoneHalfSize - QueryRadius * 0.5f, 0.0f }
+		};
+		for (const auto& point : offGridPoints)
+		{
+			const uint32_t indexCount = index.QueryRadius(point.first, point.second, QueryRadius, TypeMask, indexResults.data(), spawnCount);
+			const uint32_t scanCount = scanRadius(spawns, point.first, point.second, QueryRadius, TypeMask, scanResults.data(), spawnCount);
+			const uint32_t boxCount = index.QueryBox(point.first - QueryRadius * 0.25f, point.second - QueryRadius * 0.25f, point.first + QueryRadius * 0.25f, point.second + QueryRadius * 0.25f, TypeMask, indexResults.data(), spawnCount);
+			const uint32_t scanBoxCount = static_cast<uint32_t>(std::count_if(spawns.begin(), spawns.end(), [&](const Spawn& spawn)
+			{
+				return SpawnSpatialIndex::IsTypeMatch(TypeMask, spawn.Type) && std::fabs(spawn.X - point.first) <= QueryRadius * 0.25f && std::fabs(spawn.Y - point.second) <= QueryRadius * 0.25f;
+			}));
+
+			if (indexCount != scanCount || boxCount != scanBoxCount)
+			{
+				fprintf(stderr, "Off grid query mismatch with %u spawns at (%f, %f)\n", spawnCount, point.first, point.second);
+				return false;
+			}
+		}
+
+		uint64_t checksum = 0;
+		SpawnQueryResult* pIndexResults = indexResults.data();
+		SpawnQueryResult* pScanResults = scanResults.data();
+
+		const double indexRadius = timeQueries(points, [&](float x, float y) { return index.QueryRadius(x, y, QueryRadius, TypeMask, pIndexResults, spawnCount); }, checksum);
+		const double scanRadiusTime = timeQueries(points, [&](float x, float y) { return scanRadius(spawns, x, y, QueryRadius, TypeMask, pScanResults, spawnCount); }, checksum);
+		const double indexBox = timeQueries(points, [&](float x, float y) { return index.QueryBox(x - QueryRadius, y - QueryRadius, x + QueryRadius, y + QueryRadius, TypeMask, pIndexResults, spawnCount); }, checksum);
+		const double indexNearest = timeQueries(points, [&](float x, float y) { return index.QueryNearest(x, y, NearestCount, 0.0f, TypeMask, pIndexResults); }, checksum);
+		const double scanNearestTime = timeQueries(points, [&](float x, float y) { return scanNearest(spawns, x, y, NearestCount, TypeMask, pScanResults); }, checksum);
+
+		printf("%6u spawns  refresh %8.1f us  radius %8.1f ns (scan %9.1f ns)  box %8.1f ns  nearest %u %8.1f ns (scan %9.1f ns)  [%llu]\n",
+			spawnCount, refreshMicroseconds, indexRadius, scanRadiusTime, indexBox, NearestCount, indexNearest, scanNearestTime,
+			static_cast<unsigned long long>(checksum));
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const uint32_t queryCount = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 100000;
+	if (queryCount == 0)
+	{
+		fprintf(stderr, "Usage: %s [queries per size]\n", argv[0]);
+		return 1;
+	}
+
+	for (uint32_t spawnCount : { 100u, 1000u, 10000u })
+	{
+		if (!runSize(spawnCount, queryCount))
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,266 @@
+// Fake MQ2Main.dll for the portable CMake build. Implements the exports declared in the stub MQ2Plugin.h well enough for the
+// loader and the managed side to initialize and run: chat goes to stdout, commands are kept in a table HideDoCommand can
+// dispatch to, and there are Int and String TLOs/types (any other type name gets an empty type). ParseMacroData only
+// resolves ${TLO[index]} without members, which covers what the loader benchmark needs. The spawn list and the character's
+// items are owned by whoever drives the loader, e.g. the benchmark.
+
+#include "MQ2Plugin.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+
+char gszINIPath[MAX_PATH] = { 0 };
+
+namespace
+{
+	SPAWNMANAGER spawnManager{ nullptr, nullptr };
+	PSPAWNMANAGER pSpawnManagerInstance = &spawnManager;
+	PSPAWNINFO pLocalPlayerInstance = nullptr;
+	PSPAWNINFO pTargetInstance = nullptr;
+	PCHARINFO pCharDataInstance = nullptr;
+
+	class IntType : public MQ2Type
+	{
+	public:
+		IntType() : MQ2Type("int") {}
+
+		bool GetMember(MQ2VARPTR VarPtr, PCHAR Member, PCHAR Index, MQ2TYPEVAR& Dest) override { return false; }
+
+		bool ToString(MQ2VARPTR VarPtr, PCHAR Destination) override
+		{
+			snprintf(Destination, MAX_STRING, "%d", VarPtr.Int);
+			return true;
+		}
+
+		bool FromData(MQ2VARPTR& VarPtr, MQ2TYPEVAR& Source) override
+		{
+			VarPtr.Int = Source.VarPtr.Int;
+			return true;
+		}
+
+		bool FromString(MQ2VARPTR& VarPtr, PCHAR Source) override
+		{
+			VarPtr.Int = atoi(Source);
+			return true;
+		}
+	};
+
+	class StringType : public MQ2Type
+	{
+	public:
+		StringType() : MQ2Type("string") {}
+
+		bool GetMember(MQ2VARPTR VarPtr, PCHAR Member, PCHAR Index, MQ2TYPEVAR& Dest) override { return false; }
+
+		bool ToString(MQ2VARPTR VarPtr, PCHAR Destination) override
+		{
+			snprintf(Destination, MAX_STRING, "%s", VarPtr.Ptr ? static_cast<const char*>(VarPtr.Ptr) : "");
+			return true;
+		}
+
+		bool FromData(MQ2VARPTR& VarPtr, MQ2TYPEVAR& Source) override { return false; }
+		bool FromString(MQ2VARPTR& VarPtr, PCHAR Source) override { return false; }
+	};
+
+	// Every other data type. MQ2DotNetCore looks up all of MQ2's types by name when it starts, these have the name and nothing else
+	class EmptyType : public MQ2Type
+	{
+	public:
+		explicit EmptyType(const char* name) : MQ2Type(name) {}
+
+		bool GetMember(MQ2VARPTR VarPtr, PCHAR Member, PCHAR Index, MQ2TYPEVAR& Dest) override { return false; }
+		bool ToString(MQ2VARPTR VarPtr, PCHAR Destination) override { return false; }
+		bool FromData(MQ2VARPTR& VarPtr, MQ2TYPEVAR& Source) override { return false; }
+		bool FromString(MQ2VARPTR& VarPtr, PCHAR Source) override { return false; }
+	};
+
+	IntType intType;
+	StringType stringType;
+
+	// Like MQ2's, TLO results share one buffer that the next read overwrites
+	char dataTypeTemp[MAX_STRING] = { 0 };
+
+	BOOL dataInt(PCHAR szIndex, MQ2TYPEVAR& Ret)
+	{
+		Ret.Type = &intType;
+		Ret.VarPtr.Int = szIndex ? atoi(szIndex) : 0;
+		return true;
+	}
+
+	BOOL dataString(PCHAR szIndex, MQ2TYPEVAR& Ret)
+	{
+		snprintf(dataTypeTemp, sizeof(dataTypeTemp), "%s", szIndex ? szIndex : "");
+		Ret.Type = &stringType;
+		Ret.VarPtr.Ptr = dataTypeTemp;
+		return true;
+	}
+
+	MQ2DATAITEM dataItems[] = {
+		{ "Int", &dataInt },
+		{ "String", &dataString },
+	};
+
+	std::map<std::string, fEQCommand>& commands()
+	{
+		static std::map<std::string, fEQCommand> commands;
+		return commands;
+	}
+
+	void writeChat(const char* szFormat, va_list arguments)
+	{
+		char buffer[MAX_STRING];
+		vsnprintf(buffer, sizeof(buffer), szFormat, arguments);
+		printf("[MQ2] %s\n", buffer);
+	}
+}
+
+PSPAWNMANAGER* ppSpawnManager = &pSpawnManagerInstance;
+PSPAWNINFO* ppLocalPlayer = &pLocalPlayerInstance;
+PSPAWNINFO* ppTarget = &pTargetInstance;
+PCHARINFO* ppCharData = &pCharDataInstance;
+MQ2Type* pStringType = &stringType;
+
+VOID WriteChatf(const char* szFormat, ...)
+{
+	va_list arguments;
+	va_start(arguments, szFormat);
+	writeChat(szFormat, arguments);
+	va_end(arguments);
+}
+
+VOID WriteChatfSafe(const char* szFormat, ...)
+{
+	va_list arguments;
+	va_start(arguments, szFormat);
+	writeChat(szFormat, arguments);
+	va_end(arguments);
+}
+
+VOID AddCommand(PCHAR Command, fEQCommand Function, BOOL EQ, BOOL Parse, BOOL InGame)
+{
+	if (Command && Function)
+		commands()[Command] = Function;
+}
+
+BOOL RemoveCommand(PCHAR Command)
+{
+	return Command && commands().erase(Command) != 0;
+}
+
+VOID HideDoCommand(PSPAWNINFO pChar, PCHAR szLine, BOOL delayed)
+{
+	if (szLine == nullptr)
+		return;
+
+	std::string line(szLine);
+	const size_t nameEnd = line.find(' ');
+	const auto command = commands().find(line.substr(0, nameEnd));
+	if (command == commands().end())
+	{
+		WriteChatf("Couldn't parse '%s'", szLine);
+		return;
+	}
+
+	const size_t argumentsStart = nameEnd == std::string::npos ? std::string::npos : line.find_first_not_of(' ', nameEnd);
+	std::string arguments = argumentsStart == std::string::npos ? std::string() : line.substr(argumentsStart);
+	command->second(pChar, &arguments[0]);
+}
+
+PMQ2DATAITEM FindMQ2Data(PCHAR szName)
+{
+	if (szName == nullptr)
+		return nullptr;
+
+	for (auto& dataItem : dataItems)
+	{
+		if (strcmp(dataItem.Name, szName) == 0)
+			return &dataItem;
+	}
+
+	return nullptr;
+}
+
+MQ2Type* FindMQ2DataType(PCHAR szName)
+{
+	if (szName == nullptr)
+		return nullptr;
+
+	if (strcmp(szName, intType.TypeName) == 0)
+		return &intType;
+
+	if (strcmp(szName, stringType.TypeName) == 0)
+		return &stringType;
+
+	static std::map<std::string, std::unique_ptr<EmptyType>> emptyTypes;
+	auto& pType = emptyTypes[szName];
+	if (!pType)
+		pType = std::make_unique<EmptyType>(szName);
+
+	return pType.get();
+}
+
+// Resolves the innermost ${Name[Index]} until there are none left. Members aren't supported.
+BOOL ParseMacroData(PCHAR szOriginal, size_t BufferSize)
+{
+	std::string text(szOriginal);
+	for (size_t start = text.rfind("${"); start != std::string::npos; start = text.rfind("${"))
+	{
+		const size_t end = text.find('}', start);
+		if (end == std::string::npos)
+			return false;
+
+		std::string name = text.substr(start + 2, end - start - 2);
+		std::string index;
+		const size_t indexStart = name.find('[');
+		if (indexStart != std::string::npos && name.back() == ']')
+		{
+			index = name.substr(indexStart + 1, name.size() - indexStart - 2);
+			name.resize(indexStart);
+		}
+
+		char result[MAX_STRING] = "NULL";
+		MQ2TYPEVAR value{};
+		const auto pDataItem = FindMQ2Data(&name[0]);
+		if (pDataItem && pDataItem->Function(&index[0], value) && value.Type)
+			value.Type->ToString(value.VarPtr, result);
+
+		text.replace(start, end - start + 1, result);
+	}
+
+	if (text.size() + 1 > BufferSize)
+		return false;
+
+	memcpy(szOriginal, text.c_str(), text.size() + 1);
+	return true;
+}
+
+BOOL Calculate(PCHAR szFormula, DOUBLE& Result)
+{
+	char* pEnd = nullptr;
+	Result = strtod(szFormula, &pEnd);
+	return pEnd != szFormula;
+}
+
+PVOID GetItemList()
+{
+	return nullptr;
+}
+
+PCHARINFO GetCharInfo()
+{
+	return pCharData;
+}
+
+PCHARINFO2 GetCharInfo2()
+{
+	return pCharData ? pCharData->pCharInfo2 : nullptr;
+}
+
+PITEMINFO GetItemFromContents(PCONTENTS c)
+{
+	return c ? c->Item : nullptr;
+}
@@ -0,0 +1,257 @@
+#pragma once
+
+// Stand-in for MQ2's MQ2Plugin.h, used by the portable CMake build to compile the loader outside of an MQ2 source tree. Only
+// the parts the loader uses are declared, with the same names and shapes as MQ2's so the loader's sources build unchanged.
+// MQ2Main.cpp next to it implements them as a small fake host (MQ2Main.dll) that the loader and the managed side link
+// against. Spawn, ground item and item layouts only have the fields the loader reads, they don't match the real client structs.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+#else
+
+#define __declspec(attribute) __attribute__((visibility("default")))
+#define __cdecl
+#define __stdcall
+
+#define MAX_PATH 260
+
+typedef void VOID;
+typedef int BOOL;
+typedef unsigned char BYTE;
+typedef unsigned short WORD;
+typedef uint32_t DWORD;
+typedef char CHAR;
+typedef char* PCHAR;
+typedef float FLOAT;
+typedef double DOUBLE;
+typedef void* PVOID;
+typedef int64_t __int64;
+
+#endif
+
+#define MAX_STRING 2048
+
+#define EQLIB_API extern "C" __declspec(dllexport)
+#define EQLIB_VAR extern "C" __declspec(dllexport)
+
+#define PLUGIN_API extern "C" __declspec(dllexport)
+#define PLUGIN_VERSION(Version) extern "C" { __declspec(dllexport) float MQ2Version = Version; }
+#define PreSetup(pluginname) extern "C" { __declspec(dllexport) char INIFileName[MAX_PATH] = { 0 }; __declspec(dllexport) const char* PluginName = pluginname; }
+
+// Data types
+union MQ2VARPTR
+{
+	PVOID Ptr;
+	FLOAT Float;
+	DWORD DWord;
+	int Int;
+	DOUBLE Double;
+	__int64 Int64;
+	uint64_t UInt64;
+};
+
+class MQ2Type;
+
+struct MQ2TYPEVAR
+{
+	MQ2Type* Type;
+	MQ2VARPTR VarPtr;
+};
+typedef MQ2TYPEVAR* PMQ2TYPEVAR;
+
+class MQ2Type
+{
+public:
+	explicit MQ2Type(const char* NewName)
+	{
+		strncpy(TypeName, NewName, sizeof(TypeName) - 1);
+		TypeName[sizeof(TypeName) - 1] = '\0';
+	}
+
+	virtual ~MQ2Type() = default;
+
+	virtual bool GetMember(MQ2VARPTR VarPtr, PCHAR Member, PCHAR Index, MQ2TYPEVAR& Dest) = 0;
+	virtual bool ToString(MQ2VARPTR VarPtr, PCHAR Destination) = 0;
+	virtual bool FromData(MQ2VARPTR& VarPtr, MQ2TYPEVAR& Source) = 0;
+	virtual bool FromString(MQ2VARPTR& VarPtr, PCHAR Source) = 0;
+	virtual void InitVariable(MQ2VARPTR& VarPtr) { VarPtr.UInt64 = 0; }
+	virtual void FreeVariable(MQ2VARPTR& VarPtr) {}
+
+	PCHAR GetName() { return TypeName; }
+
+	char TypeName[32];
+};
+
+typedef BOOL(__cdecl* fMQData)(PCHAR szIndex, MQ2TYPEVAR& Ret);
+
+struct MQ2DATAITEM
+{
+	CHAR Name[64];
+	fMQData Function;
+};
+typedef MQ2DATAITEM* PMQ2DATAITEM;
+
+// Spawns and ground items
+struct SPAWNINFO
+{
+	SPAWNINFO* pPrev;
+	SPAWNINFO* pNext;
+	CHAR Name[64];
+	FLOAT X;
+	FLOAT Y;
+	FLOAT Z;
+	FLOAT Heading;
+	DWORD SpawnID;
+	BYTE Type;
+	BYTE Level;
+	BYTE StandState;
+	int HPCurrent;
+	int HPMax;
+	DWORD TargetOfTarget;
+};
+typedef SPAWNINFO* PSPAWNINFO;
+
+struct SPAWNMANAGER
+{
+	PSPAWNINFO FirstSpawn;
+	PSPAWNINFO LastSpawn;
+};
+typedef SPAWNMANAGER* PSPAWNMANAGER;
+
+struct GROUNDITEM
+{
+	GROUNDITEM* pPrev;
+	GROUNDITEM* pNext;
+	DWORD ID;
+	DWORD DropID;
+	CHAR Name[64];
+	FLOAT X;
+	FLOAT Y;
+	FLOAT Z;
+	FLOAT Heading;
+};
+typedef GROUNDITEM* PGROUNDITEM;
+
+// Items and the character's inventory. The client reaches CHARINFO2 through more indirection than pCharInfo2.
+#define ITEM_NAME_LEN 64
+#define NUM_INV_SLOTS 33
+#define NUM_BANK_SLOTS 24
+#define NUM_SHAREDBANK_SLOTS 2
+#define ITEMTYPE_PACK 1
+
+struct ITEMINFO
+{
+	CHAR Name[ITEM_NAME_LEN];
+	DWORD ItemNumber;
+	BYTE Type;
+	BYTE Slots;
+};
+typedef ITEMINFO* PITEMINFO;
+
+struct CONTENTS;
+
+struct ITEMSARRAY
+{
+	CONTENTS* Item[40];
+};
+
+struct CONTAINEDITEMS
+{
+	ITEMSARRAY* pItems;
+	DWORD Size;
+};
+
+struct ITEMBASECONTAINER
+{
+	CONTAINEDITEMS ContainedItems;
+};
+
+struct CONTENTS
+{
+	PITEMINFO Item;
+	DWORD StackCount;
+	ITEMBASECONTAINER Contents;
+};
+typedef CONTENTS* PCONTENTS;
+
+struct INVENTORYARRAY
+{
+	PCONTENTS InventoryArray[NUM_INV_SLOTS];
+};
+typedef INVENTORYARRAY* PINVENTORYARRAY;
+
+struct BANKARRAY
+{
+	PCONTENTS Bank[NUM_BANK_SLOTS];
+};
+typedef BANKARRAY* PBANKARRAY;
+
+struct SHAREDBANKARRAY
+{
+	PCONTENTS SharedBank[NUM_SHAREDBANK_SLOTS];
+};
+typedef SHAREDBANKARRAY* PSHAREDBANKARRAY;
+
+struct CHARINFO2
+{
+	PINVENTORYARRAY pInventoryArray;
+};
+typedef CHARINFO2* PCHARINFO2;
+
+struct CHARINFO
+{
+	PBANKARRAY pBankArray;
+	PSHAREDBANKARRAY pSharedBankArray;
+	PCHARINFO2 pCharInfo2;
+};
+typedef CHARINFO* PCHARINFO;
+
+// Plugin callbacks
+typedef VOID(__cdecl* fMQInitializePlugin)(VOID);
+typedef VOID(__cdecl* fMQShutdownPlugin)(VOID);
+typedef VOID(__cdecl* fMQCleanUI)(VOID);
+typedef VOID(__cdecl* fMQReloadUI)(VOID);
+typedef VOID(__cdecl* fMQDrawHUD)(VOID);
+typedef VOID(__cdecl* fMQSetGameState)(DWORD GameState);
+typedef VOID(__cdecl* fMQPulse)(VOID);
+typedef DWORD(__cdecl* fMQIncomingChat)(PCHAR Line, DWORD Color);
+typedef DWORD(__cdecl* fMQWriteChatColor)(PCHAR Line, DWORD Color, DWORD Filter);
+typedef VOID(__cdecl* fMQSpawn)(PSPAWNINFO pSpawn);
+typedef VOID(__cdecl* fMQGroundItem)(PGROUNDITEM pGroundItem);
+typedef VOID(__cdecl* fMQBeginZone)(VOID);
+typedef VOID(__cdecl* fMQEndZone)(VOID);
+typedef VOID(__cdecl* fMQZoned)(VOID);
+typedef VOID(__cdecl* fEQCommand)(PSPAWNINFO pChar, PCHAR szLine);
+
+// MQ2Main exports
+EQLIB_VAR char gszINIPath[MAX_PATH];
+EQLIB_VAR PSPAWNMANAGER* ppSpawnManager;
+EQLIB_VAR PSPAWNINFO* ppLocalPlayer;
+EQLIB_VAR PSPAWNINFO* ppTarget;
+EQLIB_VAR PCHARINFO* ppCharData;
+EQLIB_VAR MQ2Type* pStringType;
+
+#define pSpawnManager (*ppSpawnManager)
+#define pLocalPlayer (*ppLocalPlayer)
+#define pTarget (*ppTarget)
+#define pCharData (*ppCharData)
+
+EQLIB_API VOID WriteChatf(const char* szFormat, ...);
+EQLIB_API VOID WriteChatfSafe(const char* szFormat, ...);
+EQLIB_API VOID AddCommand(PCHAR Command, fEQCommand Function, BOOL EQ, BOOL Parse, BOOL InGame);
+EQLIB_API BOOL RemoveCommand(PCHAR Command);
+EQLIB_API VOID HideDoCommand(PSPAWNINFO pChar, PCHAR szLine, BOOL delayed);
+EQLIB_API BOOL ParseMacroData(PCHAR szOriginal, size_t BufferSize);
+EQLIB_API BOOL Calculate(PCHAR szFormula, DOUBLE& Result);
+EQLIB_API PMQ2DATAITEM FindMQ2Data(PCHAR szName);
+EQLIB_API MQ2Type* FindMQ2DataType(PCHAR szName);
+EQLIB_API PVOID GetItemList();
+EQLIB_API PCHARINFO GetCharInfo();
+EQLIB_API PCHARINFO2 GetCharInfo2();
+EQLIB_API PITEMINFO GetItemFromContents(PCONTENTS c);